@@ -35,6 +35,7 @@
  *****************************************************************************/
 #include "image_fundamentals.h"
 #include "coding_and_compression.h"
+#include "trace.h"
 #include "string.h"
 #include "histogram_operations.h"
 #include <stdio.h>
@@ -243,6 +244,8 @@ void build_huffman_table(TreeNode *root, int arr[], int top, HuffmanCode table[]
 
 uint8_t *encode_image(image_t *image, TreeNode *root, size_t *out_size)
 {
+    TRACE_ENTER(image, NULL);
+
     HuffmanCode table[256] = {0};
     int arr[256];
     build_huffman_table(root, arr, 0, table);
@@ -252,6 +255,7 @@ uint8_t *encode_image(image_t *image, TreeNode *root, size_t *out_size)
     uint8_t *encoded_data = malloc(capacity);
     if (!encoded_data)
     {
+        TRACE_EXIT();
         return NULL;
     }
 
@@ -263,7 +267,7 @@ uint8_t *encode_image(image_t *image, TreeNode *root, size_t *out_size)
     for (size_t i = 0; i < image->rows * image->cols; i++)
     {
         // Get pixel value and corresponding code
-        uint8_t pixel = image->data[i];
+        uint8_t pixel = image->data[((i / image->cols) * IMAGE_STRIDE(image)) + (i % image->cols)];
         HuffmanCode *code = &table[pixel];
 
         // Loop through each bit in code
@@ -298,6 +302,7 @@ uint8_t *encode_image(image_t *image, TreeNode *root, size_t *out_size)
     }
 
     *out_size = byte_index;
+    TRACE_EXIT();
     return encoded_data;
     return 0;
 }
@@ -308,6 +313,8 @@ void decode_image(
     TreeNode *root,
     image_t *dst)
 {
+    TRACE_ENTER(dst, NULL);
+
     size_t pixel_index = 0;
     TreeNode *current = root;
 
@@ -329,13 +336,19 @@ void decode_image(
             // Leaf reached?
             if (!current->left && !current->right)
             {
-                dst->data[pixel_index++] = (uint8_pixel_t)current->value;
+                dst->data[((pixel_index / dst->cols) * IMAGE_STRIDE(dst)) + (pixel_index % dst->cols)] = (uint8_pixel_t)current->value;
+                pixel_index++;
                 current = root;
 
                 // Stop exactly after all pixels
                 if (pixel_index == dst->rows * dst->cols)
+                {
+                    TRACE_EXIT();
                     return;
+                }
             }
         }
     }
+
+    TRACE_EXIT();
 }
\ No newline at end of file
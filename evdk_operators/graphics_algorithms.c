@@ -45,6 +45,7 @@
  *****************************************************************************/
 #include "image_fundamentals.h"
 #include "graphics_algorithms.h"
+#include "trace.h"
 #include "morphological_filters.h"
 
 #include "math.h"
@@ -164,11 +165,17 @@ void textSetFlipCharacters(const uint32_t flipped)
  */
 void textPutchar(image_t *img, const char c)
 {
+    TRACE_ENTER(img, NULL);
+
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(img) != 1, "img image can not be a luma view");
+
     if (local_x < 0 || local_x >= img->cols || local_y < 0 || local_y >= img->rows)
     {
         // Optional: you might want to increment local_x by a default width
         // so the NEXT character has a chance to be on screen,
         // but for a single "BLOB" string, returning is safest.
+        TRACE_EXIT();
         return;
     }
 
@@ -227,6 +234,7 @@ void textPutchar(image_t *img, const char c)
             // Stop if the x value is outside screen boundaries
             if (local_x >= img->cols)
             {
+                TRACE_EXIT();
                 return;
             }
 
@@ -285,6 +293,8 @@ void textPutchar(image_t *img, const char c)
             }
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -302,6 +312,8 @@ void textPutchar(image_t *img, const char c)
  */
 void textPutstring(image_t *img, const char *str)
 {
+    TRACE_ENTER(img, NULL);
+
     int32_t delta = 0;
     int32_t org_x = local_x;
 
@@ -327,6 +339,8 @@ void textPutstring(image_t *img, const char *str)
 
         i++;
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -342,6 +356,11 @@ void textPutstring(image_t *img, const char *str)
  */
 void drawLineUint8(image_t *img, point_t p1, point_t p2, uint8_pixel_t val)
 {
+    TRACE_ENTER(img, NULL);
+
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(img) != 1, "img image can not be a luma view");
+
     int dx = abs(p2.x - p1.x);
     int dy = abs(p2.y - p1.y);
     int sgnX = (p1.x < p2.x) ? 1 : -1;
@@ -372,10 +391,14 @@ void drawLineUint8(image_t *img, point_t p1, point_t p2, uint8_pixel_t val)
             e = e2;
         }
     }
+
+    TRACE_EXIT();
 }
 
 void drawLineBgr888(image_t *src, point_t p1, point_t p2, bgr888_pixel_t val)
 {
+    TRACE_ENTER(src, NULL);
+
     int dx = abs(p2.x - p1.x);
     int dy = abs(p2.y - p1.y);
     int sgnX = p1.x < p2.x ? 1 : -1;
@@ -406,10 +429,14 @@ void drawLineBgr888(image_t *src, point_t p1, point_t p2, bgr888_pixel_t val)
             e = e2;
         }
     }
+
+    TRACE_EXIT();
 }
 
 void drawLineUyvy(image_t *src, point_t p1, point_t p2, uyvy_pixel_t val)
 {
+    TRACE_ENTER(src, NULL);
+
     int dx = abs(p2.x - p1.x);
     int dy = abs(p2.y - p1.y);
     int sgnX = p1.x < p2.x ? 1 : -1;
@@ -440,6 +467,8 @@ void drawLineUyvy(image_t *src, point_t p1, point_t p2, uyvy_pixel_t val)
             e = e2;
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -460,6 +489,8 @@ void drawLineUyvy(image_t *src, point_t p1, point_t p2, uyvy_pixel_t val)
 void affineTransformation(const image_t *src, image_t *dst,
                           eTransformDirection d, float m[][3])
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -467,6 +498,8 @@ void affineTransformation(const image_t *src, image_t *dst,
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src == dst, "src and dst are the same images");
@@ -523,6 +556,8 @@ void affineTransformation(const image_t *src, image_t *dst,
             }
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -539,6 +574,8 @@ void affineTransformation(const image_t *src, image_t *dst,
 void rotate(const image_t *src, image_t *dst, const float radians,
             const point_t center)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -546,6 +583,8 @@ void rotate(const image_t *src, image_t *dst, const float radians,
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src == dst, "src and dst are the same images");
@@ -590,6 +629,8 @@ void rotate(const image_t *src, image_t *dst, const float radians,
             }
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -602,24 +643,36 @@ void rotate(const image_t *src, image_t *dst, const float radians,
  */
 void rotate180_c(const image_t *img)
 {
+    TRACE_ENTER(img, NULL);
+
     // Verify image validity
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_UINT8, "img type is invalid");
+    ASSERT(IMAGE_STEP(img) != 1, "img image can not be a luma view");
 
+    register const int32_t stride = IMAGE_STRIDE(img);
     register uint32_t i;
-    register uint8_pixel_t *s = (uint8_pixel_t *)img->data;
-    register uint8_pixel_t *d = (uint8_pixel_t *)(img->data +
-                                                  (img->rows * img->cols * sizeof(uint8_pixel_t)) -
-                                                  (1 * sizeof(uint8_pixel_t)));
+    register uint8_pixel_t *s;
+    register uint8_pixel_t *d;
     register uint8_pixel_t t;
 
-    for (i = (img->rows * img->cols) / 2; i > 0; i--)
+    // Swap each row in the top half with the mirrored row in the bottom half.
+    // If the number of rows is odd, the middle row is mirrored in place.
+    for (int32_t y = 0; y < (img->rows + 1) / 2; y++)
     {
-        t = *s;
-        *s++ = *d;
-        *d-- = t;
+        s = (uint8_pixel_t *)img->data + (y * stride);
+        d = (uint8_pixel_t *)img->data + ((img->rows - 1 - y) * stride) + (img->cols - 1);
+
+        for (i = (y == (img->rows - 1 - y)) ? (img->cols / 2) : img->cols; i > 0; i--)
+        {
+            t = *s;
+            *s++ = *d;
+            *d-- = t;
+        }
     }
+
+    TRACE_EXIT();
 }
 
 #ifdef CPU_MCXN947VDF_cm33
@@ -633,12 +686,20 @@ void rotate180_c(const image_t *img)
  */
 void rotate180_arm(const image_t *img)
 {
+    TRACE_ENTER(img, NULL);
+
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(img) != 1, "img image can not be a luma view");
+
     // Hardware specific implementation
 
     // This target implementation uses inline assembly.
     // 32 bits are addressed at once, but the byte order needs to
     // be reversed (REV instruction) before writing.
 
+    // This implementation requires contiguous pixel data
+    ASSERT(IMAGE_STRIDE(img) != img->cols, "img must not be a view");
+
     // Pointer to the first four pixels
     register uint32_t *first_ptr = (uint32_t *)img->data;
 
@@ -673,6 +734,8 @@ void rotate180_arm(const image_t *img)
         *(first_ptr++) = last_pixels;
         *last_ptr = first_pixels;
     }
+
+    TRACE_EXIT();
 }
 #endif
 
@@ -699,6 +762,8 @@ void warpPerspective(const image_t *src, image_t *dst,
                      const point_t *from, const point_t *to,
                      eTransformDirection d)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -706,6 +771,8 @@ void warpPerspective(const image_t *src, image_t *dst,
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src == dst, "src and dst are the same images");
@@ -804,11 +871,14 @@ void warpPerspective(const image_t *src, image_t *dst,
         B[8] = 1;
     }
 
-    // Draw mask image
+    // Draw mask image in the image arena
+    image_arena_mark_t mark = markImageArena();
+
     image_t *msk = newUint8Image(dst->cols, dst->rows);
 
     if (msk == NULL)
     {
+        TRACE_EXIT();
         return;
     }
 
@@ -947,7 +1017,9 @@ void warpPerspective(const image_t *src, image_t *dst,
         }
     }
 
-    deleteUint8Image(msk);
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -970,6 +1042,8 @@ void warpPerspective(const image_t *src, image_t *dst,
 void warpPerspectiveFast(const image_t *src, image_t *dst,
                          const point_t *from, eTransformDirection d)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -977,6 +1051,8 @@ void warpPerspectiveFast(const image_t *src, image_t *dst,
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src == dst, "src and dst are the same images");
@@ -1195,6 +1271,8 @@ void warpPerspectiveFast(const image_t *src, image_t *dst,
             }
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -1217,6 +1295,8 @@ void zoom(const image_t *src, image_t *dst,
           const int32_t hor, const int32_t ver,
           const eZoom zd)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -1224,6 +1304,8 @@ void zoom(const image_t *src, image_t *dst,
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src == dst, "src and dst are the same images");
@@ -1279,6 +1361,8 @@ void zoom(const image_t *src, image_t *dst,
             m = 0;
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -1302,6 +1386,12 @@ void zoomFactor(const image_t *src, image_t *dst,
                 const int32_t hor, const int32_t ver,
                 const eZoom zd, const int16_t factor)
 {
+    TRACE_ENTER(src, dst);
+
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+
     int32_t m = 0, n = 0;
 
     // Zoom
@@ -1363,4 +1453,6 @@ void zoomFactor(const image_t *src, image_t *dst,
             m = 0;
         }
     }
+
+    TRACE_EXIT();
 }
@@ -35,6 +35,20 @@
  *****************************************************************************/
 #include "image_fundamentals.h"
 #include "histogram_operations.h"
+#include "trace.h"
+
+/// Number of sub-histograms that are counted in turn and merged at the end
+#define HISTOGRAM_BANKS (4)
+
+// Function prototypes
+static void countUint8Row(const uint8_t *s, const int32_t step,
+                          const uint8_t *m, const int32_t mstep,
+                          const int32_t n, uint32_t *banks,
+                          const int32_t bins);
+static void mergeBanks(const uint32_t *banks, const int32_t bins,
+                       const int32_t nbanks, uint32_t *hist);
+static void statsFromHistogram(const uint32_t *hist, histogram_stats_t *stats);
+static void verifyMask(const image_t *img, const image_t *mask);
 
 /*!
  * \brief Creates an histogram of an image
@@ -42,40 +56,286 @@
  * The function does not check memory boundaries. It simply assumes that the
  * \p hist pointer points to memory allocated by the caller of this function.
  *
+ * The histogram is counted with histogramStats().
+ *
  * \param[in]  img  A pointer to a source image
  * \param[out] hist A pointer to an array of 256 uint32_t
  */
 void histogram(const image_t *img, uint32_t *hist)
 {
+    histogramStats(img, NULL, hist, NULL);
+}
+
+/*!
+ * \brief Creates an histogram of an image and the statistics of its pixels
+ *
+ * Incrementing a single array of bins is slow for images with areas of equal
+ * pixels, because every increment has to wait for the previous increment of
+ * the same bin. Consecutive pixels are therefore counted in
+ * HISTOGRAM_BANKS different sub-histograms, which are added at the end.
+ *
+ * The minimum, maximum and sum of the pixels are derived from the histogram,
+ * so they do not cost an extra pass over the image. A region of interest is
+ * counted by passing a roiImage() view.
+ *
+ * The sub-histograms are allocated in the image arena. If that fails the
+ * pixels are counted in \p hist directly.
+ *
+ * \param[in]  img   A pointer to the ::IMGTYPE_UINT8 source image, can be a
+ *                   luma view
+ * \param[in]  mask  A pointer to an ::IMGTYPE_UINT8 mask with the size of
+ *                   \p img, only pixels with a non-zero mask are counted. NULL
+ *                   counts all pixels.
+ * \param[out] hist  A pointer to an array of 256 uint32_t
+ * \param[out] stats A pointer to the statistics of the counted pixels, can be
+ *                   NULL
+ */
+void histogramStats(const image_t *img, const image_t *mask, uint32_t *hist,
+                    histogram_stats_t *stats)
+{
+    TRACE_ENTER(img, NULL);
+
     // Verify image validity
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_UINT8, "img type is invalid");
+    verifyMask(img, mask);
 
     // Verify histogram validity
     ASSERT(hist == NULL, "hist is invalid");
 
+    image_arena_mark_t mark = markImageArena();
+    uint32_t *banks = (uint32_t *)allocImageArena(HISTOGRAM_BANKS * 256 * sizeof(uint32_t));
+    const int32_t nbanks = (banks == NULL) ? 1 : HISTOGRAM_BANKS;
+
+    if (banks == NULL)
+    {
+        banks = hist;
+    }
+
     // Clear the histogram
     // Note: You might have learned that the memset() function is faster than
     //       this for-loop. However, the compiler optimizes such a loop to a
     //       call to memset() anyway (at least when optimization is set to
     //       -Ofast).
-    for (uint32_t i = 0; i < 256; ++i)
+    for (int32_t i = 0; i < (nbanks * 256); ++i)
+    {
+        banks[i] = 0;
+    }
+
+    // Set the pixel steps, the image and the mask can be luma views
+    const int32_t step = IMAGE_STEP(img);
+    const int32_t mstep = (mask == NULL) ? 0 : IMAGE_STEP(mask);
+
+    for (int32_t y = 0; y < img->rows; ++y)
     {
-        hist[i] = 0;
+        const uint8_t *s = img->data + (y * IMAGE_STRIDE(img));
+        const uint8_t *m = (mask == NULL) ? NULL : (mask->data + (y * IMAGE_STRIDE(mask)));
+
+        countUint8Row(s, step, m, mstep, img->cols, banks, (nbanks == 1) ? 0 : 256);
     }
 
-    // Set the image size
-    uint32_t imsize = img->rows * img->cols;
+    if (nbanks > 1)
+    {
+        mergeBanks(banks, 256, nbanks, hist);
+    }
+
+    if (stats != NULL)
+    {
+        statsFromHistogram(hist, stats);
+    }
+
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Creates an histogram of each channel of a color image
+ *
+ * Each row is counted channel by channel while it is in the cache, with the
+ * sub-histograms of histogramStats().
+ *
+ * \param[in]  img   A pointer to the ::IMGTYPE_BGR888 source image
+ * \param[in]  mask  A pointer to an ::IMGTYPE_UINT8 mask with the size of
+ *                   \p img, only pixels with a non-zero mask are counted. NULL
+ *                   counts all pixels.
+ * \param[out] hist  A pointer to an array of 3 * 256 uint32_t, with the
+ *                   histograms of the blue, green and red channel
+ * \param[out] stats A pointer to an array of 3 statistics, in the same order
+ *                   as the histograms, can be NULL
+ */
+void histogramBgr888(const image_t *img, const image_t *mask, uint32_t *hist,
+                     histogram_stats_t *stats)
+{
+    TRACE_ENTER(img, NULL);
+
+    // Verify image validity
+    ASSERT(img == NULL, "img image is invalid");
+    ASSERT(img->data == NULL, "img data is invalid");
+    ASSERT(img->type != IMGTYPE_BGR888, "img type is invalid");
+    verifyMask(img, mask);
+
+    // Verify histogram validity
+    ASSERT(hist == NULL, "hist is invalid");
+
+    image_arena_mark_t mark = markImageArena();
+    uint32_t *banks = (uint32_t *)allocImageArena(3 * HISTOGRAM_BANKS * 256 * sizeof(uint32_t));
+    const int32_t nbanks = (banks == NULL) ? 1 : HISTOGRAM_BANKS;
+
+    if (banks == NULL)
+    {
+        banks = hist;
+    }
+
+    for (int32_t i = 0; i < (3 * nbanks * 256); ++i)
+    {
+        banks[i] = 0;
+    }
+
+    const int32_t mstep = (mask == NULL) ? 0 : IMAGE_STEP(mask);
+
+    for (int32_t y = 0; y < img->rows; ++y)
+    {
+        const uint8_t *s = (const uint8_t *)((const bgr888_pixel_t *)img->data + (y * IMAGE_STRIDE(img)));
+        const uint8_t *m = (mask == NULL) ? NULL : (mask->data + (y * IMAGE_STRIDE(mask)));
+
+        for (int32_t c = 0; c < 3; ++c)
+        {
+            countUint8Row(s + c, sizeof(bgr888_pixel_t), m, mstep, img->cols,
+                          banks + (c * nbanks * 256), (nbanks == 1) ? 0 : 256);
+        }
+    }
+
+    for (int32_t c = 0; c < 3; ++c)
+    {
+        if (nbanks > 1)
+        {
+            mergeBanks(banks + (c * nbanks * 256), 256, nbanks, hist + (c * 256));
+        }
+
+        if (stats != NULL)
+        {
+            statsFromHistogram(hist + (c * 256), &stats[c]);
+        }
+    }
+
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Creates a binned histogram of an ::IMGTYPE_INT16 image
+ *
+ * Pixel value v is counted in bin ((v - \p min) * \p bins) / (\p max - \p min
+ * + 1). The division is replaced by an exact multiplication with a 32-bit
+ * reciprocal. Values below \p min are counted in the first bin and values
+ * above \p max in the last bin. The statistics are of the pixel values
+ * themselves, so they include these clipped values.
+ *
+ * Like histogramStats() the pixels are counted in HISTOGRAM_BANKS
+ * sub-histograms, which need \p bins * HISTOGRAM_BANKS uint32_t in the image
+ * arena.
+ *
+ * \param[in]  img   A pointer to the ::IMGTYPE_INT16 source image
+ * \param[in]  mask  A pointer to an ::IMGTYPE_UINT8 mask with the size of
+ *                   \p img, only pixels with a non-zero mask are counted. NULL
+ *                   counts all pixels.
+ * \param[in]  min   Smallest value of the first bin
+ * \param[in]  max   Largest value of the last bin
+ * \param[in]  bins  Number of bins, at most \p max - \p min + 1
+ * \param[out] hist  A pointer to an array of \p bins uint32_t
+ * \param[out] stats A pointer to the statistics of the counted pixels, can be
+ *                   NULL
+ */
+void histogramInt16(const image_t *img, const image_t *mask,
+                    const int16_pixel_t min, const int16_pixel_t max,
+                    const int32_t bins, uint32_t *hist,
+                    histogram_stats_t *stats)
+{
+    TRACE_ENTER(img, NULL);
+
+    // Verify image validity
+    ASSERT(img == NULL, "img image is invalid");
+    ASSERT(img->data == NULL, "img data is invalid");
+    ASSERT(img->type != IMGTYPE_INT16, "img type is invalid");
+    verifyMask(img, mask);
+
+    // Verify parameters
+    ASSERT(hist == NULL, "hist is invalid");
+    ASSERT(min > max, "min is greater than max");
+    ASSERT((bins < 1) || (bins > (max - min + 1)), "bins is invalid");
+
+    image_arena_mark_t mark = markImageArena();
+    uint32_t *banks = (uint32_t *)allocImageArena((size_t)HISTOGRAM_BANKS * bins * sizeof(uint32_t));
+    const int32_t nbanks = (banks == NULL) ? 1 : HISTOGRAM_BANKS;
+    const int32_t offset = (nbanks == 1) ? 0 : bins;
+
+    if (banks == NULL)
+    {
+        banks = hist;
+    }
+
+    for (int32_t i = 0; i < (nbanks * bins); ++i)
+    {
+        banks[i] = 0;
+    }
+
+    // ceil(2^32 * bins / range), exact for all offsets up to 65535
+    const uint32_t range = (uint32_t)(max - min + 1);
+    const uint64_t scale = (((uint64_t)bins << 32) + range - 1) / range;
+
+    const int32_t mstep = (mask == NULL) ? 0 : IMAGE_STEP(mask);
+    int32_t lo = INT16_MAX;
+    int32_t hi = INT16_MIN;
+    int64_t sum = 0;
+    uint32_t count = 0;
+
+    for (int32_t y = 0; y < img->rows; ++y)
+    {
+        const int16_pixel_t *s = (const int16_pixel_t *)img->data + (y * IMAGE_STRIDE(img));
+        const uint8_t *m = (mask == NULL) ? NULL : (mask->data + (y * IMAGE_STRIDE(mask)));
+        int32_t row_sum = 0;
+
+        for (int32_t x = 0; x < img->cols; ++x)
+        {
+            if ((m != NULL) && (m[x * mstep] == 0))
+            {
+                continue;
+            }
+
+            const int32_t v = s[x];
+            const int32_t c = (v < min) ? min : ((v > max) ? max : v);
+            const uint32_t bin = (uint32_t)(((uint64_t)(uint32_t)(c - min) * scale) >> 32);
+
+            banks[((x & (HISTOGRAM_BANKS - 1)) * offset) + bin]++;
+
+            lo = (v < lo) ? v : lo;
+            hi = (v > hi) ? v : hi;
+            row_sum += v;
+            count++;
+        }
+
+        sum += row_sum;
+    }
 
-    // Set image pointer
-    uint8_pixel_t *d = (uint8_pixel_t *)img->data;
+    if (nbanks > 1)
+    {
+        mergeBanks(banks, bins, nbanks, hist);
+    }
 
-    // Create the histogram
-    for (uint32_t i = 0; i < imsize; ++i)
+    if (stats != NULL)
     {
-        hist[*d++]++;
+        stats->count = count;
+        stats->min = (count == 0) ? 0 : lo;
+        stats->max = (count == 0) ? 0 : hi;
+        stats->sum = sum;
     }
+
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -92,6 +352,8 @@ void histogram(const image_t *img, uint32_t *hist)
  */
 void brightness(const image_t *src, image_t *dst, const int32_t brightness)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -99,6 +361,8 @@ void brightness(const image_t *src, image_t *dst, const int32_t brightness)
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -109,10 +373,13 @@ void brightness(const image_t *src, image_t *dst, const int32_t brightness)
     // Loop all pixels
     for (int32_t y = 0; y < src->rows; y++)
     {
+        const uint8_pixel_t *s = (const uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
         for (int32_t x = 0; x < src->cols; x++)
         {
             // Get the pixel from the original image and modify brightness
-            i = getUint8Pixel(src, x, y) + brightness;
+            i = s[x] + brightness;
 
             // Clip the result
             if (i > 255)
@@ -126,20 +393,29 @@ void brightness(const image_t *src, image_t *dst, const int32_t brightness)
             }
 
             // Store the result
-            setUint8Pixel(dst, x, y, i);
+            d[x] = i;
         }
     }
+
+    TRACE_EXIT();
 }
 
 float calculate_average(const image_t *src)
 {
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+
     uint32_t sum = 0;
-    uint8_t *src_data = (uint8_t *)src->data;
     uint32_t total_pixels = src->cols * src->rows;
 
-    for (uint32_t i = 0; i < total_pixels; ++i)
+    for (int32_t y = 0; y < src->rows; ++y)
     {
-        sum += src_data[i];
+        uint8_t *src_data = (uint8_t *)src->data + (y * IMAGE_STRIDE(src));
+
+        for (int32_t i = 0; i < src->cols; ++i)
+        {
+            sum += src_data[i];
+        }
     }
 
     return (float)sum / (float)total_pixels;
@@ -162,38 +438,203 @@ float calculate_average(const image_t *src)
  */
 void contrast(const image_t *src, image_t *dst, const float contrast)
 {
+    TRACE_ENTER(src, dst);
+
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+
     uint32_t sum = 0;
-    uint8_t *src_data = (uint8_t *)src->data;
-    uint8_t *dst_data = (uint8_t *)dst->data;
     uint32_t total_pixels = src->cols * src->rows;
 
     // Accumulate sum of all pixels
-    for (uint32_t i = 0; i < total_pixels; ++i)
+    for (int32_t y = 0; y < src->rows; ++y)
     {
-        sum += src_data[i];
+        uint8_t *src_data = (uint8_t *)src->data + (y * IMAGE_STRIDE(src));
+
+        for (int32_t i = 0; i < src->cols; ++i)
+        {
+            sum += src_data[i];
+        }
     }
 
     // Calculate average
     float average = (float)sum / (float)total_pixels;
 
     // Apply contrast to each pixel
-    for (uint32_t i = 0; i < total_pixels; ++i)
+    for (int32_t y = 0; y < src->rows; ++y)
     {
-        uint8_t current_value = src_data[i];
+        uint8_t *src_data = (uint8_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_t *dst_data = (uint8_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        for (int32_t i = 0; i < src->cols; ++i)
+        {
+            uint8_t current_value = src_data[i];
+
+            // Calculate new value
+            float new_value = (contrast * (current_value - average)) + average;
+
+            // Clipping
+            if (new_value < 0.0f)
+            {
+                new_value = 0.0f;
+            }
+            else if (new_value > 255.0f)
+            {
+                new_value = 255.0f;
+            }
 
-        // Calculate new value
-        float new_value = (contrast * (current_value - average)) + average;
+            dst_data[i] = (uint8_t)(new_value + 0.5f);
+        }
+    }
 
-        // Clipping
-        if (new_value < 0.0f)
+    TRACE_EXIT();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+/*!
+ * \brief Counts a row of 8-bit values in HISTOGRAM_BANKS sub-histograms
+ *
+ * Four consecutive values are counted in four different sub-histograms, so a
+ * run of equal values does not increment the same counter back to back.
+ *
+ * \param[in]     s     A pointer to the first value
+ * \param[in]     step  Distance between two values in bytes
+ * \param[in]     m     A pointer to the first mask value, NULL counts all
+ *                      values
+ * \param[in]     mstep Distance between two mask values in bytes
+ * \param[in]     n     Number of values
+ * \param[in,out] banks A pointer to the sub-histograms
+ * \param[in]     bins  Distance between two sub-histograms, 0 counts all
+ *                      values in the first
+ */
+static void countUint8Row(const uint8_t *s, const int32_t step,
+                          const uint8_t *m, const int32_t mstep,
+                          const int32_t n, uint32_t *banks,
+                          const int32_t bins)
+{
+    uint32_t *h0 = banks;
+    uint32_t *h1 = banks + bins;
+    uint32_t *h2 = banks + (2 * bins);
+    uint32_t *h3 = banks + (3 * bins);
+    int32_t x = 0;
+
+    if (m == NULL)
+    {
+        for (; x <= (n - 4); x += 4)
         {
-            new_value = 0.0f;
+            const uint8_t a = s[x * step];
+            const uint8_t b = s[(x + 1) * step];
+            const uint8_t c = s[(x + 2) * step];
+            const uint8_t d = s[(x + 3) * step];
+
+            h0[a]++;
+            h1[b]++;
+            h2[c]++;
+            h3[d]++;
         }
-        else if (new_value > 255.0f)
+
+        for (; x < n; ++x)
         {
-            new_value = 255.0f;
+            h0[s[x * step]]++;
         }
+    }
+    else
+    {
+        // Add 0 or 1 instead of a branch on the mask
+        for (; x <= (n - 4); x += 4)
+        {
+            h0[s[x * step]] += (m[x * mstep] != 0);
+            h1[s[(x + 1) * step]] += (m[(x + 1) * mstep] != 0);
+            h2[s[(x + 2) * step]] += (m[(x + 2) * mstep] != 0);
+            h3[s[(x + 3) * step]] += (m[(x + 3) * mstep] != 0);
+        }
+
+        for (; x < n; ++x)
+        {
+            h0[s[x * step]] += (m[x * mstep] != 0);
+        }
+    }
+}
+
+/*!
+ * \brief Adds sub-histograms
+ *
+ * \param[in]  banks  A pointer to the sub-histograms
+ * \param[in]  bins   Number of bins of every sub-histogram
+ * \param[in]  nbanks Number of sub-histograms
+ * \param[out] hist   A pointer to the histogram
+ */
+static void mergeBanks(const uint32_t *banks, const int32_t bins,
+                       const int32_t nbanks, uint32_t *hist)
+{
+    for (int32_t i = 0; i < bins; ++i)
+    {
+        uint32_t sum = 0;
+
+        for (int32_t k = 0; k < nbanks; ++k)
+        {
+            sum += banks[(k * bins) + i];
+        }
+
+        hist[i] = sum;
+    }
+}
+
+/*!
+ * \brief Calculates the statistics of the pixels from an 8-bit histogram
+ *
+ * \param[in]  hist  A pointer to an array of 256 uint32_t
+ * \param[out] stats A pointer to the statistics
+ */
+static void statsFromHistogram(const uint32_t *hist, histogram_stats_t *stats)
+{
+    stats->count = 0;
+    stats->min = 0;
+    stats->max = 0;
+    stats->sum = 0;
+
+    for (int32_t i = 0; i < 256; ++i)
+    {
+        stats->count += hist[i];
+        stats->sum += (int64_t)i * hist[i];
+    }
 
-        dst_data[i] = (uint8_t)(new_value + 0.5f);
+    if (stats->count == 0)
+    {
+        return;
+    }
+
+    while (hist[stats->min] == 0)
+    {
+        stats->min++;
     }
+
+    stats->max = 255;
+
+    while (hist[stats->max] == 0)
+    {
+        stats->max--;
+    }
+}
+
+/*!
+ * \brief Verifies that a mask can be used with an image
+ *
+ * \param[in] img  A pointer to the image
+ * \param[in] mask A pointer to the mask, can be NULL
+ */
+static void verifyMask(const image_t *img, const image_t *mask)
+{
+    if (mask == NULL)
+    {
+        return;
+    }
+
+    ASSERT(mask->data == NULL, "mask data is invalid");
+    ASSERT(mask->type != IMGTYPE_UINT8, "mask type is invalid");
+    ASSERT(mask->cols != img->cols, "img and mask have different number of columns");
+    ASSERT(mask->rows != img->rows, "img and mask have different number of rows");
 }
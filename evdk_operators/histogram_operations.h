@@ -41,9 +41,27 @@ extern "C" {
 
 #include "image.h"
 
+/// Statistics of the pixels that are counted in a histogram
+typedef struct
+{
+    uint32_t count; ///< Number of pixels
+    int32_t min;    ///< Smallest pixel value, 0 if count is 0
+    int32_t max;    ///< Largest pixel value, 0 if count is 0
+    int64_t sum;    ///< Sum of the pixel values
+
+}histogram_stats_t;
+
 // Functions are documented in the source file
 
 void histogram(const image_t *img, uint32_t *hist);
+void histogramStats(const image_t *img, const image_t *mask, uint32_t *hist,
+                    histogram_stats_t *stats);
+void histogramBgr888(const image_t *img, const image_t *mask, uint32_t *hist,
+                     histogram_stats_t *stats);
+void histogramInt16(const image_t *img, const image_t *mask,
+                    const int16_pixel_t min, const int16_pixel_t max,
+                    const int32_t bins, uint32_t *hist,
+                    histogram_stats_t *stats);
 void brightness(const image_t *src, image_t *dst, const int32_t brightness);
 void contrast(const image_t *src, image_t *dst, const float contrast);
 
@@ -70,6 +70,10 @@ typedef enum
     IMGTYPE_FLOAT  =  8, ///< An image with pixels of type ::float_pixel_t.
     IMGTYPE_UYVY   = 16, ///< An image with pixels of type ::uyvy_pixel_t.
     IMGTYPE_BGR888 = 32, ///< An image with pixels of type ::bgr888_pixel_t.
+    IMGTYPE_UINT32 = 64, ///< An image with pixels of type ::uint32_pixel_t.
+    IMGTYPE_BINARY = 128, ///< A binary image with 1 bit pixels, packed in
+                          ///< words of type ::binary_word_t.
+    IMGTYPE_COMPLEX = 256, ///< An image with pixels of type ::complex_pixel_t.
 
 }eImageType;
 
@@ -88,6 +92,22 @@ typedef int16_t int16_pixel_t;
 /// 32 bits per pixel
 typedef int32_t int32_pixel_t;
 
+/// \brief Type definition of a uint32 pixel
+///
+/// 32 bits per pixel
+typedef uint32_t uint32_pixel_t;
+
+/// \brief Type definition of a word of binary pixels
+///
+/// 64 pixels per word. Pixel x of a row is bit (x % 64) of word (x / 64), so
+/// the least significant bit is the leftmost pixel. The stride of a binary
+/// image is a multiple of ::BINARY_WORD_BITS pixels, and the unused bits at
+/// the end of every row are 0.
+typedef uint64_t binary_word_t;
+
+/// Number of pixels in a ::binary_word_t
+#define BINARY_WORD_BITS (64)
+
 /// \brief Type definition of a float pixel
 ///
 /// 32 bits per pixel
@@ -113,6 +133,16 @@ typedef struct bgr888_pixel_t
 
 }bgr888_pixel_t;
 
+/// \brief Type definition of a complex pixel
+///
+/// Two floats per pixel
+typedef struct complex_pixel_t
+{
+    float real;      ///< real part of the complex number
+    float imaginary; ///< imaginary part of the complex number
+
+}complex_pixel_t;
+
 /// \name Definitions for min/max pixel values
 /// \{
 
@@ -128,6 +158,9 @@ typedef struct bgr888_pixel_t
 #define INT32_PIXEL_MIN (INT32_MIN)
 #define INT32_PIXEL_MAX (INT32_MAX)
 
+#define UINT32_PIXEL_MIN (0)
+#define UINT32_PIXEL_MAX (UINT32_MAX)
+
 #define FLOAT_PIXEL_MIN (-(FLT_MAX))
 #define FLOAT_PIXEL_MAX (FLT_MAX)
 
@@ -176,9 +209,41 @@ typedef struct
     int32_t     rows; ///< Number of rows in the image
     eImageType  type; ///< The type of pixels in the image
     uint8_t    *data; ///< A pointer to the pixel data
+    int32_t   stride; ///< Number of pixels between the starts of two
+                      ///< consecutive rows. 0 means the rows are contiguous,
+                      ///< i.e. the stride equals the number of columns.
+    int32_t     step; ///< Number of pixels between two consecutive pixels in
+                      ///< a row. 0 means the pixels are contiguous, i.e. the
+                      ///< step equals 1. Only luma views have another step,
+                      ///< see lumaView().
 
 }image_t;
 
+/*!
+ * \brief Returns the row stride of an image in pixels
+ *
+ * Images created with one of the new<type>Image() functions have a stride that
+ * equals the number of columns. Views created with roiImage() share the pixel
+ * data of their parent and therefore have the stride of that parent. Images
+ * that are initialized without a stride (0) are considered contiguous.
+ */
+#define IMAGE_STRIDE(img) (((img)->stride == 0) ? (img)->cols : (img)->stride)
+
+/*!
+ * \brief Returns the pixel step of an image in pixels
+ *
+ * Only ::IMGTYPE_UINT8 views created with lumaView() have a step other than 1.
+ */
+#define IMAGE_STEP(img) (((img)->step == 0) ? 1 : (img)->step)
+
+/// Defines a position in the image arena, see markImageArena()
+typedef struct
+{
+    size_t used; ///< Number of bytes in use at the time of the mark
+    size_t top;  ///< Offset of the block on top of the stack at that time
+
+}image_arena_mark_t;
+
 /// Defines the relative brightness to look for in an image
 typedef enum
 {
@@ -195,6 +260,45 @@ typedef enum
 
 }eConnected;
 
+/// Defines the YUV to RGB conversion matrix
+typedef enum
+{
+    YUV_BT601 = 0, ///< ITU-R BT.601, standard definition video
+    YUV_BT709,     ///< ITU-R BT.709, high definition video
+
+}eYuvMatrix;
+
+/// Defines the range of the Y, U and V values
+typedef enum
+{
+    YUV_RANGE_FULL = 0, ///< Y, U and V use the range 0 - 255
+    YUV_RANGE_LIMITED,  ///< Y uses the range 16 - 235, U and V 16 - 240
+
+}eYuvRange;
+
+/// Defines how operators treat the pixels outside the image
+typedef enum
+{
+    BORDER_SKIP = 0,  ///< The border pixels of the destination image are not
+                      ///< written
+    BORDER_CONSTANT,  ///< Pixels outside the image have a constant value
+    BORDER_REPLICATE, ///< Pixels outside the image repeat the edge pixel,
+                      ///< aaa|abcd|ddd
+    BORDER_REFLECT,   ///< Pixels outside the image mirror the image around
+                      ///< the edge pixel, dcb|abcd|cba
+
+}eBorder;
+
+/// Defines how the magnitude of a gradient is calculated from its components
+typedef enum
+{
+    MAGNITUDE_L1 = 0, ///< |gx| + |gy|
+    MAGNITUDE_L2,     ///< sqrt(gx^2 + gy^2), rounded to the nearest integer
+    MAGNITUDE_APPROX, ///< Alpha max plus beta min approximation of the L2
+                      ///< norm, 0.961 max + 0.398 min, integer only
+
+}eMagnitude;
+
 /// Defines a pixel coordinate
 typedef struct
 {
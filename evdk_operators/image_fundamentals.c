@@ -36,22 +36,85 @@
 
 #include <string.h>
 #include "image_fundamentals.h"
+#include "transforms.h"
+#include "trace.h"
 #include <stdio.h>
 #include <time.h>
 
-#define MAX_IMAGES (16)
+// SIMD paths for x86, selected at compile time. SSE2 is part of every x86-64
+// target, AVX2 requires a compiler flag such as -mavx2 or -march=native. AVX2
+// implies SSE2, so code without an AVX2 variant keeps its SSE2 path.
+#if defined(__AVX2__)
+#define USE_AVX2
+#define USE_SSE2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define USE_SSE2
+#include <emmintrin.h>
+#endif
+
+// Without -mavx2, GCC and Clang can still compile single functions for AVX2.
+// These are only called if the processor supports AVX2, which is checked at
+// run time.
+#if !defined(USE_AVX2) && defined(USE_SSE2) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define USE_AVX2_DISPATCH
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+
+/// Minimum alignment in bytes of every block that is allocated from the image
+/// arena
+#define IMAGE_ARENA_ALIGNMENT (8)
+
+/// Rounds \p n up to a multiple of IMAGE_ARENA_ALIGNMENT
+#define IMAGE_ARENA_ALIGN(n) \
+    (((n) + (IMAGE_ARENA_ALIGNMENT - 1)) & ~((size_t)IMAGE_ARENA_ALIGNMENT - 1))
+
+/// Offset of the top block when there are no blocks in the arena
+#define IMAGE_ARENA_NONE (SIZE_MAX)
+
+/*!
+ * \brief Administration that is stored in front of every block in the arena
+ *
+ * The blocks form a stack. Deleting the block on top of the stack returns its
+ * memory to the arena immediately. Deleting any other block only marks it as
+ * deleted. Its memory is returned as soon as all blocks above it are deleted
+ * as well, or when the arena is released to a mark that lies below it.
+ */
+typedef struct
+{
+    size_t  prev;    ///< Offset of the previous block, or IMAGE_ARENA_NONE
+    int32_t deleted; ///< Set when the block was deleted
+
+}arena_block_t;
+
+/// Size of the block administration including padding
+#define ARENA_BLOCK_SIZE IMAGE_ARENA_ALIGN(sizeof(arena_block_t))
 
 /*!
- * \brief Local array of image pointers. Is used to free all allocated image
- *        data when calling the function deleteAllImages(). The value of the
- *        MAX_IMAGES define might need tweaking to your application. Increasing
- *        this number allows for more images to be stored, but requires more
- *        memory and more checks every time an image is created or deleted.
+ * \brief The image arena
+ *
+ * Allocating memory is done by increasing \p used, so it takes constant time
+ * and there is no limit on the number of images other than the capacity.
  */
-static image_t *imgs[MAX_IMAGES] = {NULL};
+static struct
+{
+    uint8_t *buffer; ///< Start of the arena
+    size_t   size;   ///< Capacity in bytes
+    size_t   used;   ///< Number of bytes in use
+    size_t   top;    ///< Offset of the block on top of the stack
+    int32_t  owned;  ///< Set when the buffer was allocated from the heap
+
+}arena = {NULL, 0, 0, IMAGE_ARENA_NONE, 0};
 
 // Function prototypes
 uint8_t clip(int32_t val);
+static void *arenaAlloc(const size_t size, const size_t alignment);
+static size_t defaultArenaSize(void);
+static size_t pixelSize(const eImageType type);
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
@@ -73,90 +136,165 @@ inline uint8_t clip(int32_t val)
 /// \name Getter functions for individual pixels
 /// \{
 
-/*!
- * \brief Getter functions for individual pixels
- *
- * \param[in] img A pointer to the image
- * \param[in] c   Column (x) coordinate of the pixel
- * \param[in] r   Row (y) coordinate of the pixel
- *
- * \return Pixel value at coordinate (c,r)
- */
+// The getter functions are defined inline in image_fundamentals.h. These
+// declarations provide the external definitions for callers that do not
+// inline them.
+extern inline uint8_pixel_t getUint8Pixel(const image_t *img, const int32_t c, const int32_t r);
+extern inline uint8_pixel_t getUint8PixelStrided(const image_t *img, const int32_t c, const int32_t r);
+extern inline int16_pixel_t getInt16Pixel(const image_t *img, const int32_t c, const int32_t r);
+extern inline int32_pixel_t getInt32Pixel(const image_t *img, const int32_t c, const int32_t r);
+extern inline float_pixel_t getFloatPixel(const image_t *img, const int32_t c, const int32_t r);
+extern inline uyvy_pixel_t getUyvyPixel(const image_t *img, const int32_t c, const int32_t r);
+extern inline bgr888_pixel_t getBgr888Pixel(const image_t *img, const int32_t c, const int32_t r);
+extern inline uint32_pixel_t getUint32Pixel(const image_t *img, const int32_t c, const int32_t r);
+extern inline uint8_pixel_t getBinaryPixel(const image_t *img, const int32_t c, const int32_t r);
+extern inline complex_pixel_t getComplexPixel(const image_t *img, const int32_t c, const int32_t r);
+/// \}
 
-inline uint8_pixel_t getUint8Pixel(const image_t *img, const int32_t c, const int32_t r)
-{
-    return (*((uint8_pixel_t *)(img->data) + (r * img->cols + c)));
-}
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
 
-inline int16_pixel_t getInt16Pixel(const image_t *img, const int32_t c, const int32_t r)
-{
-    return (*((int16_pixel_t *)(img->data) + (r * img->cols + c)));
-}
+/// \name Setter functions for individual pixels
+/// \{
 
-inline int32_pixel_t getInt32Pixel(const image_t *img, const int32_t c, const int32_t r)
-{
-    return (*((int32_pixel_t *)(img->data) + (r * img->cols + c)));
-}
+// The setter functions are defined inline in image_fundamentals.h. These
+// declarations provide the external definitions for callers that do not
+// inline them.
+extern inline void setUint8Pixel(const image_t *img, const int32_t c, const int32_t r, const uint8_pixel_t value);
+extern inline void setUint8PixelStrided(const image_t *img, const int32_t c, const int32_t r, const uint8_pixel_t value);
+extern inline void setInt16Pixel(const image_t *img, const int32_t c, const int32_t r, const int16_pixel_t value);
+extern inline void setInt32Pixel(const image_t *img, const int32_t c, const int32_t r, const int32_pixel_t value);
+extern inline void setFloatPixel(const image_t *img, const int32_t c, const int32_t r, const float_pixel_t value);
+extern inline void setUyvyPixel(const image_t *img, const int32_t c, const int32_t r, const uyvy_pixel_t value);
+extern inline void setBgr888Pixel(const image_t *img, const int32_t c, const int32_t r, const bgr888_pixel_t value);
+extern inline void setUint32Pixel(const image_t *img, const int32_t c, const int32_t r, const uint32_pixel_t value);
+extern inline void setBinaryPixel(const image_t *img, const int32_t c, const int32_t r, const uint8_pixel_t value);
+extern inline void setComplexPixel(const image_t *img, const int32_t c, const int32_t r, const complex_pixel_t value);
+/// \}
 
-inline float_pixel_t getFloatPixel(const image_t *img, const int32_t c, const int32_t r)
-{
-    return (*((float_pixel_t *)(img->data) + (r * img->cols + c)));
-}
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
 
-inline uyvy_pixel_t getUyvyPixel(const image_t *img, const int32_t c, const int32_t r)
-{
-    return (*((uyvy_pixel_t *)(img->data) + (r * img->cols + c)));
-}
+/// \name Functions for integral images
+/// \{
 
-inline bgr888_pixel_t getBgr888Pixel(const image_t *img, const int32_t c, const int32_t r)
-{
-    return (*((bgr888_pixel_t *)(img->data) + (r * img->cols + c)));
-}
+// getIntegralSum() is defined inline in image_fundamentals.h. This
+// declaration provides the external definition for callers that do not
+// inline it.
+extern inline uint32_t getIntegralSum(const image_t *ii, const int32_t x0, const int32_t y0, const int32_t x1, const int32_t y1);
 /// \}
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
-/// \name Setter functions for individual pixels
+/// \name Functions for the image arena
 /// \{
 
 /*!
- * \brief Setter functions for individual pixels
+ * \brief Initializes the arena that is used for allocating images
+ *
+ * Calling this function is optional. Without it, a buffer of IMAGE_ARENA_SIZE
+ * bytes is allocated from the heap when the first image is created. Provide a
+ * statically allocated buffer to avoid using the heap at all. All images that
+ * were created before calling this function become invalid.
  *
- * \param[in] img   A pointer to the image
- * \param[in] c     Column (x) coordinate of the pixel
- * \param[in] r     Row (y) coordinate of the pixel
- * \param[in] value New pixel value for coordinate (c,r)
+ * \param[in] buffer A pointer to the memory for the arena. If NULL, \p size
+ *                   bytes are allocated from the heap.
+ * \param[in] size   Capacity of the arena in bytes
  */
-
-inline void setUint8Pixel(const image_t *img, const int32_t c, const int32_t r, const uint8_pixel_t value)
+void initImageArena(uint8_t *buffer, const size_t size)
 {
-    *((uint8_pixel_t *)(img->data) + (r * img->cols + c)) = value;
-}
+    if (arena.owned)
+    {
+        free(arena.buffer);
+    }
 
-inline void setInt16Pixel(const image_t *img, const int32_t c, const int32_t r, const int16_pixel_t value)
-{
-    *((int16_pixel_t *)(img->data) + (r * img->cols + c)) = value;
+    arena.buffer = buffer;
+    arena.owned = 0;
+
+    if (arena.buffer == NULL)
+    {
+        arena.buffer = (uint8_t *)malloc(size);
+        arena.owned = 1;
+    }
+
+    // Verify arena validity
+    ASSERT(arena.buffer == NULL, "Unable to allocate memory for the image arena");
+
+    arena.size = (arena.buffer == NULL) ? 0 : size;
+    arena.used = 0;
+    arena.top = IMAGE_ARENA_NONE;
 }
 
-inline void setInt32Pixel(const image_t *img, const int32_t c, const int32_t r, const int32_pixel_t value)
+/*!
+ * \brief Returns the current position in the arena
+ *
+ * Together with releaseImageArena() this implements per-frame allocation. Take
+ * a mark before the processing of a frame starts and release to it when the
+ * frame is done. All images and buffers that were allocated in between are
+ * freed at once.
+ *
+ * \return The current position in the arena
+ */
+image_arena_mark_t markImageArena(void)
 {
-    *((int32_pixel_t *)(img->data) + (r * img->cols + c)) = value;
+    image_arena_mark_t mark = {arena.used, arena.top};
+
+    return mark;
 }
 
-inline void setFloatPixel(const image_t *img, const int32_t c, const int32_t r, const float_pixel_t value)
+/*!
+ * \brief Frees all images and buffers that were allocated after \p mark was
+ *        taken
+ *
+ * \param[in] mark A position in the arena returned by markImageArena()
+ */
+void releaseImageArena(const image_arena_mark_t mark)
 {
-    *((float_pixel_t *)(img->data) + (r * img->cols + c)) = value;
+    // Verify mark validity
+    ASSERT(mark.used > arena.used, "mark is invalid, it has already been released");
+
+    arena.used = mark.used;
+    arena.top = mark.top;
 }
 
-inline void setUyvyPixel(const image_t *img, const int32_t c, const int32_t r, const uyvy_pixel_t value)
+/*!
+ * \brief Allocates a temporary buffer from the arena
+ *
+ * The buffer is aligned to IMAGE_ARENA_ALIGNMENT bytes. It is freed by
+ * releaseImageArena() or deleteAllImages(). Operators use it for look-up
+ * tables and other scratch memory, so that the heap is not used while
+ * processing a frame.
+ *
+ * \param[in] size The number of bytes to allocate
+ *
+ * \return A pointer to the buffer. NULL if the arena is full.
+ */
+void *allocImageArena(const size_t size)
 {
-    *((uyvy_pixel_t *)(img->data) + (r * img->cols + c)) = value;
+    arena_block_t *blk = (arena_block_t *)arenaAlloc(ARENA_BLOCK_SIZE + size,
+                                                     IMAGE_ARENA_ALIGNMENT);
+
+    if (blk == NULL)
+    {
+        return NULL;
+    }
+
+    blk->prev = arena.top;
+    blk->deleted = 0;
+    arena.top = (uint8_t *)blk - arena.buffer;
+
+    return (uint8_t *)blk + ARENA_BLOCK_SIZE;
 }
 
-inline void setBgr888Pixel(const image_t *img, const int32_t c, const int32_t r, const bgr888_pixel_t value)
+/*!
+ * \brief Returns the number of bytes that are in use in the arena
+ *
+ * \return The number of bytes in use
+ */
+size_t getImageArenaUsage(void)
 {
-    *((bgr888_pixel_t *)(img->data) + (r * img->cols + c)) = value;
+    return arena.used;
 }
 
 /// \}
@@ -164,295 +302,279 @@ inline void setBgr888Pixel(const image_t *img, const int32_t c, const int32_t r,
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
-/// \name Functions for creating new images
-/// \{
-
 /*!
- * \brief Functions for creating new images
+ * \brief Allocates \p size bytes from the arena
  *
- * After the image has been used and is not needed any more, make sure that the
- * image is deleted by calling the function delete<type>Image() or
- * deleteAllImages().
+ * The arena is initialized with the default capacity on first use.
  *
- * \param[in] cols The number of columns for the new image
- * \param[in] rows The number of rows for the new image
+ * \param[in] size      The number of bytes to allocate
+ * \param[in] alignment Alignment in bytes of the memory, must be a power of two
  *
- * \return A pointer to the new image. NULL if memory allocation failed.
+ * \return A pointer to the memory. NULL if the arena is full.
  */
-image_t *newUint8Image(const uint32_t cols, const uint32_t rows)
+static void *arenaAlloc(const size_t size, const size_t alignment)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if (img == NULL)
+    if (arena.buffer == NULL)
     {
-        // Unable to allocate memory for new image
-        ASSERT(1 == 1, "Unable to allocate memory for new image");
-
-        return NULL;
+        initImageArena(NULL, defaultArenaSize());
     }
 
-    img->data = (uint8_t *)malloc((rows * cols) * sizeof(uint8_pixel_t));
+    // Align the start of the block
+    uintptr_t base = (uintptr_t)arena.buffer;
+    uintptr_t addr = (base + arena.used + (alignment - 1)) & ~((uintptr_t)alignment - 1);
+    size_t start = addr - base;
 
-    if (img->data == NULL)
+    if ((start > arena.size) || (size > (arena.size - start)))
     {
-        // Unable to allocate memory for image data
-        free(img);
-
-        ASSERT(1 == 1, "Unable to allocate memory for image data");
-
         return NULL;
     }
 
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_UINT8;
-
-    // Add image to the images array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return (img);
-        }
-    }
-
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
-
-    ASSERT(1 == 1, "Local imgs array is too small, increase MAX_IMAGES");
+    arena.used = start + size;
 
-    return NULL;
+    return arena.buffer + start;
 }
 
-image_t *newInt16Image(const uint32_t cols, const uint32_t rows)
+/*!
+ * \brief Returns the capacity of the arena if the application does not
+ *        provide one
+ *
+ * \return IMAGE_ARENA_SIZE, or on the host the value of the environment
+ *         variable EVDK_IMAGE_ARENA_SIZE if it is set
+ */
+static size_t defaultArenaSize(void)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if (img == NULL)
-    {
-        // Unable to allocate memory for new image
-        ASSERT(1 == 1, "Unable to allocate memory for new image");
-
-        return NULL;
-    }
-
-    img->data = (uint8_t *)malloc((rows * cols) * sizeof(int16_pixel_t));
+#ifndef MCUXPRESSO_SDK
+    const char *env = getenv("EVDK_IMAGE_ARENA_SIZE");
 
-    if (img->data == NULL)
+    if (env != NULL)
     {
-        // Unable to allocate memory for image data
-        free(img);
+        char *end = NULL;
+        unsigned long long size = strtoull(env, &end, 10);
 
-        ASSERT(1 == 1, "Unable to allocate memory for image data");
-
-        return NULL;
-    }
-
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_INT16;
+        if ((*end == 'K') || (*end == 'k'))
+        {
+            size <<= 10;
+        }
+        else if ((*end == 'M') || (*end == 'm'))
+        {
+            size <<= 20;
+        }
+        else if ((*end == 'G') || (*end == 'g'))
+        {
+            size <<= 30;
+        }
 
-    // Add image to the images array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] == NULL)
+        if ((end != env) && (size > 0) && (size <= SIZE_MAX))
         {
-            imgs[i] = img;
-            return (img);
+            return (size_t)size;
         }
     }
+#endif
 
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
-
-    ASSERT(1 == 1, "Local imgs array is too small, increase MAX_IMAGES");
-
-    return NULL;
+    return IMAGE_ARENA_SIZE;
 }
 
-image_t *newInt32Image(const uint32_t cols, const uint32_t rows)
+/*!
+ * \brief Returns the size in bytes of a single pixel
+ *
+ * \param[in] type The type of pixel
+ *
+ * \return The size of the pixel. 0 if the type is invalid.
+ */
+static size_t pixelSize(const eImageType type)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if (img == NULL)
+    switch (type)
     {
-        // Unable to allocate memory for new image
-        ASSERT(1 == 1, "Unable to allocate memory for new image");
-
-        return NULL;
+    case IMGTYPE_UINT8:
+        return sizeof(uint8_pixel_t);
+    case IMGTYPE_INT16:
+        return sizeof(int16_pixel_t);
+    case IMGTYPE_INT32:
+        return sizeof(int32_pixel_t);
+    case IMGTYPE_FLOAT:
+        return sizeof(float_pixel_t);
+    case IMGTYPE_UYVY:
+        return sizeof(uyvy_pixel_t);
+    case IMGTYPE_BGR888:
+        return sizeof(bgr888_pixel_t);
+    case IMGTYPE_UINT32:
+        return sizeof(uint32_pixel_t);
+    case IMGTYPE_BINARY:
+        // Pixels are smaller than a byte, see newBinaryImage()
+        return 0;
+    case IMGTYPE_COMPLEX:
+        return sizeof(complex_pixel_t);
     }
 
-    img->data = (uint8_t *)malloc((rows * cols) * sizeof(int32_pixel_t));
-
-    if (img->data == NULL)
-    {
-        // Unable to allocate memory for image data
-        free(img);
-
-        ASSERT(1 == 1, "Unable to allocate memory for image data");
+    return 0;
+}
 
-        return NULL;
-    }
+/*!
+ * \brief Creates a new image in the arena
+ *
+ * The image_t is followed by the pixel data in the same block, so both are
+ * returned to the arena at once.
+ *
+ * \param[in] cols      The number of columns for the new image
+ * \param[in] rows      The number of rows for the new image
+ * \param[in] type      The type of pixels in the new image
+ * \param[in] size      The size of a single pixel in bytes. If 0, no memory
+ *                      for the pixel data is allocated.
+ * \param[in] stride    The number of pixels between the starts of two rows
+ * \param[in] alignment Alignment in bytes of the pixel data
+ *
+ * \return A pointer to the new image. NULL if memory allocation failed.
+ */
+static image_t *newImage(const uint32_t cols, const uint32_t rows,
+                         const eImageType type, const size_t size,
+                         const uint32_t stride, const size_t alignment)
+{
+    size_t used = arena.used;
 
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_INT32;
+    arena_block_t *blk = (arena_block_t *)arenaAlloc(ARENA_BLOCK_SIZE + sizeof(image_t),
+                                                     IMAGE_ARENA_ALIGNMENT);
+    uint8_t *data = NULL;
 
-    // Add image to the images array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
+    if ((blk != NULL) && (size != 0))
     {
-        if (imgs[i] == NULL)
+        data = (uint8_t *)arenaAlloc((size_t)rows * stride * size, alignment);
+
+        if (data == NULL)
         {
-            imgs[i] = img;
-            return (img);
+            // Undo the allocation of the image
+            arena.used = used;
+            blk = NULL;
         }
     }
 
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
-
-    ASSERT(1 == 1, "Local imgs array is too small, increase MAX_IMAGES");
-
-    return NULL;
-}
-
-image_t *newFloatImage(const uint32_t cols, const uint32_t rows)
-{
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if (img == NULL)
+    if (blk == NULL)
     {
         // Unable to allocate memory for new image
-        ASSERT(1 == 1, "Unable to allocate memory for new image");
+        ASSERT(1 == 1, "Unable to allocate memory for new image, increase the size of the image arena");
 
         return NULL;
     }
 
-    img->data = (uint8_t *)malloc((rows * cols) * sizeof(float_pixel_t));
-
-    if (img->data == NULL)
-    {
-        // Unable to allocate memory for image data
-        free(img);
-
-        ASSERT(1 == 1, "Unable to allocate memory for image data");
+    blk->prev = arena.top;
+    blk->deleted = 0;
+    arena.top = (uint8_t *)blk - arena.buffer;
 
-        return NULL;
-    }
+    image_t *img = (image_t *)((uint8_t *)blk + ARENA_BLOCK_SIZE);
 
     img->cols = cols;
     img->rows = rows;
-    img->type = IMGTYPE_FLOAT;
-
-    // Add image to the images array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return (img);
-        }
-    }
+    img->type = type;
+    img->stride = stride;
+    img->step = 0;
+    img->data = data;
 
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
-
-    ASSERT(1 == 1, "Local imgs array is too small, increase MAX_IMAGES");
-
-    return NULL;
+    return img;
 }
 
-image_t *newUyvyImage(const uint32_t cols, const uint32_t rows)
+/*!
+ * \brief Deletes an image that was created in the arena
+ *
+ * \param[in] img A pointer to the image
+ */
+static void deleteImage(image_t *img)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if (img == NULL)
-    {
-        // Unable to allocate memory for new image
-        ASSERT(1 == 1, "Unable to allocate memory for new image");
-
-        return NULL;
-    }
+    // Verify image validity
+    ASSERT(img == NULL, "img image is invalid");
+    ASSERT(((uint8_t *)img < arena.buffer) ||
+           ((uint8_t *)img >= (arena.buffer + arena.used)), "img is not allocated in the image arena");
 
-    img->data = (uint8_t *)malloc((rows * cols) * sizeof(uyvy_pixel_t));
+    arena_block_t *blk = (arena_block_t *)((uint8_t *)img - ARENA_BLOCK_SIZE);
+    blk->deleted = 1;
 
-    if (img->data == NULL)
+    // Return the memory of all deleted blocks on top of the stack
+    while (arena.top != IMAGE_ARENA_NONE)
     {
-        // Unable to allocate memory for image data
-        free(img);
-
-        ASSERT(1 == 1, "Unable to allocate memory for image data");
-
-        return NULL;
-    }
-
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_UYVY;
+        blk = (arena_block_t *)(arena.buffer + arena.top);
 
-    // Add image to the images array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] == NULL)
+        if (blk->deleted == 0)
         {
-            imgs[i] = img;
-            return (img);
+            break;
         }
+
+        arena.used = arena.top;
+        arena.top = blk->prev;
     }
+}
 
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
 
-    ASSERT(1 == 1, "Local imgs array is too small, increase MAX_IMAGES");
+/// \name Functions for creating new images
+/// \{
 
-    return NULL;
+/*!
+ * \brief Functions for creating new images
+ *
+ * The image and its pixel data are allocated from the image arena in constant
+ * time. After the image has been used and is not needed any more, make sure
+ * that the image is deleted by calling the function delete<type>Image(),
+ * releaseImageArena() or deleteAllImages().
+ *
+ * \param[in] cols The number of columns for the new image
+ * \param[in] rows The number of rows for the new image
+ *
+ * \return A pointer to the new image. NULL if memory allocation failed.
+ */
+image_t *newUint8Image(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(cols, rows, IMGTYPE_UINT8, sizeof(uint8_pixel_t), cols, IMAGE_ARENA_ALIGNMENT);
 }
 
-image_t *newBgr888Image(const uint32_t cols, const uint32_t rows)
+image_t *newInt16Image(const uint32_t cols, const uint32_t rows)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if (img == NULL)
-    {
-        // Unable to allocate memory for new image
-        ASSERT(1 == 1, "Unable to allocate memory for new image");
+    return newImage(cols, rows, IMGTYPE_INT16, sizeof(int16_pixel_t), cols, IMAGE_ARENA_ALIGNMENT);
+}
 
-        return NULL;
-    }
+image_t *newInt32Image(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(cols, rows, IMGTYPE_INT32, sizeof(int32_pixel_t), cols, IMAGE_ARENA_ALIGNMENT);
+}
 
-    img->data = (uint8_t *)malloc((rows * cols) * sizeof(bgr888_pixel_t));
+image_t *newFloatImage(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(cols, rows, IMGTYPE_FLOAT, sizeof(float_pixel_t), cols, IMAGE_ARENA_ALIGNMENT);
+}
 
-    if (img->data == NULL)
-    {
-        // Unable to allocate memory for image data
-        free(img);
+image_t *newUyvyImage(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(cols, rows, IMGTYPE_UYVY, sizeof(uyvy_pixel_t), cols, IMAGE_ARENA_ALIGNMENT);
+}
 
-        ASSERT(1 == 1, "Unable to allocate memory for image data");
+image_t *newBgr888Image(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(cols, rows, IMGTYPE_BGR888, sizeof(bgr888_pixel_t), cols, IMAGE_ARENA_ALIGNMENT);
+}
 
-        return NULL;
-    }
+image_t *newUint32Image(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(cols, rows, IMGTYPE_UINT32, sizeof(uint32_pixel_t), cols, IMAGE_ARENA_ALIGNMENT);
+}
 
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_BGR888;
+image_t *newBinaryImage(const uint32_t cols, const uint32_t rows)
+{
+    // Every row starts at a new word
+    const uint32_t words = (cols + BINARY_WORD_BITS - 1) / BINARY_WORD_BITS;
 
-    // Add image to the images array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
+    image_t *img = newImage(cols, rows, IMGTYPE_BINARY, sizeof(binary_word_t), words, IMAGE_ARENA_ALIGNMENT);
+
+    if (img != NULL)
     {
-        if (imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return (img);
-        }
+        // The stride is in pixels, and the unused bits must be 0
+        img->stride = words * BINARY_WORD_BITS;
+        memset(img->data, 0, (size_t)rows * words * sizeof(binary_word_t));
     }
 
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
-
-    ASSERT(1 == 1, "Local imgs array is too small, increase MAX_IMAGES");
+    return img;
+}
 
-    return NULL;
+image_t *newComplexImage(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(cols, rows, IMGTYPE_COMPLEX, sizeof(complex_pixel_t), cols, IMAGE_ARENA_ALIGNMENT);
 }
 
 /// \}
@@ -467,7 +589,8 @@ image_t *newBgr888Image(const uint32_t cols, const uint32_t rows)
  * \brief Functions for creating new images without data allocation
  *
  * After the image has been used and is not needed any more, make sure that the
- * image is deleted by calling the function deleteImage().
+ * image is deleted by calling the function delete<type>Image(). The pixel data
+ * is not owned by the image, so it is not freed when the image is deleted.
  *
  * \param[in] cols The number of columns for the new image
  * \param[in] rows The number of rows for the new image
@@ -476,212 +599,217 @@ image_t *newBgr888Image(const uint32_t cols, const uint32_t rows)
  */
 image_t *newEmptyUint8Image(const uint32_t cols, const uint32_t rows)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if (img == NULL)
-    {
-        // Unable to allocate memory for new image
-        ASSERT(1 == 1, "Unable to allocate memory for new image");
-
-        return NULL;
-    }
-
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_UINT8;
-    img->data = NULL;
-
-    // Add image to the images array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return (img);
-        }
-    }
-
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
-
-    ASSERT(1 == 1, "Local imgs array is too small, increase MAX_IMAGES");
-
-    return NULL;
+    return newImage(cols, rows, IMGTYPE_UINT8, 0, cols, IMAGE_ARENA_ALIGNMENT);
 }
 
 image_t *newEmptyInt16Image(const uint32_t cols, const uint32_t rows)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if (img == NULL)
-    {
-        // Unable to allocate memory for new image
-        ASSERT(1 == 1, "Unable to allocate memory for new image");
-
-        return NULL;
-    }
-
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_INT16;
-    img->data = NULL;
-
-    // Add image to the images array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return (img);
-        }
-    }
-
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
-
-    ASSERT(1 == 1, "Local imgs array is too small, increase MAX_IMAGES");
-
-    return NULL;
+    return newImage(cols, rows, IMGTYPE_INT16, 0, cols, IMAGE_ARENA_ALIGNMENT);
 }
 
 image_t *newEmptyInt32Image(const uint32_t cols, const uint32_t rows)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if (img == NULL)
-    {
-        // Unable to allocate memory for new image
-        ASSERT(1 == 1, "Unable to allocate memory for new image");
-
-        return NULL;
-    }
-
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_INT32;
-    img->data = NULL;
-
-    // Add image to the images array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return (img);
-        }
-    }
-
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
-
-    ASSERT(1 == 1, "Local imgs array is too small, increase MAX_IMAGES");
-
-    return NULL;
+    return newImage(cols, rows, IMGTYPE_INT32, 0, cols, IMAGE_ARENA_ALIGNMENT);
 }
 
 image_t *newEmptyFloatImage(const uint32_t cols, const uint32_t rows)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if (img == NULL)
-    {
-        // Unable to allocate memory for new image
-        ASSERT(1 == 1, "Unable to allocate memory for new image");
+    return newImage(cols, rows, IMGTYPE_FLOAT, 0, cols, IMAGE_ARENA_ALIGNMENT);
+}
 
-        return NULL;
-    }
+image_t *newEmptyUyvyImage(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(cols, rows, IMGTYPE_UYVY, 0, cols, IMAGE_ARENA_ALIGNMENT);
+}
 
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_FLOAT;
-    img->data = NULL;
+image_t *newEmptyBgr888Image(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(cols, rows, IMGTYPE_BGR888, 0, cols, IMAGE_ARENA_ALIGNMENT);
+}
 
-    // Add image to the images array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return (img);
-        }
-    }
+image_t *newEmptyUint32Image(const uint32_t cols, const uint32_t rows)
+{
+    return newImage(cols, rows, IMGTYPE_UINT32, 0, cols, IMAGE_ARENA_ALIGNMENT);
+}
 
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
+/// \}
 
-    ASSERT(1 == 1, "Local imgs array is too small, increase MAX_IMAGES");
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
 
-    return NULL;
-}
+/// \name Functions for creating new aligned images
+/// \{
 
-image_t *newEmptyUyvyImage(const uint32_t cols, const uint32_t rows)
+/*!
+ * \brief Creates a new image with aligned and padded rows
+ *
+ * The start of the pixel data and the start of every row are aligned to
+ * \p alignment bytes. To achieve this, each row is padded with unused pixels,
+ * so the stride of the image is larger than the number of columns. The
+ * padding belongs to the image, which allows vectorized kernels to process
+ * full vectors per row and to read beyond the last column without checks.
+ * Operators that respect the stride can be used on these images as usual.
+ *
+ * Typical values for \p alignment are 16 (SSE, Helium), 32 (AVX2) and 64
+ * (cache line, AVX-512).
+ *
+ * After the image has been used and is not needed any more, make sure that the
+ * image is deleted by calling the function delete<type>Image(),
+ * releaseImageArena() or deleteAllImages().
+ *
+ * \param[in] cols      The number of columns for the new image
+ * \param[in] rows      The number of rows for the new image
+ * \param[in] type      The type of pixels in the new image
+ * \param[in] alignment Alignment in bytes, must be a power of two
+ *
+ * \return A pointer to the new image. NULL if memory allocation failed.
+ */
+image_t *newAlignedImage(const uint32_t cols, const uint32_t rows,
+                         const eImageType type, const uint32_t alignment)
 {
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if (img == NULL)
-    {
-        // Unable to allocate memory for new image
-        ASSERT(1 == 1, "Unable to allocate memory for new image");
+    // Verify alignment validity
+    ASSERT(alignment == 0, "alignment can not be equal to 0");
+    ASSERT((alignment & (alignment - 1)) != 0, "alignment must be a power of two");
 
-        return NULL;
-    }
+    size_t size = pixelSize(type);
 
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_UYVY;
-    img->data = NULL;
+    ASSERT(size == 0, "type is invalid");
 
-    // Add image to the images array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
+    // The rows are aligned if the stride in bytes is a multiple of the
+    // alignment. Only the power of two factor of the pixel size helps with
+    // that, e.g. for bgr888_pixel_t the stride must be a multiple of the
+    // alignment itself.
+    uint32_t factor = 1;
+
+    while (((size % (factor * 2)) == 0) && ((factor * 2) <= alignment))
     {
-        if (imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return (img);
-        }
+        factor *= 2;
     }
 
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
-
-    ASSERT(1 == 1, "Local imgs array is too small, increase MAX_IMAGES");
+    uint32_t step = alignment / factor;
+    uint32_t stride = ((cols + step - 1) / step) * step;
 
-    return NULL;
+    return newImage(cols, rows, type, size, stride,
+                    (alignment > IMAGE_ARENA_ALIGNMENT) ? alignment : IMAGE_ARENA_ALIGNMENT);
 }
 
-image_t *newEmptyBgr888Image(const uint32_t cols, const uint32_t rows)
-{
-    image_t *img = (image_t *)malloc(sizeof(image_t));
-    if (img == NULL)
-    {
-        // Unable to allocate memory for new image
-        ASSERT(1 == 1, "Unable to allocate memory for new image");
+/// \}
 
-        return NULL;
-    }
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
 
-    img->cols = cols;
-    img->rows = rows;
-    img->type = IMGTYPE_BGR888;
-    img->data = NULL;
+/// \name Functions for creating image views
+/// \{
 
-    // Add image to the images array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] == NULL)
-        {
-            imgs[i] = img;
-            return (img);
-        }
-    }
+/*!
+ * \brief Creates a view on a rectangular region of interest (ROI) in an image
+ *
+ * The view shares the pixel data with the source image, so no pixels are
+ * copied. Operators that are applied to the view, only read and write the
+ * pixels inside the ROI. The view takes over the row stride of the source
+ * image, so a view of a view is also supported.
+ *
+ * The view is not allocated by this function and is not added to the images
+ * that are deleted by deleteAllImages(). Typically, the view is a local
+ * variable:
+ *
+ * \code
+ * image_t roi;
+ * roiImage(src, &roi, 40, 30, 80, 60);
+ * threshold(&roi, &roi, 0, 64);
+ * \endcode
+ *
+ * The view is valid as long as the pixel data of the source image is valid.
+ * For uyvy_pixel_t images the \p x coordinate and the number of columns must
+ * be even, so that the chroma values of a pixel pair remain in the view.
+ *
+ * \param[in]  src  A pointer to the source image
+ * \param[out] roi  A pointer to the image that will describe the view
+ * \param[in]  x    Column (x) coordinate of the top-left pixel of the ROI
+ * \param[in]  y    Row (y) coordinate of the top-left pixel of the ROI
+ * \param[in]  cols The number of columns of the ROI
+ * \param[in]  rows The number of rows of the ROI
+ */
+void roiImage(const image_t *src, image_t *roi, const int32_t x,
+              const int32_t y, const int32_t cols, const int32_t rows)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(roi == NULL, "roi image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
 
-    // Should never get here, because it means the imgs array is too small
-    free(img->data);
-    free(img);
+    // Verify image consistency
+    ASSERT(x < 0, "x-value is out of range");
+    ASSERT(y < 0, "y-value is out of range");
+    ASSERT(cols <= 0, "cols is out of range");
+    ASSERT(rows <= 0, "rows is out of range");
+    ASSERT((x + cols) > src->cols, "roi exceeds the number of columns");
+    ASSERT((y + rows) > src->rows, "roi exceeds the number of rows");
+    ASSERT((src->type == IMGTYPE_UYVY) && ((x % 2) != 0), "x-value must be even for uyvy images");
+    ASSERT((src->type == IMGTYPE_UYVY) && ((cols % 2) != 0), "cols must be even for uyvy images");
+
+    size_t size = pixelSize(src->type);
+
+    ASSERT(size == 0, "src type is invalid");
+
+    int32_t stride = IMAGE_STRIDE(src);
+    int32_t step = IMAGE_STEP(src);
+
+    roi->cols = cols;
+    roi->rows = rows;
+    roi->type = src->type;
+    roi->stride = stride;
+    roi->step = src->step;
+    roi->data = src->data + (((y * stride) + (x * step)) * size);
+}
 
-    ASSERT(1 == 1, "Local imgs array is too small, increase MAX_IMAGES");
+/*!
+ * \brief Creates a ::IMGTYPE_UINT8 view on the Y channel of an uyvy_pixel_t
+ *        image
+ *
+ * The view shares the pixel data with the source image, so no pixels are
+ * copied. Each pixel in the view is the Y byte of the corresponding
+ * uyvy_pixel_t pixel. The view has a row stride of twice the stride of the
+ * source image and a pixel step of 2, see ::IMAGE_STEP. This assumes a little
+ * endian processor, where the Y byte is the second byte of an uyvy_pixel_t.
+ *
+ * Like roiImage(), the view is not allocated by this function and is valid as
+ * long as the pixel data of the source image is valid. A roiImage() of a luma
+ * view is again a luma view.
+ *
+ * Only the following operators support a luma view as source image:
+ * getUint8PixelStrided(), setUint8PixelStrided(), copyUint8Image(), histogram(),
+ * histogramStats() and the threshold functions that are based on them,
+ * threshold(), labelIterative(), labelTwoPass(), pyrDown(), gaussianPyramid(),
+ * frequencyFilter(), runningMinMax() and the filters that are based on it,
+ * integralImage(), squaredIntegralImage(), convertUint8ToBinary(), convolve()
+ * and correlate(). convolve() and correlate() filter a copy of the view in the
+ * image arena. All other operators require images with a pixel step of 1 and
+ * assert this.
+ *
+ * \code
+ * image_t luma;
+ * lumaView(uyvy, &luma);
+ * threshold(&luma, dst, 0, 64);
+ * \endcode
+ *
+ * \param[in]  src  A pointer to the uyvy_pixel_t source image
+ * \param[out] luma A pointer to the image that will describe the view
+ */
+void lumaView(const image_t *src, image_t *luma)
+{
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(luma == NULL, "luma image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(src->type != IMGTYPE_UYVY, "src type is invalid");
 
-    return NULL;
+    luma->cols = src->cols;
+    luma->rows = src->rows;
+    luma->type = IMGTYPE_UINT8;
+    luma->stride = IMAGE_STRIDE(src) * sizeof(uyvy_pixel_t);
+    luma->step = sizeof(uyvy_pixel_t);
+    luma->data = src->data + 1;
 }
 
 /// \}
@@ -692,108 +820,69 @@ image_t *newEmptyBgr888Image(const uint32_t cols, const uint32_t rows)
 /// \name Functions for deleting images
 /// \{
 
+/*!
+ * \brief Functions for deleting images
+ *
+ * Deleting the most recently created image returns its memory to the arena
+ * immediately. Other images are returned as soon as all images that were
+ * created after them are deleted as well.
+ *
+ * \param[in] img A pointer to the image
+ */
 void deleteUint8Image(image_t *img)
 {
-    // Remove image from the array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] == img)
-        {
-            imgs[i] = NULL;
-        }
-    }
-
-    free(img->data);
-    free(img);
+    deleteImage(img);
 }
 
 void deleteInt16Image(image_t *img)
 {
-    // Remove image from the array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] == img)
-        {
-            imgs[i] = NULL;
-        }
-    }
-
-    free(img->data);
-    free(img);
+    deleteImage(img);
 }
 
 void deleteInt32Image(image_t *img)
 {
-    // Remove image from the array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] == img)
-        {
-            imgs[i] = NULL;
-        }
-    }
-
-    free(img->data);
-    free(img);
+    deleteImage(img);
 }
 
 void deleteFloatImage(image_t *img)
 {
-    // Remove image from the array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] == img)
-        {
-            imgs[i] = NULL;
-        }
-    }
-
-    free(img->data);
-    free(img);
+    deleteImage(img);
 }
 
 void deleteUyvyImage(image_t *img)
 {
-    // Remove image from the array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] == img)
-        {
-            imgs[i] = NULL;
-        }
-    }
-
-    free(img->data);
-    free(img);
+    deleteImage(img);
 }
 
 void deleteBgr888Image(image_t *img)
 {
-    // Remove image from the array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] == img)
-        {
-            imgs[i] = NULL;
-        }
-    }
+    deleteImage(img);
+}
+
+void deleteUint32Image(image_t *img)
+{
+    deleteImage(img);
+}
+
+void deleteBinaryImage(image_t *img)
+{
+    deleteImage(img);
+}
 
-    free(img->data);
-    free(img);
+void deleteComplexImage(image_t *img)
+{
+    deleteImage(img);
 }
 
+/*!
+ * \brief Deletes all images and temporary buffers in the arena
+ *
+ * The capacity of the arena is kept, so new images can be created afterwards.
+ */
 void deleteAllImages(void)
 {
-    // Remove image from the array
-    for (uint32_t i = 0; i < MAX_IMAGES; i++)
-    {
-        if (imgs[i] != NULL)
-        {
-            free(imgs[i]->data);
-            free(imgs[i]);
-            imgs[i] = NULL;
-        }
-    }
+    arena.used = 0;
+    arena.top = IMAGE_ARENA_NONE;
 }
 
 /// \}
@@ -817,6 +906,8 @@ void deleteAllImages(void)
 
 void copyUint8Image(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -830,12 +921,36 @@ void copyUint8Image(const image_t *src, image_t *dst)
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
     ASSERT(src == dst, "src and dst are the same images");
 
-    // Copy data
-    memcpy(dst->data, src->data, src->cols * src->rows * sizeof(uint8_pixel_t));
+    // The source image can be a luma view
+    if ((IMAGE_STEP(src) != 1) || (IMAGE_STEP(dst) != 1))
+    {
+        for (int32_t y = 0; y < src->rows; y++)
+        {
+            for (int32_t x = 0; x < src->cols; x++)
+            {
+                setUint8PixelStrided(dst, x, y, getUint8PixelStrided(src, x, y));
+            }
+        }
+
+        TRACE_EXIT();
+        return;
+    }
+
+    // Copy data row by row, because both images can be views
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        memcpy((uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst)),
+               (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src)),
+               src->cols * sizeof(uint8_pixel_t));
+    }
+
+    TRACE_EXIT();
 }
 
 void copyInt16Image(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -849,12 +964,21 @@ void copyInt16Image(const image_t *src, image_t *dst)
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
     ASSERT(src == dst, "src and dst are the same images");
 
-    // Copy data
-    memcpy(dst->data, src->data, src->cols * src->rows * sizeof(int16_pixel_t));
+    // Copy data row by row, because both images can be views
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        memcpy((int16_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst)),
+               (int16_pixel_t *)src->data + (y * IMAGE_STRIDE(src)),
+               src->cols * sizeof(int16_pixel_t));
+    }
+
+    TRACE_EXIT();
 }
 
 void copyInt32Image(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -868,12 +992,21 @@ void copyInt32Image(const image_t *src, image_t *dst)
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
     ASSERT(src == dst, "src and dst are the same images");
 
-    // Copy data
-    memcpy(dst->data, src->data, src->cols * src->rows * sizeof(int32_pixel_t));
+    // Copy data row by row, because both images can be views
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        memcpy((int32_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst)),
+               (int32_pixel_t *)src->data + (y * IMAGE_STRIDE(src)),
+               src->cols * sizeof(int32_pixel_t));
+    }
+
+    TRACE_EXIT();
 }
 
 void copyFloatImage(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -887,12 +1020,21 @@ void copyFloatImage(const image_t *src, image_t *dst)
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
     ASSERT(src == dst, "src and dst are the same images");
 
-    // Copy data
-    memcpy(dst->data, src->data, src->cols * src->rows * sizeof(float_pixel_t));
+    // Copy data row by row, because both images can be views
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        memcpy((float_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst)),
+               (float_pixel_t *)src->data + (y * IMAGE_STRIDE(src)),
+               src->cols * sizeof(float_pixel_t));
+    }
+
+    TRACE_EXIT();
 }
 
 void copyUyvyImage(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -906,12 +1048,21 @@ void copyUyvyImage(const image_t *src, image_t *dst)
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
     ASSERT(src == dst, "src and dst are the same images");
 
-    // Copy data
-    memcpy(dst->data, src->data, src->cols * src->rows * sizeof(uyvy_pixel_t));
+    // Copy data row by row, because both images can be views
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        memcpy((uyvy_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst)),
+               (uyvy_pixel_t *)src->data + (y * IMAGE_STRIDE(src)),
+               src->cols * sizeof(uyvy_pixel_t));
+    }
+
+    TRACE_EXIT();
 }
 
 void copyBgr888Image(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -925,8 +1076,73 @@ void copyBgr888Image(const image_t *src, image_t *dst)
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
     ASSERT(src == dst, "src and dst are the same images");
 
-    // Copy data
-    memcpy(dst->data, src->data, src->cols * src->rows * sizeof(bgr888_pixel_t));
+    // Copy data row by row, because both images can be views
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        memcpy((bgr888_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst)),
+               (bgr888_pixel_t *)src->data + (y * IMAGE_STRIDE(src)),
+               src->cols * sizeof(bgr888_pixel_t));
+    }
+
+    TRACE_EXIT();
+}
+
+void copyUint32Image(const image_t *src, image_t *dst)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT32, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_UINT32, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+    ASSERT(src == dst, "src and dst are the same images");
+
+    // Copy data row by row, because both images can be views
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        memcpy((uint32_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst)),
+               (uint32_pixel_t *)src->data + (y * IMAGE_STRIDE(src)),
+               src->cols * sizeof(uint32_pixel_t));
+    }
+
+    TRACE_EXIT();
+}
+
+void copyBinaryImage(const image_t *src, image_t *dst)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_BINARY, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_BINARY, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+    ASSERT(src == dst, "src and dst are the same images");
+
+    const int32_t words = (src->cols + BINARY_WORD_BITS - 1) / BINARY_WORD_BITS;
+
+    // Copy data row by row, the strides can differ
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        memcpy((binary_word_t *)dst->data + (y * (IMAGE_STRIDE(dst) / BINARY_WORD_BITS)),
+               (binary_word_t *)src->data + (y * (IMAGE_STRIDE(src) / BINARY_WORD_BITS)),
+               words * sizeof(binary_word_t));
+    }
+
+    TRACE_EXIT();
 }
 
 /// \}
@@ -947,70 +1163,143 @@ void copyBgr888Image(const image_t *src, image_t *dst)
 
 void clearUint8Image(image_t *img)
 {
+    TRACE_ENTER(img, NULL);
+
     // Verify image validity
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_UINT8, "img type is invalid");
+    ASSERT(IMAGE_STEP(img) != 1, "img image can not be a luma view");
 
-    register long int i = img->rows * img->cols;
-    register uint8_pixel_t *d = (uint8_pixel_t *)img->data;
-
-    // Loop all pixels and clear
-    while (i-- > 0)
+    // Loop all rows
+    for (int32_t y = 0; y < img->rows; y++)
     {
-        *d++ = (uint8_pixel_t)0;
+        register long int i = img->cols;
+        register uint8_pixel_t *d = (uint8_pixel_t *)img->data + (y * IMAGE_STRIDE(img));
+
+        // Loop all pixels in the row and clear
+        while (i-- > 0)
+        {
+            *d++ = (uint8_pixel_t)0;
+        }
     }
+
+    TRACE_EXIT();
 }
 
 void clearInt16Image(image_t *img)
 {
+    TRACE_ENTER(img, NULL);
+
     // Verify image validity
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_INT16, "img type is invalid");
 
-    register long int i = img->rows * img->cols;
-    register int16_pixel_t *d = (int16_pixel_t *)img->data;
-
-    // Loop all pixels and clear
-    while (i-- > 0)
+    // Loop all rows
+    for (int32_t y = 0; y < img->rows; y++)
     {
-        *d++ = (int16_pixel_t)0;
+        register long int i = img->cols;
+        register int16_pixel_t *d = (int16_pixel_t *)img->data + (y * IMAGE_STRIDE(img));
+
+        // Loop all pixels in the row and clear
+        while (i-- > 0)
+        {
+            *d++ = (int16_pixel_t)0;
+        }
     }
+
+    TRACE_EXIT();
 }
 
 void clearInt32Image(image_t *img)
 {
+    TRACE_ENTER(img, NULL);
+
     // Verify image validity
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_INT32, "img type is invalid");
 
-    register long int i = img->rows * img->cols;
-    register int32_pixel_t *d = (int32_pixel_t *)img->data;
-
-    // Loop all pixels and clear
-    while (i-- > 0)
+    // Loop all rows
+    for (int32_t y = 0; y < img->rows; y++)
     {
-        *d++ = (int32_pixel_t)0;
-    }
-}
+        register long int i = img->cols;
+        register int32_pixel_t *d = (int32_pixel_t *)img->data + (y * IMAGE_STRIDE(img));
 
-void clearFloatImage(image_t *img)
+        // Loop all pixels in the row and clear
+        while (i-- > 0)
+        {
+            *d++ = (int32_pixel_t)0;
+        }
+    }
+
+    TRACE_EXIT();
+}
+
+void clearFloatImage(image_t *img)
 {
+    TRACE_ENTER(img, NULL);
+
     // Verify image validity
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_FLOAT, "img type is invalid");
 
-    register long int i = img->rows * img->cols;
-    register float_pixel_t *d = (float_pixel_t *)img->data;
+    // Loop all rows
+    for (int32_t y = 0; y < img->rows; y++)
+    {
+        register long int i = img->cols;
+        register float_pixel_t *d = (float_pixel_t *)img->data + (y * IMAGE_STRIDE(img));
+
+        // Loop all pixels in the row and clear
+        while (i-- > 0)
+        {
+            *d++ = (float_pixel_t)0.0f;
+        }
+    }
+
+    TRACE_EXIT();
+}
+
+void clearUint32Image(image_t *img)
+{
+    TRACE_ENTER(img, NULL);
+
+    // Verify image validity
+    ASSERT(img == NULL, "img image is invalid");
+    ASSERT(img->data == NULL, "img data is invalid");
+    ASSERT(img->type != IMGTYPE_UINT32, "img type is invalid");
 
-    // Loop all pixels and clear
-    while (i-- > 0)
+    // Loop all rows
+    for (int32_t y = 0; y < img->rows; y++)
     {
-        *d++ = (float_pixel_t)0.0f;
+        register long int i = img->cols;
+        register uint32_pixel_t *d = (uint32_pixel_t *)img->data + (y * IMAGE_STRIDE(img));
+
+        // Loop all pixels in the row and clear
+        while (i-- > 0)
+        {
+            *d++ = (uint32_pixel_t)0;
+        }
     }
+
+    TRACE_EXIT();
+}
+
+void clearBinaryImage(image_t *img)
+{
+    TRACE_ENTER(img, NULL);
+
+    // Verify image validity
+    ASSERT(img == NULL, "img image is invalid");
+    ASSERT(img->data == NULL, "img data is invalid");
+    ASSERT(img->type != IMGTYPE_BINARY, "img type is invalid");
+
+    // Clear all words, including the unused bits
+    memset(img->data, 0, (size_t)img->rows * (IMAGE_STRIDE(img) / BINARY_WORD_BITS) * sizeof(binary_word_t));
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -1024,6 +1313,11 @@ void clearFloatImage(image_t *img)
  */
 void convertUyvyToUint8(image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+
     // Each value in src image contains either an U or V value.
     // Each value in src image container always a Y value.
     // Remove from each value the U or V value.
@@ -1037,22 +1331,25 @@ void convertUyvyToUint8(image_t *src, image_t *dst)
     // 0000 0000 1100 0100 -> shifting (>> 8)
     // 1100 0100           -> casten naar uint_8
 
-    uint16_t *src_uyvy = (uint16_t *)src->data;
-
     // Compiler kan beter omgaan met 32 bits ondanks dat we niet zo'n groot getal nodig hebben
-    uint32_t total_pixels = src->cols * src->rows;
-
-    uint8_t *dst_y_only = (uint8_t *)dst->data;
+    uint32_t cols = src->cols;
 
-    for (int i = 0; i < total_pixels; ++i)
+    for (int32_t y = 0; y < src->rows; ++y)
     {
-        uint16_t uyvy_element = src_uyvy[i];
+        uint16_t *src_uyvy = (uint16_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_t *dst_y_only = (uint8_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        for (uint32_t i = 0; i < cols; ++i)
+        {
+            uint16_t uyvy_element = src_uyvy[i];
 
-        uint8_t y_value = (uint8_t)(uyvy_element >> 8);
+            uint8_t y_value = (uint8_t)(uyvy_element >> 8);
 
-        dst_y_only[i] = y_value;
+            dst_y_only[i] = y_value;
+        }
     }
 
+    TRACE_EXIT();
     return;
 }
 
@@ -1068,20 +1365,30 @@ void convertUyvyToUint8(image_t *src, image_t *dst)
  */
 void convertUint8ToUyvy(image_t *src, image_t *dst)
 {
-    uint32_t i = src->rows * src->cols;
-    uint8_pixel_t *uint8_pixel = (uint8_pixel_t *)src->data;
-    uyvy_pixel_t *uyvy_pixel = (uyvy_pixel_t *)dst->data;
+    TRACE_ENTER(src, dst);
+
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
 
-    // Loop all pixels and convert
-    while (i-- > 0)
+    for (int32_t y = 0; y < src->rows; y++)
     {
-        *uyvy_pixel = ((uyvy_pixel_t)(*uint8_pixel)) << 8;
-        *uyvy_pixel |= 0x0080;
+        uint32_t i = src->cols;
+        uint8_pixel_t *uint8_pixel = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uyvy_pixel_t *uyvy_pixel = (uyvy_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Loop all pixels in the row and convert
+        while (i-- > 0)
+        {
+            *uyvy_pixel = ((uyvy_pixel_t)(*uint8_pixel)) << 8;
+            *uyvy_pixel |= 0x0080;
 
-        // Next pixel
-        uyvy_pixel++;
-        uint8_pixel++;
+            // Next pixel
+            uyvy_pixel++;
+            uint8_pixel++;
+        }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -1095,19 +1402,26 @@ void convertUint8ToUyvy(image_t *src, image_t *dst)
  */
 void convertUyvyToInt16(image_t *src, image_t *dst)
 {
-    uint32_t i = src->rows * src->cols;
-    uyvy_pixel_t *uyvy_pixel = (uyvy_pixel_t *)src->data;
-    int16_pixel_t *int16_pixel = (int16_pixel_t *)dst->data;
+    TRACE_ENTER(src, dst);
 
-    // Loop all pixels and convert
-    while (i-- > 0)
+    for (int32_t y = 0; y < src->rows; y++)
     {
-        *int16_pixel = (int16_pixel_t)((*uyvy_pixel) >> 8);
+        uint32_t i = src->cols;
+        uyvy_pixel_t *uyvy_pixel = (uyvy_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        int16_pixel_t *int16_pixel = (int16_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Loop all pixels in the row and convert
+        while (i-- > 0)
+        {
+            *int16_pixel = (int16_pixel_t)((*uyvy_pixel) >> 8);
 
-        // Next pixel
-        uyvy_pixel++;
-        int16_pixel++;
+            // Next pixel
+            uyvy_pixel++;
+            int16_pixel++;
+        }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -1127,109 +1441,447 @@ void convertUyvyToInt16(image_t *src, image_t *dst)
  */
 void convertUyvyToBgr888(image_t *src, image_t *dst)
 {
-    uint32_t i = src->rows * src->cols;
-    uyvy_pixel_t *uyvy_pixel = (uyvy_pixel_t *)src->data;
-    bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)dst->data;
+    TRACE_ENTER(src, dst);
 
-    while (i > 0)
+    for (int32_t y = 0; y < src->rows; y++)
     {
-        // Decrement by 2, because the chroma values are stored in two pixels
-        i -= 2;
+        uint32_t i = src->cols;
+        uyvy_pixel_t *uyvy_pixel = (uyvy_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        while (i > 0)
+        {
+            // Decrement by 2, because the chroma values are stored in two pixels
+            i -= 2;
 
-        uyvy_pixel_t uy = *uyvy_pixel++;
-        uyvy_pixel_t vy = *uyvy_pixel++;
+            uyvy_pixel_t uy = *uyvy_pixel++;
+            uyvy_pixel_t vy = *uyvy_pixel++;
 
-        int32_t u = (uy & 0xFFU) - 128;
-        int32_t y1 = uy >> 8;
-        int32_t v = (vy & 0xFFU) - 128;
-        int32_t y2 = vy >> 8;
+            int32_t u = (uy & 0xFFU) - 128;
+            int32_t y1 = uy >> 8;
+            int32_t v = (vy & 0xFFU) - 128;
+            int32_t y2 = vy >> 8;
 
-        bgr888_pixel->r = clip(y1 + (1.140f * v));
-        bgr888_pixel->g = clip(y1 - (0.394f * v) - (0.581f * u));
-        bgr888_pixel->b = clip(y1 + (2.032f * u));
-        bgr888_pixel++;
+            bgr888_pixel->r = clip(y1 + (1.140f * v));
+            bgr888_pixel->g = clip(y1 - (0.394f * v) - (0.581f * u));
+            bgr888_pixel->b = clip(y1 + (2.032f * u));
+            bgr888_pixel++;
 
-        bgr888_pixel->r = clip(y2 + (1.140f * v));
-        bgr888_pixel->g = clip(y2 - (0.394f * v) - (0.581f * u));
-        bgr888_pixel->b = clip(y2 + (2.032f * u));
-        bgr888_pixel++;
+            bgr888_pixel->r = clip(y2 + (1.140f * v));
+            bgr888_pixel->g = clip(y2 - (0.394f * v) - (0.581f * u));
+            bgr888_pixel->b = clip(y2 + (2.032f * u));
+            bgr888_pixel++;
 
-        // Test with alternative coefficients
+            // Test with alternative coefficients
 
 #if 0
 
-        bgr888_pixel->r = clip(y1 + (1.370705f * (v)));
-        bgr888_pixel->g = clip(y1 - (0.698001f * (v)) - (0.337633f * (u)));
-        bgr888_pixel->b = clip(y1 + (1.732446f * (u)));
-        bgr888_pixel++;
+            bgr888_pixel->r = clip(y1 + (1.370705f * (v)));
+            bgr888_pixel->g = clip(y1 - (0.698001f * (v)) - (0.337633f * (u)));
+            bgr888_pixel->b = clip(y1 + (1.732446f * (u)));
+            bgr888_pixel++;
 
-        bgr888_pixel->r = clip(y2 + (1.370705f * (v)));
-        bgr888_pixel->g = clip(y2 - (0.698001f * (v)) - (0.337633f * (u)));
-        bgr888_pixel->b = clip(y2 + (1.732446f * (u)));
-        bgr888_pixel++;
+            bgr888_pixel->r = clip(y2 + (1.370705f * (v)));
+            bgr888_pixel->g = clip(y2 - (0.698001f * (v)) - (0.337633f * (u)));
+            bgr888_pixel->b = clip(y2 + (1.732446f * (u)));
+            bgr888_pixel++;
 
 #endif
 
-        // Several alternative calculation methods
-        // \see https://learn.microsoft.com/en-us/windows/win32/medfound/recommended-8-bit-yuv-formats-for-video-rendering
+            // Several alternative calculation methods
+            // \see https://learn.microsoft.com/en-us/windows/win32/medfound/recommended-8-bit-yuv-formats-for-video-rendering
 
 #if 0
-        int32_t C = y1;
-        int32_t D = u - 128;
-        int32_t E = u - 128;
-
-        // Calculations using doubles
-        bgr888_pixel->r = clip( ( 1.164383 * C                   + 1.596027 * E  ) );
-        bgr888_pixel->g = clip( ( 1.164383 * C - (0.391762 * D) - (0.812968 * E) ) );
-        bgr888_pixel->b = clip( ( 1.164383 * C +  2.017232 * D                   ) );
-        bgr888_pixel++;
-
-        C = y2;
-
-        bgr888_pixel->r = clip( ( 1.164383 * C                   + 1.596027 * E  ) );
-        bgr888_pixel->g = clip( ( 1.164383 * C - (0.391762 * D) - (0.812968 * E) ) );
-        bgr888_pixel->b = clip( ( 1.164383 * C +  2.017232 * D                   ) );
-        bgr888_pixel++;
+            int32_t C = y1;
+            int32_t D = u - 128;
+            int32_t E = u - 128;
+
+            // Calculations using doubles
+            bgr888_pixel->r = clip( ( 1.164383 * C                   + 1.596027 * E  ) );
+            bgr888_pixel->g = clip( ( 1.164383 * C - (0.391762 * D) - (0.812968 * E) ) );
+            bgr888_pixel->b = clip( ( 1.164383 * C +  2.017232 * D                   ) );
+            bgr888_pixel++;
+
+            C = y2;
+
+            bgr888_pixel->r = clip( ( 1.164383 * C                   + 1.596027 * E  ) );
+            bgr888_pixel->g = clip( ( 1.164383 * C - (0.391762 * D) - (0.812968 * E) ) );
+            bgr888_pixel->b = clip( ( 1.164383 * C +  2.017232 * D                   ) );
+            bgr888_pixel++;
 #endif
 
 #if 0
-        int32_t C = y1;
-        int32_t D = u - 128;
-        int32_t E = u - 128;
-
-        // Calculations using floats
-        bgr888_pixel->r = clip( ( 1.164383f * C                   +  1.596027f * E  ) );
-        bgr888_pixel->g = clip( ( 1.164383f * C - (0.391762f * D) - (0.812968f * E) ) );
-        bgr888_pixel->b = clip( ( 1.164383f * C +  2.017232f * D                    ) );
-        bgr888_pixel++;
-
-        C = y2;
-
-        bgr888_pixel->r = clip( ( 1.164383f * C                   +  1.596027f * E  ) );
-        bgr888_pixel->g = clip( ( 1.164383f * C - (0.391762f * D) - (0.812968f * E) ) );
-        bgr888_pixel->b = clip( ( 1.164383f * C +  2.017232f * D                    ) );
-        bgr888_pixel++;
+            int32_t C = y1;
+            int32_t D = u - 128;
+            int32_t E = u - 128;
+
+            // Calculations using floats
+            bgr888_pixel->r = clip( ( 1.164383f * C                   +  1.596027f * E  ) );
+            bgr888_pixel->g = clip( ( 1.164383f * C - (0.391762f * D) - (0.812968f * E) ) );
+            bgr888_pixel->b = clip( ( 1.164383f * C +  2.017232f * D                    ) );
+            bgr888_pixel++;
+
+            C = y2;
+
+            bgr888_pixel->r = clip( ( 1.164383f * C                   +  1.596027f * E  ) );
+            bgr888_pixel->g = clip( ( 1.164383f * C - (0.391762f * D) - (0.812968f * E) ) );
+            bgr888_pixel->b = clip( ( 1.164383f * C +  2.017232f * D                    ) );
+            bgr888_pixel++;
 #endif
 
 #if 0
-        int32_t C = y1;
-        int32_t D = u - 128;
-        int32_t E = u - 128;
-
-        // Calculations using integers
-        bgr888_pixel->r = clip(( 298 * C           + 409 * E + 128) >> 8);
-        bgr888_pixel->g = clip(( 298 * C - 100 * D - 208 * E + 128) >> 8);
-        bgr888_pixel->b = clip(( 298 * C + 516 * D           + 128) >> 8);
-        bgr888_pixel++;
-
-        C = y2;
-
-        bgr888_pixel->r = clip(( 298 * C           + 409 * E + 128) >> 8);
-        bgr888_pixel->g = clip(( 298 * C - 100 * D - 208 * E + 128) >> 8);
-        bgr888_pixel->b = clip(( 298 * C + 516 * D           + 128) >> 8);
-        bgr888_pixel++;
+            int32_t C = y1;
+            int32_t D = u - 128;
+            int32_t E = u - 128;
+
+            // Calculations using integers
+            bgr888_pixel->r = clip(( 298 * C           + 409 * E + 128) >> 8);
+            bgr888_pixel->g = clip(( 298 * C - 100 * D - 208 * E + 128) >> 8);
+            bgr888_pixel->b = clip(( 298 * C + 516 * D           + 128) >> 8);
+            bgr888_pixel++;
+
+            C = y2;
+
+            bgr888_pixel->r = clip(( 298 * C           + 409 * E + 128) >> 8);
+            bgr888_pixel->g = clip(( 298 * C - 100 * D - 208 * E + 128) >> 8);
+            bgr888_pixel->b = clip(( 298 * C + 516 * D           + 128) >> 8);
+            bgr888_pixel++;
+#endif
+        }
+    }
+
+    TRACE_EXIT();
+}
+
+/// Number of fraction bits of the fixed-point YUV to RGB coefficients
+#define YUV_SHIFT (13)
+
+/// Rounding offset plus an offset of 256 that keeps all sums positive
+#define YUV_BIAS ((1 << (YUV_SHIFT - 1)) + (256 << YUV_SHIFT))
+
+/// Fixed-point YUV to RGB coefficients, see convertUyvyToBgr888Fast()
+typedef struct
+{
+    int16_t y;        ///< Luma gain
+    int16_t rv;       ///< Contribution of V to R
+    int16_t gu;       ///< Contribution of U to G, subtracted
+    int16_t gv;       ///< Contribution of V to G, subtracted
+    int16_t bu;       ///< Contribution of U to B
+    int16_t y_offset; ///< Black level of Y
+
+}yuv_coefficients_t;
+
+/// Coefficients indexed by ::eYuvMatrix and ::eYuvRange
+static const yuv_coefficients_t yuv_coefficients[2][2] =
+{
+    // BT.601, Kr = 0.299, Kb = 0.114
+    {
+        {8192, 11485, 2819, 5850, 14516, 0},
+        {9539, 13075, 3209, 6660, 16525, 16},
+    },
+    // BT.709, Kr = 0.2126, Kb = 0.0722
+    {
+        {8192, 12901, 1535, 3835, 15201, 0},
+        {9539, 14686, 1747, 4366, 17305, 16},
+    },
+};
+
+/*!
+ * \brief Converts a fixed-point sum to a channel value
+ *
+ * \param[in] sum The sum of the products of the coefficients and Y, U and V
+ *
+ * \return The sum rounded, scaled back and clipped to the range 0 - 255
+ */
+static inline uint8_t yuvToChannel(const int32_t sum)
+{
+    int32_t val = ((sum + YUV_BIAS) >> YUV_SHIFT) - 256;
+
+    return (val < 0) ? 0 : ((val > 255) ? 255 : (uint8_t)val);
+}
+
+/*!
+ * \brief Converts a number of uyvy_pixel_t pixels of a row to bgr888_pixel_t
+ *        pixels
+ *
+ * \param[in]  s A pointer to the first uyvy_pixel_t pixel
+ * \param[out] d A pointer to the first bgr888_pixel_t pixel
+ * \param[in]  n The number of pixels, must be even
+ * \param[in]  k A pointer to the coefficients
+ */
+static void convertUyvyToBgr888Row(const uyvy_pixel_t *s, bgr888_pixel_t *d,
+                                   int32_t n, const yuv_coefficients_t *k)
+{
+    while (n > 0)
+    {
+        n -= 2;
+
+        uyvy_pixel_t uy = *s++;
+        uyvy_pixel_t vy = *s++;
+
+        int32_t u = (int32_t)(uy & 0xFFU) - 128;
+        int32_t v = (int32_t)(vy & 0xFFU) - 128;
+        int32_t y1 = k->y * ((int32_t)(uy >> 8) - k->y_offset);
+        int32_t y2 = k->y * ((int32_t)(vy >> 8) - k->y_offset);
+
+        int32_t r = k->rv * v;
+        int32_t g = -(k->gu * u) - (k->gv * v);
+        int32_t b = k->bu * u;
+
+        d->b = yuvToChannel(y1 + b);
+        d->g = yuvToChannel(y1 + g);
+        d->r = yuvToChannel(y1 + r);
+        d++;
+
+        d->b = yuvToChannel(y2 + b);
+        d->g = yuvToChannel(y2 + g);
+        d->r = yuvToChannel(y2 + r);
+        d++;
+    }
+}
+
+#if defined(USE_AVX2) || defined(USE_AVX2_DISPATCH)
+/*!
+ * \brief Converts the leading pixels of a row with AVX2
+ *
+ * The chroma terms are computed once per pixel pair. Arithmetic shifts round
+ * towards minus infinity, so no offset is needed to keep the sums positive.
+ * Packing saturates the results to the range 0 - 255.
+ *
+ * \param[in]  s A pointer to the first uyvy_pixel_t pixel
+ * \param[out] d A pointer to the first bgr888_pixel_t pixel
+ * \param[in]  n The number of pixels in the row
+ * \param[in]  k A pointer to the coefficients
+ *
+ * \return The number of converted pixels, the rest is left to
+ *         convertUyvyToBgr888Row()
+ */
+AVX2_TARGET static int32_t convertUyvyToBgr888RowAvx2(const uyvy_pixel_t *s, bgr888_pixel_t *d,
+                                                      const int32_t n, const yuv_coefficients_t *k)
+{
+    // Coefficient pairs for _mm256_madd_epi16()
+    const __m256i k_y = _mm256_set1_epi32((1 << (YUV_SHIFT - 1 + 16)) | (uint16_t)k->y);
+    const __m256i k_r = _mm256_set1_epi32(k->rv << 16);
+    const __m256i k_g = _mm256_set1_epi32(((uint32_t)(uint16_t)-k->gv << 16) | (uint16_t)-k->gu);
+    const __m256i k_b = _mm256_set1_epi32((uint16_t)k->bu);
+    const __m256i y_offset = _mm256_set1_epi16(k->y_offset);
+    const __m256i c128 = _mm256_set1_epi16(128);
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i lo_byte = _mm256_set1_epi16(0x00FF);
+    const __m256i zero = _mm256_setzero_si256();
+
+    // Removes every fourth byte of four BGRX pixels
+    const __m256i bgrx_to_bgr = _mm256_setr_epi8(
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+    int32_t x = 0;
+
+    // 16 pixels per iteration. The stores write 4 bytes beyond the 16
+    // pixels, so at least two more pixels must follow in the row.
+    for (; (x + 18) <= n; x += 16)
+    {
+        __m256i p = _mm256_loadu_si256((const __m256i *)(s + x));
+
+        // Y per pixel, U and V per pixel pair
+        __m256i yy = _mm256_sub_epi16(_mm256_srli_epi16(p, 8), y_offset);
+        __m256i uv = _mm256_sub_epi16(_mm256_and_si256(p, lo_byte), c128);
+
+        __m256i y_lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(yy, one), k_y);
+        __m256i y_hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(yy, one), k_y);
+        __m256i cr = _mm256_madd_epi16(uv, k_r);
+        __m256i cg = _mm256_madd_epi16(uv, k_g);
+        __m256i cb = _mm256_madd_epi16(uv, k_b);
+
+        // Each 128-bit lane holds 8 consecutive pixels
+        __m256i r = _mm256_packs_epi32(
+            _mm256_srai_epi32(_mm256_add_epi32(y_lo, _mm256_unpacklo_epi32(cr, cr)), YUV_SHIFT),
+            _mm256_srai_epi32(_mm256_add_epi32(y_hi, _mm256_unpackhi_epi32(cr, cr)), YUV_SHIFT));
+        __m256i g = _mm256_packs_epi32(
+            _mm256_srai_epi32(_mm256_add_epi32(y_lo, _mm256_unpacklo_epi32(cg, cg)), YUV_SHIFT),
+            _mm256_srai_epi32(_mm256_add_epi32(y_hi, _mm256_unpackhi_epi32(cg, cg)), YUV_SHIFT));
+        __m256i b = _mm256_packs_epi32(
+            _mm256_srai_epi32(_mm256_add_epi32(y_lo, _mm256_unpacklo_epi32(cb, cb)), YUV_SHIFT),
+            _mm256_srai_epi32(_mm256_add_epi32(y_hi, _mm256_unpackhi_epi32(cb, cb)), YUV_SHIFT));
+
+        // Interleave to BGRX and remove X
+        __m256i bg = _mm256_unpacklo_epi8(_mm256_packus_epi16(b, zero), _mm256_packus_epi16(g, zero));
+        __m256i rx = _mm256_unpacklo_epi8(_mm256_packus_epi16(r, zero), zero);
+        __m256i lo = _mm256_shuffle_epi8(_mm256_unpacklo_epi16(bg, rx), bgrx_to_bgr);
+        __m256i hi = _mm256_shuffle_epi8(_mm256_unpackhi_epi16(bg, rx), bgrx_to_bgr);
+
+        uint8_t *o = (uint8_t *)(d + x);
+        _mm_storeu_si128((__m128i *)(o + 0), _mm256_castsi256_si128(lo));
+        _mm_storeu_si128((__m128i *)(o + 12), _mm256_castsi256_si128(hi));
+        _mm_storeu_si128((__m128i *)(o + 24), _mm256_extracti128_si256(lo, 1));
+        _mm_storeu_si128((__m128i *)(o + 36), _mm256_extracti128_si256(hi, 1));
+    }
+
+    return x;
+}
+#endif
+
+#if defined(USE_SSE2) && !defined(USE_AVX2)
+/*!
+ * \brief Converts the leading pixels of a row with SSE2
+ *
+ * See convertUyvyToBgr888RowAvx2().
+ *
+ * \param[in]  s A pointer to the first uyvy_pixel_t pixel
+ * \param[out] d A pointer to the first bgr888_pixel_t pixel
+ * \param[in]  n The number of pixels in the row
+ * \param[in]  k A pointer to the coefficients
+ *
+ * \return The number of converted pixels, the rest is left to
+ *         convertUyvyToBgr888Row()
+ */
+static int32_t convertUyvyToBgr888RowSse2(const uyvy_pixel_t *s, bgr888_pixel_t *d,
+                                          const int32_t n, const yuv_coefficients_t *k)
+{
+    // Coefficient pairs for _mm_madd_epi16()
+    const __m128i k_y = _mm_set1_epi32((1 << (YUV_SHIFT - 1 + 16)) | (uint16_t)k->y);
+    const __m128i k_r = _mm_set1_epi32(k->rv << 16);
+    const __m128i k_g = _mm_set1_epi32(((uint32_t)(uint16_t)-k->gv << 16) | (uint16_t)-k->gu);
+    const __m128i k_b = _mm_set1_epi32((uint16_t)k->bu);
+    const __m128i y_offset = _mm_set1_epi16(k->y_offset);
+    const __m128i c128 = _mm_set1_epi16(128);
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i lo_byte = _mm_set1_epi16(0x00FF);
+
+    // Masks to remove every fourth byte of four BGRX pixels
+    const __m128i bgr_lo = _mm_set1_epi64x(0x0000000000FFFFFFLL);
+    const __m128i bgr_hi = _mm_set1_epi64x(0x0000FFFFFF000000LL);
+    const __m128i qword_lo = _mm_set_epi32(0, 0, -1, -1);
+
+    int32_t x = 0;
+
+    // 8 pixels per iteration
+    for (; (x + 8) <= n; x += 8)
+    {
+        __m128i p = _mm_loadu_si128((const __m128i *)(s + x));
+
+        // Y per pixel, U and V per pixel pair
+        __m128i yy = _mm_sub_epi16(_mm_srli_epi16(p, 8), y_offset);
+        __m128i uv = _mm_sub_epi16(_mm_and_si128(p, lo_byte), c128);
+
+        __m128i y_lo = _mm_madd_epi16(_mm_unpacklo_epi16(yy, one), k_y);
+        __m128i y_hi = _mm_madd_epi16(_mm_unpackhi_epi16(yy, one), k_y);
+        __m128i cr = _mm_madd_epi16(uv, k_r);
+        __m128i cg = _mm_madd_epi16(uv, k_g);
+        __m128i cb = _mm_madd_epi16(uv, k_b);
+
+        __m128i r = _mm_packs_epi32(
+            _mm_srai_epi32(_mm_add_epi32(y_lo, _mm_unpacklo_epi32(cr, cr)), YUV_SHIFT),
+            _mm_srai_epi32(_mm_add_epi32(y_hi, _mm_unpackhi_epi32(cr, cr)), YUV_SHIFT));
+        __m128i g = _mm_packs_epi32(
+            _mm_srai_epi32(_mm_add_epi32(y_lo, _mm_unpacklo_epi32(cg, cg)), YUV_SHIFT),
+            _mm_srai_epi32(_mm_add_epi32(y_hi, _mm_unpackhi_epi32(cg, cg)), YUV_SHIFT));
+        __m128i b = _mm_packs_epi32(
+            _mm_srai_epi32(_mm_add_epi32(y_lo, _mm_unpacklo_epi32(cb, cb)), YUV_SHIFT),
+            _mm_srai_epi32(_mm_add_epi32(y_hi, _mm_unpackhi_epi32(cb, cb)), YUV_SHIFT));
+
+        // Interleave to BGRX
+        __m128i bg = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), _mm_packus_epi16(g, g));
+        __m128i rx = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), _mm_setzero_si128());
+        __m128i lo = _mm_unpacklo_epi16(bg, rx);
+        __m128i hi = _mm_unpackhi_epi16(bg, rx);
+
+        // Remove X, this packs 4 pixels into the lower 12 bytes
+        lo = _mm_or_si128(_mm_and_si128(lo, bgr_lo), _mm_and_si128(_mm_srli_epi64(lo, 8), bgr_hi));
+        hi = _mm_or_si128(_mm_and_si128(hi, bgr_lo), _mm_and_si128(_mm_srli_epi64(hi, 8), bgr_hi));
+        lo = _mm_or_si128(_mm_and_si128(lo, qword_lo), _mm_srli_si128(_mm_andnot_si128(qword_lo, lo), 2));
+        hi = _mm_or_si128(_mm_and_si128(hi, qword_lo), _mm_srli_si128(_mm_andnot_si128(qword_lo, hi), 2));
+
+        uint8_t *o = (uint8_t *)(d + x);
+        _mm_storeu_si128((__m128i *)(o + 0), _mm_or_si128(lo, _mm_slli_si128(hi, 12)));
+        _mm_storel_epi64((__m128i *)(o + 16), _mm_srli_si128(hi, 4));
+    }
+
+    return x;
+}
+#endif
+
+/*!
+ * \brief Converts an uyvy_pixel_t image to a bgr888_pixel_t image using
+ *        fixed-point arithmetic
+ *
+ * The conversion is defined by the following equations, in which all
+ * coefficients are integers with YUV_SHIFT (13) fraction bits:
+ *
+ * y' = Y - y_offset, u' = U - 128, v' = V - 128
+ *
+ * R = clip((ky * y' + krv * v'             + 4096) >> 13)
+ * G = clip((ky * y' - kgu * u' - kgv * v'  + 4096) >> 13)
+ * B = clip((ky * y' + kbu * u'             + 4096) >> 13)
+ *
+ * The coefficients are the BT.601 or BT.709 coefficients, rounded to the
+ * nearest multiple of 1/8192:
+ *
+ * ky = 1, krv = 2(1 - Kr), kgu = 2Kb(1 - Kb)/Kg, kgv = 2Kr(1 - Kr)/Kg,
+ * kbu = 2(1 - Kb), with Kg = 1 - Kr - Kb
+ *
+ * For limited range, ky is multiplied by 255/219, the chroma coefficients by
+ * 255/224 and y_offset is 16. For full range y_offset is 0.
+ *
+ * The result differs at most 1 from the same equations evaluated with real
+ * coefficients. All code paths, scalar, SSE2 and AVX2, produce bit-exact
+ * identical results. The SIMD paths are selected at compile time. A build
+ * with GCC or Clang for SSE2 also contains the AVX2 path, and uses it if the
+ * processor supports AVX2.
+ *
+ * \param[in]  src    A pointer to the uyvy_pixel_t image
+ * \param[out] dst    A pointer to the converted bgr888_pixel_t image
+ * \param[in]  matrix The conversion matrix
+ * \param[in]  range  The range of the Y, U and V values in \p src
+ */
+void convertUyvyToBgr888Fast(const image_t *src, image_t *dst,
+                             const eYuvMatrix matrix, const eYuvRange range)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UYVY, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_BGR888, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+    ASSERT((src->cols % 2) != 0, "src must have an even number of columns");
+
+    // Verify parameters
+    ASSERT((matrix != YUV_BT601) && (matrix != YUV_BT709), "matrix is invalid");
+    ASSERT((range != YUV_RANGE_FULL) && (range != YUV_RANGE_LIMITED), "range is invalid");
+
+    const yuv_coefficients_t *k = &yuv_coefficients[matrix][range];
+
+#if defined(USE_AVX2_DISPATCH)
+    const int32_t avx2 = __builtin_cpu_supports("avx2");
 #endif
+
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        const uyvy_pixel_t *s = (const uyvy_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        bgr888_pixel_t *d = (bgr888_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+        int32_t x = 0;
+
+#if defined(USE_AVX2)
+        x = convertUyvyToBgr888RowAvx2(s, d, src->cols, k);
+#elif defined(USE_AVX2_DISPATCH)
+        x = avx2 ? convertUyvyToBgr888RowAvx2(s, d, src->cols, k) :
+                   convertUyvyToBgr888RowSse2(s, d, src->cols, k);
+#elif defined(USE_SSE2)
+        x = convertUyvyToBgr888RowSse2(s, d, src->cols, k);
+#endif
+
+        // Remaining pixels
+        convertUyvyToBgr888Row(s + x, d + x, src->cols - x, k);
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -1243,21 +1895,31 @@ void convertUyvyToBgr888(image_t *src, image_t *dst)
  */
 void convertUint8ToBgr888(image_t *src, image_t *dst)
 {
-    uint32_t i = src->rows * src->cols;
-    uint8_pixel_t *uint8_pixel = (uint8_pixel_t *)src->data;
-    bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)dst->data;
+    TRACE_ENTER(src, dst);
+
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
 
-    while (i-- > 0)
+    for (int32_t y = 0; y < src->rows; y++)
     {
-        uint8_t val = *uint8_pixel;
+        uint32_t i = src->cols;
+        uint8_pixel_t *uint8_pixel = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        while (i-- > 0)
+        {
+            uint8_t val = *uint8_pixel;
 
-        bgr888_pixel->r = val;
-        bgr888_pixel->g = val;
-        bgr888_pixel->b = val;
+            bgr888_pixel->r = val;
+            bgr888_pixel->g = val;
+            bgr888_pixel->b = val;
 
-        bgr888_pixel++;
-        uint8_pixel++;
+            bgr888_pixel++;
+            uint8_pixel++;
+        }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -1271,19 +1933,29 @@ void convertUint8ToBgr888(image_t *src, image_t *dst)
  */
 void convertBgr888ToUint8(image_t *src, image_t *dst)
 {
-    uint32_t i = src->rows * src->cols;
-    bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)src->data;
-    uint8_pixel_t *uint8_pixel = (uint8_pixel_t *)dst->data;
+    TRACE_ENTER(src, dst);
 
-    while (i-- > 0)
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+
+    for (int32_t y = 0; y < src->rows; y++)
     {
-        *uint8_pixel = (bgr888_pixel->r * 0.299f) +
-                       (bgr888_pixel->g * 0.587f) +
-                       (bgr888_pixel->b * 0.114f);
+        uint32_t i = src->cols;
+        bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *uint8_pixel = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        while (i-- > 0)
+        {
+            *uint8_pixel = (bgr888_pixel->r * 0.299f) +
+                           (bgr888_pixel->g * 0.587f) +
+                           (bgr888_pixel->b * 0.114f);
 
-        bgr888_pixel++;
-        uint8_pixel++;
+            bgr888_pixel++;
+            uint8_pixel++;
+        }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -1297,19 +1969,135 @@ void convertBgr888ToUint8(image_t *src, image_t *dst)
  */
 void convertBgr888ToInt16(image_t *src, image_t *dst)
 {
-    uint32_t i = src->rows * src->cols;
-    bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)src->data;
-    int16_pixel_t *int16_pixel = (int16_pixel_t *)dst->data;
+    TRACE_ENTER(src, dst);
+
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        uint32_t i = src->cols;
+        bgr888_pixel_t *bgr888_pixel = (bgr888_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        int16_pixel_t *int16_pixel = (int16_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        while (i-- > 0)
+        {
+            *int16_pixel = (bgr888_pixel->r * 0.299f) +
+                           (bgr888_pixel->g * 0.587f) +
+                           (bgr888_pixel->b * 0.114f);
+
+            bgr888_pixel++;
+            int16_pixel++;
+        }
+    }
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Packs a binary uint8_pixel_t image in a binary image
+ *
+ * Every pixel that is not 0 becomes 1. Packing reduces the memory of a
+ * binary image by a factor 8, and allows the morphological filters to
+ * process 64 pixels per operation.
+ *
+ * \param[in]  src A pointer to the uint8_pixel_t image
+ * \param[out] dst A pointer to the binary image
+ */
+void convertUint8ToBinary(const image_t *src, image_t *dst)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_BINARY, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    const int32_t cols = src->cols;
+    const int32_t words = (cols + BINARY_WORD_BITS - 1) / BINARY_WORD_BITS;
+    const int32_t step = IMAGE_STEP(src);
+
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        const uint8_pixel_t *s = (const uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        binary_word_t *d = (binary_word_t *)dst->data + (y * (IMAGE_STRIDE(dst) / BINARY_WORD_BITS));
+
+        for (int32_t w = 0; w < words; w++)
+        {
+            const int32_t x0 = w * BINARY_WORD_BITS;
+            const int32_t n = ((cols - x0) < BINARY_WORD_BITS) ? (cols - x0) : BINARY_WORD_BITS;
+
+            binary_word_t word = 0;
+            int32_t i = 0;
+
+#if defined(USE_SSE2)
+            // The sign bits of 16 comparisons at once
+            if (step == 1)
+            {
+                const __m128i zero = _mm_setzero_si128();
+
+                for (; (i + 16) <= n; i += 16)
+                {
+                    __m128i v = _mm_loadu_si128((const __m128i *)(s + x0 + i));
+                    uint32_t bits = ~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)) & 0xFFFFu;
+
+                    word |= (binary_word_t)bits << i;
+                }
+            }
+#endif
+            for (; i < n; i++)
+            {
+                word |= (binary_word_t)(s[(x0 + i) * step] != 0) << i;
+            }
+
+            d[w] = word;
+        }
+    }
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Unpacks a binary image in a binary uint8_pixel_t image
+ *
+ * \param[in]  src A pointer to the binary image
+ * \param[out] dst A pointer to the uint8_pixel_t image with values 0 and 1
+ */
+void convertBinaryToUint8(const image_t *src, image_t *dst)
+{
+    TRACE_ENTER(src, dst);
 
-    while (i-- > 0)
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_BINARY, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    const int32_t cols = src->cols;
+    const int32_t step = IMAGE_STEP(dst);
+
+    for (int32_t y = 0; y < src->rows; y++)
     {
-        *int16_pixel = (bgr888_pixel->r * 0.299f) +
-                       (bgr888_pixel->g * 0.587f) +
-                       (bgr888_pixel->b * 0.114f);
+        const binary_word_t *s = (const binary_word_t *)src->data + (y * (IMAGE_STRIDE(src) / BINARY_WORD_BITS));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
 
-        bgr888_pixel++;
-        int16_pixel++;
+        for (int32_t x = 0; x < cols; x++)
+        {
+            d[x * step] = (uint8_pixel_t)((s[x / BINARY_WORD_BITS] >> (x % BINARY_WORD_BITS)) & 1);
+        }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -1323,11 +2111,15 @@ void convertBgr888ToInt16(image_t *src, image_t *dst)
  */
 void convertToUint8(image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -1349,6 +2141,8 @@ void convertToUint8(image_t *src, image_t *dst)
         {
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -1362,11 +2156,14 @@ void convertToUint8(image_t *src, image_t *dst)
  */
 void convertToInt16(image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -1388,6 +2185,8 @@ void convertToInt16(image_t *src, image_t *dst)
         {
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -1401,11 +2200,14 @@ void convertToInt16(image_t *src, image_t *dst)
  */
 void convertToUyvy(image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -1423,6 +2225,8 @@ void convertToUyvy(image_t *src, image_t *dst)
         {
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -1436,11 +2240,14 @@ void convertToUyvy(image_t *src, image_t *dst)
  */
 void convertToBgr888(image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -1462,6 +2269,8 @@ void convertToBgr888(image_t *src, image_t *dst)
         {
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -1476,6 +2285,8 @@ void convertToBgr888(image_t *src, image_t *dst)
 void setSelectedToValue(const image_t *src, image_t *dst,
                         const uint8_pixel_t selected, const uint8_pixel_t value)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -1483,36 +2294,43 @@ void setSelectedToValue(const image_t *src, image_t *dst,
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
-    uint32_t i = src->rows * src->cols;
-    uint8_pixel_t *s = (uint8_pixel_t *)src->data;
-    uint8_pixel_t *d = (uint8_pixel_t *)dst->data;
-
     dst->rows = src->rows;
     dst->cols = src->cols;
     dst->type = src->type;
 
-    // Loop all pixels and set selected pixel to value
-    // Copy all others
-    while (i-- > 0)
+    for (int32_t y = 0; y < src->rows; y++)
     {
-        if (*s == selected)
-        {
-            *d = value;
-        }
-        else
+        uint32_t i = src->cols;
+        uint8_pixel_t *s = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Loop all pixels in the row and set selected pixel to value
+        // Copy all others
+        while (i-- > 0)
         {
-            *d = *s;
-        }
+            if (*s == selected)
+            {
+                *d = value;
+            }
+            else
+            {
+                *d = *s;
+            }
 
-        // Next pixel
-        s++;
-        d++;
+            // Next pixel
+            s++;
+            d++;
+        }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -1534,6 +2352,7 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_UINT8, "img type is invalid");
+    ASSERT(IMAGE_STEP(img) != 1, "img image can not be a luma view");
 
     // Verify image consistency
     ASSERT(x < 0, "x-value is out of range");
@@ -1541,7 +2360,8 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
     ASSERT(y < 0, "y-value is out of range");
     ASSERT(y >= img->rows, "y-value is out of range");
 
-    register uint8_pixel_t *s = (uint8_pixel_t *)(img->data + (y * img->cols + x));
+    register const int32_t stride = IMAGE_STRIDE(img);
+    register uint8_pixel_t *s = (uint8_pixel_t *)(img->data + (y * stride + x));
 
     unsigned int cnt = 0;
 
@@ -1552,14 +2372,14 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
         {
             cnt++;
         } // right
-        if (*(s + (img->cols * sizeof(uint8_pixel_t))) == p)
+        if (*(s + stride) == p)
         {
             cnt++;
         } // down
 
         if (c == CONNECTED_EIGHT)
         {
-            if (*(s + (img->cols * sizeof(uint8_pixel_t)) + 1) == p)
+            if (*(s + stride + 1) == p)
             {
                 cnt++;
             } // down-right
@@ -1572,14 +2392,14 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
         {
             cnt++;
         } // left
-        if (*(s + (img->cols * sizeof(uint8_pixel_t))) == p)
+        if (*(s + stride) == p)
         {
             cnt++;
         } // down
 
         if (c == CONNECTED_EIGHT)
         {
-            if (*(s + (img->cols * sizeof(uint8_pixel_t)) - 1) == p)
+            if (*(s + stride - 1) == p)
             {
                 cnt++;
             } // down-left
@@ -1588,7 +2408,7 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
     // Left-bottom pixel
     else if (x == 0 && y == img->rows - 1)
     {
-        if (*(s - (img->cols * sizeof(uint8_pixel_t))) == p)
+        if (*(s - stride) == p)
         {
             cnt++;
         } // up
@@ -1599,7 +2419,7 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
 
         if (c == CONNECTED_EIGHT)
         {
-            if (*(s - (img->cols * sizeof(uint8_pixel_t)) + 1) == p)
+            if (*(s - stride + 1) == p)
             {
                 cnt++;
             } // up-right
@@ -1608,7 +2428,7 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
     // Right-bottom pixel
     else if (x == img->cols - 1 && y == img->rows - 1)
     {
-        if (*(s - (img->cols * sizeof(uint8_pixel_t))) == p)
+        if (*(s - stride) == p)
         {
             cnt++;
         } // up
@@ -1619,7 +2439,7 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
 
         if (c == CONNECTED_EIGHT)
         {
-            if (*(s - (img->cols * sizeof(uint8_pixel_t)) - 1) == p)
+            if (*(s - stride - 1) == p)
             {
                 cnt++;
             } // up-left
@@ -1636,18 +2456,18 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
         {
             cnt++;
         } // right
-        if (*(s + (img->cols * sizeof(uint8_pixel_t))) == p)
+        if (*(s + stride) == p)
         {
             cnt++;
         } // down
 
         if (c == CONNECTED_EIGHT)
         {
-            if (*(s + (img->cols * sizeof(uint8_pixel_t)) - 1) == p)
+            if (*(s + stride - 1) == p)
             {
                 cnt++;
             } // down-left
-            if (*(s + (img->cols * sizeof(uint8_pixel_t)) + 1) == p)
+            if (*(s + stride + 1) == p)
             {
                 cnt++;
             } // down-right
@@ -1656,7 +2476,7 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
     // Bottom border pixels
     else if (y == img->rows - 1)
     {
-        if (*(s - (img->cols * sizeof(uint8_pixel_t))) == p)
+        if (*(s - stride) == p)
         {
             cnt++;
         } // up
@@ -1671,11 +2491,11 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
 
         if (c == CONNECTED_EIGHT)
         {
-            if (*(s - (img->cols * sizeof(uint8_pixel_t)) - 1) == p)
+            if (*(s - stride - 1) == p)
             {
                 cnt++;
             } // up-left
-            if (*(s - (img->cols * sizeof(uint8_pixel_t)) + 1) == p)
+            if (*(s - stride + 1) == p)
             {
                 cnt++;
             } // up-right
@@ -1684,7 +2504,7 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
     // Left border pixels
     else if (x == 0)
     {
-        if (*(s - (img->cols * sizeof(uint8_pixel_t))) == p)
+        if (*(s - stride) == p)
         {
             cnt++;
         } // up
@@ -1692,18 +2512,18 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
         {
             cnt++;
         } // right
-        if (*(s + (img->cols * sizeof(uint8_pixel_t))) == p)
+        if (*(s + stride) == p)
         {
             cnt++;
         } // down
 
         if (c == CONNECTED_EIGHT)
         {
-            if (*(s - (img->cols * sizeof(uint8_pixel_t)) + 1) == p)
+            if (*(s - stride + 1) == p)
             {
                 cnt++;
             } // up-right
-            if (*(s + (img->cols * sizeof(uint8_pixel_t)) + 1) == p)
+            if (*(s + stride + 1) == p)
             {
                 cnt++;
             } // down-right
@@ -1712,7 +2532,7 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
     // Right border pixels
     else if (x == img->cols - 1)
     {
-        if (*(s - (img->cols * sizeof(uint8_pixel_t))) == p)
+        if (*(s - stride) == p)
         {
             cnt++;
         } // up
@@ -1720,18 +2540,18 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
         {
             cnt++;
         } // left
-        if (*(s + (img->cols * sizeof(uint8_pixel_t))) == p)
+        if (*(s + stride) == p)
         {
             cnt++;
         } // down
 
         if (c == CONNECTED_EIGHT)
         {
-            if (*(s - (img->cols * sizeof(uint8_pixel_t)) - 1) == p)
+            if (*(s - stride - 1) == p)
             {
                 cnt++;
             } // up-left
-            if (*(s + (img->cols * sizeof(uint8_pixel_t)) - 1) == p)
+            if (*(s + stride - 1) == p)
             {
                 cnt++;
             } // down-left
@@ -1740,7 +2560,7 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
     else
     {
         // Inner pixels
-        if (*(s - (img->cols * sizeof(uint8_pixel_t))) == p)
+        if (*(s - stride) == p)
         {
             cnt++;
         } // up
@@ -1752,26 +2572,26 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
         {
             cnt++;
         } // right
-        if (*(s + (img->cols * sizeof(uint8_pixel_t))) == p)
+        if (*(s + stride) == p)
         {
             cnt++;
         } // down
 
         if (c == CONNECTED_EIGHT)
         {
-            if (*(s - (img->cols * sizeof(uint8_pixel_t)) - 1) == p)
+            if (*(s - stride - 1) == p)
             {
                 cnt++;
             } // up-left
-            if (*(s - (img->cols * sizeof(uint8_pixel_t)) + 1) == p)
+            if (*(s - stride + 1) == p)
             {
                 cnt++;
             } // up-right
-            if (*(s + (img->cols * sizeof(uint8_pixel_t)) - 1) == p)
+            if (*(s + stride - 1) == p)
             {
                 cnt++;
             } // down-left
-            if (*(s + (img->cols * sizeof(uint8_pixel_t)) + 1) == p)
+            if (*(s + stride + 1) == p)
             {
                 cnt++;
             } // down-right
@@ -1785,30 +2605,627 @@ uint32_t neighbourCount(const image_t *img, const int32_t x, const int32_t y,
 // ----------------------------------------------------------------------------
 
 /*!
- * \brief Applies a filter mask to an image by convolving the filter mask with
- *        the original image
+ * \brief Returns the greatest common divisor of two values
  *
- * \param[in]  src A pointer to the source image
- * \param[out] dst A pointer to the destination image
- * \param[in]  msk A pointer to the mask image
+ * \param[in] a The first value
+ * \param[in] b The second value
+ *
+ * \return The greatest common divisor, always positive unless both values are
+ *         0
  */
-void convolve(const image_t *src, image_t *dst, const image_t *msk)
+static int32_t gcd(int32_t a, int32_t b)
 {
-    // Verify image validity
-    ASSERT(src == NULL, "src image is invalid");
-    ASSERT(dst == NULL, "dst image is invalid");
+    a = (a < 0) ? -a : a;
+    b = (b < 0) ? -b : b;
+
+    while (b != 0)
+    {
+        int32_t t = a % b;
+        a = b;
+        b = t;
+    }
+
+    return a;
+}
+
+/*!
+ * \brief Splits a rank-1 mask in a row and a column mask
+ *
+ * A mask m is rank-1 if m(i,j) = col(j) * row(i) for all i and j. The row mask
+ * is the first non-zero row of the mask divided by the greatest common
+ * divisor of its values, so both masks are integer.
+ *
+ * \param[in]  msk A pointer to an ::IMGTYPE_UINT8 or ::IMGTYPE_INT16 mask
+ * \param[out] row A pointer to msk->cols values for the row mask
+ * \param[out] col A pointer to msk->rows values for the column mask
+ *
+ * \return 1 if the mask is rank-1, 0 otherwise
+ */
+static uint32_t factorizeMask(const image_t *msk, int32_t *row, int32_t *col)
+{
+    int32_t p = -1;
+    int32_t q = -1;
+
+    // Read the mask and find a non-zero pivot
+    for (int32_t j = 0; j < msk->rows; j++)
+    {
+        for (int32_t i = 0; i < msk->cols; i++)
+        {
+            int32_t m = (msk->type == IMGTYPE_UINT8) ? getUint8Pixel(msk, i, j) : getInt16Pixel(msk, i, j);
+
+            if ((p < 0) && (m != 0))
+            {
+                p = j;
+                q = i;
+            }
+        }
+    }
+
+    if (p < 0)
+    {
+        return 0;
+    }
+
+    int32_t g = 0;
+
+    for (int32_t i = 0; i < msk->cols; i++)
+    {
+        row[i] = (msk->type == IMGTYPE_UINT8) ? getUint8Pixel(msk, i, p) : getInt16Pixel(msk, i, p);
+        g = gcd(g, row[i]);
+    }
+
+    for (int32_t j = 0; j < msk->rows; j++)
+    {
+        col[j] = (msk->type == IMGTYPE_UINT8) ? getUint8Pixel(msk, q, j) : getInt16Pixel(msk, q, j);
+    }
+
+    // Every row must be a multiple of the pivot row
+    int32_t pivot = row[q];
+
+    for (int32_t j = 0; j < msk->rows; j++)
+    {
+        for (int32_t i = 0; i < msk->cols; i++)
+        {
+            int32_t m = (msk->type == IMGTYPE_UINT8) ? getUint8Pixel(msk, i, j) : getInt16Pixel(msk, i, j);
+
+            if ((m * pivot) != (col[j] * row[i]))
+            {
+                return 0;
+            }
+        }
+    }
+
+    // m(i,j) = col(j) * row(i) / pivot, move the gcd of the pivot row to the
+    // column mask
+    for (int32_t j = 0; j < msk->rows; j++)
+    {
+        if (((col[j] * g) % pivot) != 0)
+        {
+            return 0;
+        }
+
+        col[j] = (col[j] * g) / pivot;
+    }
+
+    for (int32_t i = 0; i < msk->cols; i++)
+    {
+        row[i] /= g;
+    }
+
+    return 1;
+}
+
+/*!
+ * \brief Convolves an image with a row mask and a column mask
+ *
+ * The horizontal pass filters every source row once into a rolling buffer of
+ * \p col_size rows. The vertical pass combines the buffered rows into one
+ * output row. Both passes walk the rows from left to right without bounds
+ * checks, pixels outside the image are treated as 0 like convolve() does. The
+ * buffers are allocated in the image arena.
+ *
+ * \param[in]  src      A pointer to the source image
+ * \param[out] dst      A pointer to the destination image
+ * \param[in]  row      A pointer to the row mask values
+ * \param[in]  row_size The number of values in \p row, must be odd
+ * \param[in]  col      A pointer to the column mask values
+ * \param[in]  col_size The number of values in \p col, must be odd
+ *
+ * \return 1 on success, 0 if the image arena is full
+ */
+static uint32_t convolveRowsCols(const image_t *src, image_t *dst,
+                                 const int32_t *row, const int32_t row_size,
+                                 const int32_t *col, const int32_t col_size)
+{
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t dc = row_size / 2;
+    const int32_t dr = col_size / 2;
+
+    // Rolling buffer and an accumulator row
+    int32_t *buf = (int32_t *)allocImageArena((size_t)(col_size + 1) * cols * sizeof(int32_t));
+
+    if (buf == NULL)
+    {
+        return 0;
+    }
+
+    int32_t *acc = buf + (col_size * cols);
+    int32_t next = 0;
+
+    for (int32_t y = 0; y < rows; y++)
+    {
+        // Filter the source rows up to y + dr horizontally. The row that is
+        // overwritten in the rolling buffer is no longer needed.
+        int32_t last = ((y + dr) < rows) ? (y + dr) : (rows - 1);
+
+        for (; next <= last; next++)
+        {
+            int32_t *t = buf + ((next % col_size) * cols);
+
+            memset(t, 0, cols * sizeof(int32_t));
+
+            for (int32_t i = -dc; i <= dc; i++)
+            {
+                const int32_t k = row[i + dc];
+
+                // Only the columns for which x - i is inside the image
+                const int32_t x0 = (i > 0) ? i : 0;
+                const int32_t x1 = (i < 0) ? (cols + i) : cols;
+
+                if (k == 0)
+                {
+                    continue;
+                }
+
+                if (src->type == IMGTYPE_UINT8)
+                {
+                    const uint8_pixel_t *s = (const uint8_pixel_t *)src->data + (next * IMAGE_STRIDE(src));
+
+                    for (int32_t x = x0; x < x1; x++)
+                    {
+                        t[x] += s[x - i] * k;
+                    }
+                }
+                else
+                {
+                    const int16_pixel_t *s = (const int16_pixel_t *)src->data + (next * IMAGE_STRIDE(src));
+
+                    for (int32_t x = x0; x < x1; x++)
+                    {
+                        t[x] += s[x - i] * k;
+                    }
+                }
+            }
+        }
+
+        // Filter vertically
+        memset(acc, 0, cols * sizeof(int32_t));
+
+        for (int32_t j = -dr; j <= dr; j++)
+        {
+            const int32_t k = col[j + dr];
+
+            if ((k == 0) || ((y - j) < 0) || ((y - j) >= rows))
+            {
+                continue;
+            }
+
+            const int32_t *t = buf + (((y - j) % col_size) * cols);
+
+            for (int32_t x = 0; x < cols; x++)
+            {
+                acc[x] += t[x] * k;
+            }
+        }
+
+        // Clip and store the result
+        if (dst->type == IMGTYPE_UINT8)
+        {
+            uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+            for (int32_t x = 0; x < cols; x++)
+            {
+                int32_t val = acc[x];
+                val = (val > UINT8_PIXEL_MAX) ? UINT8_PIXEL_MAX : val;
+                val = (val < UINT8_PIXEL_MIN) ? UINT8_PIXEL_MIN : val;
+                d[x] = (uint8_pixel_t)val;
+            }
+        }
+        else
+        {
+            int16_pixel_t *d = (int16_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+            for (int32_t x = 0; x < cols; x++)
+            {
+                int32_t val = acc[x];
+                val = (val > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : val;
+                val = (val < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : val;
+                d[x] = (int16_pixel_t)val;
+            }
+        }
+    }
+
+    return 1;
+}
+
+/// Largest max|src| * sum|msk| for which the frequency domain path of
+/// convolve() and correlate() is used. The rounding error of the single
+/// precision FFT grows linearly with this value. With full-scale random
+/// int16_pixel_t images and masks of 5x5 up to 41x41 cells the error was at
+/// most 0.41 at 2^21 and reached 2 at 2^23, so 2^21 keeps a margin to the
+/// documented difference of at most 1.
+#define CONVOLVE_FFT_MAX_BOUND ((float)(1 << 21))
+
+/*!
+ * \brief Selects the block size of the frequency domain path of convolve()
+ *        and correlate()
+ *
+ * A direct convolution costs cols * rows * mask cells multiply-adds. The
+ * frequency domain path transforms overlapping b x b blocks of the image,
+ * each yielding (b - mask cols + 1) x (b - mask rows + 1) output pixels, at
+ * the cost of a forward and an inverse real FFT of b x b pixels. The costs
+ * are expressed in CONVOLVE_DIRECT_COST and CONVOLVE_FFT_COST. Larger blocks
+ * overlap less, smaller blocks waste less at the right and bottom border of
+ * the image. The block size with the lowest cost is selected, if that cost is
+ * lower than the direct cost.
+ *
+ * \param[in] cols  Number of columns of the image
+ * \param[in] rows  Number of rows of the image
+ * \param[in] mcols Number of columns of the mask
+ * \param[in] mrows Number of rows of the mask
+ *
+ * \return The block size, or 0 if the direct method is cheaper
+ */
+static int32_t convolveFftBlock(const int32_t cols, const int32_t rows,
+                                const int32_t mcols, const int32_t mrows)
+{
+    if ((mcols * mrows) < CONVOLVE_FFT_MIN_CELLS)
+    {
+        return 0;
+    }
+
+    float best = CONVOLVE_DIRECT_COST * (float)cols * (float)rows * (float)(mcols * mrows);
+    int32_t block = 0;
+
+    for (int32_t b = 32; b <= CONVOLVE_FFT_MAX_BLOCK; b *= 2)
+    {
+        // The blocks must be at least twice the size of the mask
+        if ((b < (2 * mcols)) || (b < (2 * mrows)))
+        {
+            continue;
+        }
+
+        const int32_t bcols = (cols + (b - mcols)) / (b - mcols + 1);
+        const int32_t brows = (rows + (b - mrows)) / (b - mrows + 1);
+        const float cost = CONVOLVE_FFT_COST * (float)bcols * (float)brows * (float)(b * b);
+
+        if (cost < best)
+        {
+            best = cost;
+            block = b;
+        }
+    }
+
+    return block;
+}
+
+/*!
+ * \brief Convolves an image with a mask in the frequency domain
+ *
+ * Overlap-save: every b x b block of the source image, padded with 0 outside
+ * the image like convolve() does, is multiplied in the frequency domain with
+ * the spectrum of the mask. After the inverse transform the first mask cols -
+ * 1 columns and mask rows - 1 rows of the block are wrapped around, the
+ * other pixels equal the linear convolution. So the blocks overlap by the
+ * mask size minus one. The result is rounded to the nearest integer and
+ * clipped like the direct method.
+ *
+ * \param[in]  src  A pointer to the ::IMGTYPE_UINT8 or ::IMGTYPE_INT16 source
+ *                  image
+ * \param[out] dst  A pointer to the destination image of the same type
+ * \param[in]  msk  A pointer to the mask image of the same type
+ * \param[in]  flip 1 to correlate, i.e. to mirror the mask
+ * \param[in]  b    The block size, see convolveFftBlock()
+ *
+ * \return 1 on success, 0 if the image arena is full
+ */
+static uint32_t convolveFft(const image_t *src, image_t *dst, const image_t *msk,
+                            const int32_t flip, const int32_t b)
+{
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t mcols = msk->cols;
+    const int32_t mrows = msk->rows;
+    const int32_t tcols = b - mcols + 1;
+    const int32_t trows = b - mrows + 1;
+
+    image_t blk = {b, b, IMGTYPE_FLOAT, NULL, 0, 0};
+    image_t spec = {(b / 2) + 1, b, IMGTYPE_COMPLEX, NULL, 0, 0};
+    image_t kern = spec;
+
+    blk.data = (uint8_t *)allocImageArena((size_t)b * b * sizeof(float_pixel_t));
+    spec.data = (uint8_t *)allocImageArena((size_t)spec.cols * b * sizeof(complex_pixel_t));
+    kern.data = (uint8_t *)allocImageArena((size_t)spec.cols * b * sizeof(complex_pixel_t));
+
+    if ((blk.data == NULL) || (spec.data == NULL) || (kern.data == NULL))
+    {
+        return 0;
+    }
+
+    float_pixel_t *t = (float_pixel_t *)blk.data;
+    complex_pixel_t *f = (complex_pixel_t *)spec.data;
+    const complex_pixel_t *h = (const complex_pixel_t *)kern.data;
+    const int32_t n = spec.cols * b;
+
+    // Spectrum of the mask
+    memset(t, 0, (size_t)b * b * sizeof(float_pixel_t));
+
+    for (int32_t j = 0; j < mrows; j++)
+    {
+        for (int32_t i = 0; i < mcols; i++)
+        {
+            const int32_t c = flip ? (mcols - 1 - i) : i;
+            const int32_t r = flip ? (mrows - 1 - j) : j;
+
+            t[(j * b) + i] = (msk->type == IMGTYPE_UINT8) ?
+                             (float_pixel_t)getUint8Pixel(msk, c, r) :
+                             (float_pixel_t)getInt16Pixel(msk, c, r);
+        }
+    }
+
+    fft2dReal(&blk, &kern);
+
+    for (int32_t y0 = 0; y0 < rows; y0 += trows)
+    {
+        for (int32_t x0 = 0; x0 < cols; x0 += tcols)
+        {
+            // Source block starting at (x0 - mcols / 2, y0 - mrows / 2)
+            const int32_t sx = x0 - (mcols / 2);
+            const int32_t sy = y0 - (mrows / 2);
+            const int32_t c0 = (sx < 0) ? -sx : 0;
+            const int32_t c1 = ((sx + b) > cols) ? (cols - sx) : b;
+
+            for (int32_t y = 0; y < b; y++)
+            {
+                float_pixel_t *d = t + (y * b);
+
+                if (((sy + y) < 0) || ((sy + y) >= rows) || (c0 >= c1))
+                {
+                    memset(d, 0, b * sizeof(float_pixel_t));
+                    continue;
+                }
+
+                for (int32_t x = 0; x < c0; x++)
+                {
+                    d[x] = 0.0f;
+                }
+
+                if (src->type == IMGTYPE_UINT8)
+                {
+                    const uint8_pixel_t *s = (uint8_pixel_t *)src->data + ((sy + y) * IMAGE_STRIDE(src)) + sx;
+
+                    for (int32_t x = c0; x < c1; x++)
+                    {
+                        d[x] = (float_pixel_t)s[x];
+                    }
+                }
+                else
+                {
+                    const int16_pixel_t *s = (int16_pixel_t *)src->data + ((sy + y) * IMAGE_STRIDE(src)) + sx;
+
+                    for (int32_t x = c0; x < c1; x++)
+                    {
+                        d[x] = (float_pixel_t)s[x];
+                    }
+                }
+
+                for (int32_t x = c1; x < b; x++)
+                {
+                    d[x] = 0.0f;
+                }
+            }
+
+            fft2dReal(&blk, &spec);
+
+            for (int32_t i = 0; i < n; i++)
+            {
+                const float re = (f[i].real * h[i].real) - (f[i].imaginary * h[i].imaginary);
+                const float im = (f[i].real * h[i].imaginary) + (f[i].imaginary * h[i].real);
+
+                f[i].real = re;
+                f[i].imaginary = im;
+            }
+
+            ifft2dReal(&spec, &blk);
+
+            // Store the pixels that did not wrap around
+            const int32_t w = ((x0 + tcols) > cols) ? (cols - x0) : tcols;
+            const int32_t hgt = ((y0 + trows) > rows) ? (rows - y0) : trows;
+
+            for (int32_t y = 0; y < hgt; y++)
+            {
+                const float_pixel_t *s = t + ((y + mrows - 1) * b) + (mcols - 1);
+
+                for (int32_t x = 0; x < w; x++)
+                {
+                    // Round to the nearest integer
+                    const float v = s[x];
+                    int32_t val = (v < 0.0f) ? -(int32_t)(0.5f - v) : (int32_t)(v + 0.5f);
+
+                    if (dst->type == IMGTYPE_UINT8)
+                    {
+                        val = (val > UINT8_PIXEL_MAX) ? UINT8_PIXEL_MAX : val;
+                        val = (val < UINT8_PIXEL_MIN) ? UINT8_PIXEL_MIN : val;
+                        ((uint8_pixel_t *)dst->data)[((y0 + y) * IMAGE_STRIDE(dst)) + x0 + x] = (uint8_pixel_t)val;
+                    }
+                    else
+                    {
+                        val = (val > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : val;
+                        val = (val < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : val;
+                        ((int16_pixel_t *)dst->data)[((y0 + y) * IMAGE_STRIDE(dst)) + x0 + x] = (int16_pixel_t)val;
+                    }
+                }
+            }
+        }
+    }
+
+    return 1;
+}
+
+/*!
+ * \brief Applies convolve() or correlate() in the frequency domain if that is
+ *        cheaper than the direct method
+ *
+ * \param[in]  src  A pointer to the source image
+ * \param[out] dst  A pointer to the destination image
+ * \param[in]  msk  A pointer to the mask image
+ * \param[in]  flip 1 to correlate, i.e. to mirror the mask
+ *
+ * \return 1 if the result was calculated, 0 if the direct method must be used
+ */
+static uint32_t convolveAuto(const image_t *src, image_t *dst, const image_t *msk,
+                             const int32_t flip)
+{
+    if (((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_INT16)) ||
+        (dst->type != src->type) || (msk->type != src->type))
+    {
+        return 0;
+    }
+
+    const int32_t b = convolveFftBlock(src->cols, src->rows, msk->cols, msk->rows);
+
+    if (b == 0)
+    {
+        return 0;
+    }
+
+    // The rounding error of the FFT grows with the magnitude of the products
+    float bound = 0.0f;
+    int32_t smax = UINT8_PIXEL_MAX;
+
+    for (int32_t j = 0; j < msk->rows; j++)
+    {
+        for (int32_t i = 0; i < msk->cols; i++)
+        {
+            const int32_t m = (msk->type == IMGTYPE_UINT8) ? getUint8Pixel(msk, i, j) : getInt16Pixel(msk, i, j);
+            bound += (float)((m < 0) ? -m : m);
+        }
+    }
+
+    if (src->type == IMGTYPE_INT16)
+    {
+        smax = 0;
+
+        for (int32_t y = 0; y < src->rows; y++)
+        {
+            const int16_pixel_t *s = (int16_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+
+            for (int32_t x = 0; x < src->cols; x++)
+            {
+                const int32_t v = (s[x] < 0) ? -s[x] : s[x];
+                smax = (v > smax) ? v : smax;
+            }
+        }
+    }
+
+    if ((bound * (float)smax) > CONVOLVE_FFT_MAX_BOUND)
+    {
+        return 0;
+    }
+
+    image_arena_mark_t mark = markImageArena();
+    const uint32_t ret = convolveFft(src, dst, msk, flip, b);
+    releaseImageArena(mark);
+
+    return ret;
+}
+
+/*!
+ * \brief Applies a filter mask to an image by convolving the filter mask with
+ *        the original image
+ *
+ * If the mask is rank-1, i.e. it is the product of a column and a row mask,
+ * the image is filtered with convolveSeparable() instead. The result is the
+ * same.
+ *
+ * Other masks of at least CONVOLVE_FFT_MIN_CELLS cells are applied in the
+ * frequency domain if the cost model predicts that this is faster. Masks of
+ * fewer than 9x9 cells always use the direct method. The frequency domain
+ * result is calculated in single precision and differs at most 1 from the
+ * direct method. The frequency domain is only used when max|src| * sum|msk|
+ * is at most 2^21, for larger values the rounding error could exceed 1. This
+ * includes every uint8_pixel_t image with sum|msk| up to 8224, but only
+ * int16_pixel_t images with small values or a small mask. The blocks are
+ * allocated in the image arena, if they do not fit the direct method is used.
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[out] dst A pointer to the destination image
+ * \param[in]  msk A pointer to the mask image
+ */
+void convolve(const image_t *src, image_t *dst, const image_t *msk)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(msk == NULL, "msk image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(msk->data == NULL, "msk data is invalid");
     ASSERT(msk->rows % 2 == 0, "mask rows must be odd");
     ASSERT(msk->cols % 2 == 0, "mask cols must be odd");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+    ASSERT(IMAGE_STEP(msk) != 1, "msk image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
     ASSERT(src == dst, "src and dst are the same images");
 
+    // A luma view is filtered through a copy with a pixel step of 1
+    if (IMAGE_STEP(src) != 1)
+    {
+        image_arena_mark_t mark = markImageArena();
+        image_t *tmp = newUint8Image(src->cols, src->rows);
+
+        copyUint8Image(src, tmp);
+        convolve(tmp, dst, msk);
+        releaseImageArena(mark);
+
+        TRACE_EXIT();
+        return;
+    }
+
+    // Apply rank-1 masks as a row and a column mask
+    if ((msk->rows > 1) && (msk->cols > 1) &&
+        ((src->type == IMGTYPE_INT16) || (src->type == IMGTYPE_UINT8)) &&
+        (dst->type == src->type) && (msk->type == src->type))
+    {
+        image_arena_mark_t mark = markImageArena();
+
+        int32_t *row = (int32_t *)allocImageArena((msk->cols + msk->rows) * sizeof(int32_t));
+        int32_t *col = (row == NULL) ? NULL : (row + msk->cols);
+
+        if ((row != NULL) && (factorizeMask(msk, row, col) == 1) &&
+            (convolveRowsCols(src, dst, row, msk->cols, col, msk->rows) == 1))
+        {
+            releaseImageArena(mark);
+            TRACE_EXIT();
+            return;
+        }
+
+        releaseImageArena(mark);
+    }
+
+    // Apply large masks in the frequency domain
+    if (convolveAuto(src, dst, msk, 0) == 1)
+    {
+        TRACE_EXIT();
+        return;
+    }
+
     if (src->type == IMGTYPE_INT16)
     {
         ASSERT(dst->type != IMGTYPE_INT16, "dst type is invalid");
@@ -1839,140 +3256,565 @@ void convolve(const image_t *src, image_t *dst, const image_t *msk)
                     }
                 }
 
-                // Clip the result
-                if (val > INT16_PIXEL_MAX)
+                // Clip the result
+                if (val > INT16_PIXEL_MAX)
+                {
+                    val = INT16_PIXEL_MAX;
+                }
+
+                if (val < INT16_PIXEL_MIN)
+                {
+                    val = INT16_PIXEL_MIN;
+                }
+
+                // Store the result
+                setInt16Pixel(dst, x, y, val);
+            }
+        }
+    }
+    else if (src->type == IMGTYPE_UINT8)
+    {
+        ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+        ASSERT(msk->type != IMGTYPE_UINT8, "msk type is invalid");
+
+        // Loop all pixels
+        for (int32_t y = 0; y < src->rows; y++)
+        {
+            for (int32_t x = 0; x < src->cols; x++)
+            {
+                int32_t val = 0;
+                int32_t dr = (msk->rows / 2);
+                int32_t dc = (msk->cols / 2);
+
+                // Apply the kernel only for pixels within the image
+                for (int32_t j = -dr; j <= dr; j++)
+                {
+                    for (int32_t i = -dc; i <= dc; i++)
+                    {
+                        if (((x - i) >= 0) &&
+                            ((y - j) >= 0) &&
+                            ((x - i) < src->cols) &&
+                            ((y - j) < src->rows))
+                        {
+                            val += getUint8Pixel(src, x - i, y - j) * getUint8Pixel(msk, i + dc, j + dr);
+                        }
+                    }
+                }
+
+                // Clip the result
+                if (val > UINT8_PIXEL_MAX)
+                {
+                    val = UINT8_PIXEL_MAX;
+                }
+
+                if (val < UINT8_PIXEL_MIN)
+                {
+                    val = UINT8_PIXEL_MIN;
+                }
+
+                // Store the result
+                setUint8Pixel(dst, x, y, val);
+            }
+        }
+    }
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Maps a coordinate outside the image to a coordinate inside the image
+ *
+ * \param[in] p      The coordinate
+ * \param[in] n      The number of columns or rows of the image
+ * \param[in] border The border mode, must be of type ::eBorder
+ *
+ * \return The mapped coordinate, or -1 if the pixel has a constant value
+ */
+static int32_t borderCoordinate(int32_t p, const int32_t n, const eBorder border)
+{
+    if ((p >= 0) && (p < n))
+    {
+        return p;
+    }
+
+    if (border == BORDER_REPLICATE)
+    {
+        return (p < 0) ? 0 : (n - 1);
+    }
+
+    if (border == BORDER_REFLECT)
+    {
+        if (n == 1)
+        {
+            return 0;
+        }
+
+        // The reflected image repeats every 2 * (n - 1) pixels
+        int32_t period = 2 * (n - 1);
+
+        p = p % period;
+        p = (p < 0) ? (p + period) : p;
+
+        return (p < n) ? p : (period - p);
+    }
+
+    return -1;
+}
+
+/*!
+ * \brief Reads a pixel of an ::IMGTYPE_UINT8, ::IMGTYPE_INT16 or
+ *        ::IMGTYPE_FLOAT image
+ *
+ * \param[in] img A pointer to the image
+ * \param[in] c   Column (x) coordinate of the pixel
+ * \param[in] r   Row (y) coordinate of the pixel
+ *
+ * \return The pixel value
+ */
+static inline double getConvolvePixel(const image_t *img, const int32_t c, const int32_t r)
+{
+    if (img->type == IMGTYPE_UINT8)
+    {
+        return getUint8Pixel(img, c, r);
+    }
+    else if (img->type == IMGTYPE_INT16)
+    {
+        return getInt16Pixel(img, c, r);
+    }
+
+    return getFloatPixel(img, c, r);
+}
+
+/*!
+ * \brief Clips a convolution result to the range of the image type and stores
+ *        it
+ *
+ * \param[in] img A pointer to the image
+ * \param[in] c   Column (x) coordinate of the pixel
+ * \param[in] r   Row (y) coordinate of the pixel
+ * \param[in] val The convolution result
+ */
+static inline void setConvolvePixel(const image_t *img, const int32_t c, const int32_t r, double val)
+{
+    if (img->type == IMGTYPE_UINT8)
+    {
+        val = (val > UINT8_PIXEL_MAX) ? UINT8_PIXEL_MAX : ((val < UINT8_PIXEL_MIN) ? UINT8_PIXEL_MIN : val);
+        setUint8Pixel(img, c, r, (uint8_pixel_t)val);
+    }
+    else if (img->type == IMGTYPE_INT16)
+    {
+        val = (val > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : ((val < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : val);
+        setInt16Pixel(img, c, r, (int16_pixel_t)val);
+    }
+    else
+    {
+        setFloatPixel(img, c, r, (float_pixel_t)val);
+    }
+}
+
+/*!
+ * \brief Adds the contribution of one mask row to a row of accumulators
+ *
+ * Three taps are applied per pass over the row, so the accumulators are read
+ * and written once per three taps.
+ *
+ * \param[in,out] a    A pointer to the accumulators
+ * \param[in]     s    A pointer to the source pixel for tap 0 of the first
+ *                      accumulator, tap i uses the pixel i positions to the
+ *                      left
+ * \param[in]     k    A pointer to the mask row
+ * \param[in]     taps The number of values in \p k
+ * \param[in]     n    The number of accumulators
+ */
+#define CONVOLVE_ROW(name, src_t, acc_t)                                       \
+static void name(acc_t *a, const src_t *s, const src_t *k,                     \
+                 const int32_t taps, const int32_t n)                          \
+{                                                                              \
+    int32_t i = 0;                                                             \
+                                                                               \
+    for (; (i + 3) <= taps; i += 3)                                            \
+    {                                                                          \
+        const src_t *p = s - i;                                                \
+        const src_t k0 = k[i];                                                 \
+        const src_t k1 = k[i + 1];                                             \
+        const src_t k2 = k[i + 2];                                             \
+                                                                               \
+        for (int32_t x = 0; x < n; x++)                                        \
+        {                                                                      \
+            a[x] += (p[x] * k0) + (p[x - 1] * k1) + (p[x - 2] * k2);           \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    for (; i < taps; i++)                                                      \
+    {                                                                          \
+        const src_t *p = s - i;                                                \
+        const src_t k0 = k[i];                                                 \
+                                                                               \
+        for (int32_t x = 0; x < n; x++)                                        \
+        {                                                                      \
+            a[x] += p[x] * k0;                                                 \
+        }                                                                      \
+    }                                                                          \
+}
+
+CONVOLVE_ROW(convolveRowUint8, uint8_pixel_t, int32_t)
+CONVOLVE_ROW(convolveRowInt16, int16_pixel_t, int32_t)
+CONVOLVE_ROW(convolveRowFloat, float_pixel_t, float)
+
+/*!
+ * \brief Convolves a row with a 3x3 mask in a single pass
+ *
+ * \param[out] a        A pointer to the results
+ * \param[in]  s        A pointer to the source pixel for mask element (0,0)
+ *                       of the first result
+ * \param[in]  stride   The row stride of the source image in pixels
+ * \param[in]  k        A pointer to the mask
+ * \param[in]  k_stride The row stride of the mask in pixels
+ * \param[in]  n        The number of results
+ */
+#define CONVOLVE_3X3(name, src_t, acc_t)                                       \
+static void name(acc_t *a, const src_t *s, const int32_t stride,               \
+                 const src_t *k, const int32_t k_stride, const int32_t n)      \
+{                                                                              \
+    const src_t *p0 = s;                                                       \
+    const src_t *p1 = s - stride;                                              \
+    const src_t *p2 = s - (2 * stride);                                        \
+    const src_t k00 = k[0], k01 = k[1], k02 = k[2];                            \
+    const src_t k10 = k[k_stride], k11 = k[k_stride + 1];                      \
+    const src_t k12 = k[k_stride + 2];                                         \
+    const src_t k20 = k[2 * k_stride], k21 = k[(2 * k_stride) + 1];            \
+    const src_t k22 = k[(2 * k_stride) + 2];                                   \
+                                                                               \
+    for (int32_t x = 0; x < n; x++)                                            \
+    {                                                                          \
+        a[x] = (p0[x] * k00) + (p0[x - 1] * k01) + (p0[x - 2] * k02) +         \
+               (p1[x] * k10) + (p1[x - 1] * k11) + (p1[x - 2] * k12) +         \
+               (p2[x] * k20) + (p2[x - 1] * k21) + (p2[x - 2] * k22);          \
+    }                                                                          \
+}
+
+CONVOLVE_3X3(convolve3x3Uint8, uint8_pixel_t, int32_t)
+CONVOLVE_3X3(convolve3x3Int16, int16_pixel_t, int32_t)
+CONVOLVE_3X3(convolve3x3Float, float_pixel_t, float)
+
+/*!
+ * \brief Applies a filter mask to an image by convolving the filter mask with
+ *        the original image
+ *
+ * The border pixels of \p dst, for which the mask is partly outside the
+ * image, are not written. This is convolveFastBorder() with ::BORDER_SKIP.
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[out] dst A pointer to the destination image
+ * \param[in]  msk A pointer to the mask image
+ */
+void convolveFast(const image_t *src, image_t *dst, const image_t *msk)
+{
+    TRACE_ENTER(src, dst);
+
+    convolveFastBorder(src, dst, msk, BORDER_SKIP, 0.0f);
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Applies a filter mask to an image by convolving the filter mask with
+ *        the original image, with a selectable treatment of the border
+ *
+ * The mask can have any odd number of columns and rows. The source image, the
+ * destination image and the mask must be of the same type: ::IMGTYPE_UINT8,
+ * ::IMGTYPE_INT16 or ::IMGTYPE_FLOAT. Integer results are clipped to the range
+ * of the destination type.
+ *
+ * The interior of the image, where the mask is completely inside the image, is
+ * processed row by row without any bounds checks. Only the border strips of
+ * half the mask size are processed pixel by pixel with the border mode.
+ *
+ * With ::BORDER_CONSTANT and a \p value of 0 the result equals convolve().
+ *
+ * \param[in]  src    A pointer to the source image
+ * \param[out] dst    A pointer to the destination image
+ * \param[in]  msk    A pointer to the mask image
+ * \param[in]  border The border mode, must be of type ::eBorder
+ * \param[in]  value  The value of the pixels outside the image for
+ *                    ::BORDER_CONSTANT
+ */
+void convolveFastBorder(const image_t *src, image_t *dst, const image_t *msk,
+                        const eBorder border, const float value)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(msk == NULL, "msk image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(msk->data == NULL, "msk data is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_INT16) && (src->type != IMGTYPE_FLOAT), "src type is invalid");
+    ASSERT(dst->type != src->type, "dst type is invalid");
+    ASSERT(msk->type != src->type, "msk type is invalid");
+    ASSERT(msk->rows % 2 == 0, "mask rows must be odd");
+    ASSERT(msk->cols % 2 == 0, "mask cols must be odd");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+    ASSERT(IMAGE_STEP(msk) != 1, "msk image can not be a luma view");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+    ASSERT(src == dst, "src and dst are the same images");
+
+    // Verify parameters
+    ASSERT((border != BORDER_SKIP) && (border != BORDER_CONSTANT) &&
+           (border != BORDER_REPLICATE) && (border != BORDER_REFLECT), "border is invalid");
+
+    const int32_t dc = msk->cols / 2;
+    const int32_t dr = msk->rows / 2;
+
+    // The interior
+    int32_t x0 = dc;
+    int32_t x1 = src->cols - dc;
+    int32_t y0 = dr;
+    int32_t y1 = src->rows - dr;
+
+    if ((x1 <= x0) || (y1 <= y0))
+    {
+        // The mask is larger than the image, there is no interior
+        x0 = x1 = y0 = y1 = 0;
+    }
+    else
+    {
+        const int32_t n = x1 - x0;
+
+        image_arena_mark_t mark = markImageArena();
+
+        // Accumulator row, int32_t for the integer types and float otherwise
+        void *acc = allocImageArena(n * sizeof(int32_t));
+
+        if (acc == NULL)
+        {
+            ASSERT(1 == 1, "Unable to allocate memory for the accumulator, increase the size of the image arena");
+            TRACE_EXIT();
+            return;
+        }
+
+        for (int32_t y = y0; y < y1; y++)
+        {
+            // Mask element (i,j) is multiplied with pixel
+            // (x + dc - i, y + dr - j)
+            if ((msk->cols == 3) && (msk->rows == 3))
+            {
+                if (src->type == IMGTYPE_UINT8)
+                {
+                    convolve3x3Uint8((int32_t *)acc,
+                                     (const uint8_pixel_t *)src->data + ((y + 1) * IMAGE_STRIDE(src)) + x0 + 1,
+                                     IMAGE_STRIDE(src), (const uint8_pixel_t *)msk->data, IMAGE_STRIDE(msk), n);
+                }
+                else if (src->type == IMGTYPE_INT16)
+                {
+                    convolve3x3Int16((int32_t *)acc,
+                                     (const int16_pixel_t *)src->data + ((y + 1) * IMAGE_STRIDE(src)) + x0 + 1,
+                                     IMAGE_STRIDE(src), (const int16_pixel_t *)msk->data, IMAGE_STRIDE(msk), n);
+                }
+                else
+                {
+                    convolve3x3Float((float *)acc,
+                                     (const float_pixel_t *)src->data + ((y + 1) * IMAGE_STRIDE(src)) + x0 + 1,
+                                     IMAGE_STRIDE(src), (const float_pixel_t *)msk->data, IMAGE_STRIDE(msk), n);
+                }
+            }
+            else
+            {
+                memset(acc, 0, n * sizeof(int32_t));
+
+                // Add the contribution of every mask row to the whole row
+                for (int32_t j = 0; j < msk->rows; j++)
+                {
+                    const int32_t sy = y + dr - j;
+                    const int32_t sx = x0 + dc;
+
+                    if (src->type == IMGTYPE_UINT8)
+                    {
+                        convolveRowUint8((int32_t *)acc,
+                                         (const uint8_pixel_t *)src->data + (sy * IMAGE_STRIDE(src)) + sx,
+                                         (const uint8_pixel_t *)msk->data + (j * IMAGE_STRIDE(msk)), msk->cols, n);
+                    }
+                    else if (src->type == IMGTYPE_INT16)
+                    {
+                        convolveRowInt16((int32_t *)acc,
+                                         (const int16_pixel_t *)src->data + (sy * IMAGE_STRIDE(src)) + sx,
+                                         (const int16_pixel_t *)msk->data + (j * IMAGE_STRIDE(msk)), msk->cols, n);
+                    }
+                    else
+                    {
+                        convolveRowFloat((float *)acc,
+                                         (const float_pixel_t *)src->data + (sy * IMAGE_STRIDE(src)) + sx,
+                                         (const float_pixel_t *)msk->data + (j * IMAGE_STRIDE(msk)), msk->cols, n);
+                    }
+                }
+            }
+
+            // Clip and store the row
+            if (dst->type == IMGTYPE_UINT8)
+            {
+                const int32_t *a = (const int32_t *)acc;
+                uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst)) + x0;
+
+                for (int32_t x = 0; x < n; x++)
                 {
-                    val = INT16_PIXEL_MAX;
+                    int32_t val = a[x];
+                    val = (val > UINT8_PIXEL_MAX) ? UINT8_PIXEL_MAX : val;
+                    val = (val < UINT8_PIXEL_MIN) ? UINT8_PIXEL_MIN : val;
+                    d[x] = (uint8_pixel_t)val;
                 }
+            }
+            else if (dst->type == IMGTYPE_INT16)
+            {
+                const int32_t *a = (const int32_t *)acc;
+                int16_pixel_t *d = (int16_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst)) + x0;
 
-                if (val < INT16_PIXEL_MIN)
+                for (int32_t x = 0; x < n; x++)
                 {
-                    val = INT16_PIXEL_MIN;
+                    int32_t val = a[x];
+                    val = (val > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : val;
+                    val = (val < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : val;
+                    d[x] = (int16_pixel_t)val;
                 }
-
-                // Store the result
-                setInt16Pixel(dst, x, y, val);
+            }
+            else
+            {
+                memcpy((float_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst)) + x0, acc, n * sizeof(float));
             }
         }
+
+        releaseImageArena(mark);
     }
-    else if (src->type == IMGTYPE_UINT8)
+
+    if (border == BORDER_SKIP)
     {
-        ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
-        ASSERT(msk->type != IMGTYPE_UINT8, "msk type is invalid");
+        TRACE_EXIT();
+        return;
+    }
 
-        // Loop all pixels
-        for (int32_t y = 0; y < src->rows; y++)
+    // The border strips
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        for (int32_t x = 0; x < src->cols; x++)
         {
-            for (int32_t x = 0; x < src->cols; x++)
+            // Skip the interior
+            if ((y >= y0) && (y < y1) && (x == x0))
             {
-                int32_t val = 0;
-                int32_t dr = (msk->rows / 2);
-                int32_t dc = (msk->cols / 2);
+                x = x1 - 1;
+                continue;
+            }
 
-                // Apply the kernel only for pixels within the image
-                for (int32_t j = -dr; j <= dr; j++)
-                {
-                    for (int32_t i = -dc; i <= dc; i++)
-                    {
-                        if (((x - i) >= 0) &&
-                            ((y - j) >= 0) &&
-                            ((x - i) < src->cols) &&
-                            ((y - j) < src->rows))
-                        {
-                            val += getUint8Pixel(src, x - i, y - j) * getUint8Pixel(msk, i + dc, j + dr);
-                        }
-                    }
-                }
+            double val = 0;
 
-                // Clip the result
-                if (val > UINT8_PIXEL_MAX)
-                {
-                    val = UINT8_PIXEL_MAX;
-                }
+            for (int32_t j = 0; j < msk->rows; j++)
+            {
+                const int32_t sy = borderCoordinate(y + dr - j, src->rows, border);
 
-                if (val < UINT8_PIXEL_MIN)
+                for (int32_t i = 0; i < msk->cols; i++)
                 {
-                    val = UINT8_PIXEL_MIN;
-                }
+                    const int32_t sx = borderCoordinate(x + dc - i, src->cols, border);
+                    const double k = getConvolvePixel(msk, i, j);
 
-                // Store the result
-                setUint8Pixel(dst, x, y, val);
+                    if ((sx < 0) || (sy < 0))
+                    {
+                        val += value * k;
+                    }
+                    else
+                    {
+                        val += getConvolvePixel(src, sx, sy) * k;
+                    }
+                }
             }
+
+            setConvolvePixel(dst, x, y, val);
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
- * \brief Applies a filter mask to an image by convolving the filter mask with
- *        the original image
+ * \brief Applies a separable filter mask to an image by convolving the image
+ *        with a row mask and a column mask
  *
- * Assumes a 3x3 mask and ignores the border pixels. Also assumes that all
- * images are of type int16_pixel_t.
+ * The result equals convolve() with the mask m(i,j) = col(0,j) * row(i,0).
+ * For a mask of N x M pixels this costs N + M instead of N * M
+ * multiplications per pixel.
  *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
- * \param[in]  msk A pointer to the mask image
+ * \param[in]  row A pointer to the row mask image, 1 row and an odd number of
+ *                 columns
+ * \param[in]  col A pointer to the column mask image, 1 column and an odd
+ *                 number of rows
  */
-void convolveFast(const image_t *src, image_t *dst, const image_t *msk)
+void convolveSeparable(const image_t *src, image_t *dst, const image_t *row, const image_t *col)
 {
-    int16_pixel_t *src_data = (int16_pixel_t *)src->data;
-    int16_pixel_t *dst_data = (int16_pixel_t *)dst->data;
-    int16_pixel_t *msk_data = (int16_pixel_t *)msk->data;
-
-    int32_t src_cols = src->cols;
-    int32_t src_rows = src->rows;
-
-    // Loop all pixels
-    for (int32_t y = 1; y < (src_rows - 1); y++)
-    {
-        int16_pixel_t *dst_row_ptr = dst_data + (y * src_cols);
+    TRACE_ENTER(src, dst);
 
-        for (int32_t x = 1; x < (src_cols - 1); x++)
-        {
-            int32_t value = 0;
-
-            // x + 1, y + 1
-            value += src_data[((y + 1) * src_cols) + (x + 1)] * msk_data[0];
-
-            // x, y + 1
-            value += src_data[((y + 1) * src_cols) + x] * msk_data[1];
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(row == NULL, "row image is invalid");
+    ASSERT(col == NULL, "col image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(row->data == NULL, "row data is invalid");
+    ASSERT(col->data == NULL, "col data is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_INT16), "src type is invalid");
+    ASSERT(dst->type != src->type, "dst type is invalid");
+    ASSERT(row->type != src->type, "row type is invalid");
+    ASSERT(col->type != src->type, "col type is invalid");
+    ASSERT(row->rows != 1, "row mask must have one row");
+    ASSERT(col->cols != 1, "col mask must have one column");
+    ASSERT(row->cols % 2 == 0, "row mask cols must be odd");
+    ASSERT(col->rows % 2 == 0, "col mask rows must be odd");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+    ASSERT(IMAGE_STEP(row) != 1, "row image can not be a luma view");
+    ASSERT(IMAGE_STEP(col) != 1, "col image can not be a luma view");
 
-            // x - 1, y + 1
-            value += src_data[((y + 1) * src_cols) + (x - 1)] * msk_data[2];
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+    ASSERT(src == dst, "src and dst are the same images");
 
-            // x + 1, y
-            value += src_data[(y * src_cols) + (x + 1)] * msk_data[3];
+    image_arena_mark_t mark = markImageArena();
 
-            // x, y
-            value += src_data[(y * src_cols) + x] * msk_data[4];
+    int32_t *row_data = (int32_t *)allocImageArena((row->cols + col->rows) * sizeof(int32_t));
 
-            // x - 1, y
-            value += src_data[(y * src_cols) + (x - 1)] * msk_data[5];
+    if (row_data == NULL)
+    {
+        ASSERT(1 == 1, "Unable to allocate memory for the mask, increase the size of the image arena");
+        TRACE_EXIT();
+        return;
+    }
 
-            // x + 1, y - 1
-            value += src_data[((y - 1) * src_cols) + (x + 1)] * msk_data[6];
+    int32_t *col_data = row_data + row->cols;
 
-            // x, y - 1
-            value += src_data[((y - 1) * src_cols) + x] * msk_data[7];
+    for (int32_t i = 0; i < row->cols; i++)
+    {
+        row_data[i] = (row->type == IMGTYPE_UINT8) ? getUint8Pixel(row, i, 0) : getInt16Pixel(row, i, 0);
+    }
 
-            // x - 1, y - 1
-            value += src_data[((y - 1) * src_cols) + (x - 1)] * msk_data[8];
+    for (int32_t j = 0; j < col->rows; j++)
+    {
+        col_data[j] = (col->type == IMGTYPE_UINT8) ? getUint8Pixel(col, 0, j) : getInt16Pixel(col, 0, j);
+    }
 
-            // Clip the result
-            if (value > INT16_PIXEL_MAX)
-            {
-                value = INT16_PIXEL_MAX;
-            }
+    if (convolveRowsCols(src, dst, row_data, row->cols, col_data, col->rows) == 0)
+    {
+        ASSERT(1 == 1, "Unable to allocate memory for the row buffer, increase the size of the image arena");
+    }
 
-            if (value < INT16_PIXEL_MIN)
-            {
-                value = INT16_PIXEL_MIN;
-            }
+    releaseImageArena(mark);
 
-            // Store the result
-            dst_row_ptr[x] = (int16_t)value;
-        }
-    }
+    TRACE_EXIT();
 }
 
 /*!
@@ -1982,12 +3824,17 @@ void convolveFast(const image_t *src, image_t *dst, const image_t *msk)
  * is often referred to as the template. The correlation is then called
  * template matching.
  *
+ * Large masks are applied in the frequency domain, with the same tolerance
+ * and conditions as convolve().
+ *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
  * \param[in]  msk A pointer to the mask image
  */
 void correlate(const image_t *src, image_t *dst, const image_t *msk)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -1997,12 +3844,35 @@ void correlate(const image_t *src, image_t *dst, const image_t *msk)
     ASSERT(msk->data == NULL, "msk data is invalid");
     ASSERT(msk->rows % 2 == 0, "mask rows must be odd");
     ASSERT(msk->cols % 2 == 0, "mask cols must be odd");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+    ASSERT(IMAGE_STEP(msk) != 1, "msk image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
     ASSERT(src == dst, "src and dst are the same images");
 
+    // A luma view is filtered through a copy with a pixel step of 1
+    if (IMAGE_STEP(src) != 1)
+    {
+        image_arena_mark_t mark = markImageArena();
+        image_t *tmp = newUint8Image(src->cols, src->rows);
+
+        copyUint8Image(src, tmp);
+        correlate(tmp, dst, msk);
+        releaseImageArena(mark);
+
+        TRACE_EXIT();
+        return;
+    }
+
+    // Apply large masks in the frequency domain
+    if (convolveAuto(src, dst, msk, 1) == 1)
+    {
+        TRACE_EXIT();
+        return;
+    }
+
     if (src->type == IMGTYPE_INT16)
     {
         ASSERT(dst->type != IMGTYPE_INT16, "dst type is invalid");
@@ -2094,6 +3964,139 @@ void correlate(const image_t *src, image_t *dst, const image_t *msk)
             }
         }
     }
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Computes the integral image (summed-area table) of an image
+ *
+ * Pixel (x,y) of the integral image is the sum of all source pixels (i,j)
+ * with i < x and j < y. The integral image therefore has one column and one
+ * row more than the source image, and its first row and column are 0. The sum
+ * of any rectangle in the source image takes four pixel reads, see
+ * getIntegralSum(). This allows box filters, local variance, adaptive
+ * thresholds and Haar-like features in constant time per pixel.
+ *
+ * The sums are computed modulo 2^32. Images with more than 16843009 pixels
+ * (e.g. 4104x4104) can overflow the bottom right pixels, but the sum of a
+ * rectangle is still correct as long as that sum itself fits in 32 bits,
+ * which holds for every rectangle of up to 16843009 pixels.
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[out] dst A pointer to the ::IMGTYPE_UINT32 integral image of
+ *                 (cols + 1) x (rows + 1) pixels
+ */
+void integralImage(const image_t *src, image_t *dst)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_UINT32, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(dst->cols != (src->cols + 1), "dst must have one column more than src");
+    ASSERT(dst->rows != (src->rows + 1), "dst must have one row more than src");
+
+    const int32_t cols = src->cols;
+    const int32_t src_stride = IMAGE_STRIDE(src);
+    const int32_t src_step = IMAGE_STEP(src);
+    const int32_t dst_stride = IMAGE_STRIDE(dst);
+
+    uint32_pixel_t *d = (uint32_pixel_t *)dst->data;
+
+    // The first row is 0
+    memset(d, 0, dst->cols * sizeof(uint32_pixel_t));
+
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        const uint8_pixel_t *s = (const uint8_pixel_t *)src->data + (y * src_stride);
+        const uint32_pixel_t *above = d + (y * dst_stride);
+        uint32_pixel_t *row = d + ((y + 1) * dst_stride);
+
+        uint32_t sum = 0;
+
+        // The first column is 0
+        row[0] = 0;
+
+        for (int32_t x = 0; x < cols; x++)
+        {
+            // Running sum of the row plus the integral of the row above
+            sum += s[x * src_step];
+            row[x + 1] = above[x + 1] + sum;
+        }
+    }
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Computes the integral image of the squared pixels of an image
+ *
+ * Pixel (x,y) of the integral image is the sum of the squares of all source
+ * pixels (i,j) with i < x and j < y. Together with integralImage() this gives
+ * the variance of any rectangle in constant time, see getIntegralSum().
+ *
+ * The sums are computed modulo 2^32. The sum of a rectangle is correct as long
+ * as that sum itself fits in 32 bits, which holds for every rectangle of up to
+ * 66051 pixels (e.g. 257x257).
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[out] dst A pointer to the ::IMGTYPE_UINT32 integral image of
+ *                 (cols + 1) x (rows + 1) pixels
+ */
+void squaredIntegralImage(const image_t *src, image_t *dst)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_UINT32, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(dst->cols != (src->cols + 1), "dst must have one column more than src");
+    ASSERT(dst->rows != (src->rows + 1), "dst must have one row more than src");
+
+    const int32_t cols = src->cols;
+    const int32_t src_stride = IMAGE_STRIDE(src);
+    const int32_t src_step = IMAGE_STEP(src);
+    const int32_t dst_stride = IMAGE_STRIDE(dst);
+
+    uint32_pixel_t *d = (uint32_pixel_t *)dst->data;
+
+    // The first row is 0
+    memset(d, 0, dst->cols * sizeof(uint32_pixel_t));
+
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        const uint8_pixel_t *s = (const uint8_pixel_t *)src->data + (y * src_stride);
+        const uint32_pixel_t *above = d + (y * dst_stride);
+        uint32_pixel_t *row = d + ((y + 1) * dst_stride);
+
+        uint32_t sum = 0;
+
+        // The first column is 0
+        row[0] = 0;
+
+        for (int32_t x = 0; x < cols; x++)
+        {
+            const uint32_t p = s[x * src_step];
+
+            sum += p * p;
+            row[x + 1] = above[x + 1] + sum;
+        }
+    }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -2108,6 +4111,8 @@ void correlate(const image_t *src, image_t *dst, const image_t *msk)
  */
 void scale(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -2115,52 +4120,62 @@ void scale(const image_t *src, image_t *dst)
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
     uint8_pixel_t min = UINT8_PIXEL_MAX, max = UINT8_PIXEL_MIN;
-    uint32_t imsize = src->rows * src->cols;
-    uint8_pixel_t *s = (uint8_pixel_t *)src->data;
+    uint32_t cols = src->cols;
 
     // Scan input image for min/max values
-    for (uint32_t i = 0; i < imsize; ++i)
+    for (int32_t y = 0; y < src->rows; ++y)
     {
-        if (*s < min)
-        {
-            min = *s;
-        }
+        uint8_pixel_t *s = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
 
-        if (*s > max)
+        for (uint32_t i = 0; i < cols; ++i)
         {
-            max = *s;
-        }
+            if (*s < min)
+            {
+                min = *s;
+            }
 
-        ++s;
-    }
+            if (*s > max)
+            {
+                max = *s;
+            }
 
-    // Restore pointers
-    s = (uint8_pixel_t *)src->data;
-    uint8_pixel_t *d = (uint8_pixel_t *)dst->data;
+            ++s;
+        }
+    }
 
-    // Prevent division by zero
-    if (max == min)
+    for (int32_t y = 0; y < src->rows; ++y)
     {
-        // Scale the output to basic image type
-        for (uint32_t i = 0; i < imsize; ++i)
+        uint8_pixel_t *s = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Prevent division by zero
+        if (max == min)
         {
-            *d++ = (uint8_pixel_t)128;
+            // Scale the output to basic image type
+            for (uint32_t i = 0; i < cols; ++i)
+            {
+                *d++ = (uint8_pixel_t)128;
+            }
         }
-    }
-    else
-    {
-        // Scale the output to basic image type
-        for (uint32_t i = 0; i < imsize; ++i)
+        else
         {
-            *d++ = (uint8_pixel_t)((255.0f / (max - min)) * (*s++ - min) + 0.5f);
+            // Scale the output to basic image type
+            for (uint32_t i = 0; i < cols; ++i)
+            {
+                *d++ = (uint8_pixel_t)((255.0f / (max - min)) * (*s++ - min) + 0.5f);
+            }
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -2175,6 +4190,8 @@ void scale(const image_t *src, image_t *dst)
  */
 void scaleInt16ToUint8(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -2182,53 +4199,61 @@ void scaleInt16ToUint8(const image_t *src, image_t *dst)
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
     int16_pixel_t min = INT16_PIXEL_MAX, max = INT16_PIXEL_MIN;
-    uint32_t imsize = src->rows * src->cols;
-
-    int16_pixel_t *s = (int16_pixel_t *)src->data;
+    uint32_t cols = src->cols;
 
     // Scan input image for min/max values
-    for (uint32_t i = 0; i < imsize; ++i)
+    for (int32_t y = 0; y < src->rows; ++y)
     {
-        if (*s < min)
-        {
-            min = *s;
-        }
+        int16_pixel_t *s = (int16_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
 
-        if (*s > max)
+        for (uint32_t i = 0; i < cols; ++i)
         {
-            max = *s;
-        }
+            if (*s < min)
+            {
+                min = *s;
+            }
 
-        ++s;
-    }
+            if (*s > max)
+            {
+                max = *s;
+            }
 
-    // Restore pointers
-    s = (int16_pixel_t *)src->data;
-    uint8_pixel_t *d = (uint8_pixel_t *)dst->data;
+            ++s;
+        }
+    }
 
-    // Prevent division by zero
-    if (max == min)
+    for (int32_t y = 0; y < src->rows; ++y)
     {
-        // Scale the output to basic image type
-        for (uint32_t i = 0; i < imsize; ++i)
+        int16_pixel_t *s = (int16_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Prevent division by zero
+        if (max == min)
         {
-            *d++ = (uint8_pixel_t)128;
+            // Scale the output to basic image type
+            for (uint32_t i = 0; i < cols; ++i)
+            {
+                *d++ = (uint8_pixel_t)128;
+            }
         }
-    }
-    else
-    {
-        // Scale the output to basic image type
-        for (uint32_t i = 0; i < imsize; ++i)
+        else
         {
-            *d++ = (uint8_pixel_t)((255.0f / (max - min)) * (*s++ - min) + 0.5f);
+            // Scale the output to basic image type
+            for (uint32_t i = 0; i < cols; ++i)
+            {
+                *d++ = (uint8_pixel_t)((255.0f / (max - min)) * (*s++ - min) + 0.5f);
+            }
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -2243,6 +4268,8 @@ void scaleInt16ToUint8(const image_t *src, image_t *dst)
  */
 void scaleFloatToUint8(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -2250,53 +4277,61 @@ void scaleFloatToUint8(const image_t *src, image_t *dst)
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
     float_pixel_t min = FLOAT_PIXEL_MAX, max = FLOAT_PIXEL_MIN;
-    uint32_t imsize = src->rows * src->cols;
-
-    float_pixel_t *s = (float_pixel_t *)src->data;
+    uint32_t cols = src->cols;
 
     // Scan input image for min/max values
-    for (uint32_t i = 0; i < imsize; ++i)
+    for (int32_t y = 0; y < src->rows; ++y)
     {
-        if (*s < min)
-        {
-            min = *s;
-        }
+        float_pixel_t *s = (float_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
 
-        if (*s > max)
+        for (uint32_t i = 0; i < cols; ++i)
         {
-            max = *s;
-        }
+            if (*s < min)
+            {
+                min = *s;
+            }
 
-        ++s;
-    }
+            if (*s > max)
+            {
+                max = *s;
+            }
 
-    // Restore pointers
-    s = (float_pixel_t *)src->data;
-    uint8_pixel_t *d = (uint8_pixel_t *)dst->data;
+            ++s;
+        }
+    }
 
-    // Prevent division by zero
-    if (max == min)
+    for (int32_t y = 0; y < src->rows; ++y)
     {
-        // Scale the output to basic image type
-        for (uint32_t i = 0; i < imsize; ++i)
+        float_pixel_t *s = (float_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Prevent division by zero
+        if (max == min)
         {
-            *d++ = (uint8_pixel_t)128;
+            // Scale the output to basic image type
+            for (uint32_t i = 0; i < cols; ++i)
+            {
+                *d++ = (uint8_pixel_t)128;
+            }
         }
-    }
-    else
-    {
-        // Scale the output to basic image type
-        for (uint32_t i = 0; i < imsize; ++i)
+        else
         {
-            *d++ = (uint8_pixel_t)((255.0f / (max - min)) * (*s++ - min) + 0.5f);
+            // Scale the output to basic image type
+            for (uint32_t i = 0; i < cols; ++i)
+            {
+                *d++ = (uint8_pixel_t)((255.0f / (max - min)) * (*s++ - min) + 0.5f);
+            }
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -2312,31 +4347,37 @@ void scaleFloatToUint8(const image_t *src, image_t *dst)
  */
 void scaleFast(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+
     uint8_pixel_t min = UINT8_PIXEL_MAX, max = UINT8_PIXEL_MIN;
-    uint32_t imsize = src->rows * src->cols;
-    uint8_pixel_t *s = (uint8_pixel_t *)src->data;
+    uint32_t cols = src->cols;
 
     uint8_pixel_t LUT[256];
 
     // Scan input image for min/max values
-    for (uint32_t i = 0; i < imsize; ++i)
+    for (int32_t y = 0; y < src->rows; ++y)
     {
-        if (*s < min)
-        {
-            min = *s;
-        }
+        uint8_pixel_t *s = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
 
-        if (*s > max)
+        for (uint32_t i = 0; i < cols; ++i)
         {
-            max = *s;
-        }
+            if (*s < min)
+            {
+                min = *s;
+            }
 
-        ++s;
-    }
+            if (*s > max)
+            {
+                max = *s;
+            }
 
-    // Restore pointers
-    s = (uint8_pixel_t *)src->data;
-    uint8_pixel_t *d = (uint8_pixel_t *)dst->data;
+            ++s;
+        }
+    }
 
     // Prevent division by zero
     if (max == min)
@@ -2373,11 +4414,18 @@ void scaleFast(const image_t *src, image_t *dst)
         LUT[max] = 255;
     }
 
-    for (uint32_t i = 0; i < imsize; ++i)
+    for (int32_t y = 0; y < src->rows; ++y)
     {
-        // p_dst(x,y) = LUT[ p_src(x,y) ]
-        *d++ = LUT[*s++];
+        uint8_pixel_t *s = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        for (uint32_t i = 0; i < cols; ++i)
+        {
+            // p_dst(x,y) = LUT[ p_src(x,y) ]
+            *d++ = LUT[*s++];
+        }
     }
 
+    TRACE_EXIT();
     return;
 }
@@ -44,8 +44,81 @@ extern "C" {
 
 #include "image.h"
 
+/*!
+ * \brief Size in bytes of the default image arena
+ *
+ * All images are allocated from a single arena. If the application does not
+ * provide memory for the arena by calling initImageArena(), a buffer of
+ * IMAGE_ARENA_SIZE bytes is allocated from the heap once, when the first image
+ * is created. The value can be overridden with a compiler definition. On the
+ * host it can also be set at run time with the environment variable
+ * EVDK_IMAGE_ARENA_SIZE, in bytes or with a K, M or G suffix.
+ */
+#ifndef IMAGE_ARENA_SIZE
+#ifdef MCUXPRESSO_SDK
+#define IMAGE_ARENA_SIZE (256 * 1024)
+#else
+#define IMAGE_ARENA_SIZE (256 * 1024 * 1024)
+#endif
+#endif
+
+/*!
+ * \brief Smallest mask, in cells, for which convolve() and correlate() may
+ *        switch to the frequency domain
+ *
+ * For masks of at least this size, the cost of the direct method is compared
+ * with the cost of an overlap-save convolution with real FFTs of blocks of up
+ * to CONVOLVE_FFT_MAX_BLOCK x CONVOLVE_FFT_MAX_BLOCK pixels, and the cheaper
+ * method is used. CONVOLVE_DIRECT_COST is the cost of one multiply-add of the
+ * direct method and CONVOLVE_FFT_COST the cost per pixel of a block, which
+ * includes the forward FFT, the multiplication with the spectrum of the mask
+ * and the inverse FFT. Set CONVOLVE_FFT_MIN_CELLS to INT32_MAX to always use
+ * the direct method.
+ *
+ * The costs were measured on the benchmark host. Masks of fewer than 9x9
+ * cells always use the direct method on every target, so the results of small
+ * masks such as those of gaussianFilter_5x5() are exact and the same on the
+ * host and the MCU.
+ */
+#ifndef CONVOLVE_FFT_MIN_CELLS
+#define CONVOLVE_FFT_MIN_CELLS (9 * 9)
+#endif
+
+/// Largest block size of the frequency domain path of convolve() and
+/// correlate(). The blocks are allocated in the image arena.
+#ifndef CONVOLVE_FFT_MAX_BLOCK
+#ifdef MCUXPRESSO_SDK
+#define CONVOLVE_FFT_MAX_BLOCK (64)
+#else
+#define CONVOLVE_FFT_MAX_BLOCK (256)
+#endif
+#endif
+
+/// Relative cost of a multiply-add of the direct method, see
+/// CONVOLVE_FFT_MIN_CELLS
+#ifndef CONVOLVE_DIRECT_COST
+#define CONVOLVE_DIRECT_COST (1.0f)
+#endif
+
+/// Relative cost per block pixel of the frequency domain method, see
+/// CONVOLVE_FFT_MIN_CELLS. Per pixel, the FFTs of blocks of 32 x 32 up to
+/// 256 x 256 pixels take about the same time as seven multiply-adds of the
+/// direct method.
+#ifndef CONVOLVE_FFT_COST
+#define CONVOLVE_FFT_COST (7.0f)
+#endif
+
 // Functions are documented in the source file
 
+/// \name Functions for the image arena
+/// \{
+void initImageArena(uint8_t *buffer, const size_t size);
+image_arena_mark_t markImageArena(void);
+void releaseImageArena(const image_arena_mark_t mark);
+void *allocImageArena(const size_t size);
+size_t getImageArenaUsage(void);
+/// \}
+
 /// \name Functions for creating new images
 /// \{
 image_t *newUint8Image(const uint32_t cols, const uint32_t rows);
@@ -54,6 +127,9 @@ image_t *newInt32Image(const uint32_t cols, const uint32_t rows);
 image_t *newFloatImage(const uint32_t cols, const uint32_t rows);
 image_t *newUyvyImage(const uint32_t cols, const uint32_t rows);
 image_t *newBgr888Image(const uint32_t cols, const uint32_t rows);
+image_t *newUint32Image(const uint32_t cols, const uint32_t rows);
+image_t *newBinaryImage(const uint32_t cols, const uint32_t rows);
+image_t *newComplexImage(const uint32_t cols, const uint32_t rows);
 /// \}
 
 /// \name Functions for creating new images without data allocation
@@ -64,6 +140,18 @@ image_t *newEmptyInt32Image(const uint32_t cols, const uint32_t rows);
 image_t *newEmptyFloatImage(const uint32_t cols, const uint32_t rows);
 image_t *newEmptyUyvyImage(const uint32_t cols, const uint32_t rows);
 image_t *newEmptyBgr888Image(const uint32_t cols, const uint32_t rows);
+image_t *newEmptyUint32Image(const uint32_t cols, const uint32_t rows);
+/// \}
+
+/// \name Functions for creating new aligned images
+/// \{
+image_t *newAlignedImage(const uint32_t cols, const uint32_t rows, const eImageType type, const uint32_t alignment);
+/// \}
+
+/// \name Functions for creating image views
+/// \{
+void roiImage(const image_t *src, image_t *roi, const int32_t x, const int32_t y, const int32_t cols, const int32_t rows);
+void lumaView(const image_t *src, image_t *luma);
 /// \}
 
 /// \name Functions for deleting images
@@ -74,6 +162,9 @@ void deleteInt32Image(image_t *img);
 void deleteFloatImage(image_t *img);
 void deleteUyvyImage(image_t *img);
 void deleteBgr888Image(image_t *img);
+void deleteUint32Image(image_t *img);
+void deleteBinaryImage(image_t *img);
+void deleteComplexImage(image_t *img);
 void deleteAllImages(void);
 /// \}
 
@@ -85,6 +176,8 @@ void copyInt32Image(const image_t *src, image_t *dst);
 void copyFloatImage(const image_t *src, image_t *dst);
 void copyUyvyImage(const image_t *src, image_t *dst);
 void copyBgr888Image(const image_t *src, image_t *dst);
+void copyUint32Image(const image_t *src, image_t *dst);
+void copyBinaryImage(const image_t *src, image_t *dst);
 /// \}
 
 /// \name Functions for clearing images
@@ -93,29 +186,192 @@ void clearUint8Image(image_t *img);
 void clearInt16Image(image_t *img);
 void clearInt32Image(image_t *img);
 void clearFloatImage(image_t *img);
+void clearUint32Image(image_t *img);
+void clearBinaryImage(image_t *img);
 
 extern void clearUint8Image_cm33(const image_t *img);
 /// \}
 
 /// \name Getter functions for individual pixels
 /// \{
-extern uint8_pixel_t getUint8Pixel(const image_t *img, const int32_t c, const int32_t r);
-extern int16_pixel_t getInt16Pixel(const image_t *img, const int32_t c, const int32_t r);
-extern int32_pixel_t getInt32Pixel(const image_t *img, const int32_t c, const int32_t r);
-extern float_pixel_t getFloatPixel(const image_t *img, const int32_t c, const int32_t r);
-extern uyvy_pixel_t getUyvyPixel(const image_t *img, const int32_t c, const int32_t r);
-extern bgr888_pixel_t getBgr888Pixel(const image_t *img, const int32_t c, const int32_t r);
 
+/*!
+ * \brief Getter functions for individual pixels
+ *
+ * The getters are defined inline, so every translation unit can inline them
+ * and a pixel access does not require a function call. Inside loops, prefer
+ * walking a row pointer over calling these functions per pixel.
+ *
+ * \param[in] img A pointer to the image
+ * \param[in] c   Column (x) coordinate of the pixel
+ * \param[in] r   Row (y) coordinate of the pixel
+ *
+ * \return Pixel value at coordinate (c,r)
+ */
+
+inline uint8_pixel_t getUint8Pixel(const image_t *img, const int32_t c, const int32_t r)
+{
+    return (*((uint8_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)));
+}
+
+/*!
+ * \brief Getter for a ::IMGTYPE_UINT8 image with a pixel step, such as a
+ *        lumaView()
+ *
+ * getUint8Pixel() assumes a pixel step of 1, so it does not load the step of
+ * the image. This getter honours ::IMAGE_STEP and works on any
+ * ::IMGTYPE_UINT8 image.
+ */
+inline uint8_pixel_t getUint8PixelStrided(const image_t *img, const int32_t c, const int32_t r)
+{
+    return (*((uint8_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + (c * IMAGE_STEP(img)))));
+}
+
+inline int16_pixel_t getInt16Pixel(const image_t *img, const int32_t c, const int32_t r)
+{
+    return (*((int16_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)));
+}
+
+inline int32_pixel_t getInt32Pixel(const image_t *img, const int32_t c, const int32_t r)
+{
+    return (*((int32_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)));
+}
+
+inline float_pixel_t getFloatPixel(const image_t *img, const int32_t c, const int32_t r)
+{
+    return (*((float_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)));
+}
+
+inline uyvy_pixel_t getUyvyPixel(const image_t *img, const int32_t c, const int32_t r)
+{
+    return (*((uyvy_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)));
+}
+
+inline bgr888_pixel_t getBgr888Pixel(const image_t *img, const int32_t c, const int32_t r)
+{
+    return (*((bgr888_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)));
+}
+
+inline uint32_pixel_t getUint32Pixel(const image_t *img, const int32_t c, const int32_t r)
+{
+    return (*((uint32_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)));
+}
+
+inline uint8_pixel_t getBinaryPixel(const image_t *img, const int32_t c, const int32_t r)
+{
+    const binary_word_t *w = (binary_word_t *)(img->data) + ((r * IMAGE_STRIDE(img) + c) / BINARY_WORD_BITS);
+
+    return (uint8_pixel_t)((*w >> (c % BINARY_WORD_BITS)) & 1);
+}
+
+inline complex_pixel_t getComplexPixel(const image_t *img, const int32_t c, const int32_t r)
+{
+    return (*((complex_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)));
+}
 /// \}
 
 /// \name Setter functions for individual pixels
 /// \{
-extern void setUint8Pixel(const image_t *img, const int32_t c, const int32_t r, uint8_pixel_t const value);
-extern void setInt16Pixel(const image_t *img, const int32_t c, const int32_t r, int16_pixel_t const value);
-extern void setInt32Pixel(const image_t *img, const int32_t c, const int32_t r, int32_pixel_t const value);
-extern void setFloatPixel(const image_t *img, const int32_t c, const int32_t r, float_pixel_t const value);
-extern void setUyvyPixel(const image_t *img, const int32_t c, const int32_t r, const uyvy_pixel_t value);
-extern void setBgr888Pixel(const image_t *img, const int32_t c, const int32_t r, const bgr888_pixel_t value);
+
+/*!
+ * \brief Setter functions for individual pixels
+ *
+ * The setters are defined inline, so every translation unit can inline them
+ * and a pixel access does not require a function call.
+ *
+ * \param[in] img   A pointer to the image
+ * \param[in] c     Column (x) coordinate of the pixel
+ * \param[in] r     Row (y) coordinate of the pixel
+ * \param[in] value New pixel value for coordinate (c,r)
+ */
+
+inline void setUint8Pixel(const image_t *img, const int32_t c, const int32_t r, const uint8_pixel_t value)
+{
+    *((uint8_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)) = value;
+}
+
+/*!
+ * \brief Setter for a ::IMGTYPE_UINT8 image with a pixel step, such as a
+ *        lumaView()
+ *
+ * setUint8Pixel() assumes a pixel step of 1, so it does not load the step of
+ * the image. This setter honours ::IMAGE_STEP and works on any
+ * ::IMGTYPE_UINT8 image.
+ */
+inline void setUint8PixelStrided(const image_t *img, const int32_t c, const int32_t r, const uint8_pixel_t value)
+{
+    *((uint8_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + (c * IMAGE_STEP(img)))) = value;
+}
+
+inline void setInt16Pixel(const image_t *img, const int32_t c, const int32_t r, const int16_pixel_t value)
+{
+    *((int16_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)) = value;
+}
+
+inline void setInt32Pixel(const image_t *img, const int32_t c, const int32_t r, const int32_pixel_t value)
+{
+    *((int32_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)) = value;
+}
+
+inline void setFloatPixel(const image_t *img, const int32_t c, const int32_t r, const float_pixel_t value)
+{
+    *((float_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)) = value;
+}
+
+inline void setUyvyPixel(const image_t *img, const int32_t c, const int32_t r, const uyvy_pixel_t value)
+{
+    *((uyvy_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)) = value;
+}
+
+inline void setBgr888Pixel(const image_t *img, const int32_t c, const int32_t r, const bgr888_pixel_t value)
+{
+    *((bgr888_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)) = value;
+}
+
+inline void setUint32Pixel(const image_t *img, const int32_t c, const int32_t r, const uint32_pixel_t value)
+{
+    *((uint32_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)) = value;
+}
+
+inline void setBinaryPixel(const image_t *img, const int32_t c, const int32_t r, const uint8_pixel_t value)
+{
+    binary_word_t *w = (binary_word_t *)(img->data) + ((r * IMAGE_STRIDE(img) + c) / BINARY_WORD_BITS);
+    const binary_word_t bit = (binary_word_t)1 << (c % BINARY_WORD_BITS);
+
+    *w = (value != 0) ? (*w | bit) : (*w & ~bit);
+}
+
+inline void setComplexPixel(const image_t *img, const int32_t c, const int32_t r, const complex_pixel_t value)
+{
+    *((complex_pixel_t *)(img->data) + (r * IMAGE_STRIDE(img) + c)) = value;
+}
+/// \}
+
+/// \name Functions for integral images
+/// \{
+
+/*!
+ * \brief Returns the sum of the source pixels in a rectangle from an
+ *        integral image, see integralImage()
+ *
+ * The rectangle includes columns \p x0 up to \p x1 and rows \p y0 up to
+ * \p y1, excluding \p x1 and \p y1.
+ *
+ * \param[in] ii A pointer to the integral image
+ * \param[in] x0 First column of the rectangle
+ * \param[in] y0 First row of the rectangle
+ * \param[in] x1 Column after the last column of the rectangle
+ * \param[in] y1 Row after the last row of the rectangle
+ *
+ * \return The sum of the pixels
+ */
+inline uint32_t getIntegralSum(const image_t *ii, const int32_t x0, const int32_t y0, const int32_t x1, const int32_t y1)
+{
+    const uint32_pixel_t *top = (const uint32_pixel_t *)ii->data + (y0 * IMAGE_STRIDE(ii));
+    const uint32_pixel_t *bottom = (const uint32_pixel_t *)ii->data + (y1 * IMAGE_STRIDE(ii));
+
+    return (bottom[x1] - bottom[x0]) - (top[x1] - top[x0]);
+}
 /// \}
 
 /// \name Conversion functions between image types
@@ -124,9 +380,12 @@ void convertUyvyToUint8(image_t *src, image_t *dst);
 void convertUyvyToInt16(image_t *src, image_t *dst);
 void convertUint8ToUyvy(image_t *src, image_t *dst);
 void convertUyvyToBgr888(image_t *src, image_t *dst);
+void convertUyvyToBgr888Fast(const image_t *src, image_t *dst, const eYuvMatrix matrix, const eYuvRange range);
 void convertUint8ToBgr888(image_t *src, image_t *dst);
 void convertBgr888ToUint8(image_t *src, image_t *dst);
 void convertBgr888ToInt16(image_t *src, image_t *dst);
+void convertUint8ToBinary(const image_t *src, image_t *dst);
+void convertBinaryToUint8(const image_t *src, image_t *dst);
 
 extern void convertUyvyToUint8_cm33(image_t *src, image_t *dst);
 /// \}
@@ -149,7 +408,11 @@ void scaleFloatToUint8(const image_t *src ,image_t *dst);
 void scaleFast(const image_t *src, image_t *dst);
 void convolve(const image_t *src, image_t *dst, const image_t *msk);
 void convolveFast(const image_t *src, image_t *dst, const image_t *msk);
+void convolveFastBorder(const image_t *src, image_t *dst, const image_t *msk, const eBorder border, const float value);
+void convolveSeparable(const image_t *src, image_t *dst, const image_t *row, const image_t *col);
 void correlate(const image_t *src, image_t *dst, const image_t *msk);
+void integralImage(const image_t *src, image_t *dst);
+void squaredIntegralImage(const image_t *src, image_t *dst);
 
 #endif // _IMAGE_FUNDAMENTALS_H_
 
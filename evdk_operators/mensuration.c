@@ -41,6 +41,7 @@
  *****************************************************************************/
 #include "image_fundamentals.h"
 #include "mensuration.h"
+#include "trace.h"
 #include "morphological_filters.h"
 
 #include <math.h>
@@ -67,25 +68,33 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
  */
 void area(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
 {
+    TRACE_ENTER(img, NULL);
+
     // Verify image validity
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
+    ASSERT(IMAGE_STEP(img) != 1, "img image can not be a luma view");
 
-    uint32_t imsize = img->rows * img->cols;
-    uint8_pixel_t *p = (uint8_pixel_t *)img->data;
     uint32_t cnt = 0;
 
     // Scan input image for blobnr
-    for (uint32_t i = 0; i < imsize; ++i)
+    for (int32_t y = 0; y < img->rows; ++y)
     {
-        if (*p++ == blobnr)
+        uint8_pixel_t *p = (uint8_pixel_t *)img->data + (y * IMAGE_STRIDE(img));
+
+        for (int32_t x = 0; x < img->cols; ++x)
         {
-            ++cnt;
+            if (*p++ == blobnr)
+            {
+                ++cnt;
+            }
         }
     }
 
     // Set the result
     blobinfo->area = cnt;
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -101,9 +110,12 @@ void area(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
  */
 void centroid(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
 {
+    TRACE_ENTER(img, NULL);
+
     // Verify image validity
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
+    ASSERT(IMAGE_STEP(img) != 1, "img image can not be a luma view");
 
     uint32_t cnt = 0;
     uint32_t xc = 0.0f;
@@ -113,9 +125,11 @@ void centroid(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
     // Pass through from left top to right bottom
     for (int32_t y = 0; y < img->rows; y++)
     {
+        const uint8_pixel_t *row = (const uint8_pixel_t *)img->data + (y * IMAGE_STRIDE(img));
+
         for (int32_t x = 0; x < img->cols; x++)
         {
-            uint8_pixel_t p = getUint8Pixel(img, x, y);
+            uint8_pixel_t p = row[x];
 
             if (p == blobnr)
             {
@@ -138,6 +152,8 @@ void centroid(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
         blobinfo->centroid.x = (int32_t)((xc / cnt) + 1);
         blobinfo->centroid.y = (int32_t)((yc / cnt) + 1);
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -157,6 +173,8 @@ void centroid(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
  */
 uint32_t labelIterative(const image_t *src, image_t *dst, const eConnected connected)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -164,24 +182,37 @@ uint32_t labelIterative(const image_t *src, image_t *dst, const eConnected conne
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     register int32_t blobcnt = 1;
     register uint32_t changed = 0;
 
+    // Create temporary image in the image arena
+    image_arena_mark_t mark = markImageArena();
+
     image_t *cnt = newInt32Image(src->cols, src->rows);
 
     if (cnt == NULL)
     {
+        TRACE_EXIT();
         return 0;
     }
 
+    int32_pixel_t *cnt_data = (int32_pixel_t *)cnt->data;
+    const int32_t stride = IMAGE_STRIDE(cnt);
+
+    // The source image can be a luma view
+    const int32_t src_step = IMAGE_STEP(src);
+
     // Assign numbers in ascending order from left-top to right-bottom
     for (int32_t r = 0; r < src->rows; r++)
     {
+        const uint8_pixel_t *s = (const uint8_pixel_t *)src->data + (r * IMAGE_STRIDE(src));
+        int32_pixel_t *row = cnt_data + (r * stride);
+
         for (int32_t c = 0; c < src->cols; c++)
         {
-            uint8_pixel_t pixel = getUint8Pixel(src, c, r);
-            setInt32Pixel(cnt, c, r, (pixel == 1) ? blobcnt++ : 0);
+            row[c] = (s[c * src_step] == 1) ? blobcnt++ : 0;
         }
     }
 
@@ -192,9 +223,11 @@ uint32_t labelIterative(const image_t *src, image_t *dst, const eConnected conne
         // Pass through from left top to right bottom
         for (int32_t r = 0; r < cnt->rows; r++)
         {
+            int32_pixel_t *row = cnt_data + (r * stride);
+
             for (int32_t c = 0; c < cnt->cols; c++)
             {
-                int32_pixel_t pixel = getInt32Pixel(cnt, c, r);
+                int32_pixel_t pixel = row[c];
 
                 // Is this an object pixel?
                 if (pixel != 0)
@@ -208,11 +241,11 @@ uint32_t labelIterative(const image_t *src, image_t *dst, const eConnected conne
                     // +-+-+-+
                     if (r > 0)
                     {
-                        int32_pixel_t neighbour = getInt32Pixel(cnt, (c), (r - 1));
+                        int32_pixel_t neighbour = row[c - stride];
 
                         if ((neighbour != 0) && (neighbour < pixel))
                         {
-                            setInt32Pixel(cnt, c, r, neighbour);
+                            row[c] = neighbour;
                             changed = 1;
                         }
                     }
@@ -226,11 +259,11 @@ uint32_t labelIterative(const image_t *src, image_t *dst, const eConnected conne
                     // +-+-+-+
                     if (c > 0)
                     {
-                        int32_pixel_t neighbour = getInt32Pixel(cnt, (c - 1), (r));
+                        int32_pixel_t neighbour = row[c - 1];
 
                         if ((neighbour != 0) && (neighbour < pixel))
                         {
-                            setInt32Pixel(cnt, c, r, neighbour);
+                            row[c] = neighbour;
                             changed = 1;
                         }
                     }
@@ -244,11 +277,11 @@ uint32_t labelIterative(const image_t *src, image_t *dst, const eConnected conne
                     // +-+-+-+
                     if (c < (cnt->cols - 1))
                     {
-                        int32_pixel_t neighbour = getInt32Pixel(cnt, (c + 1), (r));
+                        int32_pixel_t neighbour = row[c + 1];
 
                         if ((neighbour != 0) && (neighbour < pixel))
                         {
-                            setInt32Pixel(cnt, c, r, neighbour);
+                            row[c] = neighbour;
                             changed = 1;
                         }
                     }
@@ -262,11 +295,11 @@ uint32_t labelIterative(const image_t *src, image_t *dst, const eConnected conne
                     // +-+-+-+
                     if (r < (cnt->rows - 1))
                     {
-                        int32_pixel_t neighbour = getInt32Pixel(cnt, (c), (r + 1));
+                        int32_pixel_t neighbour = row[c + stride];
 
                         if ((neighbour != 0) && (neighbour < pixel))
                         {
-                            setInt32Pixel(cnt, c, r, neighbour);
+                            row[c] = neighbour;
                             changed = 1;
                         }
                     }
@@ -282,11 +315,11 @@ uint32_t labelIterative(const image_t *src, image_t *dst, const eConnected conne
                         // +-+-+-+
                         if ((c > 0) && (r > 0))
                         {
-                            int32_pixel_t neighbour = getInt32Pixel(cnt, (c - 1), (r - 1));
+                            int32_pixel_t neighbour = row[c - stride - 1];
 
                             if ((neighbour != 0) && (neighbour < pixel))
                             {
-                                setInt32Pixel(cnt, c, r, neighbour);
+                                row[c] = neighbour;
                                 changed = 1;
                             }
                         }
@@ -300,11 +333,11 @@ uint32_t labelIterative(const image_t *src, image_t *dst, const eConnected conne
                         // +-+-+-+
                         if ((c < (cnt->cols - 1)) && (r > 0))
                         {
-                            int32_pixel_t neighbour = getInt32Pixel(cnt, (c + 1), (r - 1));
+                            int32_pixel_t neighbour = row[c - stride + 1];
 
                             if ((neighbour != 0) && (neighbour < pixel))
                             {
-                                setInt32Pixel(cnt, c, r, neighbour);
+                                row[c] = neighbour;
                                 changed = 1;
                             }
                         }
@@ -318,11 +351,11 @@ uint32_t labelIterative(const image_t *src, image_t *dst, const eConnected conne
                         // +-+-+-+
                         if ((c > 0) && (r < (cnt->rows - 1)))
                         {
-                            int32_pixel_t neighbour = getInt32Pixel(cnt, (c - 1), (r + 1));
+                            int32_pixel_t neighbour = row[c + stride - 1];
 
                             if ((neighbour != 0) && (neighbour < pixel))
                             {
-                                setInt32Pixel(cnt, c, r, neighbour);
+                                row[c] = neighbour;
                                 changed = 1;
                             }
                         }
@@ -336,11 +369,11 @@ uint32_t labelIterative(const image_t *src, image_t *dst, const eConnected conne
                         // +-+-+-+
                         if ((c < (cnt->cols - 1)) && (r < (cnt->rows - 1)))
                         {
-                            int32_pixel_t neighbour = getInt32Pixel(cnt, (c + 1), (r + 1));
+                            int32_pixel_t neighbour = row[c + stride + 1];
 
                             if ((neighbour != 0) && (neighbour < pixel))
                             {
-                                setInt32Pixel(cnt, c, r, neighbour);
+                                row[c] = neighbour;
                                 changed = 1;
                             }
                         }
@@ -356,20 +389,24 @@ uint32_t labelIterative(const image_t *src, image_t *dst, const eConnected conne
     // Pass through from left top to right bottom
     for (int32_t r = 0; r < cnt->rows; r++)
     {
+        int32_pixel_t *row = cnt_data + (r * stride);
+
         for (int32_t c = 0; c < cnt->cols; c++)
         {
-            int32_pixel_t pixel = getInt32Pixel(cnt, c, r);
+            int32_pixel_t pixel = row[c];
 
             if ((pixel != 0) && (pixel >= blobcnt))
             {
                 // Set selected to value
                 for (int32_t rr = 0; rr < cnt->rows; rr++)
                 {
+                    int32_pixel_t *sel = cnt_data + (rr * stride);
+
                     for (int32_t cc = 0; cc < cnt->cols; cc++)
                     {
-                        if (getInt32Pixel(cnt, cc, rr) == pixel)
+                        if (sel[cc] == pixel)
                         {
-                            setInt32Pixel(cnt, cc, rr, blobcnt);
+                            sel[cc] = blobcnt;
                         }
                     }
                 }
@@ -382,16 +419,19 @@ uint32_t labelIterative(const image_t *src, image_t *dst, const eConnected conne
     // Copy result
     for (int32_t r = 0; r < src->rows; r++)
     {
+        const int32_pixel_t *row = cnt_data + (r * stride);
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (r * IMAGE_STRIDE(dst));
+
         for (int32_t c = 0; c < src->cols; c++)
         {
-            int32_pixel_t pixel = getInt32Pixel(cnt, c, r);
-            setUint8Pixel(dst, c, r, (uint8_pixel_t)(pixel % 255));
+            d[c] = (uint8_pixel_t)(row[c] % 255);
         }
     }
 
     // Cleanup
-    deleteInt32Image(cnt);
+    releaseImageArena(mark);
 
+    TRACE_EXIT();
     return (blobcnt - 1);
 }
 
@@ -421,10 +461,19 @@ uint32_t labelIterative(const image_t *src, image_t *dst, const eConnected conne
 uint32_t labelTwoPass(const image_t *src, image_t *dst,
                       const eConnected connected, const uint32_t lutSize)
 {
-    uint32_t *lut = (uint32_t *)malloc(lutSize * sizeof(uint32_t));
+    TRACE_ENTER(src, dst);
+
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+
+    // Allocate the lookup table in the image arena
+    image_arena_mark_t mark = markImageArena();
+
+    uint32_t *lut = (uint32_t *)allocImageArena(lutSize * sizeof(uint32_t));
 
     if (lut == NULL)
     {
+        TRACE_EXIT();
         return 0;
     }
 
@@ -432,12 +481,18 @@ uint32_t labelTwoPass(const image_t *src, image_t *dst,
 
     uint32_t nextLabel = 1;
 
+    // Both images can be views with a different stride, the source image can
+    // also be a luma view
+    const uint32_t src_stride = IMAGE_STRIDE(src);
+    const uint32_t src_step = IMAGE_STEP(src);
+    const uint32_t dst_stride = IMAGE_STRIDE(dst);
+
     // clear the border pixels
     for (uint32_t y = 0; y < src->rows; y++)
     {
         for (uint32_t x = 0; x < src->cols; x++)
         {
-            uint32_t idx = y * src->cols + x;
+            uint32_t idx = y * dst_stride + x;
 
             // if on border
             if (x == 0 || x == src->cols - 1 || y == 0 || y == src->rows - 1)
@@ -452,17 +507,17 @@ uint32_t labelTwoPass(const image_t *src, image_t *dst,
     {
         for (int32_t x = 1; x < src->cols - 1; x++)
         {
-            uint32_t idx = y * src->cols + x;
+            uint32_t idx = y * dst_stride + x;
 
             // if object
-            if (src->data[idx] != 0)
+            if (src->data[y * src_stride + x * src_step] != 0)
             {
                 /*
                     1 1 1
                     1 0 0
                     0 0 0
                 */
-                uint32_t n = dst->data[idx - src->cols];
+                uint32_t n = dst->data[idx - dst_stride];
                 uint32_t w = dst->data[idx - 1];
                 uint32_t nw = 0;
                 uint32_t ne = 0;
@@ -470,8 +525,8 @@ uint32_t labelTwoPass(const image_t *src, image_t *dst,
                 // Alleen diagonalen meenemen als we 8-connected gebruiken
                 if (connected == CONNECTED_EIGHT)
                 {
-                    nw = dst->data[idx - src->cols - 1];
-                    ne = dst->data[idx - src->cols + 1];
+                    nw = dst->data[idx - dst_stride - 1];
+                    ne = dst->data[idx - dst_stride + 1];
                 }
 
                 // if neighbours labelled
@@ -528,7 +583,8 @@ uint32_t labelTwoPass(const image_t *src, image_t *dst,
                 {
                     if (nextLabel >= lutSize)
                     {
-                        free(lut);
+                        releaseImageArena(mark);
+                        TRACE_EXIT();
                         return 0; // Lookup table is too small
                     }
 
@@ -571,7 +627,7 @@ uint32_t labelTwoPass(const image_t *src, image_t *dst,
     {
         for (uint32_t x = 0; x < dst->cols; x++)
         {
-            uint32_t idx = y * dst->cols + x;
+            uint32_t idx = y * dst_stride + x;
             uint32_t currentLabel = dst->data[idx];
 
             if (currentLabel != 0)
@@ -581,7 +637,9 @@ uint32_t labelTwoPass(const image_t *src, image_t *dst,
         }
     }
 
-    free(lut);
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -599,6 +657,8 @@ uint32_t labelTwoPass(const image_t *src, image_t *dst,
  */
 void circularity(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
 {
+    TRACE_ENTER(img, NULL);
+
     if (blobinfo->area == 0)
     {
         area(img, blobinfo, blobnr);
@@ -611,6 +671,8 @@ void circularity(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr
 
     blobinfo->circularity = 4 * 3.14159f *
                             (blobinfo->area / (blobinfo->perimeter * blobinfo->perimeter));
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -630,10 +692,13 @@ void circularity(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr
  */
 void huInvariantMoments(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
 {
+    TRACE_ENTER(img, NULL);
+
     // Verify image validity
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_UINT8, "img type is invalid");
+    ASSERT(IMAGE_STEP(img) != 1, "img image can not be a luma view");
 
     // Verify BLOB info validity
     ASSERT(blobinfo == NULL, "blobinfo is invalid");
@@ -654,6 +719,8 @@ void huInvariantMoments(const image_t *img, blobinfo_t *blobinfo, const uint32_t
     // blobinfo->hu_moments[3] = powf(ncm_30 + ncm_12, 2) + powf(ncm_21 + ncm_03, 2);
 
     // Add more Hu invariant moments here if required by the application
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -678,6 +745,7 @@ float ncm(const image_t *img, const uint8_t blobnr, const int32_t p, const int32
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_UINT8, "img type is invalid");
+    ASSERT(IMAGE_STEP(img) != 1, "img image can not be a luma view");
 
     if ((p == 0) && (q == 0))
     {
@@ -700,8 +768,10 @@ float ncm(const image_t *img, const uint8_t blobnr, const int32_t p, const int32
     // Calculate moments m00, m10 and m01
     for (r = (img->rows - 1); r >= 0; r--)
     {
+        const uint8_pixel_t *row = (const uint8_pixel_t *)img->data + (r * IMAGE_STRIDE(img));
+
         for (c = (img->cols - 1); c >= 0; c--)
-            if (getUint8Pixel(img, c, r) == blobnr)
+            if (row[c] == blobnr)
             {
                 m00 += 1.0f;
                 m10 += c;
@@ -719,9 +789,11 @@ float ncm(const image_t *img, const uint8_t blobnr, const int32_t p, const int32
     {
         for (r = (img->rows - 1); r >= 0; r--)
         {
+            const uint8_pixel_t *row = (const uint8_pixel_t *)img->data + (r * IMAGE_STRIDE(img));
+
             for (c = (img->cols - 1); c >= 0; c--)
             {
-                if (getUint8Pixel(img, c, r) == blobnr)
+                if (row[c] == blobnr)
                 {
                     upq += powf((float)(r - rc), (float)q);
                 }
@@ -734,9 +806,11 @@ float ncm(const image_t *img, const uint8_t blobnr, const int32_t p, const int32
     {
         for (r = (img->rows - 1); r >= 0; r--)
         {
+            const uint8_pixel_t *row = (const uint8_pixel_t *)img->data + (r * IMAGE_STRIDE(img));
+
             for (c = (img->cols - 1); c >= 0; c--)
             {
-                if (getUint8Pixel(img, c, r) == blobnr)
+                if (row[c] == blobnr)
                 {
                     upq += powf((float)(c - cc), (float)p);
                 }
@@ -748,9 +822,11 @@ float ncm(const image_t *img, const uint8_t blobnr, const int32_t p, const int32
         // ... or when p!=0 and q!=0
         for (r = (img->rows - 1); r >= 0; r--)
         {
+            const uint8_pixel_t *row = (const uint8_pixel_t *)img->data + (r * IMAGE_STRIDE(img));
+
             for (c = (img->cols - 1); c >= 0; c--)
             {
-                if (getUint8Pixel(img, c, r) == blobnr)
+                if (row[c] == blobnr)
                 {
                     upq += powf((float)(c - cc), (float)p) *
                            powf((float)(r - rc), (float)q);
@@ -767,7 +843,7 @@ static inline uint32_t get_pixel(const image_t *img, int x, int y)
 {
     if (x < 0 || y < 0 || x >= (int)img->cols || y >= (int)img->rows)
         return 0; // buiten beeld = achtergrond
-    return img->data[y * img->cols + x];
+    return img->data[y * IMAGE_STRIDE(img) + x];
 }
 
 /*!
@@ -791,8 +867,15 @@ static inline uint32_t get_pixel(const image_t *img, int x, int y)
  */
 void perimeter(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
 {
+    TRACE_ENTER(img, NULL);
+
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(img) != 1, "img image can not be a luma view");
+
     float p = 0.0;
 
+    const int stride = IMAGE_STRIDE(img);
+
     int mask[3][3] = {
         {10, 2, 10},
         {2, 1, 2},
@@ -802,16 +885,16 @@ void perimeter(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
     {
         for (int x = 1; x < (int)img->cols - 1; x++)
         {
-            if (img->data[y * img->cols + x] != blobnr)
+            if (img->data[y * stride + x] != blobnr)
             {
                 continue;
             }
 
             // 1. If it's an edge, apply the convolution mask
-            if (img->data[(y - 1) * img->cols + x] == 0 ||
-                img->data[(y + 1) * img->cols + x] == 0 ||
-                img->data[y * img->cols + (x - 1)] == 0 ||
-                img->data[y * img->cols + (x + 1)] == 0)
+            if (img->data[(y - 1) * stride + x] == 0 ||
+                img->data[(y + 1) * stride + x] == 0 ||
+                img->data[y * stride + (x - 1)] == 0 ||
+                img->data[y * stride + (x + 1)] == 0)
             {
                 int pixel_sum = 0;
                 for (int ky = -1; ky <= 1; ky++)
@@ -819,12 +902,12 @@ void perimeter(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
                     for (int kx = -1; kx <= 1; kx++)
                     {
                         // Check if the neighbor is also part of the blob
-                        if (img->data[(y + ky) * img->cols + (x + kx)] == blobnr)
+                        if (img->data[(y + ky) * stride + (x + kx)] == blobnr)
                         {
-                            if (img->data[((y + ky) - 1) * img->cols + (x + kx)] == 0 ||
-                                img->data[((y + ky) + 1) * img->cols + (x + kx)] == 0 ||
-                                img->data[(y + ky) * img->cols + ((x + kx) - 1)] == 0 ||
-                                img->data[(y + ky) * img->cols + ((x + kx) + 1)] == 0)
+                            if (img->data[((y + ky) - 1) * stride + (x + kx)] == 0 ||
+                                img->data[((y + ky) + 1) * stride + (x + kx)] == 0 ||
+                                img->data[(y + ky) * stride + ((x + kx) - 1)] == 0 ||
+                                img->data[(y + ky) * stride + ((x + kx) + 1)] == 0)
                             {
                                 pixel_sum += mask[ky + 1][kx + 1];
                             }
@@ -851,6 +934,8 @@ void perimeter(const image_t *img, blobinfo_t *blobinfo, const uint32_t blobnr)
     }
 
     blobinfo->perimeter = p;
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -878,7 +963,8 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
     ASSERT(y < 0, "y-value is out of range");
     ASSERT(y >= img->rows, "y-value is out of range");
 
-    register uint8_pixel_t *s = (uint8_pixel_t *)(img->data + (y * img->cols + x));
+    register const int32_t stride = IMAGE_STRIDE(img);
+    register uint8_pixel_t *s = (uint8_pixel_t *)(img->data + (y * stride + x));
 
     uint8_pixel_t val = UINT8_PIXEL_MAX;
     uint8_pixel_t pixel;
@@ -891,7 +977,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
         {
             val = pixel;
         }
-        pixel = *(s + (img->cols * sizeof(uint8_pixel_t))); // down
+        pixel = *(s + stride); // down
         if ((pixel < val) && (pixel > 1))
         {
             val = pixel;
@@ -899,7 +985,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
 
         if (c == CONNECTED_EIGHT)
         {
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) + 1); // down-right
+            pixel = *(s + stride + 1); // down-right
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
@@ -914,7 +1000,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
         {
             val = pixel;
         }
-        pixel = *(s + (img->cols * sizeof(uint8_pixel_t))); // down
+        pixel = *(s + stride); // down
         if ((pixel < val) && (pixel > 1))
         {
             val = pixel;
@@ -922,7 +1008,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
 
         if (c == CONNECTED_EIGHT)
         {
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) - 1); // down-left
+            pixel = *(s + stride - 1); // down-left
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
@@ -932,7 +1018,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
     // Left-bottom pixel
     else if (x == 0 && y == img->rows - 1)
     {
-        pixel = *(s - (img->cols * sizeof(uint8_pixel_t))); // up
+        pixel = *(s - stride); // up
         if ((pixel < val) && (pixel > 1))
         {
             val = pixel;
@@ -945,7 +1031,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
 
         if (c == CONNECTED_EIGHT)
         {
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) + 1); // up-right
+            pixel = *(s - stride + 1); // up-right
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
@@ -955,7 +1041,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
     // Right-bottom pixel
     else if (x == img->cols - 1 && y == img->rows - 1)
     {
-        pixel = *(s - (img->cols * sizeof(uint8_pixel_t))); // up
+        pixel = *(s - stride); // up
         if ((pixel < val) && (pixel > 1))
         {
             val = pixel;
@@ -968,7 +1054,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
 
         if (c == CONNECTED_EIGHT)
         {
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) - 1); // up-left
+            pixel = *(s - stride - 1); // up-left
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
@@ -988,7 +1074,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
         {
             val = pixel;
         }
-        pixel = *(s + (img->cols * sizeof(uint8_pixel_t))); // down
+        pixel = *(s + stride); // down
         if ((pixel < val) && (pixel > 1))
         {
             val = pixel;
@@ -996,12 +1082,12 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
 
         if (c == CONNECTED_EIGHT)
         {
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) - 1); // down-left
+            pixel = *(s + stride - 1); // down-left
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
             }
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) + 1); // down-right
+            pixel = *(s + stride + 1); // down-right
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
@@ -1011,7 +1097,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
     // Bottom border pixels
     else if (y == img->rows - 1)
     {
-        pixel = *(s - (img->cols * sizeof(uint8_pixel_t))); // up
+        pixel = *(s - stride); // up
         if ((pixel < val) && (pixel > 1))
         {
             val = pixel;
@@ -1029,12 +1115,12 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
 
         if (c == CONNECTED_EIGHT)
         {
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) - 1); // up-left
+            pixel = *(s - stride - 1); // up-left
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
             }
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) + 1); // up-right
+            pixel = *(s - stride + 1); // up-right
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
@@ -1044,7 +1130,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
     // Left border pixels
     else if (x == 0)
     {
-        pixel = *(s - (img->cols * sizeof(uint8_pixel_t))); // up
+        pixel = *(s - stride); // up
         if ((pixel < val) && (pixel > 1))
         {
             val = pixel;
@@ -1054,7 +1140,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
         {
             val = pixel;
         }
-        pixel = *(s + (img->cols * sizeof(uint8_pixel_t))); // down
+        pixel = *(s + stride); // down
         if ((pixel < val) && (pixel > 1))
         {
             val = pixel;
@@ -1062,12 +1148,12 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
 
         if (c == CONNECTED_EIGHT)
         {
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) + 1); // up-right
+            pixel = *(s - stride + 1); // up-right
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
             }
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) + 1); // down-right
+            pixel = *(s + stride + 1); // down-right
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
@@ -1077,7 +1163,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
     // Right border pixels
     else if (x == img->cols - 1)
     {
-        pixel = *(s - (img->cols * sizeof(uint8_pixel_t))); // up
+        pixel = *(s - stride); // up
         if ((pixel < val) && (pixel > 1))
         {
             val = pixel;
@@ -1087,7 +1173,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
         {
             val = pixel;
         }
-        pixel = *(s + (img->cols * sizeof(uint8_pixel_t))); // down
+        pixel = *(s + stride); // down
         if ((pixel < val) && (pixel > 1))
         {
             val = pixel;
@@ -1095,12 +1181,12 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
 
         if (c == CONNECTED_EIGHT)
         {
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) - 1); // up-left
+            pixel = *(s - stride - 1); // up-left
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
             }
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) - 1); // down-left
+            pixel = *(s + stride - 1); // down-left
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
@@ -1110,7 +1196,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
     else
     {
         // Inner pixels
-        pixel = *(s - (img->cols * sizeof(uint8_pixel_t))); // up
+        pixel = *(s - stride); // up
         if ((pixel < val) && (pixel > 1))
         {
             val = pixel;
@@ -1125,7 +1211,7 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
         {
             val = pixel;
         }
-        pixel = *(s + (img->cols * sizeof(uint8_pixel_t))); // down
+        pixel = *(s + stride); // down
         if ((pixel < val) && (pixel > 1))
         {
             val = pixel;
@@ -1133,22 +1219,22 @@ uint8_pixel_t lowestNeighbour(const image_t *img, const int32_t x,
 
         if (c == CONNECTED_EIGHT)
         {
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) - 1); // up-left
+            pixel = *(s - stride - 1); // up-left
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
             }
-            pixel = *(s - (img->cols * sizeof(uint8_pixel_t)) + 1); // up-right
+            pixel = *(s - stride + 1); // up-right
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
             }
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) - 1); // down-left
+            pixel = *(s + stride - 1); // down-left
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
             }
-            pixel = *(s + (img->cols * sizeof(uint8_pixel_t)) + 1); // down-right
+            pixel = *(s + stride + 1); // down-right
             if ((pixel < val) && (pixel > 1))
             {
                 val = pixel;
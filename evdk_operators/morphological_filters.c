@@ -36,15 +36,316 @@
  *****************************************************************************/
 #include "image_fundamentals.h"
 #include "morphological_filters.h"
+#include "nonlinear_filters.h"
+#include "trace.h"
 
 #include <string.h>
 
+/*!
+ * \brief Checks if a graylevel mask is flat
+ *
+ * A flat mask has an odd size and the same value in every cell. Graylevel
+ * dilation and erosion with a flat mask equal a running maximum or minimum
+ * plus or minus that value.
+ *
+ * \param[in] mask A pointer to a square mask of size \p n
+ * \param[in] n    The size of the mask
+ *
+ * \return 1 if the mask is flat, 0 otherwise
+ */
+static int32_t isFlatMask(const uint8_t *mask, const uint8_t n)
+{
+    if ((n % 2) == 0)
+    {
+        return 0;
+    }
+
+    for (int32_t i = 1; i < (n * n); i++)
+    {
+        if (mask[i] != mask[0])
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*!
+ * \brief Returns word \p w of a padded binary row, shifted so that bit x of
+ *        the result is bit x + \p i of the row
+ *
+ * \param[in] row A pointer to word 0 of the padded row
+ * \param[in] w   The word
+ * \param[in] i   The shift in pixels, may be negative
+ *
+ * \return The shifted word
+ */
+static inline binary_word_t shiftedWord(const binary_word_t *row, const int32_t w, const int32_t i)
+{
+    // Floor division, so r is in the range 0 - 63
+    const int32_t q = (i >= 0) ? (i / BINARY_WORD_BITS) : -((BINARY_WORD_BITS - 1 - i) / BINARY_WORD_BITS);
+    const int32_t r = i - (q * BINARY_WORD_BITS);
+
+    if (r == 0)
+    {
+        return row[w + q];
+    }
+
+    return (row[w + q] >> r) | (row[w + q + 1] << (BINARY_WORD_BITS - r));
+}
+
+/*!
+ * \brief Binary dilation or erosion of a binary image, 64 pixels at once
+ *
+ * The source rows are copied to a padded buffer first, so the shifted words
+ * near the left and right border can be read without checks. Pixels outside
+ * the image are 0 for dilation and 1 for erosion, so they never change the
+ * result, just like the window clipping of the uint8_pixel_t operators.
+ *
+ * \param[in]  src    A pointer to the source image
+ * \param[out] dst    A pointer to the destination image
+ * \param[in]  mask   A pointer to a square mask of size \p n
+ * \param[in]  n      The size of the mask
+ * \param[in]  erode  1 for erosion, 0 for dilation
+ * \param[in]  invert 1 to use the complement of the source image
+ */
+static void binaryMorphology(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_t n,
+                             const int32_t erode, const int32_t invert)
+{
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t h = n / 2;
+    const int32_t words = (cols + BINARY_WORD_BITS - 1) / BINARY_WORD_BITS;
+    const int32_t guard = (h / BINARY_WORD_BITS) + 1;
+    const int32_t padded_words = words + (2 * guard);
+    const int32_t src_words = IMAGE_STRIDE(src) / BINARY_WORD_BITS;
+    const int32_t dst_words = IMAGE_STRIDE(dst) / BINARY_WORD_BITS;
+
+    const binary_word_t fill = erode ? ~(binary_word_t)0 : 0;
+    const binary_word_t flip = invert ? ~(binary_word_t)0 : 0;
+
+    // Valid bits of the last word of a row
+    const int32_t last_bits = cols - ((words - 1) * BINARY_WORD_BITS);
+    const binary_word_t last_mask = (last_bits == BINARY_WORD_BITS) ? ~(binary_word_t)0 :
+                                    (((binary_word_t)1 << last_bits) - 1);
+
+    image_arena_mark_t mark = markImageArena();
+
+    binary_word_t *padded = (binary_word_t *)allocImageArena((size_t)rows * padded_words * sizeof(binary_word_t));
+    binary_word_t *acc = (binary_word_t *)allocImageArena(words * sizeof(binary_word_t));
+
+    if ((padded == NULL) || (acc == NULL))
+    {
+        ASSERT(1 == 1, "Unable to allocate memory for the padded rows, increase the size of the image arena");
+        releaseImageArena(mark);
+        return;
+    }
+
+    for (int32_t y = 0; y < rows; y++)
+    {
+        const binary_word_t *s = (const binary_word_t *)src->data + (y * src_words);
+        binary_word_t *p = padded + (y * padded_words);
+
+        for (int32_t w = 0; w < padded_words; w++)
+        {
+            p[w] = fill;
+        }
+
+        for (int32_t w = 0; w < words; w++)
+        {
+            p[guard + w] = s[w] ^ flip;
+        }
+
+        p[guard + words - 1] = (p[guard + words - 1] & last_mask) | (fill & ~last_mask);
+    }
+
+    for (int32_t y = 0; y < rows; y++)
+    {
+        for (int32_t w = 0; w < words; w++)
+        {
+            acc[w] = fill;
+        }
+
+        for (int32_t j = -h; j <= h; j++)
+        {
+            // Rows outside the image do not change the result
+            if (((y + j) < 0) || ((y + j) >= rows))
+            {
+                continue;
+            }
+
+            const binary_word_t *p = padded + ((y + j) * padded_words) + guard;
+            const uint8_t *m = mask + ((j + h) * n) + h;
+
+            for (int32_t i = -h; i <= h; i++)
+            {
+                if (m[i] != 1)
+                {
+                    continue;
+                }
+
+                if (erode)
+                {
+                    for (int32_t w = 0; w < words; w++)
+                    {
+                        acc[w] &= shiftedWord(p, w, i);
+                    }
+                }
+                else
+                {
+                    for (int32_t w = 0; w < words; w++)
+                    {
+                        acc[w] |= shiftedWord(p, w, i);
+                    }
+                }
+            }
+        }
+
+        binary_word_t *d = (binary_word_t *)dst->data + (y * dst_words);
+
+        memcpy(d, acc, words * sizeof(binary_word_t));
+        d[words - 1] &= last_mask;
+    }
+
+    releaseImageArena(mark);
+}
+
+/*!
+ * \brief Hit-and-miss transform of a binary image, 64 pixels at once
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[out] dst A pointer to the destination image
+ * \param[in]  m1  A pointer to a 3x3 mask for the foreground pixels
+ * \param[in]  m2  A pointer to a 3x3 mask for the background pixels
+ */
+static void hitmissBinary(const image_t *src, image_t *dst, const uint8_t *m1, const uint8_t *m2)
+{
+    const int32_t words = (src->cols + BINARY_WORD_BITS - 1) / BINARY_WORD_BITS;
+
+    image_arena_mark_t mark = markImageArena();
+
+    image_t *tmp = newBinaryImage(src->cols, src->rows);
+
+    if (tmp == NULL)
+    {
+        releaseImageArena(mark);
+        return;
+    }
+
+    // The background mask is applied to the complement of the source image
+    binaryMorphology(src, dst, m1, 3, 1, 0);
+    binaryMorphology(src, tmp, m2, 3, 1, 1);
+
+    // Calculate the intersection
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        const binary_word_t *t = (const binary_word_t *)tmp->data + (y * (IMAGE_STRIDE(tmp) / BINARY_WORD_BITS));
+        binary_word_t *d = (binary_word_t *)dst->data + (y * (IMAGE_STRIDE(dst) / BINARY_WORD_BITS));
+
+        for (int32_t w = 0; w < words; w++)
+        {
+            d[w] &= t[w];
+        }
+    }
+
+    releaseImageArena(mark);
+}
+
+/*!
+ * \brief Skeleton of a binary image, 64 pixels at once
+ *
+ * Same algorithm as the uint8_pixel_t version of skeleton(). The border of
+ * size \p n / 2 is skipped by means of a word mask for the columns.
+ *
+ * \param[in]  src  A pointer to the source image
+ * \param[out] dst  A pointer to the destination image
+ * \param[in]  mask A pointer to a square mask of size \p n
+ * \param[in]  n    The size of the mask
+ */
+static void skeletonBinary(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_t n)
+{
+    const int32_t h = n / 2;
+    const int32_t words = (src->cols + BINARY_WORD_BITS - 1) / BINARY_WORD_BITS;
+
+    clearBinaryImage(dst);
+
+    image_arena_mark_t mark = markImageArena();
+
+    image_t *org = newBinaryImage(src->cols, src->rows);
+    image_t *eroded = newBinaryImage(src->cols, src->rows);
+    image_t *opened = newBinaryImage(src->cols, src->rows);
+    binary_word_t *inner = (binary_word_t *)allocImageArena(words * sizeof(binary_word_t));
+
+    if ((opened == NULL) || (inner == NULL))
+    {
+        ASSERT(1 == 1, "Unable to allocate memory for the skeleton, increase the size of the image arena");
+        releaseImageArena(mark);
+        return;
+    }
+
+    copyBinaryImage(src, org);
+
+    // Only columns h to cols-h-1 are processed
+    for (int32_t w = 0; w < words; w++)
+    {
+        inner[w] = 0;
+    }
+
+    for (int32_t x = h; x < (src->cols - h); x++)
+    {
+        inner[x / BINARY_WORD_BITS] |= (binary_word_t)1 << (x % BINARY_WORD_BITS);
+    }
+
+    // Loop as long as the original image has not been fully eroded
+    uint8_t changes = 1;
+    while (changes)
+    {
+        changes = 0;
+
+        // eroded = erode_n(org)
+        binaryMorphology(org, eroded, mask, n, 1, 0);
+
+        // opened = open(erode_n(org), mask)
+        binaryMorphology(eroded, opened, mask, n, 0, 0);
+
+        // Loop all rows, skip the border
+        for (int32_t y = h; y < (src->rows - h); y++)
+        {
+            binary_word_t *o = (binary_word_t *)org->data + (y * (IMAGE_STRIDE(org) / BINARY_WORD_BITS));
+            const binary_word_t *op = (const binary_word_t *)opened->data + (y * (IMAGE_STRIDE(opened) / BINARY_WORD_BITS));
+            const binary_word_t *e = (const binary_word_t *)eroded->data + (y * (IMAGE_STRIDE(eroded) / BINARY_WORD_BITS));
+            binary_word_t *d = (binary_word_t *)dst->data + (y * (IMAGE_STRIDE(dst) / BINARY_WORD_BITS));
+
+            for (int32_t w = 0; w < words; w++)
+            {
+                // Create skeleton by the union of Kn(A) of all erosions
+                d[w] |= o[w] & ~op[w] & inner[w];
+
+                // Copy eroded image to original image
+                o[w] = (o[w] & ~inner[w]) | (e[w] & inner[w]);
+
+                // Continue as long as the original image has not yet been fully eroded
+                if ((e[w] & inner[w]) != 0)
+                {
+                    changes = 1;
+                }
+            }
+        }
+    }
+
+    releaseImageArena(mark);
+}
+
 /*!
  * \brief Binary dilation of an object increases its geometrical area
  *
  * Dilation is defined as the union of all vector additions of all pixels a
  * in object A with all pixels b in the structuring function B (\p mask).
  *
+ * The image can also be of type IMGTYPE_BINARY, in which case 64 pixels are
+ * dilated at once.
+ *
  * \param[in]  src  A pointer to the source image
  * \param[out] dst  A pointer to the destination image
  * \param[in]  mask A pointer to a square mask of size \p n
@@ -52,13 +353,17 @@
  */
 void dilation(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_t n)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
-    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
-    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_BINARY), "src type is invalid");
+    ASSERT(dst->type != src->type, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verifiy mask validity
     ASSERT(mask == NULL, "mask is invalid");
@@ -69,39 +374,60 @@ void dilation(const image_t *src, image_t *dst, const uint8_t *mask, const uint8
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
-    // Loop all pixels
+    // Binary images are processed 64 pixels at once
+    if (src->type == IMGTYPE_BINARY)
+    {
+        binaryMorphology(src, dst, mask, n, 0, 0);
+
+        TRACE_EXIT();
+        return;
+    }
+
+    const uint8_pixel_t *src_data = (const uint8_pixel_t *)src->data;
+    const int32_t src_stride = IMAGE_STRIDE(src);
+    const int32_t h = n / 2;
+
+    // Loop all rows
     for (int32_t y = 0; y < src->rows; y++)
     {
+        uint8_pixel_t *dst_row = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Rows of the window that are within the image
+        const int32_t j0 = (y < h) ? -y : -h;
+        const int32_t j1 = ((y + h) >= src->rows) ? (src->rows - 1 - y) : h;
+
         for (int32_t x = 0; x < src->cols; x++)
         {
+            // Columns of the window that are within the image
+            const int32_t i0 = (x < h) ? -x : -h;
+            const int32_t i1 = ((x + h) >= src->cols) ? (src->cols - 1 - x) : h;
+
             uint32_t smax = 0;
 
             // Apply the kernel only for pixels within the image
-            for (int32_t j = -n / 2; j <= n / 2; j++)
+            for (int32_t j = j0; j <= j1; j++)
             {
-                for (int32_t i = -n / 2; i <= n / 2; i++)
+                const uint8_pixel_t *s = src_data + ((y + j) * src_stride) + x;
+                const uint8_t *m = mask + ((j + h) * n) + h;
+
+                for (int32_t i = i0; i <= i1; i++)
                 {
-                    if ((x + i) >= 0 &&
-                        (y + j) >= 0 &&
-                        (x + i) < src->cols &&
-                        (y + j) < src->rows)
+                    // Is the pixel set and is the corresponding
+                    // cell in the mask set?
+                    if ((s[i] == 1) && (m[i] == 1))
                     {
-                        // Is the pixel set and is the corresponding
-                        // cell in the mask set?
-                        if ((getUint8Pixel(src, x + i, y + j) == 1) &&
-                            (mask[((j + (n / 2)) * n) + (i + (n / 2))] == 1))
-                        {
-                            // Mark this cell for dilation
-                            smax = 1;
-                        }
+                        // Mark this cell for dilation
+                        smax = 1;
                     }
                 }
             }
 
             // Store the result
-            setUint8Pixel(dst, x, y, smax);
+            dst_row[x] = smax;
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -110,6 +436,9 @@ void dilation(const image_t *src, image_t *dst, const uint8_t *mask, const uint8
  * Graylevel dilation is defined as the maximum of the sum of a local region of
  * an image and a given graylevel \p mask.
  *
+ * A flat mask, with an odd size and the same value in every cell, is handled
+ * by runningMinMax() in constant time per pixel.
+ *
  * \param[in]  src  A pointer to the source image
  * \param[out] dst  A pointer to the destination image
  * \param[in]  mask A pointer to a square mask of size \p n
@@ -117,6 +446,8 @@ void dilation(const image_t *src, image_t *dst, const uint8_t *mask, const uint8
  */
 void dilationGray(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_t n)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -124,6 +455,8 @@ void dilationGray(const image_t *src, image_t *dst, const uint8_t *mask, const u
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verifiy mask validity
     ASSERT(mask == NULL, "mask is invalid");
@@ -134,28 +467,62 @@ void dilationGray(const image_t *src, image_t *dst, const uint8_t *mask, const u
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
-    // Loop all pixels
+    // With a flat mask the result is the running maximum plus the mask value,
+    // which takes constant time per pixel
+    if (isFlatMask(mask, n))
+    {
+        const int32_t c = mask[0];
+
+        runningMinMax(src, NULL, dst, n, n);
+
+        for (int32_t y = 0; y < dst->rows; y++)
+        {
+            uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+            for (int32_t x = 0; x < dst->cols; x++)
+            {
+                // Clip the result
+                d[x] = (uint8_pixel_t)((d[x] > (UINT8_PIXEL_MAX - c)) ? UINT8_PIXEL_MAX : (d[x] + c));
+            }
+        }
+
+        TRACE_EXIT();
+        return;
+    }
+
+    const uint8_pixel_t *src_data = (const uint8_pixel_t *)src->data;
+    const int32_t src_stride = IMAGE_STRIDE(src);
+    const int32_t h = n / 2;
+
+    // Loop all rows
     for (int32_t y = 0; y < src->rows; y++)
     {
+        uint8_pixel_t *dst_row = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Rows of the window that are within the image
+        const int32_t j0 = (y < h) ? -y : -h;
+        const int32_t j1 = ((y + h) >= src->rows) ? (src->rows - 1 - y) : h;
+
         for (int32_t x = 0; x < src->cols; x++)
         {
+            // Columns of the window that are within the image
+            const int32_t i0 = (x < h) ? -x : -h;
+            const int32_t i1 = ((x + h) >= src->cols) ? (src->cols - 1 - x) : h;
+
             int32_t smax = 0;
 
             // Apply the kernel only for pixels within the image
-            for (int32_t j = -n / 2; j <= n / 2; j++)
+            for (int32_t j = j0; j <= j1; j++)
             {
-                for (int32_t i = -n / 2; i <= n / 2; i++)
+                const uint8_pixel_t *s = src_data + ((y + j) * src_stride) + x;
+                const uint8_t *m = mask + ((j + h) * n) + h;
+
+                for (int32_t i = i0; i <= i1; i++)
                 {
-                    if ((x + i) >= 0 &&
-                        (y + j) >= 0 &&
-                        (x + i) < src->cols &&
-                        (y + j) < src->rows)
-                    {
-                        int32_t val = getUint8Pixel(src, x + i, y + j) + mask[((j + (n / 2)) * n) + (i + (n / 2))];
+                    int32_t val = s[i] + m[i];
 
-                        if (val > smax)
-                            smax = val;
-                    }
+                    if (val > smax)
+                        smax = val;
                 }
             }
 
@@ -166,9 +533,11 @@ void dilationGray(const image_t *src, image_t *dst, const uint8_t *mask, const u
             }
 
             // Store the result
-            setUint8Pixel(dst, x, y, smax);
+            dst_row[x] = smax;
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -177,6 +546,9 @@ void dilationGray(const image_t *src, image_t *dst, const uint8_t *mask, const u
  * Erosion is defined as the complement of the resulting dilation of the
  * complement of object A with structuring function B (\p mask).
  *
+ * The image can also be of type IMGTYPE_BINARY, in which case 64 pixels are
+ * eroded at once.
+ *
  * \param[in]  src  A pointer to the source image
  * \param[out] dst  A pointer to the destination image
  * \param[in]  mask A pointer to a square mask of size \p n
@@ -184,13 +556,17 @@ void dilationGray(const image_t *src, image_t *dst, const uint8_t *mask, const u
  */
 void erosion(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_t n)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
-    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
-    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_BINARY), "src type is invalid");
+    ASSERT(dst->type != src->type, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verifiy mask validity
     ASSERT(mask == NULL, "mask is invalid");
@@ -201,39 +577,60 @@ void erosion(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
-    // Loop all pixels
+    // Binary images are processed 64 pixels at once
+    if (src->type == IMGTYPE_BINARY)
+    {
+        binaryMorphology(src, dst, mask, n, 1, 0);
+
+        TRACE_EXIT();
+        return;
+    }
+
+    const uint8_pixel_t *src_data = (const uint8_pixel_t *)src->data;
+    const int32_t src_stride = IMAGE_STRIDE(src);
+    const int32_t h = n / 2;
+
+    // Loop all rows
     for (int32_t y = 0; y < src->rows; y++)
     {
+        uint8_pixel_t *dst_row = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Rows of the window that are within the image
+        const int32_t j0 = (y < h) ? -y : -h;
+        const int32_t j1 = ((y + h) >= src->rows) ? (src->rows - 1 - y) : h;
+
         for (int32_t x = 0; x < src->cols; x++)
         {
+            // Columns of the window that are within the image
+            const int32_t i0 = (x < h) ? -x : -h;
+            const int32_t i1 = ((x + h) >= src->cols) ? (src->cols - 1 - x) : h;
+
             uint32_t smin = 1;
 
             // Apply the kernel only for pixels within the image
-            for (int32_t j = -n / 2; j <= n / 2; j++)
+            for (int32_t j = j0; j <= j1; j++)
             {
-                for (int32_t i = -n / 2; i <= n / 2; i++)
+                const uint8_pixel_t *s = src_data + ((y + j) * src_stride) + x;
+                const uint8_t *m = mask + ((j + h) * n) + h;
+
+                for (int32_t i = i0; i <= i1; i++)
                 {
-                    if ((x + i) >= 0 &&
-                        (y + j) >= 0 &&
-                        (x + i) < src->cols &&
-                        (y + j) < src->rows)
+                    // Is the pixel background and is the corresponding
+                    // cell in the mask set?
+                    if ((s[i] == 0) && (m[i] == 1))
                     {
-                        // Is the pixel background and is the corresponding
-                        // cell in the mask set?
-                        if ((getUint8Pixel(src, x + i, y + j) == 0) &&
-                            (mask[((j + (n / 2)) * n) + (i + (n / 2))] == 1))
-                        {
-                            // Mark this cell for erosion
-                            smin = 0;
-                        }
+                        // Mark this cell for erosion
+                        smin = 0;
                     }
                 }
             }
 
             // Store the result
-            setUint8Pixel(dst, x, y, smin);
+            dst_row[x] = smin;
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -242,6 +639,9 @@ void erosion(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_
  * Graylevel dilation is defined as the minimum of the difference of a local
  * region of an image and a given graylevel \p mask.
  *
+ * A flat mask, with an odd size and the same value in every cell, is handled
+ * by runningMinMax() in constant time per pixel.
+ *
  * \param[in]  src  A pointer to the source image
  * \param[out] dst  A pointer to the destination image
  * \param[in]  mask A pointer to a square mask of size \p n
@@ -249,6 +649,8 @@ void erosion(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_
  */
 void erosionGray(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_t n)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -256,6 +658,8 @@ void erosionGray(const image_t *src, image_t *dst, const uint8_t *mask, const ui
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verifiy mask validity
     ASSERT(mask == NULL, "mask is invalid");
@@ -266,28 +670,62 @@ void erosionGray(const image_t *src, image_t *dst, const uint8_t *mask, const ui
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
-    // Loop all pixels
+    // With a flat mask the result is the running minimum minus the mask value,
+    // which takes constant time per pixel
+    if (isFlatMask(mask, n))
+    {
+        const int32_t c = mask[0];
+
+        runningMinMax(src, dst, NULL, n, n);
+
+        for (int32_t y = 0; y < dst->rows; y++)
+        {
+            uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+            for (int32_t x = 0; x < dst->cols; x++)
+            {
+                // Clip the result
+                d[x] = (uint8_pixel_t)((d[x] < c) ? UINT8_PIXEL_MIN : (d[x] - c));
+            }
+        }
+
+        TRACE_EXIT();
+        return;
+    }
+
+    const uint8_pixel_t *src_data = (const uint8_pixel_t *)src->data;
+    const int32_t src_stride = IMAGE_STRIDE(src);
+    const int32_t h = n / 2;
+
+    // Loop all rows
     for (int32_t y = 0; y < src->rows; y++)
     {
+        uint8_pixel_t *dst_row = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Rows of the window that are within the image
+        const int32_t j0 = (y < h) ? -y : -h;
+        const int32_t j1 = ((y + h) >= src->rows) ? (src->rows - 1 - y) : h;
+
         for (int32_t x = 0; x < src->cols; x++)
         {
+            // Columns of the window that are within the image
+            const int32_t i0 = (x < h) ? -x : -h;
+            const int32_t i1 = ((x + h) >= src->cols) ? (src->cols - 1 - x) : h;
+
             int32_t smin = 255;
 
             // Apply the kernel only for pixels within the image
-            for (int32_t j = -n / 2; j <= n / 2; j++)
+            for (int32_t j = j0; j <= j1; j++)
             {
-                for (int32_t i = -n / 2; i <= n / 2; i++)
+                const uint8_pixel_t *s = src_data + ((y + j) * src_stride) + x;
+                const uint8_t *m = mask + ((j + h) * n) + h;
+
+                for (int32_t i = i0; i <= i1; i++)
                 {
-                    if ((x + i) >= 0 &&
-                        (y + j) >= 0 &&
-                        (x + i) < src->cols &&
-                        (y + j) < src->rows)
-                    {
-                        int32_t val = getUint8Pixel(src, x + i, y + j) - mask[((j + (n / 2)) * n) + (i + (n / 2))];
+                    int32_t val = s[i] - m[i];
 
-                        if (val < smin)
-                            smin = val;
-                    }
+                    if (val < smin)
+                        smin = val;
                 }
             }
 
@@ -298,9 +736,11 @@ void erosionGray(const image_t *src, image_t *dst, const uint8_t *mask, const ui
             }
 
             // Store the result
-            setUint8Pixel(dst, x, y, smin);
+            dst_row[x] = smin;
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -315,6 +755,8 @@ void erosionGray(const image_t *src, image_t *dst, const uint8_t *mask, const ui
  */
 void fillHolesIterative(const image_t *src, image_t *dst, const eConnected c)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -322,6 +764,8 @@ void fillHolesIterative(const image_t *src, image_t *dst, const eConnected c)
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -333,30 +777,38 @@ void fillHolesIterative(const image_t *src, image_t *dst, const eConnected c)
         copyUint8Image(src, dst);
     }
 
+    uint8_pixel_t *dst_data = (uint8_pixel_t *)dst->data;
+    const int32_t dst_stride = IMAGE_STRIDE(dst);
+
     // Mark the border pixels that are set
     for (int32_t y = 0; y < dst->rows; y++)
     {
-        if (getUint8Pixel(dst, 0, y) == 0)
+        uint8_pixel_t *row = dst_data + (y * dst_stride);
+
+        if (row[0] == 0)
         {
-            setUint8Pixel(dst, 0, y, 2);
+            row[0] = 2;
         }
 
-        if (getUint8Pixel(dst, (dst->cols - 1), y) == 0)
+        if (row[dst->cols - 1] == 0)
         {
-            setUint8Pixel(dst, (dst->cols - 1), y, 2);
+            row[dst->cols - 1] = 2;
         }
     }
 
+    uint8_pixel_t *first = dst_data;
+    uint8_pixel_t *last = dst_data + ((dst->rows - 1) * dst_stride);
+
     for (int32_t x = 0; x < dst->cols; x++)
     {
-        if (getUint8Pixel(dst, x, 0) == 0)
+        if (first[x] == 0)
         {
-            setUint8Pixel(dst, x, 0, 2);
+            first[x] = 2;
         }
 
-        if (getUint8Pixel(dst, x, (dst->rows - 1)) == 0)
+        if (last[x] == 0)
         {
-            setUint8Pixel(dst, x, (dst->rows - 1), 2);
+            last[x] = 2;
         }
     }
 
@@ -373,16 +825,18 @@ void fillHolesIterative(const image_t *src, image_t *dst, const eConnected c)
         // Discard first row, last row, first column and last column
         for (int32_t y = 1; y < dst->rows - 1; y++)
         {
+            uint8_pixel_t *row = dst_data + (y * dst_stride);
+
             for (int32_t x = 1; x < dst->cols - 1; x++)
             {
                 // Does the pixel belong to the background?
-                if (getUint8Pixel(dst, x, y) == 0)
+                if (row[x] == 0)
                 {
                     // Is a neighbour marked?
                     if (neighbourCount(dst, x, y, 2, c) > 0)
                     {
                         // Also mark this pixel
-                        setUint8Pixel(dst, x, y, 2);
+                        row[x] = 2;
                         changes = 1;
                     }
                 }
@@ -398,16 +852,18 @@ void fillHolesIterative(const image_t *src, image_t *dst, const eConnected c)
         // Discard first row, last row, firs column and last column
         for (int32_t y = dst->rows - 2; y > 0; y--)
         {
+            uint8_pixel_t *row = dst_data + (y * dst_stride);
+
             for (int32_t x = dst->cols - 2; x > 0; x--)
             {
                 // Does the pixel belong to the background?
-                if (getUint8Pixel(dst, x, y) == 0)
+                if (row[x] == 0)
                 {
                     // Is a neighbour marked?
                     if (neighbourCount(dst, x, y, 2, c) > 0)
                     {
                         // Also mark this pixel
-                        setUint8Pixel(dst, x, y, 2);
+                        row[x] = 2;
                         changes = 1;
                     }
                 }
@@ -417,29 +873,25 @@ void fillHolesIterative(const image_t *src, image_t *dst, const eConnected c)
         iterations++;
     } while (changes != 0);
 
-    // Set background to object value
-    for (int32_t y = 0; y < src->rows; y++)
+    // Set background to object value and marked value to background value
+    for (int32_t y = 0; y < dst->rows; y++)
     {
-        for (int32_t x = 0; x < src->cols; x++)
+        uint8_pixel_t *row = dst_data + (y * dst_stride);
+
+        for (int32_t x = 0; x < dst->cols; x++)
         {
-            if (getUint8Pixel(dst, x, y) == 0)
+            if (row[x] == 0)
             {
-                setUint8Pixel(dst, x, y, 1);
+                row[x] = 1;
             }
-        }
-    }
-
-    // Set marked value to background value
-    for (int32_t y = 0; y < src->rows; y++)
-    {
-        for (int32_t x = 0; x < src->cols; x++)
-        {
-            if (getUint8Pixel(dst, x, y) == 2)
+            else if (row[x] == 2)
             {
-                setUint8Pixel(dst, x, y, 0);
+                row[x] = 0;
             }
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -464,10 +916,24 @@ void fillHolesIterative(const image_t *src, image_t *dst, const eConnected c)
 uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
                           const eConnected connected, const uint32_t lutSize)
 {
-    uint32_t *lut = (uint32_t *)malloc(lutSize * sizeof(uint32_t));
+    TRACE_ENTER(src, dst);
+
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+
+    // Both images can be views with a different stride
+    const uint32_t src_stride = IMAGE_STRIDE(src);
+    const uint32_t dst_stride = IMAGE_STRIDE(dst);
+
+    // Allocate the lookup table in the image arena
+    image_arena_mark_t mark = markImageArena();
+
+    uint32_t *lut = (uint32_t *)allocImageArena(lutSize * sizeof(uint32_t));
 
     if (lut == NULL)
     {
+        TRACE_EXIT();
         return 0;
     }
 
@@ -485,13 +951,13 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
     {
         for (uint32_t x = 0; x < src->cols; x++)
         {
-            uint32_t idx = y * src->cols + x;
+            uint32_t idx = y * dst_stride + x;
 
             // if on border
             if (x == 0 || x == src->cols - 1 || y == 0 || y == src->rows - 1)
             {
                 // if background
-                if (src->data[idx] == 0)
+                if (src->data[y * src_stride + x] == 0)
                 {
                     // set in destination 2
                     dst->data[idx] = 2;
@@ -505,17 +971,17 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
     {
         for (int32_t x = 1; x < src->cols - 1; x++)
         {
-            uint32_t idx = y * src->cols + x;
+            uint32_t idx = y * dst_stride + x;
 
             // if background
-            if (src->data[idx] == 0)
+            if (src->data[y * src_stride + x] == 0)
             {
                 /*
                     1 1 1
                     1 0 0
                     0 0 0
                 */
-                uint32_t n = dst->data[idx - src->cols];
+                uint32_t n = dst->data[idx - dst_stride];
                 uint32_t w = dst->data[idx - 1];
                 uint32_t nw = 0;
                 uint32_t ne = 0;
@@ -523,8 +989,8 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
                 // Alleen diagonalen meenemen als we 8-connected gebruiken
                 if (connected == CONNECTED_EIGHT)
                 {
-                    nw = dst->data[idx - src->cols - 1];
-                    ne = dst->data[idx - src->cols + 1];
+                    nw = dst->data[idx - dst_stride - 1];
+                    ne = dst->data[idx - dst_stride + 1];
                 }
 
                 // if neighbours labelled
@@ -581,7 +1047,8 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
                 {
                     if (nextLabel >= lutSize)
                     {
-                        free(lut);
+                        releaseImageArena(mark);
+                        TRACE_EXIT();
                         return 0; // Lookup table is too small
                     }
 
@@ -606,7 +1073,7 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
     {
         for (int32_t x = 1; x < dst->cols - 1; x++)
         {
-            uint32_t idx = y * dst->cols + x;
+            uint32_t idx = y * dst_stride + x;
             uint32_t currentLabel = dst->data[idx];
 
             // if object
@@ -627,7 +1094,7 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
 
                     if (connected == CONNECTED_EIGHT)
                     {
-                        uint32_t bottom_left = dst->data[idx + src->cols - 1];
+                        uint32_t bottom_left = dst->data[idx + dst_stride - 1];
 
                         if (bottom_left == 2)
                         {
@@ -654,7 +1121,7 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
                 if (y == dst->rows - 2)
                 {
                     // check pixels onder
-                    uint32_t bottom = dst->data[idx + dst->cols];
+                    uint32_t bottom = dst->data[idx + dst_stride];
 
                     // als waarde = 2
                     if (bottom == 2)
@@ -665,14 +1132,14 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
 
                     if (connected == CONNECTED_EIGHT)
                     {
-                        uint32_t bottom_left = dst->data[idx + dst->cols - 1];
+                        uint32_t bottom_left = dst->data[idx + dst_stride - 1];
 
                         if (bottom_left == 2)
                         {
                             lut[currentLabel] = 2;
                         }
 
-                        uint32_t bottom_right = dst->data[idx + dst->cols + 1];
+                        uint32_t bottom_right = dst->data[idx + dst_stride + 1];
 
                         if (bottom_right == 2)
                         {
@@ -697,7 +1164,7 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
     {
         for (uint32_t x = 0; x < dst->cols; x++)
         {
-            uint32_t idx = y * dst->cols + x;
+            uint32_t idx = y * dst_stride + x;
             uint32_t currentLabel = dst->data[idx];
 
             if (currentLabel == 0)
@@ -715,8 +1182,9 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
         }
     }
 
-    free(lut);
+    releaseImageArena(mark);
 
+    TRACE_EXIT();
     return 1;
 }
 
@@ -726,6 +1194,9 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
  * The function uses a hit mask and a miss mask with the requirement that the
  * intersection of the two masks is empty.
  *
+ * For images of type IMGTYPE_BINARY both erosions and the intersection are
+ * calculated on 64-bit words.
+ *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
  * \param[in]  m1  3x3 Hit mask
@@ -733,13 +1204,17 @@ uint32_t fillHolesTwoPass(const image_t *src, image_t *dst,
  */
 void hitmiss(const image_t *src, image_t *dst, const uint8_t *m1, const uint8_t *m2)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
-    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
-    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_BINARY), "src type is invalid");
+    ASSERT(dst->type != src->type, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verifiy mask validity
     ASSERT((m1[0] & m2[0]) == 1 ||
@@ -758,7 +1233,18 @@ void hitmiss(const image_t *src, image_t *dst, const uint8_t *m1, const uint8_t
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
-    // Create temporary image
+    // Binary images are processed 64 pixels at once
+    if (src->type == IMGTYPE_BINARY)
+    {
+        hitmissBinary(src, dst, m1, m2);
+
+        TRACE_EXIT();
+        return;
+    }
+
+    // Create temporary images in the image arena
+    image_arena_mark_t mark = markImageArena();
+
     image_t *org = newUint8Image(src->cols, src->rows);
     image_t *tmp = newUint8Image(src->cols, src->rows);
 
@@ -769,9 +1255,12 @@ void hitmiss(const image_t *src, image_t *dst, const uint8_t *m1, const uint8_t
     // Set tmp image to the complement of org
     for (int32_t y = 0; y < src->rows; y++)
     {
+        const uint8_pixel_t *s = (const uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *t = (uint8_pixel_t *)tmp->data + (y * IMAGE_STRIDE(tmp));
+
         for (int32_t x = 0; x < src->cols; x++)
         {
-            setUint8Pixel(tmp, x, y, 1 - getUint8Pixel(src, x, y));
+            t[x] = 1 - s[x];
         }
     }
 
@@ -781,15 +1270,19 @@ void hitmiss(const image_t *src, image_t *dst, const uint8_t *m1, const uint8_t
     // Calculate the intersection
     for (int32_t y = 0; y < src->rows; y++)
     {
+        const uint8_pixel_t *o = (const uint8_pixel_t *)org->data + (y * IMAGE_STRIDE(org));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
         for (int32_t x = 0; x < src->cols; x++)
         {
-            setUint8Pixel(dst, x, y, getUint8Pixel(dst, x, y) & getUint8Pixel(org, x, y));
+            d[x] &= o[x];
         }
     }
 
     // Cleanup
-    deleteUint8Image(org);
-    deleteUint8Image(tmp);
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -800,6 +1293,8 @@ void hitmiss(const image_t *src, image_t *dst, const uint8_t *m1, const uint8_t
  * The result is the eroded image subtracted from the original image or the
  * original image subtracted from the dilated image.
  *
+ * Supports images of type IMGTYPE_BINARY as well.
+ *
  * \param[in]  src  A pointer to the source image
  * \param[out] dst  A pointer to the destination image
  * \param[in]  mask A pointer to a square mask of size \p n
@@ -807,13 +1302,17 @@ void hitmiss(const image_t *src, image_t *dst, const uint8_t *m1, const uint8_t
  */
 void outline(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_t n)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
-    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
-    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_BINARY), "src type is invalid");
+    ASSERT(dst->type != src->type, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verifiy mask validity
     ASSERT(mask == NULL, "mask is invalid");
@@ -824,16 +1323,43 @@ void outline(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
+    // Binary images are processed 64 pixels at once
+    if (src->type == IMGTYPE_BINARY)
+    {
+        binaryMorphology(src, dst, mask, n, 1, 0);
+
+        const int32_t words = (src->cols + BINARY_WORD_BITS - 1) / BINARY_WORD_BITS;
+
+        for (int32_t y = 0; y < src->rows; y++)
+        {
+            const binary_word_t *s = (const binary_word_t *)src->data + (y * (IMAGE_STRIDE(src) / BINARY_WORD_BITS));
+            binary_word_t *d = (binary_word_t *)dst->data + (y * (IMAGE_STRIDE(dst) / BINARY_WORD_BITS));
+
+            for (int32_t w = 0; w < words; w++)
+            {
+                d[w] = s[w] & ~d[w];
+            }
+        }
+
+        TRACE_EXIT();
+        return;
+    }
+
     erosion(src, dst, mask, n);
 
     // Loop all pixels
     for (int32_t y = 0; y < src->rows; y++)
     {
+        const uint8_pixel_t *s = (const uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
         for (int32_t x = 0; x < src->cols; x++)
         {
-            setUint8Pixel(dst, x, y, getUint8Pixel(src, x, y) - getUint8Pixel(dst, x, y));
+            d[x] = s[x] - d[x];
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -845,6 +1371,8 @@ void outline(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_
  */
 void removeBorderBlobsIterative(const image_t *src, image_t *dst, const eConnected c)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -852,6 +1380,8 @@ void removeBorderBlobsIterative(const image_t *src, image_t *dst, const eConnect
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src == dst, "src and dst are the same images");
@@ -860,30 +1390,38 @@ void removeBorderBlobsIterative(const image_t *src, image_t *dst, const eConnect
 
     copyUint8Image(src, dst);
 
+    uint8_pixel_t *dst_data = (uint8_pixel_t *)dst->data;
+    const int32_t dst_stride = IMAGE_STRIDE(dst);
+
     // Mark the border pixels that are set
     for (int32_t y = 0; y < dst->rows; y++)
     {
-        if (getUint8Pixel(dst, 0, y) == 1)
+        uint8_pixel_t *row = dst_data + (y * dst_stride);
+
+        if (row[0] == 1)
         {
-            setUint8Pixel(dst, 0, y, 2);
+            row[0] = 2;
         }
 
-        if (getUint8Pixel(dst, (dst->cols - 1), y) == 1)
+        if (row[dst->cols - 1] == 1)
         {
-            setUint8Pixel(dst, (dst->cols - 1), y, 2);
+            row[dst->cols - 1] = 2;
         }
     }
 
+    uint8_pixel_t *first = dst_data;
+    uint8_pixel_t *last = dst_data + ((dst->rows - 1) * dst_stride);
+
     for (int32_t x = 0; x < dst->cols; x++)
     {
-        if (getUint8Pixel(dst, x, 0) == 1)
+        if (first[x] == 1)
         {
-            setUint8Pixel(dst, x, 0, 2);
+            first[x] = 2;
         }
 
-        if (getUint8Pixel(dst, x, (dst->rows - 1)) == 1)
+        if (last[x] == 1)
         {
-            setUint8Pixel(dst, x, (dst->rows - 1), 2);
+            last[x] = 2;
         }
     }
 
@@ -900,16 +1438,18 @@ void removeBorderBlobsIterative(const image_t *src, image_t *dst, const eConnect
         // Discard first row, last row, first column and last column
         for (int32_t y = 1; y < dst->rows - 1; y++)
         {
+            uint8_pixel_t *row = dst_data + (y * dst_stride);
+
             for (int32_t x = 1; x < dst->cols - 1; x++)
             {
                 // Does the pixel belong to a blob?
-                if (getUint8Pixel(dst, x, y) == 1)
+                if (row[x] == 1)
                 {
                     // Is a neighbour marked?
                     if (neighbourCount(dst, x, y, 2, c) > 0)
                     {
                         // Also mark this pixel
-                        setUint8Pixel(dst, x, y, 2);
+                        row[x] = 2;
                         changes = 1;
                     }
                 }
@@ -920,16 +1460,20 @@ void removeBorderBlobsIterative(const image_t *src, image_t *dst, const eConnect
     } while (changes != 0);
 
     // Set marked value to background value
-    for (int32_t y = 0; y < src->rows; y++)
+    for (int32_t y = 0; y < dst->rows; y++)
     {
-        for (int32_t x = 0; x < src->cols; x++)
+        uint8_pixel_t *row = dst_data + (y * dst_stride);
+
+        for (int32_t x = 0; x < dst->cols; x++)
         {
-            if (getUint8Pixel(dst, x, y) == 2)
+            if (row[x] == 2)
             {
-                setUint8Pixel(dst, x, y, 0);
+                row[x] = 0;
             }
         }
     }
+
+    TRACE_EXIT();
 }
 
 uint32_t find(uint32_t *lut, uint32_t i)
@@ -962,10 +1506,24 @@ uint32_t removeBorderBlobsTwoPass(const image_t *src, image_t *dst,
                                   const eConnected connected,
                                   const uint32_t lutSize)
 {
-    uint32_t *lut = (uint32_t *)malloc(lutSize * sizeof(uint32_t));
+    TRACE_ENTER(src, dst);
+
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+
+    // Both images can be views with a different stride
+    const uint32_t src_stride = IMAGE_STRIDE(src);
+    const uint32_t dst_stride = IMAGE_STRIDE(dst);
+
+    // Allocate the lookup table in the image arena
+    image_arena_mark_t mark = markImageArena();
+
+    uint32_t *lut = (uint32_t *)allocImageArena(lutSize * sizeof(uint32_t));
 
     if (lut == NULL)
     {
+        TRACE_EXIT();
         return 0;
     }
 
@@ -984,17 +1542,17 @@ uint32_t removeBorderBlobsTwoPass(const image_t *src, image_t *dst,
     {
         for (int32_t x = 1; x < src->cols - 1; x++)
         {
-            uint32_t idx = y * src->cols + x;
+            uint32_t idx = y * dst_stride + x;
 
             // if object
-            if (src->data[idx] != 0)
+            if (src->data[y * src_stride + x] != 0)
             {
                 /*
                     1 1 1
                     1 0 0
                     0 0 0
                 */
-                uint32_t n = dst->data[idx - src->cols];
+                uint32_t n = dst->data[idx - dst_stride];
                 uint32_t w = dst->data[idx - 1];
                 uint32_t nw = 0;
                 uint32_t ne = 0;
@@ -1002,8 +1560,8 @@ uint32_t removeBorderBlobsTwoPass(const image_t *src, image_t *dst,
                 // Alleen diagonalen meenemen als we 8-connected gebruiken
                 if (connected == CONNECTED_EIGHT)
                 {
-                    nw = dst->data[idx - src->cols - 1];
-                    ne = dst->data[idx - src->cols + 1];
+                    nw = dst->data[idx - dst_stride - 1];
+                    ne = dst->data[idx - dst_stride + 1];
                 }
 
                 // if neighbours labelled
@@ -1060,7 +1618,8 @@ uint32_t removeBorderBlobsTwoPass(const image_t *src, image_t *dst,
                 {
                     if (nextLabel >= lutSize)
                     {
-                        free(lut);
+                        releaseImageArena(mark);
+                        TRACE_EXIT();
                         return 0; // Lookup table is too small
                     }
 
@@ -1086,18 +1645,24 @@ uint32_t removeBorderBlobsTwoPass(const image_t *src, image_t *dst,
 
     SecondPass(dst, lut);
 
-    free(lut);
+    releaseImageArena(mark);
 
+    TRACE_EXIT();
     return 1;
 }
 
 void RecordBorderEquivalences(image_t *dst, uint32_t *lut, const eConnected connected, const image_t *src)
 {
+    TRACE_ENTER(dst, src);
+
+    // The destination image can be a view
+    const uint32_t dst_stride = IMAGE_STRIDE(dst);
+
     for (int32_t y = 1; y < dst->rows - 1; y++)
     {
         for (int32_t x = 1; x < dst->cols - 1; x++)
         {
-            uint32_t idx = y * dst->cols + x;
+            uint32_t idx = y * dst_stride + x;
             uint32_t currentLabel = dst->data[idx];
 
             // if object
@@ -1117,7 +1682,7 @@ void RecordBorderEquivalences(image_t *dst, uint32_t *lut, const eConnected conn
 
                     if (connected == CONNECTED_EIGHT)
                     {
-                        uint32_t bottom_left = dst->data[idx + src->cols - 1];
+                        uint32_t bottom_left = dst->data[idx + dst_stride - 1];
 
                         if (bottom_left == 2)
                         {
@@ -1143,7 +1708,7 @@ void RecordBorderEquivalences(image_t *dst, uint32_t *lut, const eConnected conn
                 if (y == dst->rows - 2)
                 {
                     // check pixels onder
-                    uint32_t bottom = dst->data[idx + dst->cols];
+                    uint32_t bottom = dst->data[idx + dst_stride];
 
                     // als waarde = 2
                     if (bottom == 2)
@@ -1153,14 +1718,14 @@ void RecordBorderEquivalences(image_t *dst, uint32_t *lut, const eConnected conn
 
                     if (connected == CONNECTED_EIGHT)
                     {
-                        uint32_t bottom_left = dst->data[idx + dst->cols - 1];
+                        uint32_t bottom_left = dst->data[idx + dst_stride - 1];
 
                         if (bottom_left == 2)
                         {
                             linkLabelToBorder(lut, currentLabel);
                         }
 
-                        uint32_t bottom_right = dst->data[idx + dst->cols + 1];
+                        uint32_t bottom_right = dst->data[idx + dst_stride + 1];
 
                         if (bottom_right == 2)
                         {
@@ -1171,15 +1736,22 @@ void RecordBorderEquivalences(image_t *dst, uint32_t *lut, const eConnected conn
             }
         }
     }
+
+    TRACE_EXIT();
 }
 
 void SecondPass(image_t *dst, uint32_t *lut)
 {
+    TRACE_ENTER(dst, NULL);
+
+    // The destination image can be a view
+    const uint32_t dst_stride = IMAGE_STRIDE(dst);
+
     for (uint32_t y = 0; y < dst->rows; y++)
     {
         for (uint32_t x = 0; x < dst->cols; x++)
         {
-            uint32_t idx = y * dst->cols + x;
+            uint32_t idx = y * dst_stride + x;
             uint32_t currentLabel = dst->data[idx];
 
             // 1. If background, keep it background
@@ -1199,6 +1771,8 @@ void SecondPass(image_t *dst, uint32_t *lut)
             }
         }
     }
+
+    TRACE_EXIT();
 }
 
 void ResolveEquivalences(uint32_t nextLabel, uint32_t *lut)
@@ -1231,24 +1805,30 @@ void linkLabelToBorder(uint32_t *lut, uint32_t currentLabel)
 
 void MarkBorderPixels(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
+    // Both images can be views with a different stride
+    const uint32_t src_stride = IMAGE_STRIDE(src);
+    const uint32_t dst_stride = IMAGE_STRIDE(dst);
+
     for (uint32_t y = 0; y < src->rows; y++)
     {
         for (uint32_t x = 0; x < src->cols; x++)
         {
-            uint32_t idx = y * src->cols + x;
+            uint32_t idx = y * dst_stride + x;
 
             // if on border
             if (x == 0 || x == src->cols - 1 || y == 0 || y == src->rows - 1)
             {
                 // if object
-                if (src->data[idx] != 0)
+                if (src->data[y * src_stride + x] != 0)
                 {
                     // set in destination 2
                     dst->data[idx] = 2;
                 }
 
                 // if background
-                if (src->data[idx] == 0)
+                if (src->data[y * src_stride + x] == 0)
                 {
                     // set in destination 0
                     dst->data[idx] = 0;
@@ -1256,6 +1836,8 @@ void MarkBorderPixels(const image_t *src, image_t *dst)
             }
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -1269,6 +1851,9 @@ void MarkBorderPixels(const image_t *src, image_t *dst)
  * yields the null image.
  * The function does not necessarily produce a fully connected object.
  *
+ * Supports images of type IMGTYPE_BINARY as well. For asymmetric masks the
+ * binary version clips the difference to 0 instead of wrapping around.
+ *
  * \param[in]  src  A pointer to the source image
  * \param[out] dst  A pointer to the destination image
  * \param[in]  mask A pointer to a square mask of size \p n
@@ -1276,13 +1861,17 @@ void MarkBorderPixels(const image_t *src, image_t *dst)
  */
 void skeleton(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_t n)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
-    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
-    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_BINARY), "src type is invalid");
+    ASSERT(dst->type != src->type, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify mask validity
     ASSERT(mask == NULL, "mask is invalid");
@@ -1293,9 +1882,20 @@ void skeleton(const image_t *src, image_t *dst, const uint8_t *mask, const uint8
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
+    // Binary images are processed 64 pixels at once
+    if (src->type == IMGTYPE_BINARY)
+    {
+        skeletonBinary(src, dst, mask, n);
+
+        TRACE_EXIT();
+        return;
+    }
+
     clearUint8Image(dst);
 
-    // Create temporary images
+    // Create temporary images in the image arena
+    image_arena_mark_t mark = markImageArena();
+
     image_t *org = newUint8Image(src->cols, src->rows);
     image_t *eroded = newUint8Image(src->cols, src->rows);
     image_t *opened = newUint8Image(src->cols, src->rows);
@@ -1320,26 +1920,247 @@ void skeleton(const image_t *src, image_t *dst, const uint8_t *mask, const uint8
         // Loop all pixels, skip the border
         for (int32_t y = n / 2; y < org->rows - (n / 2); y++)
         {
+            uint8_pixel_t *o = (uint8_pixel_t *)org->data + (y * IMAGE_STRIDE(org));
+            const uint8_pixel_t *op = (const uint8_pixel_t *)opened->data + (y * IMAGE_STRIDE(opened));
+            const uint8_pixel_t *e = (const uint8_pixel_t *)eroded->data + (y * IMAGE_STRIDE(eroded));
+            uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
             for (int32_t x = (n / 2); x < org->cols - (n / 2); x++)
             {
                 // Calculate Kn(A): erode_n-1(org) - open(erode_n(org), mask)
-                uint8_pixel_t p = getUint8Pixel(org, x, y) - getUint8Pixel(opened, x, y);
+                uint8_pixel_t p = o[x] - op[x];
 
                 // Create skeleton by the union of Kn(A) of all erosions
-                setUint8Pixel(dst, x, y, getUint8Pixel(dst, x, y) | p);
+                d[x] |= p;
 
                 // Copy eroded image to original image
-                setUint8Pixel(org, x, y, getUint8Pixel(eroded, x, y));
+                o[x] = e[x];
 
                 // Continue as long as the original image has not yet been fully eroded
-                if (getUint8Pixel(org, x, y) == 1)
+                if (o[x] == 1)
                     changes = 1;
             }
         }
     }
 
     // Cleanup
-    deleteUint8Image(org);
-    deleteUint8Image(eroded);
-    deleteUint8Image(opened);
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
+}
+
+/// Pixel flags used by thinning() in the destination image
+#define THIN_OBJECT (0x01) ///< Object pixel
+#define THIN_DIRTY0 (0x02) ///< Check the pixel in the first subiteration
+#define THIN_DIRTY1 (0x04) ///< Check the pixel in the second subiteration
+#define THIN_DELETE (0x08) ///< Delete the pixel at the end of the subiteration
+
+/*!
+ * \brief Zhang-Suen deletion table
+ *
+ * The index is the 8-neighbourhood of a pixel, with bit 0 to 7 being the
+ * north, north-east, east, south-east, south, south-west, west and north-west
+ * neighbour. Bit 0 of an entry is set if the pixel can be deleted in the first
+ * subiteration, bit 1 if it can be deleted in the second subiteration.
+ */
+static const uint8_t thinning_lut[256] =
+{
+    0, 0, 0, 3, 0, 0, 3, 3, 0, 0, 0, 0, 3, 0, 3, 3,
+    0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 0, 0, 3, 0, 3, 2,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    3, 0, 0, 0, 0, 0, 0, 0, 3, 0, 0, 0, 3, 0, 3, 2,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    3, 0, 0, 0, 0, 0, 0, 0, 3, 0, 0, 0, 2, 0, 2, 0,
+    0, 3, 0, 3, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 3,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    3, 3, 0, 3, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    3, 3, 0, 3, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+    3, 1, 0, 1, 0, 0, 0, 0, 3, 1, 0, 0, 2, 0, 0, 0,
+};
+
+/*!
+ * \brief Returns the 8-neighbourhood of a pixel as an index of thinning_lut
+ *
+ * Pixels outside the image are background.
+ *
+ * \param[in] img A pointer to the image
+ * \param[in] x   The column of the pixel
+ * \param[in] y   The row of the pixel
+ *
+ * \return The 8-neighbourhood of the pixel
+ */
+static inline uint8_t thinningCode(const image_t *img, const int32_t x, const int32_t y)
+{
+    const int32_t stride = IMAGE_STRIDE(img);
+    const uint8_pixel_t *p = (const uint8_pixel_t *)img->data + (y * stride) + x;
+
+    // Relative offsets of the neighbours, in the bit order of the table
+    const int32_t dx[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    const int32_t dy[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+    uint8_t code = 0;
+
+    if ((x > 0) && (y > 0) && (x < (img->cols - 1)) && (y < (img->rows - 1)))
+    {
+        for (int32_t k = 0; k < 8; k++)
+        {
+            code |= (uint8_t)((p[(dy[k] * stride) + dx[k]] & THIN_OBJECT) << k);
+        }
+    }
+    else
+    {
+        for (int32_t k = 0; k < 8; k++)
+        {
+            const int32_t nx = x + dx[k];
+            const int32_t ny = y + dy[k];
+
+            if ((nx >= 0) && (ny >= 0) && (nx < img->cols) && (ny < img->rows))
+            {
+                code |= (uint8_t)((p[(dy[k] * stride) + dx[k]] & THIN_OBJECT) << k);
+            }
+        }
+    }
+
+    return code;
+}
+
+/*!
+ * \brief Thinning reduces the objects in a binary image to lines of one pixel
+ *        wide, preserving the topology
+ *
+ * Implements the Zhang-Suen algorithm with a 256-entry lookup table. In
+ * contrast to skeleton(), the result is connected and no temporary images are
+ * needed: the state of every pixel is kept in the upper bits of \p dst.
+ *
+ * A pixel can only become deletable if one of its neighbours was deleted.
+ * Therefore, after the first pass, only the neighbours of deleted pixels are
+ * checked again, and only the bounding box of these pixels is scanned.
+ *
+ * \param[in]  src A pointer to the binary source image
+ * \param[out] dst A pointer to the destination image
+ */
+void thinning(const image_t *src, image_t *dst)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+
+    // Verify image consistency
+    ASSERT(src == dst, "src and dst are the same images");
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    const int32_t cols = dst->cols;
+    const int32_t rows = dst->rows;
+    const int32_t stride = IMAGE_STRIDE(dst);
+
+    // Every object pixel is checked in both subiterations of the first pass
+    for (int32_t y = 0; y < rows; y++)
+    {
+        const uint8_pixel_t *s = (const uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * stride);
+
+        for (int32_t x = 0; x < cols; x++)
+        {
+            d[x] = (s[x] == 1) ? (THIN_OBJECT | THIN_DIRTY0 | THIN_DIRTY1) : 0;
+        }
+    }
+
+    // Bounding box {x0, y0, x1, y1} of the pixels to check per subiteration
+    int32_t box[2][4] = {{0, 0, cols - 1, rows - 1}, {0, 0, cols - 1, rows - 1}};
+
+    // Alternate the subiterations until both bounding boxes are empty
+    for (int32_t it = 0; (box[0][0] <= box[0][2]) || (box[1][0] <= box[1][2]); it = 1 - it)
+    {
+        const uint8_t dirty = (it == 0) ? THIN_DIRTY0 : THIN_DIRTY1;
+        const int32_t x0 = box[it][0];
+        const int32_t y0 = box[it][1];
+        const int32_t x1 = box[it][2];
+        const int32_t y1 = box[it][3];
+
+        // All pixels of this subiteration are checked below
+        box[it][0] = cols;
+        box[it][1] = rows;
+        box[it][2] = -1;
+        box[it][3] = -1;
+
+        // Mark the deletable pixels, the image is not changed yet
+        for (int32_t y = y0; y <= y1; y++)
+        {
+            uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * stride);
+
+            for (int32_t x = x0; x <= x1; x++)
+            {
+                if ((d[x] & dirty) == 0)
+                {
+                    continue;
+                }
+
+                d[x] &= ~dirty;
+
+                if ((thinning_lut[thinningCode(dst, x, y)] & (1 << it)) != 0)
+                {
+                    d[x] |= THIN_DELETE;
+                }
+            }
+        }
+
+        // Delete the marked pixels and flag their neighbours for both
+        // subiterations
+        for (int32_t y = y0; y <= y1; y++)
+        {
+            uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * stride);
+
+            for (int32_t x = x0; x <= x1; x++)
+            {
+                if ((d[x] & THIN_DELETE) == 0)
+                {
+                    continue;
+                }
+
+                d[x] = 0;
+
+                const int32_t nx0 = (x > 0) ? (x - 1) : 0;
+                const int32_t ny0 = (y > 0) ? (y - 1) : 0;
+                const int32_t nx1 = (x < (cols - 1)) ? (x + 1) : (cols - 1);
+                const int32_t ny1 = (y < (rows - 1)) ? (y + 1) : (rows - 1);
+
+                for (int32_t ny = ny0; ny <= ny1; ny++)
+                {
+                    uint8_pixel_t *n = (uint8_pixel_t *)dst->data + (ny * stride);
+
+                    for (int32_t nx = nx0; nx <= nx1; nx++)
+                    {
+                        if ((n[nx] & THIN_OBJECT) != 0)
+                        {
+                            n[nx] |= THIN_DIRTY0 | THIN_DIRTY1;
+                        }
+                    }
+                }
+
+                for (int32_t i = 0; i < 2; i++)
+                {
+                    box[i][0] = (nx0 < box[i][0]) ? nx0 : box[i][0];
+                    box[i][1] = (ny0 < box[i][1]) ? ny0 : box[i][1];
+                    box[i][2] = (nx1 > box[i][2]) ? nx1 : box[i][2];
+                    box[i][3] = (ny1 > box[i][3]) ? ny1 : box[i][3];
+                }
+            }
+        }
+    }
+
+    TRACE_EXIT();
 }
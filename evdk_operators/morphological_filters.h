@@ -63,6 +63,7 @@ extern "C"
     void ResolveEquivalences(uint32_t nextLabel, uint32_t *lut);
     void MarkBorderPixels(const image_t *src, image_t *dst);
     void skeleton(const image_t *src, image_t *dst, const uint8_t *mask, const uint8_t n);
+    void thinning(const image_t *src, image_t *dst);
 
 #endif // _MORPHOLOGICAL_FILTERS_H_
 
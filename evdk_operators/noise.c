@@ -8,6 +8,12 @@
  *
  * \see       Myler, H. R., & Weeks, A. R. (2009). The pocket handbook of
  *            image processing algorithms in C. Prentice Hall Press.
+ * \see       Blackman, D., & Vigna, S. (2021). Scrambled linear pseudorandom
+ *            number generators. ACM Transactions on Mathematical Software,
+ *            47(4), 1-32.
+ * \see       Marsaglia, G., & Tsang, W. W. (2000). The ziggurat method for
+ *            generating random variables. Journal of Statistical Software,
+ *            5(8), 1-7.
  *
  * \copyright 2024 HAN University of Applied Sciences. All Rights Reserved.
  *            \n\n
@@ -35,10 +41,197 @@
  *****************************************************************************/
 #include "image_fundamentals.h"
 #include "noise.h"
+#include "trace.h"
 
 #define _USE_MATH_DEFINES
 #include "math.h"
 #include "time.h"
+#include <string.h>
+
+/// Number of layers of the ziggurat, a power of 2
+#define ZIGGURAT_LAYERS (128)
+
+/// Start of the tail of the normal distribution, for 128 layers
+#define ZIGGURAT_R (3.442619855899)
+
+/// Area of every layer of the ziggurat, for 128 layers
+#define ZIGGURAT_V (9.91256303526217e-3)
+
+// Ziggurat tables, shared by all generators and built by rngSeed()
+static uint32_t zig_k[ZIGGURAT_LAYERS]; // Rectangle limit of every layer
+static float zig_w[ZIGGURAT_LAYERS];    // Scale from integer to x
+static float zig_f[ZIGGURAT_LAYERS];    // Density at the edge of every layer
+static int32_t zig_ready = 0;
+
+// Generator of the functions without an rng_t parameter
+static rng_t default_rng;
+static int32_t default_seeded = 0;
+
+// Function prototypes
+static inline uint32_t xoshiro128ss(uint32_t s[4]);
+static inline float uniformOpen(uint32_t s[4]);
+static inline float zigguratSample(uint32_t s[4]);
+static void zigguratInit(void);
+static rng_t *defaultRng(void);
+
+/*!
+ * \brief Seeds a pseudo random-number generator
+ *
+ * The seed is expanded to the 128-bit state with splitmix64, so similar seeds
+ * give unrelated sequences. The same seed always gives the same sequence, on
+ * every platform.
+ *
+ * The first call also builds the tables of rngGaussian(), so seed a generator
+ * before sharing it with other threads.
+ *
+ * \param[out] rng  A pointer to the generator
+ * \param[in]  seed The seed, any value
+ */
+void rngSeed(rng_t *rng, const uint64_t seed)
+{
+    ASSERT(rng == NULL, "rng is invalid");
+
+    uint64_t x = seed;
+
+    for (int32_t i = 0; i < 4; i += 2)
+    {
+        // splitmix64
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z = z ^ (z >> 31);
+
+        rng->s[i] = (uint32_t)z;
+        rng->s[i + 1] = (uint32_t)(z >> 32);
+    }
+
+    // The all zero state is the only invalid state
+    if ((rng->s[0] | rng->s[1] | rng->s[2] | rng->s[3]) == 0)
+    {
+        rng->s[0] = 1;
+    }
+
+    if (zig_ready == 0)
+    {
+        zigguratInit();
+    }
+}
+
+/*!
+ * \brief Returns the next pseudo random number of a generator
+ *
+ * \param[in,out] rng A pointer to a generator, see rngSeed()
+ *
+ * \return A pseudo random number, uniformly distributed in [0, 2^32)
+ */
+uint32_t rngUint32(rng_t *rng)
+{
+    return xoshiro128ss(rng->s);
+}
+
+/*!
+ * \brief Returns a uniformly distributed pseudo random number
+ *
+ * \param[in,out] rng A pointer to a generator, see rngSeed()
+ *
+ * \return A pseudo random number in [0, 1), with a resolution of 2^-24
+ */
+float rngUniform(rng_t *rng)
+{
+    return (float)(xoshiro128ss(rng->s) >> 8) * (1.0f / 16777216.0f);
+}
+
+/*!
+ * \brief Returns a normally distributed pseudo random number
+ *
+ * The number is generated with the ziggurat method. The area under the
+ * density is divided into 128 layers of equal area, and a random point in a
+ * random layer is accepted right away for about 99% of the numbers. Only the
+ * rejected points evaluate exp() or log(). This is several times faster than
+ * the Box-Muller method, which evaluates log(), sqrt() and cos() for every
+ * number.
+ *
+ * \param[in,out] rng A pointer to a generator, see rngSeed()
+ *
+ * \return A pseudo random number with mean 0 and standard deviation 1
+ */
+float rngGaussian(rng_t *rng)
+{
+    return zigguratSample(rng->s);
+}
+
+/*!
+ * \brief Fills a buffer with pseudo random numbers
+ *
+ * The result is the same as \p n calls of rngUint32(), but the state stays in
+ * registers.
+ *
+ * \param[in,out] rng A pointer to a generator, see rngSeed()
+ * \param[out]    buf A pointer to a buffer of at least \p n numbers
+ * \param[in]     n   Number of pseudo random numbers
+ */
+void rngFillUint32(rng_t *rng, uint32_t *buf, const size_t n)
+{
+    ASSERT(rng == NULL, "rng is invalid");
+    ASSERT(buf == NULL, "buf is invalid");
+
+    uint32_t s[4] = {rng->s[0], rng->s[1], rng->s[2], rng->s[3]};
+
+    for (size_t i = 0; i < n; i++)
+    {
+        buf[i] = xoshiro128ss(s);
+    }
+
+    memcpy(rng->s, s, sizeof(s));
+}
+
+/*!
+ * \brief Fills a buffer with uniformly distributed pseudo random numbers
+ *
+ * The result is the same as \p n calls of rngUniform().
+ *
+ * \param[in,out] rng A pointer to a generator, see rngSeed()
+ * \param[out]    buf A pointer to a buffer of at least \p n numbers
+ * \param[in]     n   Number of pseudo random numbers
+ */
+void rngFillUniform(rng_t *rng, float *buf, const size_t n)
+{
+    ASSERT(rng == NULL, "rng is invalid");
+    ASSERT(buf == NULL, "buf is invalid");
+
+    uint32_t s[4] = {rng->s[0], rng->s[1], rng->s[2], rng->s[3]};
+
+    for (size_t i = 0; i < n; i++)
+    {
+        buf[i] = (float)(xoshiro128ss(s) >> 8) * (1.0f / 16777216.0f);
+    }
+
+    memcpy(rng->s, s, sizeof(s));
+}
+
+/*!
+ * \brief Fills a buffer with normally distributed pseudo random numbers
+ *
+ * The result is the same as \p n calls of rngGaussian().
+ *
+ * \param[in,out] rng A pointer to a generator, see rngSeed()
+ * \param[out]    buf A pointer to a buffer of at least \p n numbers
+ * \param[in]     n   Number of pseudo random numbers
+ */
+void rngFillGaussian(rng_t *rng, float *buf, const size_t n)
+{
+    ASSERT(rng == NULL, "rng is invalid");
+    ASSERT(buf == NULL, "buf is invalid");
+
+    uint32_t s[4] = {rng->s[0], rng->s[1], rng->s[2], rng->s[3]};
+
+    for (size_t i = 0; i < n; i++)
+    {
+        buf[i] = zigguratSample(s);
+    }
+
+    memcpy(rng->s, s, sizeof(s));
+}
 
 /*!
  * \brief Generates image data containing salt and pepper noise
@@ -49,102 +242,188 @@
  * 255. Salt and pepper noise occur in images acquired by cameras containing
  * malfunctioning pixels.
  *
+ * The noise differs on every call, see saltPepperRng() for reproducible noise.
+ *
  * \param[out] img         A pointer to the image
  * \param[in]  probability The probability of the noise appearing in the image
  */
 void saltPepper(image_t *img, const float probability)
 {
+    saltPepperRng(img, probability, defaultRng());
+}
+
+/*!
+ * \brief Generates image data containing Gaussian noise
+ *
+ * The function removes the original image data.
+ *
+ * The noise differs on every call, see gaussianRng() for reproducible noise.
+ *
+ * \param[out] img  A pointer to the image
+ * \param[in]  var  Variance of the noise
+ * \param[in]  mean Mean value of the noise
+ */
+void gaussian(image_t *img, const float var, const float mean)
+{
+    gaussianRng(img, var, mean, defaultRng());
+}
+
+/*!
+ * \brief Generates image data containing uniform noise between \p min and \p
+ *        max
+ *
+ * The function removes the original image data.
+ * Uniform noise is used to degrade images in the evaluation of image
+ * processing algorithms.
+ *
+ * The noise differs on every call, see uniformRng() for reproducible noise.
+ *
+ * \param[out] img A pointer to the image
+ * \param[in]  min Minimum value of the uniform noise
+ * \param[in]  max Maximum value of the uniform noise
+ */
+void uniform(image_t *img, const uint8_pixel_t min, const uint8_pixel_t max)
+{
+    uniformRng(img, min, max, defaultRng());
+}
+
+/*!
+ * \brief Adds salt and pepper noise to an image with a given generator
+ *
+ * Each pixel is set to 0 with probability \p probability / 2 and to 255 with
+ * probability \p probability / 2, the other pixels are not changed.
+ *
+ * \param[in,out] img         A pointer to the image, can be a luma view
+ * \param[in]     probability The probability of the noise, in [0, 1]
+ * \param[in,out] rng         A pointer to a generator, see rngSeed()
+ */
+void saltPepperRng(image_t *img, const float probability, rng_t *rng)
+{
+    TRACE_ENTER(img, NULL);
+
     // Verify image validity
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_UINT8, "img type is invalid");
 
-    // Set window boundaries
-    uint32_t window_size = (uint32_t)(probability * (RAND_MAX/2));
-    uint32_t boundary_right = (RAND_MAX/2) + window_size;
-    uint32_t boundary_left = (RAND_MAX/2) - window_size;
+    // Verify parameters
+    ASSERT((probability < 0.0f) || (probability > 1.0f), "probability is invalid");
+    ASSERT(rng == NULL, "rng is invalid");
+
+    // Numbers below half are pepper, numbers below twice half are salt
+    const uint64_t half = (uint64_t)((double)probability * 2147483648.0);
+    const int32_t stride = IMAGE_STRIDE(img);
+    const int32_t step = IMAGE_STEP(img);
 
-    // Seed the pseudo random-number generator
-    srand(time(0));
+    uint32_t s[4] = {rng->s[0], rng->s[1], rng->s[2], rng->s[3]};
 
-    for(int32_t y=0; y<img->rows; y++)
+    for (int32_t y = 0; y < img->rows; y++)
     {
-        for(int32_t x=0; x<img->cols; x++)
-        {
-            // Get random-number
-            uint32_t val = rand();
+        uint8_pixel_t *d = (uint8_pixel_t *)img->data + (y * stride);
 
-            // Within 'pepper' window? Set pixel to 0
-            if((val >= (RAND_MAX/2)) && (val < boundary_right))
-                setUint8Pixel(img, x, y, 0);
+        for (int32_t x = 0; x < img->cols; x++)
+        {
+            const uint64_t val = xoshiro128ss(s);
 
-            // Within 'salt' window? Set pixel to 255
-            else if((val >= boundary_left) && (val < (RAND_MAX/2)))
-                setUint8Pixel(img, x, y, 255);
+            if (val < half)
+            {
+                d[x * step] = 0;
+            }
+            else if (val < (2 * half))
+            {
+                d[x * step] = 255;
+            }
         }
     }
+
+    memcpy(rng->s, s, sizeof(s));
+
+    TRACE_EXIT();
 }
 
 /*!
- * \brief Generates image data containing Gaussian noise
+ * \brief Generates image data containing Gaussian noise with a given
+ *        generator
  *
- * The function removes the original image data.
- * The Gaussian value for each pixel is then calculated with the Box-Muller
- * method.
+ * The function removes the original image data. The pixels are \p mean plus
+ * normally distributed noise with variance \p var, rounded and clipped to
+ * [0, 255]. The noise of a row is generated in one batch with
+ * rngFillGaussian(), see rngGaussian().
  *
- * \param[out] img  A pointer to the image
- * \param[in]  var  Standard deviation of the noise
- * \param[in]  mean Mean value of the noise
+ * \param[out]    img  A pointer to the image, can be a luma view
+ * \param[in]     var  Variance of the noise
+ * \param[in]     mean Mean value of the noise
+ * \param[in,out] rng  A pointer to a generator, see rngSeed()
  */
-void gaussian(image_t *img, const float var, const float mean)
+void gaussianRng(image_t *img, const float var, const float mean, rng_t *rng)
 {
+    TRACE_ENTER(img, NULL);
+
     // Verify image validity
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
     ASSERT(img->type != IMGTYPE_UINT8, "img type is invalid");
 
-    float noise, theta;
+    // Verify parameters
+    ASSERT(var < 0.0f, "var is invalid");
+    ASSERT(rng == NULL, "rng is invalid");
 
-    // Seed the pseudo random-number generator
-    srand(time(0));
+    image_arena_mark_t mark = markImageArena();
+    float *noise = (float *)allocImageArena((size_t)img->cols * sizeof(float));
 
-    for(int32_t y=0; y<img->rows; y++)
+    if (noise == NULL)
     {
-        for(int32_t x=0; x<img->cols; x++)
+        ASSERT(1 == 1, "Unable to allocate memory for the noise, increase the size of the image arena");
+        releaseImageArena(mark);
+        TRACE_EXIT();
+        return;
+    }
+
+    const float sd = sqrtf(var);
+    const int32_t stride = IMAGE_STRIDE(img);
+    const int32_t step = IMAGE_STEP(img);
+
+    for (int32_t y = 0; y < img->rows; y++)
+    {
+        uint8_pixel_t *d = (uint8_pixel_t *)img->data + (y * stride);
+
+        rngFillGaussian(rng, noise, (size_t)img->cols);
+
+        for (int32_t x = 0; x < img->cols; x++)
         {
-            // Calculate Gaussian noise using Box-Muller method
-            theta = ((float)rand() / (float)RAND_MAX) * 2 * 3.14159265359f;
-            noise = sqrt(-2 * var * log((float)rand() / (float)RAND_MAX));
-            noise = noise * cos(theta);
-            noise = noise + mean;
+            float val = (noise[x] * sd) + mean;
 
             // Clip the result
-            if(noise>255)
-                noise=255;
-
-            if(noise<0)
-                noise=0;
+            val = (val > 255.0f) ? 255.0f : val;
+            val = (val < 0.0f) ? 0.0f : val;
 
             // Store the result
-            setUint8Pixel(img, x, y, (uint8_pixel_t)(noise + 0.5f));
+            d[x * step] = (uint8_pixel_t)(val + 0.5f);
         }
     }
+
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
 }
 
 /*!
  * \brief Generates image data containing uniform noise between \p min and \p
- *        max
+ *        max with a given generator
  *
- * The function removes the original image data.
- * Uniform noise is used to degrade images in the evaluation of image
- * processing algorithms.
+ * The function removes the original image data. Every value in
+ * [\p min, \p max] has the same probability.
  *
- * \param[out] img A pointer to the image
- * \param[in]  min Minimum value of the uniform noise
- * \param[in]  max Maximum value of the uniform noise
+ * \param[out]    img A pointer to the image, can be a luma view
+ * \param[in]     min Minimum value of the uniform noise
+ * \param[in]     max Maximum value of the uniform noise
+ * \param[in,out] rng A pointer to a generator, see rngSeed()
  */
-void uniform(image_t *img, const uint8_pixel_t min, const uint8_pixel_t max)
+void uniformRng(image_t *img, const uint8_pixel_t min, const uint8_pixel_t max,
+                rng_t *rng)
 {
+    TRACE_ENTER(img, NULL);
+
     // Verify image validity
     ASSERT(img == NULL, "img image is invalid");
     ASSERT(img->data == NULL, "img data is invalid");
@@ -152,28 +431,164 @@ void uniform(image_t *img, const uint8_pixel_t min, const uint8_pixel_t max)
 
     // Verify parameters
     ASSERT(min > max, "min is greater than max");
+    ASSERT(rng == NULL, "rng is invalid");
 
-    float noise;
+    const uint64_t range = (uint64_t)(max - min) + 1;
+    const int32_t stride = IMAGE_STRIDE(img);
+    const int32_t step = IMAGE_STEP(img);
 
-    // Seed the pseudo random-number generator
-    srand(time(0));
+    uint32_t s[4] = {rng->s[0], rng->s[1], rng->s[2], rng->s[3]};
 
-    for(int32_t y=0; y<img->rows; y++)
+    for (int32_t y = 0; y < img->rows; y++)
     {
-        for(int32_t x=0; x<img->cols; x++)
+        uint8_pixel_t *d = (uint8_pixel_t *)img->data + (y * stride);
+
+        for (int32_t x = 0; x < img->cols; x++)
         {
-            // Calculate uniform noise
-            noise = ((float)rand() / (float)RAND_MAX) * (max - min) + min;
+            // Scale [0, 2^32) to [0, range) without a division
+            d[x * step] = (uint8_pixel_t)(min + ((xoshiro128ss(s) * range) >> 32));
+        }
+    }
 
-            // Clip the result
-            if(noise>255)
-                noise=255;
+    memcpy(rng->s, s, sizeof(s));
+
+    TRACE_EXIT();
+}
 
-            if(noise<0)
-                noise=0;
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
 
-            // Store the result
-            setUint8Pixel(img, x, y, (uint8_pixel_t)(noise + 0.5f));
+/*!
+ * \brief Advances the xoshiro128** generator
+ *
+ * \param[in,out] s The state
+ *
+ * \return The next pseudo random number
+ */
+static inline uint32_t xoshiro128ss(uint32_t s[4])
+{
+    const uint32_t r = s[1] * 5;
+    const uint32_t result = ((r << 7) | (r >> 25)) * 9;
+    const uint32_t t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 11) | (s[3] >> 21);
+
+    return result;
+}
+
+/*!
+ * \brief Returns a uniformly distributed pseudo random number in (0, 1]
+ *
+ * \param[in,out] s The state
+ *
+ * \return The pseudo random number, never 0 so it is safe for log()
+ */
+static inline float uniformOpen(uint32_t s[4])
+{
+    return (float)((xoshiro128ss(s) >> 8) + 1) * (1.0f / 16777216.0f);
+}
+
+/*!
+ * \brief Generates a normally distributed pseudo random number
+ *
+ * \param[in,out] s The state
+ *
+ * \return The pseudo random number
+ */
+static inline float zigguratSample(uint32_t s[4])
+{
+    for (;;)
+    {
+        // The low bits select the layer, the other bits the position
+        const uint32_t r = xoshiro128ss(s);
+        const uint32_t i = r & (ZIGGURAT_LAYERS - 1);
+        const int32_t h = (int32_t)(r & ~(uint32_t)(ZIGGURAT_LAYERS - 1));
+        const uint32_t a = (h < 0) ? (0u - (uint32_t)h) : (uint32_t)h;
+        const float x = (float)h * zig_w[i];
+
+        // Inside the rectangle of the layer
+        if (a < zig_k[i])
+        {
+            return x;
         }
+
+        // Beyond ZIGGURAT_R in the base layer, sample the tail
+        if (i == 0)
+        {
+            float t;
+            float u;
+
+            do
+            {
+                t = -logf(uniformOpen(s)) * (float)(1.0 / ZIGGURAT_R);
+                u = -logf(uniformOpen(s));
+            }
+            while ((u + u) < (t * t));
+
+            return (h > 0) ? ((float)ZIGGURAT_R + t) : -((float)ZIGGURAT_R + t);
+        }
+
+        // In the wedge between the rectangle and the density
+        const float fy = zig_f[i] + (uniformOpen(s) * (zig_f[i - 1] - zig_f[i]));
+
+        if (fy < expf(-0.5f * x * x))
+        {
+            return x;
+        }
+    }
+}
+
+/*!
+ * \brief Builds the ziggurat tables
+ *
+ * Layer i spans x in [0, x_i] with x_127 = ZIGGURAT_R, the positions are
+ * signed 32-bit integers scaled by zig_w.
+ */
+static void zigguratInit(void)
+{
+    const double m = 2147483648.0;
+    const double q = ZIGGURAT_V / exp(-0.5 * ZIGGURAT_R * ZIGGURAT_R);
+    double d = ZIGGURAT_R;
+    double t = d;
+
+    zig_k[0] = (uint32_t)((d / q) * m);
+    zig_k[1] = 0;
+    zig_w[0] = (float)(q / m);
+    zig_w[ZIGGURAT_LAYERS - 1] = (float)(d / m);
+    zig_f[0] = 1.0f;
+    zig_f[ZIGGURAT_LAYERS - 1] = (float)exp(-0.5 * d * d);
+
+    for (int32_t i = ZIGGURAT_LAYERS - 2; i >= 1; i--)
+    {
+        d = sqrt(-2.0 * log((ZIGGURAT_V / d) + exp(-0.5 * d * d)));
+        zig_k[i + 1] = (uint32_t)((d / t) * m);
+        t = d;
+        zig_f[i] = (float)exp(-0.5 * d * d);
+        zig_w[i] = (float)(d / m);
     }
+
+    zig_ready = 1;
+}
+
+/*!
+ * \brief Returns the generator of the functions without an rng_t parameter
+ *
+ * It is seeded with the time of the first call.
+ *
+ * \return A pointer to the generator
+ */
+static rng_t *defaultRng(void)
+{
+    if (default_seeded == 0)
+    {
+        rngSeed(&default_rng, (uint64_t)time(0));
+        default_seeded = 1;
+    }
+
+    return &default_rng;
 }
@@ -41,11 +41,37 @@ extern "C" {
 
 #include "image.h"
 
+/*!
+ * \brief Defines the state of a pseudo random-number generator
+ *
+ * The generator is xoshiro128**, which has a period of 2^128 - 1 and needs
+ * only 32-bit operations. Every generator has its own state, so generators in
+ * different threads do not interfere and every sequence is reproducible from
+ * its seed, see rngSeed().
+ */
+typedef struct
+{
+    uint32_t s[4]; ///< The state, never all zero
+
+}rng_t;
+
 // Functions are documented in the source file
 
+void rngSeed(rng_t *rng, const uint64_t seed);
+uint32_t rngUint32(rng_t *rng);
+float rngUniform(rng_t *rng);
+float rngGaussian(rng_t *rng);
+void rngFillUint32(rng_t *rng, uint32_t *buf, const size_t n);
+void rngFillUniform(rng_t *rng, float *buf, const size_t n);
+void rngFillGaussian(rng_t *rng, float *buf, const size_t n);
+
 void gaussian(image_t *img, const float var, const float mean);
 void saltPepper(image_t *img, const float probability);
 void uniform(image_t *img, const uint8_pixel_t min, const uint8_pixel_t max);
+void gaussianRng(image_t *img, const float var, const float mean, rng_t *rng);
+void saltPepperRng(image_t *img, const float probability, rng_t *rng);
+void uniformRng(image_t *img, const uint8_pixel_t min, const uint8_pixel_t max,
+                rng_t *rng);
 
 #endif // _NOISE_H_
 
@@ -36,6 +36,9 @@
  *****************************************************************************/
 #include "image_fundamentals.h"
 #include "nonlinear_filters.h"
+#include "trace.h"
+
+#include <string.h>
 
 /*!
  * \brief Removes positive outliers
@@ -48,6 +51,8 @@
  */
 void harmonic(const image_t *src, image_t *dst, const uint8_t n)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -55,6 +60,8 @@ void harmonic(const image_t *src, image_t *dst, const uint8_t n)
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -64,43 +71,53 @@ void harmonic(const image_t *src, image_t *dst, const uint8_t n)
     // Verify parameters
     ASSERT((n % 2) == 0, "window size is not an odd value");
 
-    // Loop all pixels
+    const uint8_pixel_t *src_data = (const uint8_pixel_t *)src->data;
+    const int32_t src_stride = IMAGE_STRIDE(src);
+    const int32_t h = n / 2;
+
+    // Loop all rows
     for (int32_t y = 0; y < src->rows; y++)
     {
+        uint8_pixel_t *dst_row = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Rows of the window that are within the image
+        const int32_t j0 = (y < h) ? -y : -h;
+        const int32_t j1 = ((y + h) >= src->rows) ? (src->rows - 1 - y) : h;
+
         for (int32_t x = 0; x < src->cols; x++)
         {
+            // Columns of the window that are within the image
+            const int32_t i0 = (x < h) ? -x : -h;
+            const int32_t i1 = ((x + h) >= src->cols) ? (src->cols - 1 - x) : h;
+
             // Initialize filter specific variables
             float sum = 0;
             uint32_t cnt = 0;
 
             // Apply the kernel only for pixels within the image
-            for (int32_t j = -n / 2; j <= n / 2; j++)
+            for (int32_t j = j0; j <= j1; j++)
             {
-                for (int32_t i = -n / 2; i <= n / 2; i++)
+                const uint8_pixel_t *s = src_data + ((y + j) * src_stride) + x;
+
+                for (int32_t i = i0; i <= i1; i++)
                 {
-                    if ((x + i) >= 0 &&
-                        (y + j) >= 0 &&
-                        (x + i) < src->cols &&
-                        (y + j) < src->rows)
+                    // Count the number of valid cells
+                    cnt++;
+
+                    // Calculation for each window cell
+                    uint8_pixel_t p = s[i];
+
+                    if (p == 0)
+                    {
+                        sum = 0.0f;
+
+                        // Break from loops
+                        i = i1 + 1;
+                        j = j1 + 1;
+                    }
+                    else
                     {
-                        // Count the number of valid cells
-                        cnt++;
-
-                        // Calculation for each window cell
-                        uint8_pixel_t p = getUint8Pixel(src, x + i, y + j);
-
-                        if (p == 0)
-                        {
-                            sum = 0.0f;
-
-                            // Break from loops
-                            i = n / 2 + 1;
-                            j = n / 2 + 1;
-                        }
-                        else
-                        {
-                            sum += 1.0f / p;
-                        }
+                        sum += 1.0f / p;
                     }
                 }
             }
@@ -108,25 +125,31 @@ void harmonic(const image_t *src, image_t *dst, const uint8_t n)
             // Calculate and store the result
             if (sum == 0)
             {
-                setUint8Pixel(dst, x, y, 0);
+                dst_row[x] = 0;
             }
             else
             {
-                setUint8Pixel(dst, x, y, (uint8_pixel_t)(cnt / sum + 0.5f));
+                dst_row[x] = (uint8_pixel_t)(cnt / sum + 0.5f);
             }
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
  * \brief Removes negative outlier noise
  *
+ * Uses runningMinMax(), so the execution time does not depend on \p n.
+ *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
  * \param[in]  n   Size of the square window
  */
 void maximum(const image_t *src, image_t *dst, const uint8_t n)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -134,6 +157,7 @@ void maximum(const image_t *src, image_t *dst, const uint8_t n)
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -143,33 +167,59 @@ void maximum(const image_t *src, image_t *dst, const uint8_t n)
     // Verify parameters
     ASSERT((n % 2) == 0, "window size is not an odd value");
 
-    // Loop all pixels
+    runningMinMax(src, NULL, dst, n, n);
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Mean filter that adds the pixels in the \p n x \p n window
+ *
+ * Used by mean() if the image arena is too small for the integral image.
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[out] dst A pointer to the destination image
+ * \param[in]  n   Size of the square window
+ */
+static void meanSum(const image_t *src, image_t *dst, const uint8_t n)
+{
+    const uint8_pixel_t *src_data = (const uint8_pixel_t *)src->data;
+    const int32_t src_stride = IMAGE_STRIDE(src);
+    const int32_t h = n / 2;
+
+    // Loop all rows
     for (int32_t y = 0; y < src->rows; y++)
     {
+        uint8_pixel_t *dst_row = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Rows of the window that are within the image
+        const int32_t j0 = (y < h) ? -y : -h;
+        const int32_t j1 = ((y + h) >= src->rows) ? (src->rows - 1 - y) : h;
+
         for (int32_t x = 0; x < src->cols; x++)
         {
+            // Columns of the window that are within the image
+            const int32_t i0 = (x < h) ? -x : -h;
+            const int32_t i1 = ((x + h) >= src->cols) ? (src->cols - 1 - x) : h;
+
             // Initialize filter specific variables
-            uint8_pixel_t max = UINT8_PIXEL_MIN;
+            uint32_t sum = 0;
+            uint32_t cnt = (uint32_t)((j1 - j0 + 1) * (i1 - i0 + 1));
 
             // Apply the kernel only for pixels within the image
-            for (int32_t j = -n / 2; j <= n / 2; j++)
+            for (int32_t j = j0; j <= j1; j++)
             {
-                for (int32_t i = -n / 2; i <= n / 2; i++)
+                const uint8_pixel_t *s = src_data + ((y + j) * src_stride) + x;
+
+                for (int32_t i = i0; i <= i1; i++)
                 {
-                    if ((x + i) >= 0 &&
-                        (y + j) >= 0 &&
-                        (x + i) < src->cols &&
-                        (y + j) < src->rows)
-                    {
-                        // Calculation for each window cell
-                        uint8_pixel_t p = getUint8Pixel(src, x + i, y + j);
-                        max = p > max ? p : max;
-                    }
+                    // Calculation for each window cell
+                    sum += s[i];
                 }
             }
 
-            // Calculate and store the result
-            setUint8Pixel(dst, x, y, max);
+            // Calculate and store the rounded result
+            dst_row[x] = (uint8_pixel_t)(((2 * sum) + cnt) / (2 * cnt));
         }
     }
 }
@@ -177,7 +227,11 @@ void maximum(const image_t *src, image_t *dst, const uint8_t n)
 /*!
  * \brief Calculates the arithmetic mean of the pixels within the window
  *
- * The window is always a square.
+ * The window is always a square. It is clipped at the image border.
+ *
+ * The window sums are read from an integral image, so the execution time per
+ * pixel does not depend on the window size. If the image arena is too small
+ * for the integral image, the pixels of every window are added instead.
  *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
@@ -185,6 +239,8 @@ void maximum(const image_t *src, image_t *dst, const uint8_t n)
  */
 void mean(const image_t *src, image_t *dst, const uint8_t n)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -192,6 +248,8 @@ void mean(const image_t *src, image_t *dst, const uint8_t n)
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -201,38 +259,55 @@ void mean(const image_t *src, image_t *dst, const uint8_t n)
     // Verify parameters
     ASSERT((n % 2) == 0, "window size is not an odd value");
 
-    // Loop all pixels
-    for (int32_t y = 0; y < src->rows; y++)
+    image_arena_mark_t mark = markImageArena();
+    image_t *ii = newUint32Image(src->cols + 1, src->rows + 1);
+
+    if (ii == NULL)
     {
-        for (int32_t x = 0; x < src->cols; x++)
-        {
-            // Initialize filter specific variables
-            uint32_t sum = 0;
-            uint32_t cnt = 0;
+        releaseImageArena(mark);
+        meanSum(src, dst, n);
 
-            // Apply the kernel only for pixels within the image
-            for (int32_t j = -n / 2; j <= n / 2; j++)
-            {
-                for (int32_t i = -n / 2; i <= n / 2; i++)
-                {
-                    if ((x + i) >= 0 &&
-                        (y + j) >= 0 &&
-                        (x + i) < src->cols &&
-                        (y + j) < src->rows)
-                    {
-                        // Count the number of valid pixels
-                        cnt++;
+        TRACE_EXIT();
+        return;
+    }
 
-                        // Calculation for each window cell
-                        sum += getUint8Pixel(src, x + i, y + j);
-                    }
-                }
-            }
+    integralImage(src, ii);
 
-            // Calculate and store the result
-            setUint8Pixel(dst, x, y, (uint8_pixel_t)((float)sum / (float)cnt + 0.5f));
+    const uint32_pixel_t *ii_data = (const uint32_pixel_t *)ii->data;
+    const int32_t ii_stride = IMAGE_STRIDE(ii);
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t h = n / 2;
+
+    // Loop all rows
+    for (int32_t y = 0; y < rows; y++)
+    {
+        uint8_pixel_t *dst_row = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Rows of the window that are within the image
+        const int32_t y0 = (y < h) ? 0 : (y - h);
+        const int32_t y1 = ((y + h) >= rows) ? rows : (y + h + 1);
+
+        const uint32_pixel_t *top = ii_data + (y0 * ii_stride);
+        const uint32_pixel_t *bottom = ii_data + (y1 * ii_stride);
+
+        for (int32_t x = 0; x < cols; x++)
+        {
+            // Columns of the window that are within the image
+            const int32_t x0 = (x < h) ? 0 : (x - h);
+            const int32_t x1 = ((x + h) >= cols) ? cols : (x + h + 1);
+
+            uint32_t sum = (bottom[x1] - bottom[x0]) - (top[x1] - top[x0]);
+            uint32_t cnt = (uint32_t)((y1 - y0) * (x1 - x0));
+
+            // Calculate and store the rounded result
+            dst_row[x] = (uint8_pixel_t)(((2 * sum) + cnt) / (2 * cnt));
         }
     }
+
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -245,9 +320,18 @@ void mean(const image_t *src, image_t *dst, const uint8_t n)
  */
 void meanFast(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
+    // Luma views are not supported, see lumaView()
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+
     uint8_pixel_t *src_data = (uint8_pixel_t *)src->data;
     uint8_pixel_t *dst_data = (uint8_pixel_t *)dst->data;
 
+    int32_t src_stride = IMAGE_STRIDE(src);
+    int32_t dst_stride = IMAGE_STRIDE(dst);
+
     // Loop all pixels
     for (int32_t y = 1; y < (src->rows - 1); y++)
     {
@@ -257,96 +341,90 @@ void meanFast(const image_t *src, image_t *dst)
             uint32_t sum = 0;
 
             // x + 1, y + 1
-            sum += src_data[((y + 1) * src->cols) + (x + 1)];
+            sum += src_data[((y + 1) * src_stride) + (x + 1)];
 
             // x, y + 1
-            sum += src_data[((y + 1) * src->cols) + x];
+            sum += src_data[((y + 1) * src_stride) + x];
 
             // x - 1, y + 1
-            sum += src_data[((y + 1) * src->cols) + (x - 1)];
+            sum += src_data[((y + 1) * src_stride) + (x - 1)];
 
             // x + 1, y
-            sum += src_data[(y * src->cols) + (x + 1)];
+            sum += src_data[(y * src_stride) + (x + 1)];
 
             // x, y
-            sum += src_data[(y * src->cols) + x];
+            sum += src_data[(y * src_stride) + x];
 
             // x - 1, y
-            sum += src_data[(y * src->cols) + (x - 1)];
+            sum += src_data[(y * src_stride) + (x - 1)];
 
             // x + 1, y - 1
-            sum += src_data[((y - 1) * src->cols) + (x + 1)];
+            sum += src_data[((y - 1) * src_stride) + (x + 1)];
 
             // x, y - 1
-            sum += src_data[((y - 1) * src->cols) + x];
+            sum += src_data[((y - 1) * src_stride) + x];
 
             // x - 1, y - 1
-            sum += src_data[((y - 1) * src->cols) + (x - 1)];
+            sum += src_data[((y - 1) * src_stride) + (x - 1)];
 
-            // Calculate and store the result
-            dst_data[(y * src->cols) + x] = (uint8_pixel_t)((float)sum / 9.0f + 0.5f);
+            // Calculate and store the result, rounded to the nearest integer.
+            // A sum of nine pixels is never exactly halfway between two
+            // integers, so this equals rounding sum / 9.0f.
+            dst_data[(y * dst_stride) + x] = (uint8_pixel_t)(((2 * sum) + 9) / 18);
         }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
- * \brief The median is calculated by sorting the pixels in the \p n x \p n
- * window and selecting the centre value
+ * \brief Median filter that sorts the pixels in the \p n x \p n window
  *
- * Removes long tailed noise and salt and pepper type noise.
- * Has minimum blurring effect and preserves spatial details.
- * Can remove outlier noise from images that contain less than 50% of its
- * pixels as outliers
+ * Used by median() if the image arena is too small for the histograms. The
+ * window size must not exceed 11.
  *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
  * \param[in]  n   Size of the square window
  */
-void median(const image_t *src, image_t *dst, const uint8_t n)
+static void medianSort(const image_t *src, image_t *dst, const uint8_t n)
 {
-    // Verify image validity
-    ASSERT(src == NULL, "src image is invalid");
-    ASSERT(dst == NULL, "dst image is invalid");
-    ASSERT(src->data == NULL, "src data is invalid");
-    ASSERT(dst->data == NULL, "dst data is invalid");
-    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
-    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
-
-    // Verify image consistency
-    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
-    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
-    ASSERT(src == dst, "src and dst are the same images");
-
-    // Verify parameters
-    ASSERT((n % 2) == 0, "window size is not an odd value");
-    ASSERT(n > 11, "window size is too large");
+    const uint8_pixel_t *src_data = (const uint8_pixel_t *)src->data;
+    const int32_t src_stride = IMAGE_STRIDE(src);
+    const int32_t h = n / 2;
 
     uint8_pixel_t median[121];
 
-    // Loop all pixels
+    // Loop all rows
     for (int32_t y = 0; y < src->rows; y++)
     {
+        uint8_pixel_t *dst_row = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Rows of the window that are within the image
+        const int32_t j0 = (y < h) ? -y : -h;
+        const int32_t j1 = ((y + h) >= src->rows) ? (src->rows - 1 - y) : h;
+
         for (int32_t x = 0; x < src->cols; x++)
         {
+            // Columns of the window that are within the image
+            const int32_t i0 = (x < h) ? -x : -h;
+            const int32_t i1 = ((x + h) >= src->cols) ? (src->cols - 1 - x) : h;
+
             // Initialize filter specific variables
             uint32_t cnt = 0;
 
             // Apply the kernel only for pixels within the image
-            for (int32_t j = -n / 2; j <= n / 2; j++)
+            for (int32_t j = j0; j <= j1; j++)
             {
-                for (int32_t i = -n / 2; i <= n / 2; i++)
+                const uint8_pixel_t *s = src_data + ((y + j) * src_stride) + x;
+
+                for (int32_t i = i0; i <= i1; i++)
                 {
-                    if ((x + i) >= 0 &&
-                        (y + j) >= 0 &&
-                        (x + i) < src->cols &&
-                        (y + j) < src->rows)
-                    {
-                        // Store pixel value in array
-                        median[cnt] = getUint8Pixel(src, x + i, y + j);
+                    // Store pixel value in array
+                    median[cnt] = s[i];
 
-                        // Count the number of valid cells
-                        cnt++;
-                    }
+                    // Count the number of valid cells
+                    cnt++;
                 }
             }
 
@@ -374,27 +452,173 @@ void median(const image_t *src, image_t *dst, const uint8_t n)
             if ((cnt % 2) == 0)
             {
                 // Store the result
-                setUint8Pixel(dst, x, y, (median[(cnt / 2) - 1] + median[cnt / 2]) / 2.0f + 0.5f);
+                dst_row[x] = (median[(cnt / 2) - 1] + median[cnt / 2]) / 2.0f + 0.5f;
             }
             else
             {
                 // Store the result
-                setUint8Pixel(dst, x, y, median[cnt / 2]);
+                dst_row[x] = median[cnt / 2];
             }
         }
     }
+
 }
 
+
+/// Number of fine bins of a median histogram
+#define MEDIAN_FINE_BINS (256)
+
+/// Number of coarse bins of a median histogram, one for every 16 fine bins
+#define MEDIAN_COARSE_BINS (16)
+
+/// Number of fine bins per coarse bin
+#define MEDIAN_GROUP (MEDIAN_FINE_BINS / MEDIAN_COARSE_BINS)
+
+/// Histogram of the median window
+typedef struct
+{
+    uint16_t fine[MEDIAN_FINE_BINS];     ///< Fine bins, only valid for the
+                                         ///< column in last
+    uint16_t coarse[MEDIAN_COARSE_BINS]; ///< Coarse bins, always valid
+    int32_t last[MEDIAN_COARSE_BINS];    ///< Column for which the fine bins of
+                                         ///< a coarse bin are valid, -1 if none
+
+}median_hist_t;
+
 /*!
- * \brief Used to remove short tailed noise, such as Gaussian and uniform type
- *        noise
+ * \brief Brings the fine bins of coarse bin \p b of the window histogram up
+ *        to date for column \p x
+ *
+ * The fine bins are only updated when they are needed for selecting the
+ * median. If they were last updated more than a window width ago, they are
+ * computed from the column histograms of the window instead.
+ *
+ * \param[in,out] hist     A pointer to the window histogram
+ * \param[in]     col_fine A pointer to the fine column histograms
+ * \param[in]     b        The coarse bin
+ * \param[in]     x        The column of the window centre
+ * \param[in]     h        Half the window size
+ * \param[in]     cols     The number of columns of the image
+ */
+static void medianUpdateFine(median_hist_t *hist, const uint16_t *col_fine, const int32_t b,
+                             const int32_t x, const int32_t h, const int32_t cols)
+{
+    uint16_t *f = hist->fine + (b * MEDIAN_GROUP);
+    const uint16_t *c = col_fine + (b * MEDIAN_GROUP);
+
+    if ((hist->last[b] < 0) || ((x - hist->last[b]) > ((2 * h) + 1)))
+    {
+        const int32_t x0 = ((x - h) < 0) ? 0 : (x - h);
+        const int32_t x1 = ((x + h) >= cols) ? (cols - 1) : (x + h);
+
+        memset(f, 0, MEDIAN_GROUP * sizeof(uint16_t));
+
+        for (int32_t i = x0; i <= x1; i++)
+        {
+            for (int32_t v = 0; v < MEDIAN_GROUP; v++)
+            {
+                f[v] += c[(i * MEDIAN_FINE_BINS) + v];
+            }
+        }
+    }
+    else
+    {
+        for (int32_t i = hist->last[b] + 1; i <= x; i++)
+        {
+            if ((i - h - 1) >= 0)
+            {
+                for (int32_t v = 0; v < MEDIAN_GROUP; v++)
+                {
+                    f[v] -= c[((i - h - 1) * MEDIAN_FINE_BINS) + v];
+                }
+            }
+
+            if ((i + h) < cols)
+            {
+                for (int32_t v = 0; v < MEDIAN_GROUP; v++)
+                {
+                    f[v] += c[((i + h) * MEDIAN_FINE_BINS) + v];
+                }
+            }
+        }
+    }
+
+    hist->last[b] = x;
+}
+
+/*!
+ * \brief Returns the k-th smallest value (zero-based) of the window
+ *        histogram
+ *
+ * The coarse bins are searched first, followed by the fine bins of the
+ * coarse bin that contains the value.
+ *
+ * \param[in,out] hist     A pointer to the window histogram
+ * \param[in]     col_fine A pointer to the fine column histograms
+ * \param[in]     k        Zero-based rank of the value
+ * \param[in]     x        The column of the window centre
+ * \param[in]     h        Half the window size
+ * \param[in]     cols     The number of columns of the image
+ *
+ * \return The value
+ */
+static uint8_pixel_t medianSelect(median_hist_t *hist, const uint16_t *col_fine, const uint32_t k,
+                                  const int32_t x, const int32_t h, const int32_t cols)
+{
+    uint32_t sum = 0;
+    int32_t b = 0;
+
+    while ((sum + hist->coarse[b]) <= k)
+    {
+        sum += hist->coarse[b];
+        b++;
+    }
+
+    if (hist->last[b] != x)
+    {
+        medianUpdateFine(hist, col_fine, b, x, h, cols);
+    }
+
+    int32_t v = b * MEDIAN_GROUP;
+
+    while ((sum + hist->fine[v]) <= k)
+    {
+        sum += hist->fine[v];
+        v++;
+    }
+
+    return (uint8_pixel_t)v;
+}
+
+/*!
+ * \brief The median is the centre value of the sorted pixels in the \p n x
+ * \p n window
+ *
+ * Removes long tailed noise and salt and pepper type noise.
+ * Has minimum blurring effect and preserves spatial details.
+ * Can remove outlier noise from images that contain less than 50% of its
+ * pixels as outliers
+ *
+ * The window is clipped at the image border. If a clipped window contains an
+ * even number of pixels, the result is the rounded average of the two centre
+ * values.
+ *
+ * The median is selected from a two-level histogram of the window (Perreault
+ * and Hebert, 2007). A histogram is kept for every column, and is updated by
+ * one pixel when moving down a row. Moving right a column updates the coarse
+ * bins of the window histogram by one column histogram, the fine bins are
+ * only updated when the median is searched in them. This makes the execution
+ * time per pixel independent of the window size. If the image arena is too
+ * small for the column histograms, windows up to 11x11 are sorted instead.
  *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
  * \param[in]  n   Size of the square window
  */
-void midpoint(const image_t *src, image_t *dst, const uint8_t n)
+void median(const image_t *src, image_t *dst, const uint8_t n)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -402,6 +626,8 @@ void midpoint(const image_t *src, image_t *dst, const uint8_t n)
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -411,48 +637,158 @@ void midpoint(const image_t *src, image_t *dst, const uint8_t n)
     // Verify parameters
     ASSERT((n % 2) == 0, "window size is not an odd value");
 
-    // Loop all pixels
-    for (int32_t y = 0; y < src->rows; y++)
+    const uint8_pixel_t *src_data = (const uint8_pixel_t *)src->data;
+    const int32_t src_stride = IMAGE_STRIDE(src);
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t h = n / 2;
+
+    image_arena_mark_t mark = markImageArena();
+
+    // Column histograms and the window histogram
+    uint16_t *col_fine = (uint16_t *)allocImageArena(cols * MEDIAN_FINE_BINS * sizeof(uint16_t));
+    uint16_t *col_coarse = (uint16_t *)allocImageArena(cols * MEDIAN_COARSE_BINS * sizeof(uint16_t));
+    median_hist_t *hist = (median_hist_t *)allocImageArena(sizeof(median_hist_t));
+
+    if ((col_fine == NULL) || (col_coarse == NULL) || (hist == NULL))
     {
-        for (int32_t x = 0; x < src->cols; x++)
+        releaseImageArena(mark);
+
+        ASSERT(n > 11, "Unable to allocate memory for the histograms, increase the size of the image arena");
+
+        medianSort(src, dst, n);
+
+        TRACE_EXIT();
+        return;
+    }
+
+    memset(col_fine, 0, cols * MEDIAN_FINE_BINS * sizeof(uint16_t));
+    memset(col_coarse, 0, cols * MEDIAN_COARSE_BINS * sizeof(uint16_t));
+
+    // Add the rows of the window of the first row
+    for (int32_t y = 0; (y <= h) && (y < rows); y++)
+    {
+        const uint8_pixel_t *s = src_data + (y * src_stride);
+
+        for (int32_t x = 0; x < cols; x++)
         {
-            // Initialize filter specific variables
-            uint8_pixel_t min = UINT8_PIXEL_MAX;
-            uint8_pixel_t max = UINT8_PIXEL_MIN;
+            col_fine[(x * MEDIAN_FINE_BINS) + s[x]]++;
+            col_coarse[(x * MEDIAN_COARSE_BINS) + (s[x] / MEDIAN_GROUP)]++;
+        }
+    }
 
-            // Apply the kernel only for pixels within the image
-            for (int32_t j = -n / 2; j <= n / 2; j++)
+    // Loop all rows
+    for (int32_t y = 0; y < rows; y++)
+    {
+        uint8_pixel_t *dst_row = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Move the column histograms down one row
+        if ((y > 0) && ((y - h - 1) >= 0))
+        {
+            const uint8_pixel_t *s = src_data + ((y - h - 1) * src_stride);
+
+            for (int32_t x = 0; x < cols; x++)
+            {
+                col_fine[(x * MEDIAN_FINE_BINS) + s[x]]--;
+                col_coarse[(x * MEDIAN_COARSE_BINS) + (s[x] / MEDIAN_GROUP)]--;
+            }
+        }
+
+        if ((y > 0) && ((y + h) < rows))
+        {
+            const uint8_pixel_t *s = src_data + ((y + h) * src_stride);
+
+            for (int32_t x = 0; x < cols; x++)
             {
-                for (int32_t i = -n / 2; i <= n / 2; i++)
+                col_fine[(x * MEDIAN_FINE_BINS) + s[x]]++;
+                col_coarse[(x * MEDIAN_COARSE_BINS) + (s[x] / MEDIAN_GROUP)]++;
+            }
+        }
+
+        // Number of rows of the window that are within the image
+        const int32_t j0 = (y < h) ? -y : -h;
+        const int32_t j1 = ((y + h) >= rows) ? (rows - 1 - y) : h;
+        const uint32_t win_rows = (uint32_t)(j1 - j0 + 1);
+
+        // Coarse bins of the window histogram of the first column, the fine
+        // bins are computed when needed
+        memset(hist->coarse, 0, sizeof(hist->coarse));
+
+        for (int32_t b = 0; b < MEDIAN_COARSE_BINS; b++)
+        {
+            hist->last[b] = -1;
+        }
+
+        for (int32_t x = 0; (x <= h) && (x < cols); x++)
+        {
+            for (int32_t b = 0; b < MEDIAN_COARSE_BINS; b++)
+            {
+                hist->coarse[b] += col_coarse[(x * MEDIAN_COARSE_BINS) + b];
+            }
+        }
+
+        for (int32_t x = 0; x < cols; x++)
+        {
+            // Move the coarse bins right one column
+            if ((x > 0) && ((x - h - 1) >= 0))
+            {
+                for (int32_t b = 0; b < MEDIAN_COARSE_BINS; b++)
                 {
-                    if ((x + i) >= 0 &&
-                        (y + j) >= 0 &&
-                        (x + i) < src->cols &&
-                        (y + j) < src->rows)
-                    {
-                        // Calculation for each window cell
-                        uint8_pixel_t p = getUint8Pixel(src, x + i, y + j);
-                        min = p < min ? p : min;
-                        max = p > max ? p : max;
-                    }
+                    hist->coarse[b] -= col_coarse[((x - h - 1) * MEDIAN_COARSE_BINS) + b];
                 }
             }
 
-            // Calculate and store the result
-            setUint8Pixel(dst, x, y, ((min + max) / 2.0f) + 0.5f);
+            if ((x > 0) && ((x + h) < cols))
+            {
+                for (int32_t b = 0; b < MEDIAN_COARSE_BINS; b++)
+                {
+                    hist->coarse[b] += col_coarse[((x + h) * MEDIAN_COARSE_BINS) + b];
+                }
+            }
+
+            // Number of pixels of the window that are within the image
+            const int32_t i0 = (x < h) ? -x : -h;
+            const int32_t i1 = ((x + h) >= cols) ? (cols - 1 - x) : h;
+            const uint32_t cnt = win_rows * (uint32_t)(i1 - i0 + 1);
+
+            // Check if there is an even number of pixels.
+            // This might be the case for border pixels.
+            if ((cnt % 2) == 0)
+            {
+                const uint32_t a = medianSelect(hist, col_fine, (cnt / 2) - 1, x, h, cols);
+                const uint32_t b = medianSelect(hist, col_fine, cnt / 2, x, h, cols);
+
+                // Store the rounded average
+                dst_row[x] = (uint8_pixel_t)((a + b + 1) / 2);
+            }
+            else
+            {
+                // Store the result
+                dst_row[x] = medianSelect(hist, col_fine, cnt / 2, x, h, cols);
+            }
         }
     }
+
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
 }
 
 /*!
- * \brief Removes positive outlier noise
+ * \brief Used to remove short tailed noise, such as Gaussian and uniform type
+ *        noise
+ *
+ * The result is the rounded average of the window minimum and maximum, both
+ * computed in a single runningMinMax() call.
  *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
  * \param[in]  n   Size of the square window
  */
-void minimum(const image_t *src, image_t *dst, const uint8_t n)
+void midpoint(const image_t *src, image_t *dst, const uint8_t n)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -460,6 +796,7 @@ void minimum(const image_t *src, image_t *dst, const uint8_t n)
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -469,46 +806,84 @@ void minimum(const image_t *src, image_t *dst, const uint8_t n)
     // Verify parameters
     ASSERT((n % 2) == 0, "window size is not an odd value");
 
-    // Loop all pixels
+    image_arena_mark_t mark = markImageArena();
+    image_t *tmp = newUint8Image(src->cols, src->rows);
+
+    if (tmp == NULL)
+    {
+        ASSERT(1 == 1, "Unable to allocate memory for the minimum, increase the size of the image arena");
+        TRACE_EXIT();
+        return;
+    }
+
+    // The minimum in tmp and the maximum in dst
+    runningMinMax(src, tmp, dst, n, n);
+
     for (int32_t y = 0; y < src->rows; y++)
     {
+        const uint8_pixel_t *min = (const uint8_pixel_t *)tmp->data + (y * IMAGE_STRIDE(tmp));
+        uint8_pixel_t *max = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
         for (int32_t x = 0; x < src->cols; x++)
         {
-            // Initialize filter specific variables
-            uint8_pixel_t min = UINT8_PIXEL_MAX;
-
-            // Apply the kernel only for pixels within the image
-            for (int32_t j = -n / 2; j <= n / 2; j++)
-            {
-                for (int32_t i = -n / 2; i <= n / 2; i++)
-                {
-                    if ((x + i) >= 0 &&
-                        (y + j) >= 0 &&
-                        (x + i) < src->cols &&
-                        (y + j) < src->rows)
-                    {
-                        // Calculation for each window cell
-                        uint8_pixel_t p = getUint8Pixel(src, x + i, y + j);
-                        min = p < min ? p : min;
-                    }
-                }
-            }
-
-            // Calculate and store the result
-            setUint8Pixel(dst, x, y, min);
+            // Calculate and store the rounded result
+            max[x] = (uint8_pixel_t)((min[x] + max[x] + 1) / 2);
         }
     }
+
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Removes positive outlier noise
+ *
+ * Uses runningMinMax(), so the execution time does not depend on \p n.
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[out] dst A pointer to the destination image
+ * \param[in]  n   Size of the square window
+ */
+void minimum(const image_t *src, image_t *dst, const uint8_t n)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+    ASSERT(src == dst, "src and dst are the same images");
+
+    // Verify parameters
+    ASSERT((n % 2) == 0, "window size is not an odd value");
+
+    runningMinMax(src, dst, NULL, n, n);
+
+    TRACE_EXIT();
 }
 
 /*!
  * \brief Outputs the difference between the local maximum and minimum
  *
+ * The minimum and maximum are computed in a single runningMinMax() call.
+ *
  * \param[in]  src A pointer to the source image
  * \param[out] dst A pointer to the destination image
  * \param[in]  n   Size of the square window
  */
 void range(const image_t *src, image_t *dst, const uint8_t n)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -516,6 +891,7 @@ void range(const image_t *src, image_t *dst, const uint8_t n)
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -525,35 +901,361 @@ void range(const image_t *src, image_t *dst, const uint8_t n)
     // Verify parameters
     ASSERT((n % 2) == 0, "window size is not an odd value");
 
-    // Loop all pixels
+    image_arena_mark_t mark = markImageArena();
+    image_t *tmp = newUint8Image(src->cols, src->rows);
+
+    if (tmp == NULL)
+    {
+        ASSERT(1 == 1, "Unable to allocate memory for the minimum, increase the size of the image arena");
+        TRACE_EXIT();
+        return;
+    }
+
+    // The minimum in tmp and the maximum in dst
+    runningMinMax(src, tmp, dst, n, n);
+
     for (int32_t y = 0; y < src->rows; y++)
     {
+        const uint8_pixel_t *min = (const uint8_pixel_t *)tmp->data + (y * IMAGE_STRIDE(tmp));
+        uint8_pixel_t *max = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
         for (int32_t x = 0; x < src->cols; x++)
         {
-            // Initialize filter specific variables
-            uint8_pixel_t min = UINT8_PIXEL_MAX;
-            uint8_pixel_t max = UINT8_PIXEL_MIN;
+            // Calculate and store the result
+            max[x] = (uint8_pixel_t)(max[x] - min[x]);
+        }
+    }
 
-            // Apply the kernel only for pixels within the image
-            for (int32_t j = -n / 2; j <= n / 2; j++)
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
+}
+
+/// Maximum of two pixel values
+#define MINMAX_MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+/// Minimum of two pixel values
+#define MINMAX_MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+/*!
+ * \brief Defines the horizontal and vertical van Herk/Gil-Werman passes of a
+ *        running maximum or minimum
+ *
+ * The line is divided in blocks of \p k pixels. Within every block a prefix
+ * and a suffix maximum are computed, and the maximum of a window that starts
+ * at pixel i is the maximum of suffix[i] and prefix[i + k - 1]. This takes
+ * three comparisons per pixel, regardless of the window size. The line is
+ * padded with \p neutral values, so windows are clipped at the image border.
+ *
+ * \param name    Name prefix of the functions
+ * \param OP      ::MINMAX_MAX or ::MINMAX_MIN
+ * \param neutral The pixel value that does not change the result of OP
+ */
+#define RUNNING_MINMAX(name, OP, neutral)                                                           \
+/* Horizontal pass of one row of cols pixels, p and g hold cols + k - 1 pixels */                   \
+static void name##Row(const uint8_pixel_t *s, const int32_t step, uint8_pixel_t *d,                 \
+                      const int32_t cols, const int32_t k, uint8_pixel_t *p, uint8_pixel_t *g)      \
+{                                                                                                   \
+    const int32_t h = k / 2;                                                                        \
+    const int32_t len = cols + (2 * h);                                                             \
+                                                                                                    \
+    memset(p, (neutral), h);                                                                        \
+    memset(p + h + cols, (neutral), h);                                                             \
+                                                                                                    \
+    for (int32_t x = 0; x < cols; x++)                                                              \
+    {                                                                                               \
+        p[h + x] = s[x * step];                                                                     \
+    }                                                                                               \
+                                                                                                    \
+    for (int32_t b = 0; b < len; b += k)                                                            \
+    {                                                                                               \
+        const int32_t e = ((b + k) < len) ? (b + k) : len;                                          \
+                                                                                                    \
+        /* Prefix in g, suffix in place in p */                                                     \
+        g[b] = p[b];                                                                                \
+                                                                                                    \
+        for (int32_t i = b + 1; i < e; i++)                                                         \
+        {                                                                                           \
+            g[i] = OP(g[i - 1], p[i]);                                                              \
+        }                                                                                           \
+                                                                                                    \
+        for (int32_t i = e - 2; i >= b; i--)                                                        \
+        {                                                                                           \
+            p[i] = OP(p[i + 1], p[i]);                                                              \
+        }                                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    for (int32_t x = 0; x < cols; x++)                                                              \
+    {                                                                                               \
+        d[x] = OP(p[x], g[x + k - 1]);                                                              \
+    }                                                                                               \
+}                                                                                                   \
+                                                                                                    \
+/* Vertical pass, suffix holds k rows and prefix one row of cols pixels */                          \
+static void name##Cols(const image_t *src, image_t *dst, const int32_t k,                           \
+                       uint8_pixel_t *suffix, uint8_pixel_t *prefix)                                \
+{                                                                                                   \
+    const int32_t cols = src->cols;                                                                 \
+    const int32_t rows = src->rows;                                                                 \
+    const int32_t h = k / 2;                                                                        \
+    const int32_t len = rows + (2 * h);                                                             \
+                                                                                                    \
+    for (int32_t b = 0; b < rows; b += k)                                                           \
+    {                                                                                               \
+        const int32_t e = ((b + k) < len) ? (b + k) : len;                                          \
+                                                                                                    \
+        /* Suffix rows of the block, padded row i is image row i - h */                             \
+        for (int32_t i = e - 1; i >= b; i--)                                                        \
+        {                                                                                           \
+            uint8_pixel_t *sf = suffix + ((i - b) * cols);                                          \
+            const int32_t y = i - h;                                                                \
+                                                                                                    \
+            if ((y < 0) || (y >= rows))                                                             \
+            {                                                                                       \
+                if (i == (e - 1))                                                                   \
+                {                                                                                   \
+                    memset(sf, (neutral), cols);                                                    \
+                }                                                                                   \
+                else                                                                                \
+                {                                                                                   \
+                    memcpy(sf, sf + cols, cols);                                                    \
+                }                                                                                   \
+            }                                                                                       \
+            else                                                                                    \
+            {                                                                                       \
+                const uint8_pixel_t *s = (const uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src)); \
+                                                                                                    \
+                if (i == (e - 1))                                                                   \
+                {                                                                                   \
+                    memcpy(sf, s, cols);                                                            \
+                }                                                                                   \
+                else                                                                                \
+                {                                                                                   \
+                    const uint8_pixel_t *next = sf + cols;                                          \
+                                                                                                    \
+                    for (int32_t x = 0; x < cols; x++)                                              \
+                    {                                                                               \
+                        sf[x] = OP(next[x], s[x]);                                                  \
+                    }                                                                               \
+                }                                                                                   \
+            }                                                                                       \
+        }                                                                                           \
+                                                                                                    \
+        /* Output rows of the block, the prefix runs over the next block */                         \
+        for (int32_t r = b; (r < (b + k)) && (r < rows); r++)                                       \
+        {                                                                                           \
+            uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (r * IMAGE_STRIDE(dst));                \
+            const uint8_pixel_t *sf = suffix + ((r - b) * cols);                                    \
+            const int32_t y = r + k - 1 - h;                                                        \
+                                                                                                    \
+            if (r == b)                                                                             \
+            {                                                                                       \
+                memcpy(d, sf, cols);                                                                \
+                continue;                                                                           \
+            }                                                                                       \
+                                                                                                    \
+            if (y >= rows)                                                                          \
+            {                                                                                       \
+                if (r == (b + 1))                                                                   \
+                {                                                                                   \
+                    memset(prefix, (neutral), cols);                                                \
+                }                                                                                   \
+            }                                                                                       \
+            else                                                                                    \
+            {                                                                                       \
+                const uint8_pixel_t *s = (const uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src)); \
+                                                                                                    \
+                if (r == (b + 1))                                                                   \
+                {                                                                                   \
+                    memcpy(prefix, s, cols);                                                        \
+                }                                                                                   \
+                else                                                                                \
+                {                                                                                   \
+                    for (int32_t x = 0; x < cols; x++)                                              \
+                    {                                                                               \
+                        prefix[x] = OP(prefix[x], s[x]);                                            \
+                    }                                                                               \
+                }                                                                                   \
+            }                                                                                       \
+                                                                                                    \
+            for (int32_t x = 0; x < cols; x++)                                                      \
+            {                                                                                       \
+                d[x] = OP(sf[x], prefix[x]);                                                        \
+            }                                                                                       \
+        }                                                                                           \
+    }                                                                                               \
+}
+
+RUNNING_MINMAX(runningMax, MINMAX_MAX, UINT8_PIXEL_MIN)
+RUNNING_MINMAX(runningMin, MINMAX_MIN, UINT8_PIXEL_MAX)
+
+/*!
+ * \brief Running minimum and maximum that scan the full window per pixel
+ *
+ * Used by runningMinMax() if the image arena is too small for its buffers.
+ *
+ * \param[in]  src  A pointer to the source image
+ * \param[out] min  A pointer to the minimum image, or NULL
+ * \param[out] max  A pointer to the maximum image, or NULL
+ * \param[in]  cols Number of columns of the window
+ * \param[in]  rows Number of rows of the window
+ */
+static void runningMinMaxScan(const image_t *src, image_t *min, image_t *max,
+                              const int32_t cols, const int32_t rows)
+{
+    const int32_t hc = cols / 2;
+    const int32_t hr = rows / 2;
+
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        // Rows of the window that are within the image
+        const int32_t y0 = (y < hr) ? 0 : (y - hr);
+        const int32_t y1 = ((y + hr) >= src->rows) ? (src->rows - 1) : (y + hr);
+
+        for (int32_t x = 0; x < src->cols; x++)
+        {
+            // Columns of the window that are within the image
+            const int32_t x0 = (x < hc) ? 0 : (x - hc);
+            const int32_t x1 = ((x + hc) >= src->cols) ? (src->cols - 1) : (x + hc);
+
+            uint8_pixel_t lo = UINT8_PIXEL_MAX;
+            uint8_pixel_t hi = UINT8_PIXEL_MIN;
+
+            for (int32_t j = y0; j <= y1; j++)
             {
-                for (int32_t i = -n / 2; i <= n / 2; i++)
+                for (int32_t i = x0; i <= x1; i++)
                 {
-                    if ((x + i) >= 0 &&
-                        (y + j) >= 0 &&
-                        (x + i) < src->cols &&
-                        (y + j) < src->rows)
-                    {
-                        // Calculation for each window cell
-                        uint8_pixel_t p = getUint8Pixel(src, x + i, y + j);
-                        min = p < min ? p : min;
-                        max = p > max ? p : max;
-                    }
+                    uint8_pixel_t p = getUint8PixelStrided(src, i, j);
+                    lo = MINMAX_MIN(lo, p);
+                    hi = MINMAX_MAX(hi, p);
                 }
             }
 
-            // Calculate and store the result
-            setUint8Pixel(dst, x, y, max - min);
+            if (min != NULL)
+            {
+                setUint8Pixel(min, x, y, lo);
+            }
+
+            if (max != NULL)
+            {
+                setUint8Pixel(max, x, y, hi);
+            }
+        }
+    }
+}
+
+/*!
+ * \brief Calculates the running minimum and maximum over a rectangular
+ *        window
+ *
+ * The window is \p cols x \p rows pixels, centred on the destination pixel
+ * and clipped at the image border. A window of 1 x n or n x 1 pixels gives a
+ * line structuring element. This is the engine of minimum(), maximum(),
+ * range(), midpoint() and the graylevel morphology with a flat mask.
+ *
+ * The window is separated in a horizontal and a vertical pass, and each pass
+ * uses the van Herk/Gil-Werman algorithm. The execution time per pixel is
+ * therefore independent of the window size. If the image arena is too small
+ * for the intermediate image, the full window is scanned per pixel instead.
+ *
+ * \param[in]  src  A pointer to the source image
+ * \param[out] min  A pointer to the minimum image, or NULL if not needed
+ * \param[out] max  A pointer to the maximum image, or NULL if not needed
+ * \param[in]  cols Number of columns of the window, must be odd
+ * \param[in]  rows Number of rows of the window, must be odd
+ */
+void runningMinMax(const image_t *src, image_t *min, image_t *max,
+                   const int32_t cols, const int32_t rows)
+{
+    TRACE_ENTER(src, (min != NULL) ? min : max);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT((min == NULL) && (max == NULL), "min and max images are both invalid");
+    ASSERT((min != NULL) && (IMAGE_STEP(min) != 1), "min image can not be a luma view");
+    ASSERT((max != NULL) && (IMAGE_STEP(max) != 1), "max image can not be a luma view");
+
+    // Verify image consistency
+    ASSERT((min != NULL) && ((min->type != IMGTYPE_UINT8) || (min->cols != src->cols) || (min->rows != src->rows)), "min image is invalid");
+    ASSERT((max != NULL) && ((max->type != IMGTYPE_UINT8) || (max->cols != src->cols) || (max->rows != src->rows)), "max image is invalid");
+    ASSERT((src == min) || (src == max) || (min == max), "src, min and max are not different images");
+
+    // Verify parameters
+    ASSERT(((cols % 2) == 0) || (cols < 1), "window columns is not a positive odd value");
+    ASSERT(((rows % 2) == 0) || (rows < 1), "window rows is not a positive odd value");
+
+    // The vertical pass can read src directly if there is no horizontal
+    // window and the pixels of src are contiguous
+    const int32_t horizontal = (cols > 1) || (rows == 1) || (IMAGE_STEP(src) != 1);
+    const int32_t vertical = (rows > 1);
+
+    image_arena_mark_t mark = markImageArena();
+
+    // Result of the horizontal pass, and the buffers of both passes
+    image_t *tmp = (horizontal && vertical) ? newUint8Image(src->cols, src->rows) : NULL;
+    uint8_pixel_t *p = (uint8_pixel_t *)allocImageArena(src->cols + cols - 1);
+    uint8_pixel_t *g = (uint8_pixel_t *)allocImageArena(src->cols + cols - 1);
+    uint8_pixel_t *suffix = (uint8_pixel_t *)allocImageArena((size_t)rows * src->cols);
+    uint8_pixel_t *prefix = (uint8_pixel_t *)allocImageArena(src->cols);
+
+    if ((horizontal && vertical && (tmp == NULL)) ||
+        (p == NULL) || (g == NULL) || (suffix == NULL) || (prefix == NULL))
+    {
+        releaseImageArena(mark);
+        runningMinMaxScan(src, min, max, cols, rows);
+
+        TRACE_EXIT();
+        return;
+    }
+
+    for (int32_t pass = 0; pass < 2; pass++)
+    {
+        image_t *dst = (pass == 0) ? min : max;
+
+        if (dst == NULL)
+        {
+            continue;
+        }
+
+        // Without a vertical pass the horizontal pass writes dst, without a
+        // horizontal pass the vertical pass reads src
+        image_t *h_dst = vertical ? tmp : dst;
+        const image_t *v_src = horizontal ? tmp : src;
+
+        if (horizontal)
+        {
+            for (int32_t y = 0; y < src->rows; y++)
+            {
+                const uint8_pixel_t *s = (const uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+                uint8_pixel_t *d = (uint8_pixel_t *)h_dst->data + (y * IMAGE_STRIDE(h_dst));
+
+                if (pass == 0)
+                {
+                    runningMinRow(s, IMAGE_STEP(src), d, src->cols, cols, p, g);
+                }
+                else
+                {
+                    runningMaxRow(s, IMAGE_STEP(src), d, src->cols, cols, p, g);
+                }
+            }
+        }
+
+        if (vertical)
+        {
+            if (pass == 0)
+            {
+                runningMinCols(v_src, dst, rows, suffix, prefix);
+            }
+            else
+            {
+                runningMaxCols(v_src, dst, rows, suffix, prefix);
+            }
         }
     }
+
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
 }
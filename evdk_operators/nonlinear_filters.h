@@ -52,6 +52,7 @@ void median(const image_t *src, image_t *dst, const uint8_t n);
 void midpoint(const image_t *src, image_t *dst, const uint8_t n);
 void minimum(const image_t *src, image_t *dst, const uint8_t n);
 void range(const image_t *src, image_t *dst, const uint8_t n);
+void runningMinMax(const image_t *src, image_t *min, image_t *max, const int32_t cols, const int32_t rows);
 
 #endif // _NONLINEAR_FILTERS_H_
 
@@ -50,9 +50,12 @@ extern "C" {
 #include "morphological_filters.h"
 #include "nonlinear_filters.h"
 #include "noise.h"
+#include "pyramids.h"
 #include "segmentation.h"
 #include "spatial_filters.h"
 #include "spatial_frequency_filters.h"
+#include "template_matching.h"
+#include "trace.h"
 #include "transforms.h"
 
 #endif // _OPERATORS_H_
@@ -0,0 +1,723 @@
+/*! ***************************************************************************
+ *
+ * \brief     Gaussian and Laplacian image pyramids
+ * \file      pyramids.c
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \note      The pyramids are built with the 5-tap binomial kernel
+ *            [1 4 6 4 1] / 16, applied separably. Borders are handled by
+ *            mirroring without repeating the border pixel (reflect-101).
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "image_fundamentals.h"
+#include "pyramids.h"
+#include "trace.h"
+
+/// Alignment in bytes of the pixel data of each level in a pyramid buffer
+#define PYRAMID_ALIGNMENT (8)
+
+/// Defines what the upsampling kernel does with the upsampled pixels
+typedef enum
+{
+    PYRUP_COPY = 0, ///< dst = up(src)
+    PYRUP_SUBTRACT, ///< dst = other - up(src), a Laplacian level
+    PYRUP_ADD,      ///< dst = other + up(src), a reconstructed Gaussian level
+
+}ePyrUp;
+
+// Function prototypes
+static int32_t reflect101(int32_t i, const int32_t n);
+static size_t pyramidLevelSize(const int32_t cols, const int32_t rows, const eImageType type);
+static void pyrUpRow(const uint8_pixel_t *s, const int32_t n, uint16_t *h, const int32_t cols);
+static int32_t pyrUpKernel(const image_t *src, image_t *dst, const image_t *other, const ePyrUp op);
+
+/*!
+ * \brief Halves the size of an image after a Gaussian low-pass filter
+ *
+ * The source image is filtered with the 5x5 kernel that is the outer product
+ * of [1 4 6 4 1] / 16, and every second pixel in every second row is kept.
+ * The filter suppresses the frequencies that would alias after decimation.
+ * Destination pixel (x,y) is centered on source pixel (2x,2y).
+ *
+ * The filter is separable. Each destination row is computed from five source
+ * rows that are summed vertically into a single row buffer, which is then
+ * filtered horizontally at the even positions only. So the source image is
+ * read once and the row buffer is the only temporary memory.
+ *
+ * The source image can be a luma view, see lumaView().
+ *
+ * \param[in]  src A pointer to the ::IMGTYPE_UINT8 source image
+ * \param[out] dst A pointer to the ::IMGTYPE_UINT8 destination image with
+ *                 (src->cols + 1) / 2 columns and (src->rows + 1) / 2 rows
+ */
+void pyrDown(const image_t *src, image_t *dst)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+
+    // Verify image consistency
+    ASSERT(dst->cols != ((src->cols + 1) / 2), "dst must have half the number of columns of src");
+    ASSERT(dst->rows != ((src->rows + 1) / 2), "dst must have half the number of rows of src");
+    ASSERT(src == dst, "src and dst are the same images");
+
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t src_stride = IMAGE_STRIDE(src);
+    const int32_t step = IMAGE_STEP(src);
+
+    image_arena_mark_t mark = markImageArena();
+
+    // Vertically filtered row with two pixels of border on both sides
+    uint16_t *buf = (uint16_t *)allocImageArena((cols + 4) * sizeof(uint16_t));
+
+    if (buf == NULL)
+    {
+        ASSERT(1 == 1, "Unable to allocate memory for the row buffer, increase the size of the image arena");
+        TRACE_EXIT();
+        return;
+    }
+
+    uint16_t *v = buf + 2;
+
+    for (int32_t y = 0; y < dst->rows; y++)
+    {
+        const uint8_pixel_t *s0 = (uint8_pixel_t *)src->data + (reflect101(2 * y - 2, rows) * src_stride);
+        const uint8_pixel_t *s1 = (uint8_pixel_t *)src->data + (reflect101(2 * y - 1, rows) * src_stride);
+        const uint8_pixel_t *s2 = (uint8_pixel_t *)src->data + (reflect101(2 * y, rows) * src_stride);
+        const uint8_pixel_t *s3 = (uint8_pixel_t *)src->data + (reflect101(2 * y + 1, rows) * src_stride);
+        const uint8_pixel_t *s4 = (uint8_pixel_t *)src->data + (reflect101(2 * y + 2, rows) * src_stride);
+
+        // Vertical pass, at most 16 * 255 per pixel
+        if (step == 1)
+        {
+            for (int32_t x = 0; x < cols; x++)
+            {
+                v[x] = (uint16_t)(s0[x] + s4[x] + 4 * (s1[x] + s3[x]) + 6 * s2[x]);
+            }
+        }
+        else
+        {
+            for (int32_t x = 0; x < cols; x++)
+            {
+                const int32_t i = x * step;
+                v[x] = (uint16_t)(s0[i] + s4[i] + 4 * (s1[i] + s3[i]) + 6 * s2[i]);
+            }
+        }
+
+        // Mirror the borders of the row buffer
+        v[-2] = v[reflect101(-2, cols)];
+        v[-1] = v[reflect101(-1, cols)];
+        v[cols] = v[reflect101(cols, cols)];
+        v[cols + 1] = v[reflect101(cols + 1, cols)];
+
+        // Horizontal pass at the even positions, at most 256 * 255 per pixel
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        for (int32_t x = 0; x < dst->cols; x++)
+        {
+            const uint16_t *p = v + (2 * x);
+            uint32_t sum = (uint32_t)p[-2] + p[2] + 4 * ((uint32_t)p[-1] + p[1]) + 6 * (uint32_t)p[0];
+            d[x] = (uint8_pixel_t)((sum + 128) >> 8);
+        }
+    }
+
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Doubles the size of an image followed by a Gaussian low-pass filter
+ *
+ * This is the counterpart of pyrDown(). Source pixel (x,y) is placed at
+ * destination pixel (2x,2y), the other pixels are set to zero and the result
+ * is filtered with four times the kernel of pyrDown(). Because in each
+ * direction every other product is zero, the even destination pixels are
+ * computed with the weights [1 6 1] / 8 and the odd pixels with [4 4] / 8.
+ *
+ * The destination can have an odd or even number of columns and rows, so
+ * that the size of any pyrDown() source can be restored.
+ *
+ * \param[in]  src A pointer to the ::IMGTYPE_UINT8 source image
+ * \param[out] dst A pointer to the ::IMGTYPE_UINT8 destination image with
+ *                 2 * src->cols or 2 * src->cols - 1 columns and
+ *                 2 * src->rows or 2 * src->rows - 1 rows
+ */
+void pyrUp(const image_t *src, image_t *dst)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+
+    // Verify image consistency
+    ASSERT(src->cols != ((dst->cols + 1) / 2), "dst must have twice the number of columns of src");
+    ASSERT(src->rows != ((dst->rows + 1) / 2), "dst must have twice the number of rows of src");
+    ASSERT(src == dst, "src and dst are the same images");
+
+    if (pyrUpKernel(src, dst, NULL, PYRUP_COPY) == 0)
+    {
+        ASSERT(1 == 1, "Unable to allocate memory for the row buffers, increase the size of the image arena");
+    }
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Calculates the size of the buffer that holds all levels of a pyramid
+ *
+ * \param[in] cols   Number of columns of level 0
+ * \param[in] rows   Number of rows of level 0
+ * \param[in] levels Number of levels
+ * \param[in] type   The type of the pixels, ::IMGTYPE_UINT8 for a Gaussian
+ *                   pyramid and ::IMGTYPE_INT16 for a Laplacian pyramid
+ *
+ * \return The number of bytes
+ */
+size_t pyramidBufferSize(const int32_t cols, const int32_t rows,
+                         const int32_t levels, const eImageType type)
+{
+    // Verify parameters
+    ASSERT((cols <= 0) || (rows <= 0), "size is invalid");
+    ASSERT((levels < 1) || (levels > PYRAMID_MAX_LEVELS), "levels is invalid");
+    ASSERT((type != IMGTYPE_UINT8) && (type != IMGTYPE_INT16), "type is invalid");
+
+    size_t size = 0;
+    int32_t c = cols;
+    int32_t r = rows;
+
+    for (int32_t l = 0; l < levels; l++)
+    {
+        size += pyramidLevelSize(c, r, type);
+        c = (c + 1) / 2;
+        r = (r + 1) / 2;
+    }
+
+    return size;
+}
+
+/*!
+ * \brief Lays out the levels of a pyramid in a single buffer
+ *
+ * The levels are stored one after another, finest first, each aligned to
+ * PYRAMID_ALIGNMENT bytes. A single allocation holds the complete pyramid, so
+ * it can be built once, for example in the image arena, and reused for every
+ * frame.
+ *
+ * \code
+ * pyramid_t pyr;
+ * void *buf = allocImageArena(pyramidBufferSize(cols, rows, 4, IMGTYPE_UINT8));
+ * initPyramid(&pyr, buf, cols, rows, 4, IMGTYPE_UINT8);
+ * gaussianPyramid(src, &pyr);
+ * \endcode
+ *
+ * \param[out] pyr    A pointer to the pyramid
+ * \param[in]  buffer A pointer to a buffer of at least pyramidBufferSize()
+ *                    bytes, aligned to PYRAMID_ALIGNMENT bytes
+ * \param[in]  cols   Number of columns of level 0
+ * \param[in]  rows   Number of rows of level 0
+ * \param[in]  levels Number of levels
+ * \param[in]  type   The type of the pixels, ::IMGTYPE_UINT8 for a Gaussian
+ *                    pyramid and ::IMGTYPE_INT16 for a Laplacian pyramid
+ */
+void initPyramid(pyramid_t *pyr, void *buffer, const int32_t cols,
+                 const int32_t rows, const int32_t levels,
+                 const eImageType type)
+{
+    // Verify parameters
+    ASSERT(pyr == NULL, "pyr is invalid");
+    ASSERT(buffer == NULL, "buffer is invalid");
+    ASSERT((cols <= 0) || (rows <= 0), "size is invalid");
+    ASSERT((levels < 1) || (levels > PYRAMID_MAX_LEVELS), "levels is invalid");
+    ASSERT((type != IMGTYPE_UINT8) && (type != IMGTYPE_INT16), "type is invalid");
+
+    uint8_t *data = (uint8_t *)buffer;
+    int32_t c = cols;
+    int32_t r = rows;
+
+    pyr->levels = levels;
+
+    for (int32_t l = 0; l < levels; l++)
+    {
+        pyr->level[l].cols = c;
+        pyr->level[l].rows = r;
+        pyr->level[l].type = type;
+        pyr->level[l].data = data;
+        pyr->level[l].stride = 0;
+        pyr->level[l].step = 0;
+
+        data += pyramidLevelSize(c, r, type);
+        c = (c + 1) / 2;
+        r = (r + 1) / 2;
+    }
+}
+
+/*!
+ * \brief Builds a Gaussian pyramid
+ *
+ * Level 0 is a copy of the source image, every next level is the pyrDown() of
+ * the previous level.
+ *
+ * The source image can be a luma view, see lumaView().
+ *
+ * \param[in]  src   A pointer to the ::IMGTYPE_UINT8 source image
+ * \param[out] gauss A pointer to an ::IMGTYPE_UINT8 pyramid, initialized by
+ *                   initPyramid() with the size of the source image
+ */
+void gaussianPyramid(const image_t *src, pyramid_t *gauss)
+{
+    TRACE_ENTER(src, NULL);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(gauss == NULL, "gauss is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT((gauss->levels < 1) || (gauss->levels > PYRAMID_MAX_LEVELS), "gauss levels is invalid");
+    ASSERT(gauss->level[0].type != IMGTYPE_UINT8, "gauss type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != gauss->level[0].cols, "src and gauss have different number of columns");
+    ASSERT(src->rows != gauss->level[0].rows, "src and gauss have different number of rows");
+
+    copyUint8Image(src, &gauss->level[0]);
+
+    for (int32_t l = 1; l < gauss->levels; l++)
+    {
+        pyrDown(&gauss->level[l - 1], &gauss->level[l]);
+    }
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Builds a Laplacian pyramid from a Gaussian pyramid
+ *
+ * Level l is the difference between Gaussian level l and the pyrUp() of
+ * Gaussian level l + 1. It holds the details that are lost by the
+ * downsampling. The last level is a copy of the last Gaussian level.
+ *
+ * The upsampled levels are not stored, each is subtracted as soon as a row
+ * has been calculated. The original image is restored exactly by
+ * collapseLaplacianPyramid().
+ *
+ * \param[in]  gauss A pointer to the ::IMGTYPE_UINT8 Gaussian pyramid
+ * \param[out] lap   A pointer to an ::IMGTYPE_INT16 pyramid with the same
+ *                   size and number of levels
+ */
+void laplacianPyramid(const pyramid_t *gauss, pyramid_t *lap)
+{
+    TRACE_ENTER(NULL, NULL);
+
+    // Verify parameters
+    ASSERT(gauss == NULL, "gauss is invalid");
+    ASSERT(lap == NULL, "lap is invalid");
+    ASSERT((gauss->levels < 1) || (gauss->levels > PYRAMID_MAX_LEVELS), "gauss levels is invalid");
+    ASSERT(gauss->levels != lap->levels, "gauss and lap have a different number of levels");
+
+    for (int32_t l = 0; l < gauss->levels; l++)
+    {
+        ASSERT(gauss->level[l].type != IMGTYPE_UINT8, "gauss type is invalid");
+        ASSERT(lap->level[l].type != IMGTYPE_INT16, "lap type is invalid");
+        ASSERT(gauss->level[l].cols != lap->level[l].cols, "gauss and lap have different number of columns");
+        ASSERT(gauss->level[l].rows != lap->level[l].rows, "gauss and lap have different number of rows");
+    }
+
+    const int32_t last = gauss->levels - 1;
+
+    for (int32_t l = 0; l < last; l++)
+    {
+        if (pyrUpKernel(&gauss->level[l + 1], &lap->level[l], &gauss->level[l], PYRUP_SUBTRACT) == 0)
+        {
+            ASSERT(1 == 1, "Unable to allocate memory for the row buffers, increase the size of the image arena");
+            TRACE_EXIT();
+            return;
+        }
+    }
+
+    // The coarsest level is the residual low-pass image
+    const image_t *g = &gauss->level[last];
+    image_t *d = &lap->level[last];
+
+    for (int32_t y = 0; y < g->rows; y++)
+    {
+        const uint8_pixel_t *s = (uint8_pixel_t *)g->data + (y * IMAGE_STRIDE(g));
+        int16_pixel_t *t = (int16_pixel_t *)d->data + (y * IMAGE_STRIDE(d));
+
+        for (int32_t x = 0; x < g->cols; x++)
+        {
+            t[x] = (int16_pixel_t)s[x];
+        }
+    }
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Reconstructs a Gaussian pyramid from a Laplacian pyramid
+ *
+ * Starting at the coarsest level, Gaussian level l is the sum of Laplacian
+ * level l and the pyrUp() of Gaussian level l + 1. For a Laplacian pyramid
+ * that was built by laplacianPyramid() the result is exactly the original
+ * Gaussian pyramid. If the Laplacian levels have been modified, for example
+ * to blend images or to suppress noise, the results are clipped to the
+ * uint8_pixel_t range.
+ *
+ * \param[in]  lap   A pointer to the ::IMGTYPE_INT16 Laplacian pyramid
+ * \param[out] gauss A pointer to an ::IMGTYPE_UINT8 pyramid with the same
+ *                   size and number of levels. Level 0 is the reconstructed
+ *                   image.
+ */
+void collapseLaplacianPyramid(const pyramid_t *lap, pyramid_t *gauss)
+{
+    TRACE_ENTER(NULL, NULL);
+
+    // Verify parameters
+    ASSERT(lap == NULL, "lap is invalid");
+    ASSERT(gauss == NULL, "gauss is invalid");
+    ASSERT((lap->levels < 1) || (lap->levels > PYRAMID_MAX_LEVELS), "lap levels is invalid");
+    ASSERT(gauss->levels != lap->levels, "gauss and lap have a different number of levels");
+
+    for (int32_t l = 0; l < lap->levels; l++)
+    {
+        ASSERT(lap->level[l].type != IMGTYPE_INT16, "lap type is invalid");
+        ASSERT(gauss->level[l].type != IMGTYPE_UINT8, "gauss type is invalid");
+        ASSERT(gauss->level[l].cols != lap->level[l].cols, "gauss and lap have different number of columns");
+        ASSERT(gauss->level[l].rows != lap->level[l].rows, "gauss and lap have different number of rows");
+    }
+
+    const int32_t last = lap->levels - 1;
+    const image_t *s = &lap->level[last];
+    image_t *d = &gauss->level[last];
+
+    for (int32_t y = 0; y < s->rows; y++)
+    {
+        const int16_pixel_t *p = (int16_pixel_t *)s->data + (y * IMAGE_STRIDE(s));
+        uint8_pixel_t *q = (uint8_pixel_t *)d->data + (y * IMAGE_STRIDE(d));
+
+        for (int32_t x = 0; x < s->cols; x++)
+        {
+            int32_t val = p[x];
+            q[x] = (uint8_pixel_t)((val < 0) ? 0 : ((val > UINT8_PIXEL_MAX) ? UINT8_PIXEL_MAX : val));
+        }
+    }
+
+    for (int32_t l = last - 1; l >= 0; l--)
+    {
+        if (pyrUpKernel(&gauss->level[l + 1], &gauss->level[l], &lap->level[l], PYRUP_ADD) == 0)
+        {
+            ASSERT(1 == 1, "Unable to allocate memory for the row buffers, increase the size of the image arena");
+            break;
+        }
+    }
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Maps a pixel coordinate from one pyramid level to another
+ *
+ * Pixel (x,y) in level l + 1 is centered on pixel (2x,2y) in level l. Mapping
+ * to a coarser level rounds to the nearest pixel, mapping to a finer level
+ * returns the pixel on which the coarse pixel is centered. The result is
+ * clipped to the size of the target level, so that it can be used to start a
+ * search in that level, for example in coarse-to-fine matching.
+ *
+ * \param[in] pyr  A pointer to the pyramid
+ * \param[in] p    The coordinate in level from
+ * \param[in] from The level of the coordinate
+ * \param[in] to   The level to map the coordinate to
+ *
+ * \return The coordinate in level to
+ */
+point_t pyramidMapPoint(const pyramid_t *pyr, const point_t p,
+                        const int32_t from, const int32_t to)
+{
+    // Verify parameters
+    ASSERT(pyr == NULL, "pyr is invalid");
+    ASSERT((from < 0) || (from >= pyr->levels), "from is invalid");
+    ASSERT((to < 0) || (to >= pyr->levels), "to is invalid");
+
+    const image_t *src = &pyr->level[from];
+    const image_t *dst = &pyr->level[to];
+    point_t q;
+
+    // Clip to the source level first, so that the shifts do not overflow
+    q.x = (p.x < 0) ? 0 : ((p.x >= src->cols) ? (src->cols - 1) : p.x);
+    q.y = (p.y < 0) ? 0 : ((p.y >= src->rows) ? (src->rows - 1) : p.y);
+
+    if (to > from)
+    {
+        const int32_t shift = to - from;
+        const int32_t half = 1 << (shift - 1);
+
+        q.x = (q.x + half) >> shift;
+        q.y = (q.y + half) >> shift;
+    }
+    else if (to < from)
+    {
+        const int32_t shift = from - to;
+
+        q.x <<= shift;
+        q.y <<= shift;
+    }
+
+    q.x = (q.x >= dst->cols) ? (dst->cols - 1) : q.x;
+    q.y = (q.y >= dst->rows) ? (dst->rows - 1) : q.y;
+
+    return q;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+/*!
+ * \brief Mirrors an index into the range [0,n) without repeating the border
+ *
+ * Index -1 maps to 1 and index n maps to n - 2. Applied repeatedly, so that
+ * it is also valid for images that are smaller than the kernel.
+ *
+ * \param[in] i The index
+ * \param[in] n The number of elements
+ *
+ * \return The mirrored index
+ */
+static int32_t reflect101(int32_t i, const int32_t n)
+{
+    if (n == 1)
+    {
+        return 0;
+    }
+
+    while ((i < 0) || (i >= n))
+    {
+        i = (i < 0) ? -i : ((2 * n) - 2 - i);
+    }
+
+    return i;
+}
+
+/*!
+ * \brief Calculates the number of bytes of one pyramid level
+ *
+ * \param[in] cols Number of columns of the level
+ * \param[in] rows Number of rows of the level
+ * \param[in] type The type of the pixels
+ *
+ * \return The number of bytes, rounded up to PYRAMID_ALIGNMENT
+ */
+static size_t pyramidLevelSize(const int32_t cols, const int32_t rows, const eImageType type)
+{
+    size_t size = (size_t)cols * (size_t)rows *
+                  ((type == IMGTYPE_INT16) ? sizeof(int16_pixel_t) : sizeof(uint8_pixel_t));
+
+    return (size + (PYRAMID_ALIGNMENT - 1)) & ~(size_t)(PYRAMID_ALIGNMENT - 1);
+}
+
+/*!
+ * \brief Upsamples a row horizontally with the pyrUp() weights
+ *
+ * The source pixels just outside the row are mirrored about the outer pixels
+ * of the destination row. For an odd destination width the last destination
+ * pixel coincides with the last source pixel, so pixel n - 2 is mirrored. For
+ * an even width the mirror lies halfway between two destination pixels, so
+ * pixel n - 1 is repeated.
+ *
+ * \param[in]  s    A pointer to the source row
+ * \param[in]  n    Number of source pixels
+ * \param[out] h    A pointer to the destination row, at most 8 * 255 per pixel
+ * \param[in]  cols Number of destination pixels, 2 * n or 2 * n - 1
+ */
+static void pyrUpRow(const uint8_pixel_t *s, const int32_t n, uint16_t *h, const int32_t cols)
+{
+    const uint16_t left = s[(n > 1) ? 1 : 0];
+    const uint16_t right = s[((cols & 1) && (n > 1)) ? (n - 2) : (n - 1)];
+
+    if (n == 1)
+    {
+        h[0] = (uint16_t)(left + 6 * s[0] + right);
+
+        if (cols > 1)
+        {
+            h[1] = (uint16_t)(4 * (s[0] + right));
+        }
+
+        return;
+    }
+
+    h[0] = (uint16_t)(left + 6 * s[0] + s[1]);
+    h[1] = (uint16_t)(4 * (s[0] + s[1]));
+
+    for (int32_t i = 1; i < (n - 1); i++)
+    {
+        h[2 * i] = (uint16_t)(s[i - 1] + 6 * s[i] + s[i + 1]);
+        h[2 * i + 1] = (uint16_t)(4 * (s[i] + s[i + 1]));
+    }
+
+    h[2 * n - 2] = (uint16_t)(s[n - 2] + 6 * s[n - 1] + right);
+
+    if (cols == (2 * n))
+    {
+        h[2 * n - 1] = (uint16_t)(4 * (s[n - 1] + right));
+    }
+}
+
+/*!
+ * \brief Upsamples an image and optionally combines it with another image
+ *
+ * Shared by pyrUp(), laplacianPyramid() and collapseLaplacianPyramid(). The
+ * source rows are upsampled horizontally into a ring of three row buffers,
+ * from which the destination rows are filtered vertically. Each source row is
+ * upsampled once.
+ *
+ * \param[in]  src   A pointer to the ::IMGTYPE_UINT8 source image
+ * \param[out] dst   A pointer to the destination image
+ * \param[in]  other A pointer to the image that is combined with the
+ *                   upsampled image, NULL for ::PYRUP_COPY
+ * \param[in]  op    What to do with the upsampled pixels, see ::ePyrUp
+ *
+ * \return 1 on success, 0 if the row buffers could not be allocated
+ */
+static int32_t pyrUpKernel(const image_t *src, image_t *dst, const image_t *other, const ePyrUp op)
+{
+    const int32_t n = src->cols;
+    const int32_t m = src->rows;
+    const int32_t cols = dst->cols;
+    const int32_t src_stride = IMAGE_STRIDE(src);
+
+    image_arena_mark_t mark = markImageArena();
+
+    uint16_t *buf = (uint16_t *)allocImageArena(3 * cols * sizeof(uint16_t) + cols);
+
+    if (buf == NULL)
+    {
+        return 0;
+    }
+
+    uint16_t *prev = buf;
+    uint16_t *cur = buf + cols;
+    uint16_t *next = buf + 2 * cols;
+    uint8_pixel_t *tmp = (uint8_pixel_t *)(buf + 3 * cols);
+
+    // Source rows just outside the image, mirrored like in pyrUpRow()
+    const int32_t top = (m > 1) ? 1 : 0;
+    const int32_t bottom = ((dst->rows & 1) && (m > 1)) ? (m - 2) : (m - 1);
+
+    pyrUpRow((uint8_pixel_t *)src->data + (top * src_stride), n, prev, cols);
+    pyrUpRow((uint8_pixel_t *)src->data, n, cur, cols);
+    pyrUpRow((uint8_pixel_t *)src->data + (((m > 1) ? 1 : bottom) * src_stride), n, next, cols);
+
+    for (int32_t j = 0; j < m; j++)
+    {
+        for (int32_t k = 0; k < 2; k++)
+        {
+            const int32_t y = 2 * j + k;
+
+            if (y >= dst->rows)
+            {
+                break;
+            }
+
+            // Rows are written directly into the destination when copying
+            uint8_pixel_t *u = (op == PYRUP_COPY) ?
+                               (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst)) : tmp;
+
+            // Even rows [1 6 1] / 8, odd rows [4 4] / 8, 64 in total
+            if (k == 0)
+            {
+                for (int32_t x = 0; x < cols; x++)
+                {
+                    u[x] = (uint8_pixel_t)((prev[x] + 6 * cur[x] + next[x] + 32) >> 6);
+                }
+            }
+            else
+            {
+                for (int32_t x = 0; x < cols; x++)
+                {
+                    u[x] = (uint8_pixel_t)((cur[x] + next[x] + 8) >> 4);
+                }
+            }
+
+            if (op == PYRUP_SUBTRACT)
+            {
+                const uint8_pixel_t *g = (uint8_pixel_t *)other->data + (y * IMAGE_STRIDE(other));
+                int16_pixel_t *d = (int16_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+                for (int32_t x = 0; x < cols; x++)
+                {
+                    d[x] = (int16_pixel_t)(g[x] - u[x]);
+                }
+            }
+            else if (op == PYRUP_ADD)
+            {
+                const int16_pixel_t *l = (int16_pixel_t *)other->data + (y * IMAGE_STRIDE(other));
+                uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+                for (int32_t x = 0; x < cols; x++)
+                {
+                    int32_t val = l[x] + u[x];
+                    d[x] = (uint8_pixel_t)((val < 0) ? 0 : ((val > UINT8_PIXEL_MAX) ? UINT8_PIXEL_MAX : val));
+                }
+            }
+        }
+
+        // Shift the ring of row buffers down by one source row
+        uint16_t *t = prev;
+        prev = cur;
+        cur = next;
+        next = t;
+
+        if ((j + 2) < m)
+        {
+            pyrUpRow((uint8_pixel_t *)src->data + ((j + 2) * src_stride), n, next, cols);
+        }
+        else if ((j + 1) < m)
+        {
+            pyrUpRow((uint8_pixel_t *)src->data + (bottom * src_stride), n, next, cols);
+        }
+    }
+
+    releaseImageArena(mark);
+
+    return 1;
+}
@@ -0,0 +1,81 @@
+/*! ***************************************************************************
+ *
+ * \brief     Gaussian and Laplacian image pyramids
+ * \file      pyramids.h
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Include guard to prevent recursive inclusion
+#ifndef _PYRAMIDS_H_
+#define _PYRAMIDS_H_
+
+#include "image.h"
+
+/// Maximum number of levels in a pyramid
+#define PYRAMID_MAX_LEVELS (10)
+
+/*!
+ * \brief Defines an image pyramid
+ *
+ * Level 0 has the full resolution. Every next level has half the number of
+ * columns and rows of the previous level, rounded up. The pixel data of all
+ * levels is stored in one buffer, see initPyramid().
+ */
+typedef struct
+{
+    int32_t levels;                    ///< Number of levels in use
+    image_t level[PYRAMID_MAX_LEVELS]; ///< The levels, finest first
+
+}pyramid_t;
+
+// Functions are documented in the source file
+
+void pyrDown(const image_t *src, image_t *dst);
+void pyrUp(const image_t *src, image_t *dst);
+
+size_t pyramidBufferSize(const int32_t cols, const int32_t rows,
+                         const int32_t levels, const eImageType type);
+void initPyramid(pyramid_t *pyr, void *buffer, const int32_t cols,
+                 const int32_t rows, const int32_t levels,
+                 const eImageType type);
+void gaussianPyramid(const image_t *src, pyramid_t *gauss);
+void laplacianPyramid(const pyramid_t *gauss, pyramid_t *lap);
+void collapseLaplacianPyramid(const pyramid_t *lap, pyramid_t *gauss);
+point_t pyramidMapPoint(const pyramid_t *pyr, const point_t p,
+                        const int32_t from, const int32_t to);
+
+#endif // _PYRAMIDS_H_
+
+#ifdef __cplusplus
+}
+#endif
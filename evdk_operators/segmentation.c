@@ -41,6 +41,10 @@
 #include "histogram_operations.h"
 #include "image_fundamentals.h"
 #include "segmentation.h"
+#include "spatial_filters.h"
+#include "trace.h"
+
+#include <string.h>
 
 /*!
  * \brief Separates object from background
@@ -62,26 +66,58 @@
 void threshold(const image_t *src, image_t *dst,
                const uint8_pixel_t min, const uint8_pixel_t max)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
 
-    uint32_t i = src->rows * src->cols;
-    uint8_pixel_t *s = (uint8_pixel_t *)src->data;
-    uint8_pixel_t *d = (uint8_pixel_t *)dst->data;
+    // The source image can be a luma view
+    const int32_t step = IMAGE_STEP(src);
 
-    // Loop all pixels and set to 1 if the pixel is within thresholding window
-    while (i-- > 0)
+    for (int32_t y = 0; y < src->rows; y++)
     {
-        uint8_pixel_t pixel = *s++;
-        *d++ = ((pixel >= min) && (pixel <= max)) ? 1 : 0;
+        uint32_t i = src->cols;
+        uint8_pixel_t *s = (uint8_pixel_t *)src->data + (y * IMAGE_STRIDE(src));
+        uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        // Loop all pixels in the row and set to 1 if the pixel is within
+        // thresholding window
+        if (step == 1)
+        {
+            while (i-- > 0)
+            {
+                uint8_pixel_t pixel = *s++;
+                *d++ = ((pixel >= min) && (pixel <= max)) ? 1 : 0;
+            }
+        }
+        else if (step == 2)
+        {
+            // A luma view, a constant step allows vectorization
+            for (int32_t x = 0; x < (int32_t)i; x++)
+            {
+                uint8_pixel_t pixel = s[x * 2];
+                d[x] = ((pixel >= min) && (pixel <= max)) ? 1 : 0;
+            }
+        }
+        else
+        {
+            for (int32_t x = 0; x < (int32_t)i; x++)
+            {
+                uint8_pixel_t pixel = s[x * step];
+                d[x] = ((pixel >= min) && (pixel <= max)) ? 1 : 0;
+            }
+        }
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -96,6 +132,8 @@ void threshold(const image_t *src, image_t *dst,
  */
 void thresholdOptimum(const image_t *src, image_t *dst, const eBrightness b)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -163,6 +201,8 @@ void thresholdOptimum(const image_t *src, image_t *dst, const eBrightness b)
         threshold(src, dst, 0, t);
     else
         threshold(src, dst, t, 255);
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -179,6 +219,8 @@ void thresholdOptimum(const image_t *src, image_t *dst, const eBrightness b)
  */
 void threshold2Means(const image_t *src, image_t *dst, const eBrightness b)
 {
+    TRACE_ENTER(src, dst);
+
     // calculate the histogram
     uint32_t hist[256] = {0};
 
@@ -249,6 +291,8 @@ void threshold2Means(const image_t *src, image_t *dst, const eBrightness b)
     {
         threshold(src, dst, T_new, 255);
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -267,6 +311,8 @@ void threshold2Means(const image_t *src, image_t *dst, const eBrightness b)
  */
 void thresholdOtsu(const image_t *src, image_t *dst, const eBrightness b)
 {
+    TRACE_ENTER(src, dst);
+
     uint32_t hist[256] = {0};
     histogram(src, hist);
 
@@ -334,6 +380,8 @@ void thresholdOtsu(const image_t *src, image_t *dst, const eBrightness b)
     {
         threshold(src, dst, best_T, 255);
     }
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -376,29 +424,35 @@ void thresholdOtsu(const image_t *src, image_t *dst, const eBrightness b)
  */
 void lineDetector(const image_t *src, image_t *dst, int16_t mask[][3])
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
     ASSERT(src->data == NULL, "src data is invalid");
     ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
     ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
     ASSERT(src == dst, "src and dst are the same images");
 
+    const uint8_pixel_t *src_data = (const uint8_pixel_t *)src->data;
+    uint8_pixel_t *dst_data = (uint8_pixel_t *)dst->data;
+    const int32_t src_stride = IMAGE_STRIDE(src);
+    const int32_t dst_stride = IMAGE_STRIDE(dst);
+
     // Set first and last row in dst to 0
-    for (int32_t x = 0; x < dst->cols; x++)
-    {
-        setUint8Pixel(dst, x, 0, 0);
-        setUint8Pixel(dst, x, dst->rows - 1, 0);
-    }
+    memset(dst_data, 0, dst->cols * sizeof(uint8_pixel_t));
+    memset(dst_data + ((dst->rows - 1) * dst_stride), 0, dst->cols * sizeof(uint8_pixel_t));
 
     // Set first and last column in dst to 0
     for (int32_t y = 0; y < dst->rows; y++)
     {
-        setUint8Pixel(dst, 0, y, 0);
-        setUint8Pixel(dst, dst->cols - 1, y, 0);
+        dst_data[y * dst_stride] = 0;
+        dst_data[(y * dst_stride) + dst->cols - 1] = 0;
     }
 
     int32_t sum;
@@ -406,17 +460,18 @@ void lineDetector(const image_t *src, image_t *dst, int16_t mask[][3])
     // Loop all pixels, skipping the border pixels
     for (int32_t y = 1; y < (src->rows - 1); y++)
     {
+        // Rows above, at and below the current pixel
+        const uint8_pixel_t *s0 = src_data + ((y - 1) * src_stride);
+        const uint8_pixel_t *s1 = s0 + src_stride;
+        const uint8_pixel_t *s2 = s1 + src_stride;
+        uint8_pixel_t *d = dst_data + (y * dst_stride);
+
         for (int32_t x = 1; x < (src->cols - 1); x++)
         {
             // Calculate the sum under the 3x3 mask
-            sum = 0;
-            for (int32_t j = -1; j <= 1; j++)
-            {
-                for (int32_t i = -1; i <= 1; i++)
-                {
-                    sum += getUint8Pixel(src, (x + i), (y + j)) * mask[j + 1][i + 1];
-                }
-            }
+            sum = (s0[x - 1] * mask[0][0]) + (s0[x] * mask[0][1]) + (s0[x + 1] * mask[0][2]) +
+                  (s1[x - 1] * mask[1][0]) + (s1[x] * mask[1][1]) + (s1[x + 1] * mask[1][2]) +
+                  (s2[x - 1] * mask[2][0]) + (s2[x] * mask[2][1]) + (s2[x + 1] * mask[2][2]);
 
             // Clip the result
             if (sum > 255)
@@ -430,7 +485,189 @@ void lineDetector(const image_t *src, image_t *dst, int16_t mask[][3])
             }
 
             // Store the result
-            setUint8Pixel(dst, x, y, sum);
+            d[x] = sum;
+        }
+    }
+
+    TRACE_EXIT();
+}
+
+/// Pixel states used by canny() in the destination image
+#define CANNY_NONE (0)   ///< Not an edge
+#define CANNY_EDGE (1)   ///< Edge pixel whose neighbours have been tracked
+#define CANNY_WEAK (2)   ///< Local maximum between the thresholds
+#define CANNY_TRACK (3)  ///< Edge pixel whose neighbours must still be tracked
+
+/*!
+ * \brief Canny edge detector
+ *
+ * The magnitude and direction of the gradient are calculated by sobelFused()
+ * with the L1 norm. Non-maximum suppression compares the magnitude of every
+ * pixel with its two neighbours along the gradient direction, quantised to
+ * 0, 45, 90 or 135 degrees. A local maximum of at least \p high is an edge, a
+ * local maximum of at least \p low is an edge only if it is connected to an
+ * edge.
+ *
+ * Hysteresis is implemented with an edge tracker that pushes the edge pixels
+ * on \p stack, so the weak pixels are visited once instead of sweeping the
+ * image until nothing changes. If the stack is full, the remaining edge
+ * pixels are marked and picked up by an extra sweep, so a small stack only
+ * costs time.
+ *
+ * All working memory is provided by the caller. The border pixels of \p dst
+ * are 0, the edge pixels are 1.
+ *
+ * \param[in]  src       A pointer to the ::IMGTYPE_UINT8 or ::IMGTYPE_INT16
+ *                       source image
+ * \param[out] dst       A pointer to the ::IMGTYPE_UINT8 destination image
+ * \param[out] mag       A pointer to an ::IMGTYPE_INT16 image for the gradient
+ *                       magnitude
+ * \param[out] dir       A pointer to an ::IMGTYPE_UINT8 image for the gradient
+ *                       direction
+ * \param[out] stack     A pointer to the stack of the edge tracker
+ * \param[in]  stackSize The number of elements of \p stack
+ * \param[in]  low       The low threshold of the magnitude
+ * \param[in]  high      The high threshold of the magnitude
+ */
+void canny(const image_t *src, image_t *dst, image_t *mag, image_t *dir,
+           uint32_t *stack, const uint32_t stackSize,
+           const int16_pixel_t low, const int16_pixel_t high)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(mag == NULL, "mag image is invalid");
+    ASSERT(dir == NULL, "dir image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(dst->type != IMGTYPE_UINT8, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+    ASSERT(src == dst, "src and dst are the same images");
+
+    // Verify parameters
+    ASSERT(stack == NULL, "stack is invalid");
+    ASSERT(stackSize == 0, "stack size can not be equal to 0");
+    ASSERT(low > high, "low threshold is larger than the high threshold");
+
+    sobelFused(src, mag, dir, MAGNITUDE_L1);
+
+    const int32_t cols = dst->cols;
+    const int32_t rows = dst->rows;
+    const int32_t stride = IMAGE_STRIDE(dst);
+    uint8_pixel_t *dst_data = (uint8_pixel_t *)dst->data;
+
+    // Offsets of the two neighbours along each quantised direction
+    const int32_t ms = IMAGE_STRIDE(mag);
+    const int32_t along[4] = {1, ms + 1, ms, ms - 1};
+
+    // Set first and last row in dst to 0
+    memset(dst_data, 0, cols * sizeof(uint8_pixel_t));
+    memset(dst_data + ((rows - 1) * stride), 0, cols * sizeof(uint8_pixel_t));
+
+    // Non-maximum suppression and classification, skipping the border pixels
+    for (int32_t y = 1; y < (rows - 1); y++)
+    {
+        const int16_pixel_t *m = (const int16_pixel_t *)mag->data + (y * ms);
+        const uint8_pixel_t *a = (const uint8_pixel_t *)dir->data + (y * IMAGE_STRIDE(dir));
+        uint8_pixel_t *d = dst_data + (y * stride);
+
+        d[0] = CANNY_NONE;
+        d[cols - 1] = CANNY_NONE;
+
+        for (int32_t x = 1; x < (cols - 1); x++)
+        {
+            const int16_pixel_t v = m[x];
+
+            if (v < low)
+            {
+                d[x] = CANNY_NONE;
+                continue;
+            }
+
+            // 256 binary angles per circle, 32 per 45 degrees
+            const int32_t o = along[((a[x] + 16) >> 5) & 3];
+
+            // A plateau keeps its first pixel only
+            if ((v <= m[x - o]) || (v < m[x + o]))
+            {
+                d[x] = CANNY_NONE;
+                continue;
+            }
+
+            d[x] = (v >= high) ? CANNY_TRACK : CANNY_WEAK;
         }
     }
+
+    // Hysteresis, track the edges from every strong pixel
+    const int32_t neighbours[8] = {-stride - 1, -stride, -stride + 1, -1, 1, stride - 1, stride, stride + 1};
+
+    uint32_t overflow = 1;
+
+    while (overflow)
+    {
+        overflow = 0;
+
+        for (int32_t y = 1; y < (rows - 1); y++)
+        {
+            for (int32_t x = 1; x < (cols - 1); x++)
+            {
+                if (dst_data[(y * stride) + x] != CANNY_TRACK)
+                {
+                    continue;
+                }
+
+                uint32_t top = 0;
+
+                dst_data[(y * stride) + x] = CANNY_EDGE;
+                stack[top++] = (uint32_t)((y * stride) + x);
+
+                while (top > 0)
+                {
+                    const int32_t p = (int32_t)stack[--top];
+
+                    for (int32_t i = 0; i < 8; i++)
+                    {
+                        const int32_t q = p + neighbours[i];
+
+                        if (dst_data[q] != CANNY_WEAK)
+                        {
+                            continue;
+                        }
+
+                        if (top < stackSize)
+                        {
+                            dst_data[q] = CANNY_EDGE;
+                            stack[top++] = (uint32_t)q;
+                        }
+                        else
+                        {
+                            // Track this pixel in the next sweep
+                            dst_data[q] = CANNY_TRACK;
+                            overflow = 1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Weak pixels that are not connected to an edge are removed
+    for (int32_t y = 1; y < (rows - 1); y++)
+    {
+        uint8_pixel_t *d = dst_data + (y * stride);
+
+        for (int32_t x = 1; x < (cols - 1); x++)
+        {
+            d[x] = (d[x] == CANNY_EDGE) ? 1 : 0;
+        }
+    }
+
+    TRACE_EXIT();
 }
@@ -49,6 +49,9 @@ void thresholdOptimum(const image_t *src, image_t *dst, const eBrightness b);
 void threshold2Means(const image_t *src, image_t *dst, const eBrightness b);
 void thresholdOtsu(const image_t *src, image_t *dst, const eBrightness b);
 void lineDetector(const image_t *src, image_t *dst, int16_t mask[][3]);
+void canny(const image_t *src, image_t *dst, image_t *mag, image_t *dir,
+           uint32_t *stack, const uint32_t stackSize,
+           const int16_pixel_t low, const int16_pixel_t high);
 
 #endif // _SEGMENTATION_H_
 
@@ -36,8 +36,17 @@
  *****************************************************************************/
 #include "image_fundamentals.h"
 #include "spatial_filters.h"
+#include "trace.h"
 
 #include <math.h>
+#include <stdlib.h>
+
+// SIMD path for x86, selected at compile time. SSE2 is part of every x86-64
+// target.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define USE_SSE2
+#include <emmintrin.h>
+#endif
 
 /*!
  * \brief Applies a 3x3 Gaussian filter
@@ -49,6 +58,8 @@
  */
 void gaussianFilter_3x3(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -56,6 +67,8 @@ void gaussianFilter_3x3(const image_t *src, image_t *dst)
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_INT16, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_INT16, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -86,6 +99,8 @@ void gaussianFilter_3x3(const image_t *src, image_t *dst)
         };
 
     convolve(src, dst, &msk);
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -98,6 +113,8 @@ void gaussianFilter_3x3(const image_t *src, image_t *dst)
  */
 void gaussianFilter_5x5(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -105,6 +122,8 @@ void gaussianFilter_5x5(const image_t *src, image_t *dst)
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_INT16, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_INT16, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -151,6 +170,8 @@ void gaussianFilter_5x5(const image_t *src, image_t *dst)
         };
 
     convolve(src, dst, &msk);
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -164,6 +185,8 @@ void gaussianFilter_5x5(const image_t *src, image_t *dst)
  */
 void laplacianFilter_3x3(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -171,6 +194,8 @@ void laplacianFilter_3x3(const image_t *src, image_t *dst)
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_INT16, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_INT16, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -201,6 +226,8 @@ void laplacianFilter_3x3(const image_t *src, image_t *dst)
         };
 
     convolve(src, dst, &msk);
+
+    TRACE_EXIT();
 }
 
 /*!
@@ -214,6 +241,8 @@ void laplacianFilter_3x3(const image_t *src, image_t *dst)
  */
 void laplacianFilter_5x5(const image_t *src, image_t *dst)
 {
+    TRACE_ENTER(src, dst);
+
     // Verify image validity
     ASSERT(src == NULL, "src image is invalid");
     ASSERT(dst == NULL, "dst image is invalid");
@@ -221,6 +250,8 @@ void laplacianFilter_5x5(const image_t *src, image_t *dst)
     ASSERT(dst->data == NULL, "dst data is invalid");
     ASSERT(src->type != IMGTYPE_INT16, "src type is invalid");
     ASSERT(dst->type != IMGTYPE_INT16, "dst type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(dst) != 1, "dst image can not be a luma view");
 
     // Verify image consistency
     ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
@@ -267,243 +298,541 @@ void laplacianFilter_5x5(const image_t *src, image_t *dst)
         };
 
     convolve(src, dst, &msk);
+
+    TRACE_EXIT();
 }
 
+/// Number of intervals of the arctangent table
+#define SOBEL_ATAN_STEPS (256)
+
 /*!
- * \brief Sobel edge detection algorithm that produces the magnitude and
- *        direction of an edge in grayscale images
+ * \brief atan(i / ::SOBEL_ATAN_STEPS) in binary angles, 256 per full circle
+ */
+static const uint8_t sobel_atan_lut[SOBEL_ATAN_STEPS + 1] =
+{
+    0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2,
+    3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 5, 5, 5,
+    5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7,
+    8, 8, 8, 8, 8, 8, 8, 9, 9, 9, 9, 9, 9, 10, 10, 10,
+    10, 10, 10, 10, 11, 11, 11, 11, 11, 11, 11, 12, 12, 12, 12, 12,
+    12, 12, 13, 13, 13, 13, 13, 13, 13, 14, 14, 14, 14, 14, 14, 14,
+    15, 15, 15, 15, 15, 15, 15, 16, 16, 16, 16, 16, 16, 16, 17, 17,
+    17, 17, 17, 17, 17, 17, 18, 18, 18, 18, 18, 18, 18, 19, 19, 19,
+    19, 19, 19, 19, 19, 20, 20, 20, 20, 20, 20, 20, 20, 21, 21, 21,
+    21, 21, 21, 21, 21, 21, 22, 22, 22, 22, 22, 22, 22, 22, 23, 23,
+    23, 23, 23, 23, 23, 23, 23, 24, 24, 24, 24, 24, 24, 24, 24, 24,
+    25, 25, 25, 25, 25, 25, 25, 25, 25, 25, 26, 26, 26, 26, 26, 26,
+    26, 26, 26, 27, 27, 27, 27, 27, 27, 27, 27, 27, 27, 28, 28, 28,
+    28, 28, 28, 28, 28, 28, 28, 28, 29, 29, 29, 29, 29, 29, 29, 29,
+    29, 29, 29, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 31, 31,
+    31, 31, 31, 31, 31, 31, 31, 31, 31, 31, 32, 32, 32, 32, 32, 32,
+    32,
+};
+
+/*!
+ * \brief Returns the direction of a gradient in binary angles
  *
- * The function first creates an horizontal and vertical enhanced image.
- * These enhanced images are used to calculate the Sobel magnitude and
- * direction for each pixel.
+ * The full circle is divided into 256 binary angles. 0 points to the right,
+ * 64 points down, 128 points to the left and 192 points up. The gradient is
+ * reduced to the first octant, so a single arctangent table suffices. Edge
+ * gradients have random signs, so the octant is selected with conditional
+ * moves instead of branches.
  *
- * \param[in]  src A pointer to the source image
- * \param[out] mag A pointer to the Sobel magnitude destination image
- * \param[out] dir A pointer to the Sobel direction destination image.
- *                 If this is a NULL pointer, the Sobel direction is
- *                 not calculated.
+ * \param[in] gx The horizontal component of the gradient
+ * \param[in] gy The vertical component of the gradient
+ *
+ * \return The direction of the gradient, 0 for a zero gradient
  */
-void sobel(const image_t *src, image_t *mag, image_t *dir)
+static inline uint8_t sobelAngle(const int32_t gx, const int32_t gy)
 {
-    // Verify image validity
-    ASSERT(src == NULL, "src image is invalid");
-    ASSERT(mag == NULL, "mag image is invalid");
-    ASSERT(src->data == NULL, "src data is invalid");
-    ASSERT(mag->data == NULL, "mag data is invalid");
-    ASSERT(src->type != IMGTYPE_INT16, "src type is invalid");
-    ASSERT(mag->type != IMGTYPE_INT16, "mag type is invalid");
+    const int32_t ax = abs(gx);
+    const int32_t ay = abs(gy);
 
-    // Verify image consistency
-    ASSERT(src->cols != mag->cols, "src and mag have different number of columns");
-    ASSERT(src->rows != mag->rows, "src and mag have different number of rows");
-    ASSERT(src == mag, "src and dst are the same images");
+    const int32_t steep = (ay > ax);
+    const int32_t lo = steep ? ax : ay;
+    const int32_t hi = steep ? ay : ax;
 
-    // Define Sobel masks
-    int16_pixel_t gh_msk_data[3 * 3] =
-        {
-            -1,
-            -2,
-            -1,
-            0,
-            0,
-            0,
-            1,
-            2,
-            1,
-        };
+    // A zero gradient gives a zero ratio
+    const int32_t d = (hi == 0) ? 1 : hi;
 
-    int16_pixel_t gv_msk_data[3 * 3] =
-        {
-            -1,
-            0,
-            1,
-            -2,
-            0,
-            2,
-            -1,
-            0,
-            1,
-        };
+    int32_t a = sobel_atan_lut[((lo * SOBEL_ATAN_STEPS) + (d / 2)) / d];
 
-    // Create the mask image
-    image_t msk =
-        {
-            .cols = 3,
-            .rows = 3,
-            .type = IMGTYPE_INT16,
-            .data = NULL,
-        };
+    a = steep ? (64 - a) : a;
+    a = (gx < 0) ? (128 - a) : a;
+    a = (gy < 0) ? (256 - a) : a;
+
+    return (uint8_t)a;
+}
+
+/*!
+ * \brief Returns the magnitude of a gradient, clipped to the range of
+ *        int16_pixel_t
+ *
+ * \param[in] gx   The horizontal component of the gradient
+ * \param[in] gy   The vertical component of the gradient
+ * \param[in] norm The norm, must be of type ::eMagnitude
+ *
+ * \return The magnitude of the gradient
+ */
+static inline int16_pixel_t sobelMagnitude(const int32_t gx, const int32_t gy, const eMagnitude norm)
+{
+    const int32_t ax = abs(gx);
+    const int32_t ay = abs(gy);
+    int32_t m;
 
-    // Create temporary images and verify memory allocation
-    image_t *gh = newInt16Image(src->cols, src->rows);
-    if (gh == NULL)
+    if (norm == MAGNITUDE_L1)
     {
-        // No memory allocated
-        return;
+        m = ax + ay;
+    }
+    else if (norm == MAGNITUDE_L2)
+    {
+        m = (int32_t)(sqrtf((float)((ax * ax) + (ay * ay))) + 0.5f);
     }
+    else
+    {
+        const int32_t hi = (ax > ay) ? ax : ay;
+        const int32_t lo = (ax > ay) ? ay : ax;
 
-    image_t *gv = newInt16Image(src->cols, src->rows);
+        m = ((123 * hi) + (51 * lo) + 64) >> 7;
+    }
+
+    return (m > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : (int16_pixel_t)m;
+}
 
-    if (gv == NULL)
+/*!
+ * \brief Writes the magnitude and direction of a single pixel
+ *
+ * A direction image of type ::IMGTYPE_FLOAT gets the angle of sobel(), one of
+ * type ::IMGTYPE_UINT8 the binary angle of sobelAngle().
+ *
+ * \param[out] mag  A pointer to the row of the magnitude image
+ * \param[out] dir  A pointer to the direction image, or NULL
+ * \param[in]  x    The column
+ * \param[in]  y    The row
+ * \param[in]  gx   The horizontal component of the gradient
+ * \param[in]  gy   The vertical component of the gradient
+ * \param[in]  norm The norm, must be of type ::eMagnitude
+ */
+static inline void sobelStore(int16_pixel_t *mag, const image_t *dir, const int32_t x, const int32_t y,
+                              const int32_t gx, const int32_t gy, const eMagnitude norm)
+{
+    mag[x] = sobelMagnitude(gx, gy, norm);
+
+    if (dir == NULL)
     {
-        // No memory allocated
-        deleteInt16Image(gh);
         return;
     }
 
-    clearInt16Image(gh);
-    clearInt16Image(gv);
+    if (dir->type == IMGTYPE_FLOAT)
+    {
+        // PHIsobel = tan-1(Gv/Gh)
+        ((float_pixel_t *)dir->data)[(y * IMAGE_STRIDE(dir)) + x] = atanf(((float)gx) / (float)gy);
+    }
+    else
+    {
+        ((uint8_pixel_t *)dir->data)[(y * IMAGE_STRIDE(dir)) + x] = sobelAngle(gx, gy);
+    }
+}
+
+/*!
+ * \brief Returns a source pixel, 0 outside the image
+ *
+ * \param[in] src A pointer to the source image
+ * \param[in] x   The column
+ * \param[in] y   The row
+ *
+ * \return The pixel value
+ */
+static inline int32_t sobelPixel(const image_t *src, const int32_t x, const int32_t y)
+{
+    if ((x < 0) || (y < 0) || (x >= src->cols) || (y >= src->rows))
+    {
+        return 0;
+    }
 
-    // Calculate Gh by correlating the mask
-    // Use correlation instead of convolution, because the
-    // mask is not symmetrical in both horizontal and
-    // vertical direction
-    msk.data = (uint8_t *)gh_msk_data;
-    correlate(src, gh, &msk);
+    if (src->type == IMGTYPE_UINT8)
+    {
+        return ((const uint8_pixel_t *)src->data)[(y * IMAGE_STRIDE(src)) + x];
+    }
 
-    // Calculate Gv by correlating the mask
-    // Use correlation instead of convolution, because the
-    // mask is not symmetrical in both horizontal and
-    // vertical direction
-    msk.data = (uint8_t *)gv_msk_data;
-    correlate(src, gv, &msk);
+    return ((const int16_pixel_t *)src->data)[(y * IMAGE_STRIDE(src)) + x];
+}
 
-    // Loop all pixels
-    if (dir == NULL)
+/*!
+ * \brief Calculates the Sobel gradient of a single pixel near the border
+ *
+ * The components are clipped to the range of int16_pixel_t, exactly like the
+ * correlation in sobel() used to do.
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[in]  x   The column
+ * \param[in]  y   The row
+ * \param[out] gx  The horizontal component of the gradient
+ * \param[out] gy  The vertical component of the gradient
+ */
+static void sobelBorderGradient(const image_t *src, const int32_t x, const int32_t y, int32_t *gx, int32_t *gy)
+{
+    const int32_t tl = sobelPixel(src, x - 1, y - 1);
+    const int32_t tc = sobelPixel(src, x, y - 1);
+    const int32_t tr = sobelPixel(src, x + 1, y - 1);
+    const int32_t ml = sobelPixel(src, x - 1, y);
+    const int32_t mr = sobelPixel(src, x + 1, y);
+    const int32_t bl = sobelPixel(src, x - 1, y + 1);
+    const int32_t bc = sobelPixel(src, x, y + 1);
+    const int32_t br = sobelPixel(src, x + 1, y + 1);
+
+    const int32_t h = (tr + (2 * mr) + br) - (tl + (2 * ml) + bl);
+    const int32_t v = (bl + (2 * bc) + br) - (tl + (2 * tc) + tr);
+
+    *gx = (h > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : ((h < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : h);
+    *gy = (v > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : ((v < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : v);
+}
+
+/*!
+ * \brief Sobel gradients of the interior pixels x0 - x1 of a row, from a
+ *        sliding window of three source rows
+ *
+ * Generates sobelInteriorUint8() and sobelInteriorInt16(). The pointers point
+ * to column 0 of the row above, the row itself and the row below.
+ */
+#define SOBEL_INTERIOR(name, type)                                                                    \
+    static void name(const type *t, const type *m, const type *b, int16_pixel_t *mag,                  \
+                     const image_t *dir, const int32_t y, int32_t x, const int32_t x1,                 \
+                     const eMagnitude norm)                                                           \
+    {                                                                                                 \
+        for (; x < x1; x++)                                                                           \
+        {                                                                                             \
+            int32_t gx = (t[x + 1] + (2 * m[x + 1]) + b[x + 1]) - (t[x - 1] + (2 * m[x - 1]) + b[x - 1]); \
+            int32_t gy = (b[x - 1] + (2 * b[x]) + b[x + 1]) - (t[x - 1] + (2 * t[x]) + t[x + 1]);       \
+                                                                                                      \
+            gx = (gx > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : ((gx < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : gx); \
+            gy = (gy > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : ((gy < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : gy); \
+                                                                                                      \
+            sobelStore(mag, dir, x, y, gx, gy, norm);                                                   \
+        }                                                                                             \
+    }
+
+SOBEL_INTERIOR(sobelInteriorUint8, uint8_pixel_t)
+SOBEL_INTERIOR(sobelInteriorInt16, int16_pixel_t)
+
+#if defined(USE_SSE2)
+/*!
+ * \brief SSE2 version of sobelInteriorUint8(), 8 pixels at once
+ *
+ * The gradients of 8-bit pixels fit in 16 bits, so everything but the lookup
+ * in the arctangent table is done in the vector registers. The ratio that
+ * indexes the table is calculated with a float division, which gives the same
+ * index as the integer division of sobelAngle() for gradients of this size.
+ *
+ * \param[in]  t    A pointer to column 0 of the row above
+ * \param[in]  m    A pointer to column 0 of the row
+ * \param[in]  b    A pointer to column 0 of the row below
+ * \param[out] mag  A pointer to column 0 of the magnitude row
+ * \param[out] dir  A pointer to column 0 of the ::IMGTYPE_UINT8 direction row,
+ *                  or NULL
+ * \param[in]  x    The first column
+ * \param[in]  x1   The column after the last column
+ * \param[in]  norm The norm, must be of type ::eMagnitude
+ *
+ * \return The first column that is not processed
+ */
+static int32_t sobelInteriorUint8Sse2(const uint8_pixel_t *t, const uint8_pixel_t *m, const uint8_pixel_t *b,
+                                      int16_pixel_t *mag, uint8_pixel_t *dir, int32_t x, const int32_t x1,
+                                      const eMagnitude norm)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    // Pixel x + 8 is read as well
+    for (; (x + 8) <= x1; x += 8)
+    {
+        const __m128i t0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(t + x - 1)), zero);
+        const __m128i t1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(t + x)), zero);
+        const __m128i t2 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(t + x + 1)), zero);
+        const __m128i m0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(m + x - 1)), zero);
+        const __m128i m2 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(m + x + 1)), zero);
+        const __m128i b0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(b + x - 1)), zero);
+        const __m128i b1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(b + x)), zero);
+        const __m128i b2 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(b + x + 1)), zero);
+
+        // Right column minus left column, bottom row minus top row
+        const __m128i gx = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(t2, b2), _mm_slli_epi16(m2, 1)),
+                                         _mm_add_epi16(_mm_add_epi16(t0, b0), _mm_slli_epi16(m0, 1)));
+        const __m128i gy = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(b0, b2), _mm_slli_epi16(b1, 1)),
+                                         _mm_add_epi16(_mm_add_epi16(t0, t2), _mm_slli_epi16(t1, 1)));
+
+        const __m128i ax = _mm_max_epi16(gx, _mm_sub_epi16(zero, gx));
+        const __m128i ay = _mm_max_epi16(gy, _mm_sub_epi16(zero, gy));
+        const __m128i hi = _mm_max_epi16(ax, ay);
+        const __m128i lo = _mm_min_epi16(ax, ay);
+
+        // The magnitude
+        if (norm == MAGNITUDE_L1)
+        {
+            _mm_storeu_si128((__m128i *)(mag + x), _mm_add_epi16(ax, ay));
+        }
+        else if (norm == MAGNITUDE_L2)
+        {
+            const __m128 x0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(ax, zero));
+            const __m128 x4 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(ax, zero));
+            const __m128 y0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(ay, zero));
+            const __m128 y4 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(ay, zero));
+            const __m128 half = _mm_set1_ps(0.5f);
+
+            const __m128i l0 = _mm_cvttps_epi32(_mm_add_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x0, x0), _mm_mul_ps(y0, y0))), half));
+            const __m128i l4 = _mm_cvttps_epi32(_mm_add_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x4, x4), _mm_mul_ps(y4, y4))), half));
+
+            _mm_storeu_si128((__m128i *)(mag + x), _mm_packs_epi32(l0, l4));
+        }
+        else
+        {
+            // 123 hi + 51 lo as pairwise products
+            const __m128i w = _mm_set1_epi32((51 << 16) | 123);
+            const __m128i round = _mm_set1_epi32(64);
+
+            const __m128i a0 = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(hi, lo), w), round), 7);
+            const __m128i a4 = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(hi, lo), w), round), 7);
+
+            _mm_storeu_si128((__m128i *)(mag + x), _mm_packs_epi32(a0, a4));
+        }
+
+        if (dir == NULL)
+        {
+            continue;
+        }
+
+        // Index of the arctangent table, a zero gradient gives a zero ratio
+        const __m128 steps = _mm_set1_ps((float)SOBEL_ATAN_STEPS);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128i d = _mm_max_epi16(hi, _mm_set1_epi16(1));
+
+        const __m128i i0 = _mm_cvttps_epi32(_mm_add_ps(_mm_div_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), steps),
+                                                                  _mm_cvtepi32_ps(_mm_unpacklo_epi16(d, zero))), half));
+        const __m128i i4 = _mm_cvttps_epi32(_mm_add_ps(_mm_div_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), steps),
+                                                                  _mm_cvtepi32_ps(_mm_unpackhi_epi16(d, zero))), half));
+
+        int16_t idx[8];
+        _mm_storeu_si128((__m128i *)idx, _mm_packs_epi32(i0, i4));
+
+        __m128i a = _mm_setr_epi16(sobel_atan_lut[idx[0]], sobel_atan_lut[idx[1]], sobel_atan_lut[idx[2]], sobel_atan_lut[idx[3]],
+                                   sobel_atan_lut[idx[4]], sobel_atan_lut[idx[5]], sobel_atan_lut[idx[6]], sobel_atan_lut[idx[7]]);
+
+        // Select the octant
+        const __m128i steep = _mm_cmpgt_epi16(ay, ax);
+        const __m128i left = _mm_cmplt_epi16(gx, zero);
+        const __m128i up = _mm_cmplt_epi16(gy, zero);
+
+        a = _mm_or_si128(_mm_and_si128(steep, _mm_sub_epi16(_mm_set1_epi16(64), a)), _mm_andnot_si128(steep, a));
+        a = _mm_or_si128(_mm_and_si128(left, _mm_sub_epi16(_mm_set1_epi16(128), a)), _mm_andnot_si128(left, a));
+        a = _mm_or_si128(_mm_and_si128(up, _mm_sub_epi16(_mm_set1_epi16(256), a)), _mm_andnot_si128(up, a));
+
+        a = _mm_and_si128(a, _mm_set1_epi16(255));
+
+        _mm_storel_epi64((__m128i *)(dir + x), _mm_packus_epi16(a, zero));
+    }
+
+    return x;
+}
+#endif
+
+/*!
+ * \brief Fused Sobel kernel, shared by sobel(), sobelFast() and sobelFused()
+ *
+ * Both gradients are calculated in a single pass from a sliding window of
+ * three source rows, no temporary images are needed. The interior is
+ * processed without bounds checks. The border pixels are either calculated
+ * with pixels outside the image being 0, or set to 0.
+ *
+ * Only sobelFused() passes ::IMGTYPE_UINT8 source images, so the SSE2 path can
+ * assume the direction image to be of type ::IMGTYPE_UINT8 as well.
+ *
+ * \param[in]  src    A pointer to the source image
+ * \param[out] mag    A pointer to the magnitude image
+ * \param[out] dir    A pointer to the direction image, or NULL
+ * \param[in]  norm   The norm, must be of type ::eMagnitude
+ * \param[in]  border 1 to calculate the border pixels, 0 to set them to 0
+ */
+static void sobelKernel(const image_t *src, image_t *mag, image_t *dir, const eMagnitude norm, const int32_t border)
+{
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+    const int32_t stride = IMAGE_STRIDE(src);
+
+    for (int32_t y = 0; y < rows; y++)
     {
-        for (int32_t y = 0; y < src->rows; y++)
+        int16_pixel_t *m = (int16_pixel_t *)mag->data + (y * IMAGE_STRIDE(mag));
+        const int32_t interior = (y > 0) && (y < (rows - 1)) && (cols > 2);
+
+        // Border pixels of this row
+        for (int32_t x = 0; x < cols; x = (interior && (x == 0)) ? (cols - 1) : (x + 1))
         {
-            for (int32_t x = 0; x < src->cols; x++)
+            int32_t gx = 0;
+            int32_t gy = 0;
+
+            if (border)
             {
-                // Msobel = |Gh| + |Gv|
-                int16_pixel_t m = abs(getInt16Pixel(gh, x, y)) +
-                                  abs(getInt16Pixel(gv, x, y));
-                setInt16Pixel(mag, x, y, m);
+                sobelBorderGradient(src, x, y, &gx, &gy);
             }
+
+            sobelStore(m, dir, x, y, gx, gy, norm);
+        }
+
+        if (!interior)
+        {
+            continue;
+        }
+
+        if (src->type == IMGTYPE_UINT8)
+        {
+            const uint8_pixel_t *s = (const uint8_pixel_t *)src->data + (y * stride);
+            int32_t x = 1;
+
+#if defined(USE_SSE2)
+            uint8_pixel_t *d = (dir == NULL) ? NULL : ((uint8_pixel_t *)dir->data + (y * IMAGE_STRIDE(dir)));
+
+            x = sobelInteriorUint8Sse2(s - stride, s, s + stride, m, d, x, cols - 1, norm);
+#endif
+            sobelInteriorUint8(s - stride, s, s + stride, m, dir, y, x, cols - 1, norm);
+        }
+        else
+        {
+            const int16_pixel_t *s = (const int16_pixel_t *)src->data + (y * stride);
+
+            sobelInteriorInt16(s - stride, s, s + stride, m, dir, y, 1, cols - 1, norm);
         }
     }
-    else
+}
+
+/*!
+ * \brief Sobel edge detection algorithm that produces the magnitude and
+ *        direction of an edge in grayscale images
+ *
+ * The horizontal and vertical gradients are calculated in a single pass from a
+ * sliding window of three rows, and are immediately used to calculate the
+ * Sobel magnitude and direction for each pixel. Pixels outside the image are
+ * 0.
+ *
+ * \param[in]  src A pointer to the source image
+ * \param[out] mag A pointer to the Sobel magnitude destination image
+ * \param[out] dir A pointer to the Sobel direction destination image.
+ *                 If this is a NULL pointer, the Sobel direction is
+ *                 not calculated.
+ */
+void sobel(const image_t *src, image_t *mag, image_t *dir)
+{
+    TRACE_ENTER(src, mag);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(mag == NULL, "mag image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(mag->data == NULL, "mag data is invalid");
+    ASSERT(src->type != IMGTYPE_INT16, "src type is invalid");
+    ASSERT(mag->type != IMGTYPE_INT16, "mag type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != mag->cols, "src and mag have different number of columns");
+    ASSERT(src->rows != mag->rows, "src and mag have different number of rows");
+    ASSERT(src == mag, "src and dst are the same images");
+
+    if (dir != NULL)
     {
-        ASSERT(dir == NULL, "dir image is invalid");
         ASSERT(dir->data == NULL, "dir data is invalid");
         ASSERT(dir->type != IMGTYPE_FLOAT, "dir type is invalid");
 
         // Verify image consistency
         ASSERT(dir->cols != mag->cols, "dir and mag have different number of columns");
-
-        for (int32_t y = 0; y < src->rows; y++)
-        {
-            for (int32_t x = 0; x < src->cols; x++)
-            {
-                // Msobel = |Gh| + |Gv|
-                int16_pixel_t m = abs(getInt16Pixel(gh, x, y)) +
-                                  abs(getInt16Pixel(gv, x, y));
-                setInt16Pixel(mag, x, y, m);
-
-                // PHIsobel = tan-1(Gv/Gh)
-                float_pixel_t phi = atanf(((float)getInt16Pixel(gv, x, y)) /
-                                          (float)getInt16Pixel(gh, x, y));
-                setFloatPixel(dir, x, y, phi);
-            }
-        }
+        ASSERT(dir->rows != mag->rows, "dir and mag have different number of rows");
     }
 
-    // Cleanup temporary images
-    deleteInt16Image(gh);
-    deleteInt16Image(gv);
+    sobelKernel(src, mag, dir, MAGNITUDE_L1, 1);
+
+    TRACE_EXIT();
 }
 
 /*!
  * \brief Sobel edge detection algorithm that produces the magnitude of an edge
  *        in grayscale images
  *
- * The function first creates an horizontal and vertical enhanced image.
- * These enhanced images are used to calculate the Sobel magnitude for each
- * pixel. The function skips the borders to enhance performance.
+ * The horizontal and vertical gradients are calculated in a single pass from a
+ * sliding window of three rows. The function skips the borders to enhance
+ * performance, the magnitude of the border pixels is 0.
  *
  * \param[in]  src A pointer to the source image
  * \param[out] mag A pointer to the Sobel magnitude destination image
  */
 void sobelFast(const image_t *src, image_t *mag)
 {
-    // computes horizontal gradient
-    int16_pixel_t gh_msk_data[3 * 3] =
-        {
-            -1,
-            -2,
-            -1,
-            0,
-            0,
-            0,
-            1,
-            2,
-            1,
-        };
-
-    // computes vertical gradient
-    int16_pixel_t gv_msk_data[3 * 3] =
-        {
-            -1,
-            0,
-            1,
-            -2,
-            0,
-            2,
-            -1,
-            0,
-            1,
-        };
+    TRACE_ENTER(src, mag);
 
-    image_t msk =
-        {
-            .cols = 3,
-            .rows = 3,
-            .type = IMGTYPE_INT16,
-            .data = NULL,
-        };
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(mag == NULL, "mag image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(mag->data == NULL, "mag data is invalid");
+    ASSERT(src->type != IMGTYPE_INT16, "src type is invalid");
+    ASSERT(mag->type != IMGTYPE_INT16, "mag type is invalid");
 
-    // Create temporary images and verify memory allocation
-    image_t *gh = newInt16Image(src->cols, src->rows);
-    if (gh == NULL)
-    {
-        // No memory allocated
-        return;
-    }
+    // Verify image consistency
+    ASSERT(src->cols != mag->cols, "src and mag have different number of columns");
+    ASSERT(src->rows != mag->rows, "src and mag have different number of rows");
+    ASSERT(src == mag, "src and dst are the same images");
 
-    image_t *gv = newInt16Image(src->cols, src->rows);
+    sobelKernel(src, mag, NULL, MAGNITUDE_L1, 0);
 
-    if (gv == NULL)
-    {
-        // No memory allocated
-        deleteInt16Image(gh);
-        return;
-    }
+    TRACE_EXIT();
+}
 
-    clearInt16Image(gh);
-    clearInt16Image(gv);
+/*!
+ * \brief Sobel edge detection with a selectable norm and a quantised direction
+ *
+ * Same single pass as sobel(), but the source image can also be of type
+ * ::IMGTYPE_UINT8. For such images the gradients are calculated 8 pixels at
+ * once with SSE2 if available.
+ *
+ * The direction is the direction of the gradient, quantised to 256 binary
+ * angles per full circle: 0 points to the right, 64 down, 128 to the left and
+ * 192 up. It is looked up in an arctangent table, no floating-point
+ * trigonometry is used. The direction of a zero gradient is 0.
+ *
+ * \param[in]  src  A pointer to the source image
+ * \param[out] mag  A pointer to the ::IMGTYPE_INT16 magnitude image
+ * \param[out] dir  A pointer to the ::IMGTYPE_UINT8 direction image. If this is
+ *                  a NULL pointer, the direction is not calculated.
+ * \param[in]  norm The norm used for the magnitude, must be of type
+ *                  ::eMagnitude
+ */
+void sobelFused(const image_t *src, image_t *mag, image_t *dir, const eMagnitude norm)
+{
+    TRACE_ENTER(src, mag);
 
-    msk.data = (uint8_t *)gh_msk_data;
-    convolveFast(src, gh, &msk);
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(mag == NULL, "mag image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(mag->data == NULL, "mag data is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_INT16), "src type is invalid");
+    ASSERT(mag->type != IMGTYPE_INT16, "mag type is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
 
-    msk.data = (uint8_t *)gv_msk_data;
-    convolveFast(src, gv, &msk);
+    // Verify image consistency
+    ASSERT(src->cols != mag->cols, "src and mag have different number of columns");
+    ASSERT(src->rows != mag->rows, "src and mag have different number of rows");
+    ASSERT(src == mag, "src and dst are the same images");
 
-    int16_pixel_t *gh_data = (int16_pixel_t *)gh->data;
-    int16_pixel_t *gv_data = (int16_pixel_t *)gv->data;
-    int16_pixel_t *mag_data = (int16_pixel_t *)mag->data;
+    // Verify parameters
+    ASSERT((norm != MAGNITUDE_L1) && (norm != MAGNITUDE_L2) && (norm != MAGNITUDE_APPROX), "norm is invalid");
 
-    for (int32_t y = 0; y < src->rows; y++)
+    if (dir != NULL)
     {
-        for (int32_t x = 0; x < src->cols; x++)
-        {
-            // Msobel = |Gh| + |Gv|
-            int16_pixel_t m = abs(gh_data[y * src->cols + x]) +
-                              abs(gv_data[y * src->cols + x]);
-            mag_data[y * src->cols + x] = m;
-        }
+        ASSERT(dir->data == NULL, "dir data is invalid");
+        ASSERT(dir->type != IMGTYPE_UINT8, "dir type is invalid");
+
+        // Verify image consistency
+        ASSERT(dir->cols != mag->cols, "dir and mag have different number of columns");
+        ASSERT(dir->rows != mag->rows, "dir and mag have different number of rows");
     }
 
-    // Cleanup temporary images
-    deleteInt16Image(gh);
-    deleteInt16Image(gv);
+    sobelKernel(src, mag, dir, norm, 1);
+
+    TRACE_EXIT();
 }
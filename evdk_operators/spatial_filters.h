@@ -50,6 +50,7 @@ void laplacianFilter_3x3(const image_t *src, image_t *dst);
 void laplacianFilter_5x5(const image_t *src, image_t *dst);
 void sobel(const image_t *src, image_t *mag, image_t *dir);
 void sobelFast(const image_t *src, image_t *mag);
+void sobelFused(const image_t *src, image_t *mag, image_t *dir, const eMagnitude norm);
 
 #endif // _SPATIAL_FILTERS_H_
 
@@ -35,4 +35,410 @@
  *****************************************************************************/
 #include "image_fundamentals.h"
 #include "spatial_frequency_filters.h"
+#include "transforms.h"
+#include "trace.h"
+
+#include <math.h>
+
+// Function prototypes
+static int32_t wrapFrequency(int32_t f, const int32_t n);
+static float lowpassResponse(const frequency_params_t *params, const float d2, const float d0);
+static float bandrejectResponse(const frequency_params_t *params, const float d2);
+
+/*!
+ * \brief Returns the size of the buffer for the transfer function of a
+ *        frequency domain filter
+ *
+ * \param[in] cols Number of columns of the filtered images
+ * \param[in] rows Number of rows of the filtered images
+ *
+ * \return The size in bytes
+ */
+size_t frequencyFilterBufferSize(const int32_t cols, const int32_t rows)
+{
+    // Verify parameters
+    ASSERT((cols <= 0) || (rows <= 0), "size is invalid");
+
+    return (size_t)((cols / 2) + 1) * rows * sizeof(float_pixel_t);
+}
+
+/*!
+ * \brief Calculates the transfer function of a frequency domain filter
+ *
+ * The transfer function H(u,v) is real and symmetric, H(u,v) = H(-u,-v), so
+ * it does not shift the phase of the image and only the columns that
+ * fft2dReal() calculates are stored. With the distance D = D(u,v) to the DC
+ * component, the low-pass filters are
+ *
+ *     ideal:       H = 1 if D <= D0, else 0
+ *     Butterworth: H = 1 / (1 + (D / D0)^(2n))
+ *     Gaussian:    H = exp(-D^2 / (2 D0^2))
+ *
+ * The band-reject filters remove a ring with center C0 and width W
+ *
+ *     ideal:       H = 0 if C0 - W/2 <= D <= C0 + W/2, else 1
+ *     Butterworth: H = 1 / (1 + (D W / (D^2 - C0^2))^(2n))
+ *     Gaussian:    H = 1 - exp(-((D^2 - C0^2) / (D W))^2)
+ *
+ * A high-pass or band-pass filter is 1 minus the corresponding low-pass or
+ * band-reject filter. A notch filter is the product of high-pass filters with
+ * cutoff D0 that are centered on each notch and its mirror image, so it
+ * removes periodic noise that shows up as pairs of peaks in the spectrum. The
+ * distance to a notch wraps around, as the spectrum is periodic.
+ *
+ * The transfer function only depends on the image size and the parameters,
+ * so it is calculated once and applied to every frame by frequencyFilter().
+ * A filter bank is a set of filters, each with its own buffer.
+ *
+ * \code
+ * frequency_params_t params = {0};
+ * params.shape = FREQUENCY_GAUSSIAN;
+ * params.band = FREQUENCY_NOTCH;
+ * params.cutoff = 3.0f;
+ * params.notches = 1;
+ * params.notch[0] = (point_t){16, 0};
+ *
+ * frequency_filter_t filter;
+ * void *buf = allocImageArena(frequencyFilterBufferSize(cols, rows));
+ * initFrequencyFilter(&filter, buf, cols, rows, &params);
+ *
+ * frequencyFilter(src, dst, &filter);
+ * \endcode
+ *
+ * \param[out] filter A pointer to the filter
+ * \param[in]  buffer A pointer to a buffer of at least
+ *                    frequencyFilterBufferSize() bytes for the transfer
+ *                    function
+ * \param[in]  cols   Number of columns of the filtered images
+ * \param[in]  rows   Number of rows of the filtered images
+ * \param[in]  params A pointer to the parameters of the filter
+ */
+void initFrequencyFilter(frequency_filter_t *filter, void *buffer,
+                         const int32_t cols, const int32_t rows,
+                         const frequency_params_t *params)
+{
+    // Verify parameters
+    ASSERT(filter == NULL, "filter is invalid");
+    ASSERT(buffer == NULL, "buffer is invalid");
+    ASSERT(params == NULL, "params is invalid");
+    ASSERT((cols <= 0) || (rows <= 0), "size is invalid");
+    ASSERT((params->shape != FREQUENCY_IDEAL) && (params->shape != FREQUENCY_BUTTERWORTH) &&
+           (params->shape != FREQUENCY_GAUSSIAN), "shape is invalid");
+    ASSERT((params->band < FREQUENCY_LOWPASS) || (params->band > FREQUENCY_NOTCH), "band is invalid");
+    ASSERT(params->cutoff <= 0.0f, "cutoff must be positive");
+    ASSERT(((params->band == FREQUENCY_BANDPASS) || (params->band == FREQUENCY_BANDREJECT)) &&
+           (params->width <= 0.0f), "width must be positive");
+    ASSERT((params->shape == FREQUENCY_BUTTERWORTH) && (params->order < 1), "order must be at least 1");
+    ASSERT((params->band == FREQUENCY_NOTCH) &&
+           ((params->notches < 1) || (params->notches > FREQUENCY_MAX_NOTCHES)), "notches is invalid");
+
+    filter->cols = cols;
+    filter->rows = rows;
+    filter->transfer.cols = (cols / 2) + 1;
+    filter->transfer.rows = rows;
+    filter->transfer.type = IMGTYPE_FLOAT;
+    filter->transfer.data = (uint8_t *)buffer;
+    filter->transfer.stride = 0;
+    filter->transfer.step = 0;
+
+    float_pixel_t *h = (float_pixel_t *)buffer;
+
+    for (int32_t y = 0; y < rows; y++)
+    {
+        // Row y holds the negative frequencies in its upper half
+        const int32_t v = wrapFrequency(y, rows);
+
+        for (int32_t u = 0; u < filter->transfer.cols; u++)
+        {
+            const float d2 = (float)((u * u) + (v * v));
+            float value = 1.0f;
+
+            switch (params->band)
+            {
+            case FREQUENCY_LOWPASS:
+                value = lowpassResponse(params, d2, params->cutoff);
+                break;
+            case FREQUENCY_HIGHPASS:
+                value = 1.0f - lowpassResponse(params, d2, params->cutoff);
+                break;
+            case FREQUENCY_BANDPASS:
+                value = 1.0f - bandrejectResponse(params, d2);
+                break;
+            case FREQUENCY_BANDREJECT:
+                value = bandrejectResponse(params, d2);
+                break;
+            case FREQUENCY_NOTCH:
+                for (int32_t k = 0; k < params->notches; k++)
+                {
+                    // Distance to the notch and to its mirror image
+                    const int32_t du0 = wrapFrequency(u - params->notch[k].x, cols);
+                    const int32_t dv0 = wrapFrequency(v - params->notch[k].y, rows);
+                    const int32_t du1 = wrapFrequency(u + params->notch[k].x, cols);
+                    const int32_t dv1 = wrapFrequency(v + params->notch[k].y, rows);
+
+                    value *= 1.0f - lowpassResponse(params, (float)((du0 * du0) + (dv0 * dv0)), params->cutoff);
+                    value *= 1.0f - lowpassResponse(params, (float)((du1 * du1) + (dv1 * dv1)), params->cutoff);
+                }
+                break;
+            }
+
+            h[(y * filter->transfer.cols) + u] = value;
+        }
+    }
+}
+
+/*!
+ * \brief Filters an image in the frequency domain
+ *
+ * The image is transformed with fft2dReal(), every frequency is multiplied by
+ * the transfer function of the filter and the result is transformed back with
+ * ifft2dReal(). The cost does not depend on the size of the transfer
+ * function, so for large smoothing kernels or periodic noise removal this is
+ * much cheaper than a spatial convolution. The image is treated as periodic,
+ * so the left and right and the top and bottom borders influence each other.
+ *
+ * An ::IMGTYPE_UINT8 destination image receives the result rounded and
+ * clipped to 0 - 255. Use an ::IMGTYPE_FLOAT destination image to keep the
+ * negative values of a high-pass or band-pass filter.
+ *
+ * The source image can be a luma view, see lumaView().
+ *
+ * The image arena must hold the spectrum and the temporary image of
+ * ifft2dReal(), both (cols / 2 + 1) * rows complex pixels, and a float copy
+ * of the image if either image is of type ::IMGTYPE_UINT8.
+ *
+ * \param[in]  src    A pointer to the ::IMGTYPE_UINT8 or ::IMGTYPE_FLOAT
+ *                    source image
+ * \param[out] dst    A pointer to the ::IMGTYPE_UINT8 or ::IMGTYPE_FLOAT
+ *                    destination image. May be the same image as the source
+ *                    image.
+ * \param[in]  filter A pointer to a filter initialized by
+ *                    initFrequencyFilter() for the size of the images
+ */
+void frequencyFilter(const image_t *src, image_t *dst,
+                     const frequency_filter_t *filter)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(filter == NULL, "filter is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT((src->type != IMGTYPE_UINT8) && (src->type != IMGTYPE_FLOAT), "src type is invalid");
+    ASSERT((dst->type != IMGTYPE_UINT8) && (dst->type != IMGTYPE_FLOAT), "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+    ASSERT((src->cols != filter->cols) || (src->rows != filter->rows), "filter was initialized for a different size");
+
+    const int32_t cols = src->cols;
+    const int32_t rows = src->rows;
+
+    image_arena_mark_t mark = markImageArena();
+
+    image_t spec = filter->transfer;
+    spec.type = IMGTYPE_COMPLEX;
+    spec.data = (uint8_t *)allocImageArena((size_t)spec.cols * rows * sizeof(complex_pixel_t));
+
+    // Float copy for the uint8 images
+    image_t tmp = {cols, rows, IMGTYPE_FLOAT, NULL, 0, 0};
+
+    if ((src->type == IMGTYPE_UINT8) || (dst->type == IMGTYPE_UINT8))
+    {
+        tmp.data = (uint8_t *)allocImageArena((size_t)cols * rows * sizeof(float_pixel_t));
+
+        if (tmp.data == NULL)
+        {
+            spec.data = NULL;
+        }
+    }
+
+    if (spec.data == NULL)
+    {
+        ASSERT(1 == 1, "Unable to allocate memory for the spectrum, increase the size of the image arena");
+        releaseImageArena(mark);
+        TRACE_EXIT();
+        return;
+    }
+
+    const image_t *fsrc = src;
+
+    if (src->type == IMGTYPE_UINT8)
+    {
+        const int32_t stride = IMAGE_STRIDE(src);
+        const int32_t step = IMAGE_STEP(src);
+
+        for (int32_t y = 0; y < rows; y++)
+        {
+            const uint8_pixel_t *s = (uint8_pixel_t *)src->data + (y * stride);
+            float_pixel_t *t = (float_pixel_t *)tmp.data + (y * cols);
+
+            for (int32_t x = 0; x < cols; x++)
+            {
+                t[x] = (float_pixel_t)s[x * step];
+            }
+        }
+
+        fsrc = &tmp;
+    }
+
+    fft2dReal(fsrc, &spec);
+
+    // Apply the transfer function
+    const float_pixel_t *h = (float_pixel_t *)filter->transfer.data;
+    complex_pixel_t *f = (complex_pixel_t *)spec.data;
+    const int32_t n = spec.cols * rows;
+
+    for (int32_t i = 0; i < n; i++)
+    {
+        f[i].real *= h[i];
+        f[i].imaginary *= h[i];
+    }
+
+    if (dst->type == IMGTYPE_FLOAT)
+    {
+        ifft2dReal(&spec, dst);
+    }
+    else
+    {
+        ifft2dReal(&spec, &tmp);
+
+        const int32_t stride = IMAGE_STRIDE(dst);
+        const int32_t step = IMAGE_STEP(dst);
+
+        for (int32_t y = 0; y < rows; y++)
+        {
+            const float_pixel_t *t = (float_pixel_t *)tmp.data + (y * cols);
+            uint8_pixel_t *d = (uint8_pixel_t *)dst->data + (y * stride);
+
+            for (int32_t x = 0; x < cols; x++)
+            {
+                const float v = t[x] + 0.5f;
+                d[x * step] = (v <= 0.0f) ? 0 : ((v >= 255.0f) ? 255 : (uint8_pixel_t)v);
+            }
+        }
+    }
+
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+/*!
+ * \brief Maps an index of a spectrum to a signed frequency
+ *
+ * \param[in] f The index or frequency
+ * \param[in] n The length of the spectrum
+ *
+ * \return The frequency in the range -n/2 to n/2
+ */
+static int32_t wrapFrequency(int32_t f, const int32_t n)
+{
+    f %= n;
+
+    if (f > (n / 2))
+    {
+        f -= n;
+    }
+    else if (f < -(n / 2))
+    {
+        f += n;
+    }
+
+    return f;
+}
+
+/*!
+ * \brief Returns the transfer function of a low-pass filter
+ *
+ * \param[in] params A pointer to the parameters of the filter
+ * \param[in] d2     The squared distance D^2
+ * \param[in] d0     The cutoff frequency D0
+ *
+ * \return H(D)
+ */
+static float lowpassResponse(const frequency_params_t *params, const float d2, const float d0)
+{
+    const float r = d2 / (d0 * d0);
+
+    switch (params->shape)
+    {
+    case FREQUENCY_IDEAL:
+        return (r <= 1.0f) ? 1.0f : 0.0f;
+
+    case FREQUENCY_BUTTERWORTH:
+    {
+        // (D / D0)^(2n) = (D^2 / D0^2)^n
+        float p = 1.0f;
+
+        for (int32_t i = 0; i < params->order; i++)
+        {
+            p *= r;
+        }
+
+        return 1.0f / (1.0f + p);
+    }
+
+    case FREQUENCY_GAUSSIAN:
+        return expf(-0.5f * r);
+    }
+
+    return 1.0f;
+}
+
+/*!
+ * \brief Returns the transfer function of a band-reject filter
+ *
+ * \param[in] params A pointer to the parameters of the filter
+ * \param[in] d2     The squared distance D^2
+ *
+ * \return H(D)
+ */
+static float bandrejectResponse(const frequency_params_t *params, const float d2)
+{
+    const float c2 = params->cutoff * params->cutoff;
+    const float w2 = params->width * params->width;
+    const float e = d2 - c2;
+
+    switch (params->shape)
+    {
+    case FREQUENCY_IDEAL:
+        return (fabsf(sqrtf(d2) - params->cutoff) <= (0.5f * params->width)) ? 0.0f : 1.0f;
+
+    case FREQUENCY_BUTTERWORTH:
+    {
+        if (e == 0.0f)
+        {
+            return 0.0f;
+        }
+
+        // (D W / (D^2 - C0^2))^(2n)
+        const float r = (d2 * w2) / (e * e);
+        float p = 1.0f;
+
+        for (int32_t i = 0; i < params->order; i++)
+        {
+            p *= r;
+        }
+
+        return 1.0f / (1.0f + p);
+    }
+
+    case FREQUENCY_GAUSSIAN:
+        if (d2 == 0.0f)
+        {
+            return 1.0f;
+        }
+
+        return 1.0f - expf(-(e * e) / (d2 * w2));
+    }
+
+    return 1.0f;
+}
 
@@ -41,8 +41,76 @@ extern "C" {
 
 #include "image.h"
 
+/// Maximum number of notch pairs in a notch filter
+#define FREQUENCY_MAX_NOTCHES (8)
+
+/// Defines the shape of the transfer function of a frequency domain filter
+typedef enum
+{
+    FREQUENCY_IDEAL = 0,     ///< Abrupt transition, causes ringing
+    FREQUENCY_BUTTERWORTH,   ///< Smooth transition, steepness set by the order
+    FREQUENCY_GAUSSIAN,      ///< Smooth transition without ringing
+
+}eFrequencyShape;
+
+/// Defines which frequencies a frequency domain filter passes
+typedef enum
+{
+    FREQUENCY_LOWPASS = 0,   ///< Frequencies below the cutoff
+    FREQUENCY_HIGHPASS,      ///< Frequencies above the cutoff
+    FREQUENCY_BANDPASS,      ///< Frequencies in a ring around the cutoff
+    FREQUENCY_BANDREJECT,    ///< All but the frequencies in a ring around the
+                             ///< cutoff
+    FREQUENCY_NOTCH,         ///< All but the frequencies around the notches
+
+}eFrequencyBand;
+
+/*!
+ * \brief Defines the parameters of a frequency domain filter
+ *
+ * Frequencies are expressed in cycles per image, so frequency (u,v) has u
+ * periods along the width and v periods along the height of the image. The
+ * distance D(u,v) is measured from the DC component at (0,0).
+ */
+typedef struct
+{
+    eFrequencyShape shape;  ///< Shape of the transfer function
+    eFrequencyBand band;    ///< Frequencies that are passed
+    float cutoff;           ///< Cutoff frequency D0 of a low-pass or
+                            ///< high-pass filter, center C0 of the ring of a
+                            ///< band filter or radius of the notches
+    float width;            ///< Width W of the ring of a band filter
+    int32_t order;          ///< Order n of a Butterworth filter
+    int32_t notches;        ///< Number of notch pairs of a notch filter
+    point_t notch[FREQUENCY_MAX_NOTCHES]; ///< Centers (u,v) of the notches,
+                                          ///< each is paired with (-u,-v)
+
+}frequency_params_t;
+
+/*!
+ * \brief Defines a frequency domain filter for one image size
+ *
+ * The transfer function is calculated once by initFrequencyFilter() and
+ * applied to every frame by frequencyFilter().
+ */
+typedef struct
+{
+    int32_t cols;           ///< Number of columns of the filtered images
+    int32_t rows;           ///< Number of rows of the filtered images
+    image_t transfer;       ///< ::IMGTYPE_FLOAT transfer function H(u,v) with
+                            ///< cols / 2 + 1 columns and rows rows
+
+}frequency_filter_t;
+
 // Functions are documented in the source file
 
+size_t frequencyFilterBufferSize(const int32_t cols, const int32_t rows);
+void initFrequencyFilter(frequency_filter_t *filter, void *buffer,
+                         const int32_t cols, const int32_t rows,
+                         const frequency_params_t *params);
+void frequencyFilter(const image_t *src, image_t *dst,
+                     const frequency_filter_t *filter);
+
 #endif // _SPATIAL_FREQUENCY_FILTERS_H_
 
 #ifdef __cplusplus
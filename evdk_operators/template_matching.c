@@ -0,0 +1,540 @@
+/*! ***************************************************************************
+ *
+ * \brief     Template matching
+ * \file      template_matching.c
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \note      The normalization terms of every window are read from integral
+ *            images of the source image and of the squared source image, so
+ *            they cost O(1) per position. The cross-correlation of the
+ *            template and the window is calculated directly.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "image_fundamentals.h"
+#include "pyramids.h"
+#include "template_matching.h"
+#include "trace.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Sums of the pixels of a template
+typedef struct
+{
+    uint32_t n;   ///< Number of pixels
+    uint32_t sum; ///< Sum of the pixels
+    uint32_t sq;  ///< Sum of the squared pixels
+
+}template_sums_t;
+
+// Function prototypes
+static template_sums_t templateSums(const image_t *tpl);
+static float matchScore(const eMatchMethod method, const template_sums_t *t,
+                        const uint32_t sum, const uint32_t sq, const uint32_t cross);
+static float matchScoreAt(const image_t *src, const image_t *tpl,
+                          const template_sums_t *t, const eMatchMethod method,
+                          const int32_t x, const int32_t y);
+static int32_t isBetterMatch(const eMatchMethod method, const float a, const float b);
+
+/*!
+ * \brief Compares a template with every window of an image
+ *
+ * Pixel (x,y) of the destination image is the score of the template placed
+ * with its top left corner on source pixel (x,y). With S the window of the
+ * source image, T the template and n the number of template pixels:
+ *
+ *     SSD:  sum (S - T)^2 = sum S^2 - 2 sum S T + sum T^2
+ *     NCC:  sum S T / sqrt(sum S^2 * sum T^2)
+ *     ZNCC: (n sum S T - sum S sum T) /
+ *           sqrt((n sum S^2 - (sum S)^2) * (n sum T^2 - (sum T)^2))
+ *
+ * sum S and sum S^2 are read from an integralImage() and a
+ * squaredIntegralImage() of the source image, so only sum S T is calculated
+ * for every window. The template is applied row by row to complete rows of the
+ * destination image, so that inner loop is a multiply-add of two rows. All sums
+ * are exact integers, only the final division is in floating point. An NCC or
+ * ZNCC window without variation has score 0.
+ *
+ * For large search areas matchTemplateCoarseToFine() is much faster.
+ *
+ * \param[in]  src    A pointer to the ::IMGTYPE_UINT8 source image
+ * \param[in]  tpl    A pointer to the ::IMGTYPE_UINT8 template, with at most
+ *                    MATCH_MAX_TEMPLATE_PIXELS pixels
+ * \param[out] dst    A pointer to the ::IMGTYPE_FLOAT score image with
+ *                    src->cols - tpl->cols + 1 columns and
+ *                    src->rows - tpl->rows + 1 rows
+ * \param[in]  method The score, see ::eMatchMethod
+ */
+void matchTemplate(const image_t *src, const image_t *tpl, image_t *dst,
+                   const eMatchMethod method)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(tpl == NULL, "tpl image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(tpl->data == NULL, "tpl data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT(tpl->type != IMGTYPE_UINT8, "tpl type is invalid");
+    ASSERT(dst->type != IMGTYPE_FLOAT, "dst type is invalid");
+    ASSERT((method != MATCH_SSD) && (method != MATCH_NCC) && (method != MATCH_ZNCC), "method is invalid");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(tpl) != 1, "tpl image can not be a luma view");
+
+    // Verify image consistency
+    ASSERT((tpl->cols > src->cols) || (tpl->rows > src->rows), "tpl is larger than src");
+    ASSERT((tpl->cols * tpl->rows) > MATCH_MAX_TEMPLATE_PIXELS, "tpl has too many pixels");
+    ASSERT(dst->cols != (src->cols - tpl->cols + 1), "dst must have src->cols - tpl->cols + 1 columns");
+    ASSERT(dst->rows != (src->rows - tpl->rows + 1), "dst must have src->rows - tpl->rows + 1 rows");
+
+    const int32_t cols = dst->cols;
+    const int32_t src_stride = IMAGE_STRIDE(src);
+    const int32_t tpl_stride = IMAGE_STRIDE(tpl);
+    const template_sums_t t = templateSums(tpl);
+
+    image_arena_mark_t mark = markImageArena();
+
+    image_t ii = {src->cols + 1, src->rows + 1, IMGTYPE_UINT32, NULL, 0, 0};
+    image_t sq = ii;
+
+    ii.data = (uint8_t *)allocImageArena((size_t)ii.cols * ii.rows * sizeof(uint32_pixel_t));
+    sq.data = (uint8_t *)allocImageArena((size_t)sq.cols * sq.rows * sizeof(uint32_pixel_t));
+    uint32_t *acc = (uint32_t *)allocImageArena((size_t)cols * sizeof(uint32_t));
+
+    if ((ii.data == NULL) || (sq.data == NULL) || (acc == NULL))
+    {
+        ASSERT(1 == 1, "Unable to allocate memory for the integral images, increase the size of the image arena");
+        releaseImageArena(mark);
+        TRACE_EXIT();
+        return;
+    }
+
+    integralImage(src, &ii);
+    squaredIntegralImage(src, &sq);
+
+    for (int32_t y = 0; y < dst->rows; y++)
+    {
+        // Cross-correlation of the template with all windows in this row
+        memset(acc, 0, cols * sizeof(uint32_t));
+
+        for (int32_t j = 0; j < tpl->rows; j++)
+        {
+            const uint8_pixel_t *s = (uint8_pixel_t *)src->data + ((y + j) * src_stride);
+            const uint8_pixel_t *k = (uint8_pixel_t *)tpl->data + (j * tpl_stride);
+
+            for (int32_t i = 0; i < tpl->cols; i++)
+            {
+                const uint32_t w = k[i];
+                const uint8_pixel_t *p = s + i;
+
+                if (w == 0)
+                {
+                    continue;
+                }
+
+                for (int32_t x = 0; x < cols; x++)
+                {
+                    acc[x] += p[x] * w;
+                }
+            }
+        }
+
+        float *d = (float *)dst->data + (y * IMAGE_STRIDE(dst));
+
+        for (int32_t x = 0; x < cols; x++)
+        {
+            const uint32_t sum = getIntegralSum(&ii, x, y, x + tpl->cols, y + tpl->rows);
+            const uint32_t sqr = getIntegralSum(&sq, x, y, x + tpl->cols, y + tpl->rows);
+
+            d[x] = matchScore(method, &t, sum, sqr, acc[x]);
+        }
+    }
+
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Finds the best scores in a score image
+ *
+ * The best score is selected first. Every next match is the best score at
+ * least \p distance columns or rows away from all previous matches, so a
+ * single object does not yield a cluster of matches. The matches are sorted
+ * from best to worst.
+ *
+ * \param[in]  scores      A pointer to the ::IMGTYPE_FLOAT score image, see
+ *                         matchTemplate()
+ * \param[in]  method      The method that calculated the scores, which
+ *                         determines whether lower or higher is better
+ * \param[in]  distance    Minimum distance in columns or rows between two
+ *                         matches, typically the size of the template
+ * \param[out] matches     A pointer to an array of at least \p max_matches
+ *                         matches
+ * \param[in]  max_matches Maximum number of matches to find
+ *
+ * \return The number of matches found
+ */
+int32_t findBestMatches(const image_t *scores, const eMatchMethod method,
+                        const int32_t distance, match_t *matches,
+                        const int32_t max_matches)
+{
+    // Verify parameters
+    ASSERT(scores == NULL, "scores image is invalid");
+    ASSERT(scores->data == NULL, "scores data is invalid");
+    ASSERT(scores->type != IMGTYPE_FLOAT, "scores type is invalid");
+    ASSERT(matches == NULL, "matches is invalid");
+    ASSERT(distance < 1, "distance must be at least 1");
+    ASSERT(max_matches < 1, "max_matches must be at least 1");
+
+    int32_t n = 0;
+
+    while (n < max_matches)
+    {
+        int32_t found = 0;
+
+        for (int32_t y = 0; y < scores->rows; y++)
+        {
+            const float *s = (float *)scores->data + (y * IMAGE_STRIDE(scores));
+
+            for (int32_t x = 0; x < scores->cols; x++)
+            {
+                if ((found == 1) && (isBetterMatch(method, s[x], matches[n].score) == 0))
+                {
+                    continue;
+                }
+
+                // Skip the neighbourhood of the previous matches
+                int32_t near = 0;
+
+                for (int32_t m = 0; (m < n) && (near == 0); m++)
+                {
+                    near = (abs(x - matches[m].position.x) < distance) &&
+                           (abs(y - matches[m].position.y) < distance);
+                }
+
+                if (near == 0)
+                {
+                    matches[n].position.x = x;
+                    matches[n].position.y = y;
+                    matches[n].score = s[x];
+                    found = 1;
+                }
+            }
+        }
+
+        if (found == 0)
+        {
+            break;
+        }
+
+        n++;
+    }
+
+    return n;
+}
+
+/*!
+ * \brief Finds a template with a coarse-to-fine search
+ *
+ * Gaussian pyramids of \p levels levels are built of the image and the
+ * template, see gaussianPyramid(). The complete coarsest level is searched
+ * with matchTemplate() and findBestMatches(). Every match is then refined on
+ * each finer level, by scoring only the 5x5 positions around twice its
+ * position on the coarser level. With 3 levels this evaluates the template on
+ * 1/16 of the positions, each with 1/16 of the pixels, plus a fixed number of
+ * positions per match at the finer levels.
+ *
+ * The coarsest template must keep enough detail to be found, so it must have
+ * at least 4 columns and rows. A match that is not among the best
+ * \p max_matches on the coarsest level is not found.
+ *
+ * The image arena must hold the two pyramids and the score image of the
+ * coarsest level.
+ *
+ * \param[in]  src         A pointer to the ::IMGTYPE_UINT8 source image
+ * \param[in]  tpl         A pointer to the ::IMGTYPE_UINT8 template
+ * \param[in]  method      The score, see ::eMatchMethod
+ * \param[in]  levels      Number of pyramid levels, 1 is an exhaustive search
+ * \param[out] matches     A pointer to an array of at least \p max_matches
+ *                         matches, with the scores and positions on the
+ *                         source image
+ * \param[in]  max_matches Maximum number of matches to find
+ *
+ * \return The number of matches found
+ */
+int32_t matchTemplateCoarseToFine(const image_t *src, const image_t *tpl,
+                                  const eMatchMethod method,
+                                  const int32_t levels, match_t *matches,
+                                  const int32_t max_matches)
+{
+    TRACE_ENTER(src, tpl);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(tpl == NULL, "tpl image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(tpl->data == NULL, "tpl data is invalid");
+    ASSERT(src->type != IMGTYPE_UINT8, "src type is invalid");
+    ASSERT(tpl->type != IMGTYPE_UINT8, "tpl type is invalid");
+    ASSERT(matches == NULL, "matches is invalid");
+    ASSERT((levels < 1) || (levels > PYRAMID_MAX_LEVELS), "levels is invalid");
+    ASSERT(max_matches < 1, "max_matches must be at least 1");
+    ASSERT(IMAGE_STEP(src) != 1, "src image can not be a luma view");
+    ASSERT(IMAGE_STEP(tpl) != 1, "tpl image can not be a luma view");
+
+    // Verify image consistency
+    ASSERT((tpl->cols > src->cols) || (tpl->rows > src->rows), "tpl is larger than src");
+    ASSERT((tpl->cols * tpl->rows) > MATCH_MAX_TEMPLATE_PIXELS, "tpl has too many pixels");
+
+    image_arena_mark_t mark = markImageArena();
+
+    pyramid_t sp;
+    pyramid_t tp;
+    void *sbuf = allocImageArena(pyramidBufferSize(src->cols, src->rows, levels, IMGTYPE_UINT8));
+    void *tbuf = allocImageArena(pyramidBufferSize(tpl->cols, tpl->rows, levels, IMGTYPE_UINT8));
+
+    if ((sbuf == NULL) || (tbuf == NULL))
+    {
+        ASSERT(1 == 1, "Unable to allocate memory for the pyramids, increase the size of the image arena");
+        releaseImageArena(mark);
+        TRACE_EXIT();
+        return 0;
+    }
+
+    initPyramid(&sp, sbuf, src->cols, src->rows, levels, IMGTYPE_UINT8);
+    initPyramid(&tp, tbuf, tpl->cols, tpl->rows, levels, IMGTYPE_UINT8);
+
+    const int32_t top = levels - 1;
+    const image_t *s = &sp.level[top];
+    const image_t *t = &tp.level[top];
+
+    ASSERT((t->cols < 4) || (t->rows < 4), "levels is too large for the size of tpl");
+
+    gaussianPyramid(src, &sp);
+    gaussianPyramid(tpl, &tp);
+
+    // Exhaustive search on the coarsest level
+    image_t scores = {s->cols - t->cols + 1, s->rows - t->rows + 1, IMGTYPE_FLOAT, NULL, 0, 0};
+    scores.data = (uint8_t *)allocImageArena((size_t)scores.cols * scores.rows * sizeof(float));
+
+    if (scores.data == NULL)
+    {
+        ASSERT(1 == 1, "Unable to allocate memory for the score image, increase the size of the image arena");
+        releaseImageArena(mark);
+        TRACE_EXIT();
+        return 0;
+    }
+
+    matchTemplate(s, t, &scores, method);
+
+    const int32_t n = findBestMatches(&scores, method, ((t->cols < t->rows) ? t->cols : t->rows) / 2,
+                                      matches, max_matches);
+
+    // Refine every match on the finer levels
+    for (int32_t l = top - 1; l >= 0; l--)
+    {
+        s = &sp.level[l];
+        t = &tp.level[l];
+
+        const template_sums_t sums = templateSums(t);
+        const int32_t xmax = s->cols - t->cols;
+        const int32_t ymax = s->rows - t->rows;
+
+        for (int32_t m = 0; m < n; m++)
+        {
+            const int32_t cx = 2 * matches[m].position.x;
+            const int32_t cy = 2 * matches[m].position.y;
+            int32_t found = 0;
+
+            for (int32_t y = cy - 2; y <= (cy + 2); y++)
+            {
+                for (int32_t x = cx - 2; x <= (cx + 2); x++)
+                {
+                    if ((x < 0) || (y < 0) || (x > xmax) || (y > ymax))
+                    {
+                        continue;
+                    }
+
+                    const float score = matchScoreAt(s, t, &sums, method, x, y);
+
+                    if ((found == 0) || isBetterMatch(method, score, matches[m].score))
+                    {
+                        matches[m].position.x = x;
+                        matches[m].position.y = y;
+                        matches[m].score = score;
+                        found = 1;
+                    }
+                }
+            }
+        }
+    }
+
+    // Sort from best to worst, the refinement can change the order
+    for (int32_t i = 1; i < n; i++)
+    {
+        const match_t key = matches[i];
+        int32_t j = i - 1;
+
+        while ((j >= 0) && isBetterMatch(method, key.score, matches[j].score))
+        {
+            matches[j + 1] = matches[j];
+            j--;
+        }
+
+        matches[j + 1] = key;
+    }
+
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
+
+    return n;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+/*!
+ * \brief Calculates the sums of the pixels of a template
+ *
+ * \param[in] tpl A pointer to the template
+ *
+ * \return The sums
+ */
+static template_sums_t templateSums(const image_t *tpl)
+{
+    template_sums_t t = {(uint32_t)(tpl->cols * tpl->rows), 0, 0};
+
+    for (int32_t j = 0; j < tpl->rows; j++)
+    {
+        const uint8_pixel_t *k = (uint8_pixel_t *)tpl->data + (j * IMAGE_STRIDE(tpl));
+
+        for (int32_t i = 0; i < tpl->cols; i++)
+        {
+            t.sum += k[i];
+            t.sq += (uint32_t)k[i] * k[i];
+        }
+    }
+
+    return t;
+}
+
+/*!
+ * \brief Calculates a score from the sums of a window
+ *
+ * \param[in] method The score, see ::eMatchMethod
+ * \param[in] t      A pointer to the sums of the template
+ * \param[in] sum    Sum of the window pixels
+ * \param[in] sq     Sum of the squared window pixels
+ * \param[in] cross  Sum of the products of the window and template pixels
+ *
+ * \return The score
+ */
+static float matchScore(const eMatchMethod method, const template_sums_t *t,
+                        const uint32_t sum, const uint32_t sq, const uint32_t cross)
+{
+    if (method == MATCH_SSD)
+    {
+        // Exact modulo 2^32, and the result fits
+        return (float)(uint32_t)(sq - (2 * cross) + t->sq);
+    }
+
+    if (method == MATCH_NCC)
+    {
+        const double den = (double)sq * (double)t->sq;
+
+        return (den > 0.0) ? (float)((double)cross / sqrt(den)) : 0.0f;
+    }
+
+    // n times the covariance and the variances, exact in 64 bits
+    const int64_t cov = ((int64_t)t->n * cross) - ((int64_t)sum * t->sum);
+    const int64_t vs = ((int64_t)t->n * sq) - ((int64_t)sum * sum);
+    const int64_t vt = ((int64_t)t->n * t->sq) - ((int64_t)t->sum * t->sum);
+
+    if ((vs <= 0) || (vt <= 0))
+    {
+        return 0.0f;
+    }
+
+    return (float)((double)cov / sqrt((double)vs * (double)vt));
+}
+
+/*!
+ * \brief Calculates the score of a single window without integral images
+ *
+ * \param[in] src    A pointer to the source image
+ * \param[in] tpl    A pointer to the template
+ * \param[in] t      A pointer to the sums of the template
+ * \param[in] method The score, see ::eMatchMethod
+ * \param[in] x      Column of the top left corner of the window
+ * \param[in] y      Row of the top left corner of the window
+ *
+ * \return The score
+ */
+static float matchScoreAt(const image_t *src, const image_t *tpl,
+                          const template_sums_t *t, const eMatchMethod method,
+                          const int32_t x, const int32_t y)
+{
+    uint32_t sum = 0;
+    uint32_t sq = 0;
+    uint32_t cross = 0;
+
+    for (int32_t j = 0; j < tpl->rows; j++)
+    {
+        const uint8_pixel_t *s = (uint8_pixel_t *)src->data + ((y + j) * IMAGE_STRIDE(src)) + x;
+        const uint8_pixel_t *k = (uint8_pixel_t *)tpl->data + (j * IMAGE_STRIDE(tpl));
+
+        for (int32_t i = 0; i < tpl->cols; i++)
+        {
+            sum += s[i];
+            sq += (uint32_t)s[i] * s[i];
+            cross += (uint32_t)s[i] * k[i];
+        }
+    }
+
+    return matchScore(method, t, sum, sq, cross);
+}
+
+/*!
+ * \brief Compares two scores
+ *
+ * \param[in] method The method that calculated the scores
+ * \param[in] a      The first score
+ * \param[in] b      The second score
+ *
+ * \return 1 if \p a is a better match than \p b, 0 otherwise
+ */
+static int32_t isBetterMatch(const eMatchMethod method, const float a, const float b)
+{
+    return (method == MATCH_SSD) ? (a < b) : (a > b);
+}
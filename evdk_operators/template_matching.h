@@ -0,0 +1,86 @@
+/*! ***************************************************************************
+ *
+ * \brief     Template matching
+ * \file      template_matching.h
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Include guard to prevent recursive inclusion
+#ifndef _TEMPLATE_MATCHING_H_
+#define _TEMPLATE_MATCHING_H_
+
+#include "image.h"
+
+/// Maximum number of pixels in a template. The sums of the products of the
+/// pixels in a window are calculated with 32-bit integers, and
+/// 66051 * 255 * 255 is the largest such sum that fits.
+#define MATCH_MAX_TEMPLATE_PIXELS (66051)
+
+/// Defines how a template is compared with a window of the source image
+typedef enum
+{
+    MATCH_SSD = 0, ///< Sum of squared differences, 0 for a perfect match,
+                   ///< lower is better
+    MATCH_NCC,     ///< Normalized cross-correlation, 1 for a perfect match,
+                   ///< invariant to a gain
+    MATCH_ZNCC,    ///< Zero-mean normalized cross-correlation, 1 for a perfect
+                   ///< match, -1 for an inverted match, invariant to a gain
+                   ///< and an offset
+
+}eMatchMethod;
+
+/// Defines a match of a template
+typedef struct
+{
+    point_t position; ///< Top left corner of the template in the source image
+    float score;      ///< The score, see ::eMatchMethod
+
+}match_t;
+
+// Functions are documented in the source file
+
+void matchTemplate(const image_t *src, const image_t *tpl, image_t *dst,
+                   const eMatchMethod method);
+int32_t findBestMatches(const image_t *scores, const eMatchMethod method,
+                        const int32_t distance, match_t *matches,
+                        const int32_t max_matches);
+int32_t matchTemplateCoarseToFine(const image_t *src, const image_t *tpl,
+                                  const eMatchMethod method,
+                                  const int32_t levels, match_t *matches,
+                                  const int32_t max_matches);
+
+#endif // _TEMPLATE_MATCHING_H_
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,396 @@
+/*! ***************************************************************************
+ *
+ * \brief     Tracing of operator calls
+ * \file      trace.c
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \note      The trace is exported in the Trace Event Format, which can be
+ *            opened with chrome://tracing or https://ui.perfetto.dev.
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+
+#if !defined(_WIN32) && !defined(MCUXPRESSO_SDK) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "trace.h"
+
+#if (EVDK_TRACE == 1)
+
+#include <stdio.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(MCUXPRESSO_SDK)
+#include <time.h>
+#endif
+
+// ----------------------------------------------------------------------------
+// Local variables
+// ----------------------------------------------------------------------------
+static uint64_t defaultClock(void);
+
+/// The state of the trace
+static struct
+{
+    trace_clock_t clock;   ///< The clock that timestamps the events
+    uint32_t ticks_per_us; ///< Number of clock ticks per microsecond
+    uint64_t origin;       ///< Timestamp of the last call to traceReset()
+    uint32_t count;        ///< Number of recorded events
+    uint32_t dropped;      ///< Number of events that did not fit
+
+}trace = {defaultClock, 1000, 0, 0, 0};
+
+/// The recorded events in order of the calls
+static trace_event_t events[TRACE_MAX_EVENTS];
+
+// ----------------------------------------------------------------------------
+// Function implementation
+// ----------------------------------------------------------------------------
+/*!
+ * \brief Default clock of the trace
+ *
+ * On the host a monotonic clock with a resolution of one nanosecond is used.
+ * The target has no default clock, so all timestamps are 0 until a clock is
+ * provided with traceSetClock().
+ *
+ * \return The timestamp in ticks
+ */
+static uint64_t defaultClock(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER freq, cnt;
+
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&cnt);
+
+    return (uint64_t)((cnt.QuadPart * 1000000000.0) / freq.QuadPart);
+#elif defined(MCUXPRESSO_SDK)
+    return 0;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/*!
+ * \brief Returns the number of bytes of pixel data in an image
+ *
+ * \param[in] img A pointer to the image, may be NULL
+ *
+ * \return The number of bytes
+ */
+static uint32_t imageBytes(const image_t *img)
+{
+    if ((img == NULL) || (img->data == NULL))
+    {
+        return 0;
+    }
+
+    // Binary images pack 8 pixels in a byte
+    if (img->type == IMGTYPE_BINARY)
+    {
+        return (uint32_t)IMAGE_STRIDE(img) * (uint32_t)img->rows / 8;
+    }
+
+    uint32_t size = 1;
+
+    switch (img->type)
+    {
+    case IMGTYPE_UINT8:  size = sizeof(uint8_pixel_t);  break;
+    case IMGTYPE_INT16:  size = sizeof(int16_pixel_t);  break;
+    case IMGTYPE_INT32:  size = sizeof(int32_pixel_t);  break;
+    case IMGTYPE_FLOAT:  size = sizeof(float_pixel_t);  break;
+    case IMGTYPE_UYVY:   size = sizeof(uyvy_pixel_t);   break;
+    case IMGTYPE_BGR888: size = sizeof(bgr888_pixel_t); break;
+    case IMGTYPE_UINT32: size = sizeof(uint32_pixel_t); break;
+    case IMGTYPE_BINARY: break;
+    case IMGTYPE_COMPLEX: size = sizeof(complex_pixel_t); break;
+    }
+
+    return (uint32_t)img->cols * (uint32_t)img->rows * size;
+}
+
+/*!
+ * \brief Copies the size and type of an image to a trace image
+ *
+ * \param[in]  img A pointer to the image, may be NULL
+ * \param[out] t   A pointer to the trace image
+ */
+static void describeImage(const image_t *img, trace_image_t *t)
+{
+    t->cols = (img == NULL) ? 0 : img->cols;
+    t->rows = (img == NULL) ? 0 : img->rows;
+    t->type = (img == NULL) ? IMGTYPE_UINT8 : img->type;
+}
+
+/*!
+ * \brief Sets the clock that timestamps the events
+ *
+ * The clock must be monotonic. On the target, for example, a free running
+ * timer or the DWT cycle counter (extended to 64 bits) can be used. The trace
+ * is reset.
+ *
+ * \param[in] clock        The clock, NULL selects the default clock
+ * \param[in] ticks_per_us The number of ticks of \p clock per microsecond
+ */
+void traceSetClock(const trace_clock_t clock, const uint32_t ticks_per_us)
+{
+    ASSERT((clock != NULL) && (ticks_per_us == 0), "ticks_per_us is invalid");
+
+    trace.clock = (clock == NULL) ? defaultClock : clock;
+    trace.ticks_per_us = (clock == NULL) ? 1000 : ticks_per_us;
+
+    traceReset();
+}
+
+/*!
+ * \brief Removes all recorded events
+ *
+ * The timestamps of the exported trace are relative to the moment of the last
+ * reset.
+ */
+void traceReset(void)
+{
+    trace.count = 0;
+    trace.dropped = 0;
+    trace.origin = trace.clock();
+}
+
+/*!
+ * \brief Records that an operator is called
+ *
+ * Usually called through TRACE_ENTER() as the first statement of an operator.
+ * An application can use it to mark a region of its own, such as the
+ * processing of a frame, by passing a name and NULL images.
+ *
+ * \param[in] name A pointer to the name of the operator. The string is not
+ *                 copied, so it must remain valid.
+ * \param[in] src  A pointer to the first image of the operator, may be NULL
+ * \param[in] dst  A pointer to the second image of the operator, may be NULL
+ *
+ * \return The id of the event that must be passed to traceExit(). -1 if the
+ *         event was dropped.
+ */
+int32_t traceEnter(const char *name, const image_t *src, const image_t *dst)
+{
+    if (trace.count >= TRACE_MAX_EVENTS)
+    {
+        trace.dropped++;
+        return -1;
+    }
+
+    trace_event_t *e = &events[trace.count];
+
+    e->name = name;
+    describeImage(src, &e->src);
+    describeImage(dst, &e->dst);
+    e->bytes = imageBytes(src) + imageBytes(dst);
+
+    // Read the clock last, so the administration is not part of the event
+    e->begin = trace.clock();
+    e->end = e->begin;
+
+    return (int32_t)trace.count++;
+}
+
+/*!
+ * \brief Records that an operator returns
+ *
+ * \param[in] id The id returned by traceEnter()
+ */
+void traceExit(const int32_t id)
+{
+    uint64_t now = trace.clock();
+
+    if ((id >= 0) && ((uint32_t)id < trace.count))
+    {
+        events[id].end = now;
+    }
+}
+
+/*!
+ * \brief Returns the number of recorded events
+ *
+ * \return The number of events
+ */
+uint32_t traceGetEventCount(void)
+{
+    return trace.count;
+}
+
+/*!
+ * \brief Returns the number of events that were dropped, because the maximum
+ *        number of events was reached
+ *
+ * \return The number of dropped events
+ */
+uint32_t traceGetDroppedCount(void)
+{
+    return trace.dropped;
+}
+
+/*!
+ * \brief Returns a recorded event
+ *
+ * \param[in] index The index of the event, events are in order of the calls
+ *
+ * \return A pointer to the event. NULL if \p index is out of range.
+ */
+const trace_event_t *traceGetEvent(const uint32_t index)
+{
+    return (index < trace.count) ? &events[index] : NULL;
+}
+
+/*!
+ * \brief Formats a timestamp in ticks as microseconds with three decimals
+ *
+ * \param[out] buf   A pointer to a buffer of at least 24 characters
+ * \param[in]  ticks The timestamp or duration in ticks
+ */
+static void formatMicroseconds(char *buf, const uint64_t ticks)
+{
+    uint64_t ns = (ticks * 1000) / trace.ticks_per_us;
+
+    sprintf(buf, "%lu.%03u", (unsigned long)(ns / 1000), (unsigned int)(ns % 1000));
+}
+
+/*!
+ * \brief Formats the size and type of an image, for example "160x120 uint8"
+ *
+ * \param[out] buf A pointer to a buffer of at least 32 characters
+ * \param[in]  t   A pointer to the trace image
+ */
+static void formatImage(char *buf, const trace_image_t *t)
+{
+    const char *type = "";
+
+    switch (t->type)
+    {
+    case IMGTYPE_UINT8:  type = "uint8";  break;
+    case IMGTYPE_INT16:  type = "int16";  break;
+    case IMGTYPE_INT32:  type = "int32";  break;
+    case IMGTYPE_FLOAT:  type = "float";  break;
+    case IMGTYPE_UYVY:   type = "uyvy";   break;
+    case IMGTYPE_BGR888: type = "bgr888"; break;
+    case IMGTYPE_UINT32: type = "uint32"; break;
+    case IMGTYPE_BINARY: type = "binary"; break;
+    case IMGTYPE_COMPLEX: type = "complex"; break;
+    }
+
+    sprintf(buf, "%ldx%ld %s", (long)t->cols, (long)t->rows, type);
+}
+
+/*!
+ * \brief Exports the recorded events as a Chrome trace
+ *
+ * Every operator call is exported as a complete event ("ph": "X"). Operators
+ * that call other operators show up as nested slices. The image sizes and the
+ * number of bytes of pixel data are added as arguments.
+ *
+ * \param[in] writer A function that receives the trace in pieces
+ * \param[in] ctx    A pointer that is passed to \p writer
+ */
+void traceWriteChrome(const trace_writer_t writer, void *ctx)
+{
+    ASSERT(writer == NULL, "writer is invalid");
+
+    char line[256];
+    char ts[24];
+    char dur[24];
+    char src[32];
+    char dst[32];
+
+    writer("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [", ctx);
+
+    for (uint32_t i = 0; i < trace.count; i++)
+    {
+        const trace_event_t *e = &events[i];
+
+        formatMicroseconds(ts, e->begin - trace.origin);
+        formatMicroseconds(dur, e->end - e->begin);
+
+        sprintf(line, "%s\n  {\"name\": \"%s\", \"cat\": \"evdk\", \"ph\": \"X\", "
+                      "\"ts\": %s, \"dur\": %s, \"pid\": 1, \"tid\": 1, "
+                      "\"args\": {\"bytes\": %lu",
+                (i == 0) ? "" : ",", e->name, ts, dur, (unsigned long)e->bytes);
+        writer(line, ctx);
+
+        if (e->src.cols != 0)
+        {
+            formatImage(src, &e->src);
+            sprintf(line, ", \"src\": \"%s\"", src);
+            writer(line, ctx);
+        }
+
+        if (e->dst.cols != 0)
+        {
+            formatImage(dst, &e->dst);
+            sprintf(line, ", \"dst\": \"%s\"", dst);
+            writer(line, ctx);
+        }
+
+        writer("}}", ctx);
+    }
+
+    writer("\n]}\n", ctx);
+}
+
+#ifndef MCUXPRESSO_SDK
+static void fileWriter(const char *str, void *ctx)
+{
+    fputs(str, (FILE *)ctx);
+}
+
+/*!
+ * \brief Saves the recorded events as a Chrome trace, see traceWriteChrome()
+ *
+ * \param[in] filename The name of the JSON file
+ *
+ * \return 0 on success. -1 if the file could not be written.
+ */
+int32_t traceSaveChrome(const char *filename)
+{
+    FILE *fp = fopen(filename, "w");
+
+    if (fp == NULL)
+    {
+        return -1;
+    }
+
+    traceWriteChrome(fileWriter, fp);
+
+    return (fclose(fp) == 0) ? 0 : -1;
+}
+#endif
+
+#endif // EVDK_TRACE
@@ -0,0 +1,139 @@
+/*! ***************************************************************************
+ *
+ * \brief     Tracing of operator calls
+ * \file      trace.h
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Include guard to prevent recursive inclusion
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include "image.h"
+
+/*!
+ * \brief Enables tracing of operator calls
+ *
+ * Set to 1, for example with the compiler definition EVDK_TRACE=1, to record
+ * every operator call. When set to 0, the TRACE_ENTER() and TRACE_EXIT()
+ * macros expand to nothing and none of the trace functions are compiled, so
+ * release builds do not pay for the instrumentation.
+ */
+#ifndef EVDK_TRACE
+#define EVDK_TRACE (0)
+#endif
+
+#if (EVDK_TRACE == 1)
+
+/*!
+ * \brief Maximum number of events that are recorded
+ *
+ * Events that do not fit are dropped and counted, see traceGetDroppedCount().
+ * The value can be overridden with a compiler definition.
+ */
+#ifndef TRACE_MAX_EVENTS
+#ifdef MCUXPRESSO_SDK
+#define TRACE_MAX_EVENTS (256)
+#else
+#define TRACE_MAX_EVENTS (65536)
+#endif
+#endif
+
+// ----------------------------------------------------------------------------
+// Type definitions
+// ----------------------------------------------------------------------------
+/// A monotonic clock that returns a timestamp in ticks
+typedef uint64_t (*trace_clock_t)(void);
+
+/// Receives the exported trace as a sequence of strings
+typedef void (*trace_writer_t)(const char *str, void *ctx);
+
+/// The size and type of an image that was passed to an operator
+typedef struct
+{
+    int32_t cols;    ///< Number of columns, 0 if there was no image
+    int32_t rows;    ///< Number of rows, 0 if there was no image
+    eImageType type; ///< The type of pixels in the image
+
+}trace_image_t;
+
+/// A single operator call
+typedef struct
+{
+    const char *name;  ///< Name of the operator
+    uint64_t begin;    ///< Timestamp in ticks at which the operator was called
+    uint64_t end;      ///< Timestamp in ticks at which the operator returned
+    trace_image_t src; ///< The first image passed to the operator
+    trace_image_t dst; ///< The second image passed to the operator
+    uint32_t bytes;    ///< Number of bytes of pixel data in both images
+
+}trace_event_t;
+
+// Functions are documented in the source file
+
+void traceSetClock(const trace_clock_t clock, const uint32_t ticks_per_us);
+void traceReset(void);
+int32_t traceEnter(const char *name, const image_t *src, const image_t *dst);
+void traceExit(const int32_t id);
+uint32_t traceGetEventCount(void);
+uint32_t traceGetDroppedCount(void);
+const trace_event_t *traceGetEvent(const uint32_t index);
+void traceWriteChrome(const trace_writer_t writer, void *ctx);
+#ifndef MCUXPRESSO_SDK
+int32_t traceSaveChrome(const char *filename);
+#endif
+
+/*!
+ * \brief Records the call of the operator in which it is placed
+ *
+ * Must be the first statement of the operator. Every return from the operator
+ * must be preceded by TRACE_EXIT().
+ */
+#define TRACE_ENTER(src, dst) \
+    const int32_t trace_id = traceEnter(__func__, (src), (dst))
+
+/// Records the return of the operator, see TRACE_ENTER()
+#define TRACE_EXIT() traceExit(trace_id)
+
+#else
+
+#define TRACE_ENTER(src, dst)
+#define TRACE_EXIT()
+
+#endif // EVDK_TRACE
+
+#endif // _TRACE_H_
+
+#ifdef __cplusplus
+}
+#endif
@@ -35,19 +35,948 @@
  *****************************************************************************/
 #include "image_fundamentals.h"
 #include "transforms.h"
+#include "trace.h"
 
 #include <math.h>
+#include <string.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-complex_pixel_t getComplexPixel(const image_t *img, const int32_t c, const int32_t r)
+/// Number of rows or columns that are transformed at once
+#define FFT_LANES (8)
+
+/// Maximum number of factors of a transform length
+#define FFT_MAX_FACTORS (20)
+
+/*!
+ * \brief Defines an FFT plan
+ *
+ * A plan holds everything of a transform length that does not depend on the
+ * data. For a real plan, the complex transform has half the real length.
+ */
+typedef struct
+{
+    int32_t n;                        ///< Length of the complex transform
+    int32_t real;                     ///< 1 for a real transform of length 2n
+    int32_t nfactors;                 ///< Number of factors
+    int32_t factors[FFT_MAX_FACTORS]; ///< Radix of every stage, first stage
+                                      ///< first
+    uint16_t *perm;                   ///< Digit-reversal permutation
+    complex_pixel_t *tw;              ///< exp(-2 pi i k / n), k = 0..n-1
+    complex_pixel_t *rtw;             ///< exp(-2 pi i k / 2n), k = 0..n, real
+                                      ///< plans only
+
+}fft_plan_t;
+
+/// Memory for the twiddles and permutations of all cached plans
+static complex_pixel_t fft_memory[FFT_PLAN_MEMORY / sizeof(complex_pixel_t)];
+
+/// Cached plans
+static fft_plan_t fft_plans[FFT_MAX_PLANS];
+
+/// Number of cached plans
+static int32_t fft_plan_count = 0;
+
+/// Number of elements of fft_memory in use
+static size_t fft_memory_used = 0;
+
+// Function prototypes
+static const fft_plan_t *fftPlan(const int32_t n, const int32_t real);
+static void fftStages(const fft_plan_t *plan, float *re, float *im, const int32_t inverse);
+static inline void fftGather(const uint8_t *s, const eImageType type, const uint16_t *perm, const int32_t n,
+                             const int32_t elem, const int32_t lane, const int32_t w, float *re, float *im);
+static inline void fftScatter(uint8_t *d, const eImageType type, const int32_t n, const int32_t elem,
+                              const int32_t lane, const int32_t w, const float scale, const float *re, const float *im);
+static int32_t fftPass(const image_t *src, image_t *dst, const int32_t columns, const int32_t inverse, const float scale);
+static int32_t fftRealRows(const image_t *src, image_t *dst, const int32_t inverse, const float scale);
+
+/*!
+ * \brief Two dimensional fast Fourier transform
+ *
+ * Calculates the discrete Fourier transform
+ *
+ *     F(u,v) = sum_y sum_x f(x,y) exp(-2 pi i (ux / cols + vy / rows))
+ *
+ * The transform is separable: all rows are transformed, followed by all
+ * columns. Every one dimensional transform is a mixed-radix decimation in time
+ * FFT with dedicated butterflies for radix 2, 3, 4 and 5 and a generic
+ * butterfly for other prime factors up to FFT_MAX_RADIX. So the size does not
+ * have to be a power of two, 160x120 for example factors as 4*4*2*5 by
+ * 2*4*3*5 (it is factored into radix 4 first).
+ *
+ * The factorization, digit-reversal permutation and twiddle factors of a
+ * length are calculated once and cached in a plan, see FFT_PLAN_MEMORY, so
+ * transforming a stream of frames of the same size does not evaluate any
+ * trigonometric function.
+ *
+ * Both passes transform FFT_LANES rows or columns at once. The lanes are
+ * gathered into a small buffer in which each butterfly operates on
+ * consecutive floats, so the column pass reads whole cache lines instead of
+ * one pixel per cache line.
+ *
+ * For real images fft2dReal() is about twice as fast.
+ *
+ * \param[in]  src A pointer to the ::IMGTYPE_FLOAT or ::IMGTYPE_COMPLEX source
+ *                 image
+ * \param[out] dst A pointer to the ::IMGTYPE_COMPLEX destination image. May
+ *                 be the same image as a complex source image.
+ */
+void fft2d(const image_t *src, image_t *dst)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT((src->type != IMGTYPE_FLOAT) && (src->type != IMGTYPE_COMPLEX), "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_COMPLEX, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    if ((fftPass(src, dst, 0, 0, 1.0f) == 0) || (fftPass(dst, dst, 1, 0, 1.0f) == 0))
+    {
+        ASSERT(1 == 1, "Unable to transform, see FFT_MAX_RADIX, FFT_PLAN_MEMORY and the size of the image arena");
+    }
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Two dimensional inverse fast Fourier transform
+ *
+ * Calculates the inverse of fft2d(), including the scale factor
+ * 1 / (cols * rows), so that ifft2d() of fft2d() returns the original image.
+ * The columns are transformed first.
+ *
+ * If the destination image is of type ::IMGTYPE_FLOAT, only the real part is
+ * stored. This requires a temporary ::IMGTYPE_COMPLEX image in the arena.
+ *
+ * \param[in]  src A pointer to the ::IMGTYPE_COMPLEX source image
+ * \param[out] dst A pointer to the ::IMGTYPE_COMPLEX or ::IMGTYPE_FLOAT
+ *                 destination image. May be the same image as the source
+ *                 image.
+ */
+void ifft2d(const image_t *src, image_t *dst)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_COMPLEX, "src type is invalid");
+    ASSERT((dst->type != IMGTYPE_COMPLEX) && (dst->type != IMGTYPE_FLOAT), "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != dst->cols, "src and dst have different number of columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    const float scale = 1.0f / ((float)src->cols * (float)src->rows);
+
+    image_arena_mark_t mark = markImageArena();
+
+    image_t tmp = *dst;
+
+    if (dst->type == IMGTYPE_FLOAT)
+    {
+        tmp.type = IMGTYPE_COMPLEX;
+        tmp.stride = 0;
+        tmp.step = 0;
+        tmp.data = (uint8_t *)allocImageArena((size_t)src->cols * src->rows * sizeof(complex_pixel_t));
+    }
+
+    if ((tmp.data == NULL) || (fftPass(src, &tmp, 1, 1, 1.0f) == 0) || (fftPass(&tmp, dst, 0, 1, scale) == 0))
+    {
+        ASSERT(1 == 1, "Unable to transform, see FFT_MAX_RADIX, FFT_PLAN_MEMORY and the size of the image arena");
+    }
+
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Two dimensional fast Fourier transform of a real image
+ *
+ * The spectrum of a real image is Hermitian, F(u,v) = conj(F(-u,-v)), so only
+ * columns 0 up to and including cols / 2 are calculated. The other columns
+ * follow from F(u,v) = conj(F(cols - u, (rows - v) % rows)).
+ *
+ * For an even number of columns, each row of cols real pixels is transformed
+ * as cols / 2 complex pixels, with the even pixels as real and the odd pixels
+ * as imaginary parts, and the spectrum of the row is separated afterwards.
+ * Together with the column pass that only transforms half of the columns,
+ * this is about twice as fast as fft2d(). Rows with an odd number of columns
+ * are transformed as complex rows.
+ *
+ * \param[in]  src A pointer to the ::IMGTYPE_FLOAT source image
+ * \param[out] dst A pointer to the ::IMGTYPE_COMPLEX destination image with
+ *                 src->cols / 2 + 1 columns and src->rows rows
+ */
+void fft2dReal(const image_t *src, image_t *dst)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_FLOAT, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_COMPLEX, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(dst->cols != ((src->cols / 2) + 1), "dst must have src->cols / 2 + 1 columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    if ((fftRealRows(src, dst, 0, 1.0f) == 0) || (fftPass(dst, dst, 1, 0, 1.0f) == 0))
+    {
+        ASSERT(1 == 1, "Unable to transform, see FFT_MAX_RADIX, FFT_PLAN_MEMORY and the size of the image arena");
+    }
+
+    TRACE_EXIT();
+}
+
+/*!
+ * \brief Two dimensional inverse fast Fourier transform to a real image
+ *
+ * Calculates the inverse of fft2dReal(), including the scale factor
+ * 1 / (cols * rows). The number of columns of the real image is taken from
+ * the destination image. The source image is not modified, the columns are
+ * transformed into a temporary image in the arena.
+ *
+ * \param[in]  src A pointer to the ::IMGTYPE_COMPLEX source image with
+ *                 dst->cols / 2 + 1 columns and dst->rows rows
+ * \param[out] dst A pointer to the ::IMGTYPE_FLOAT destination image
+ */
+void ifft2dReal(const image_t *src, image_t *dst)
+{
+    TRACE_ENTER(src, dst);
+
+    // Verify image validity
+    ASSERT(src == NULL, "src image is invalid");
+    ASSERT(dst == NULL, "dst image is invalid");
+    ASSERT(src->data == NULL, "src data is invalid");
+    ASSERT(dst->data == NULL, "dst data is invalid");
+    ASSERT(src->type != IMGTYPE_COMPLEX, "src type is invalid");
+    ASSERT(dst->type != IMGTYPE_FLOAT, "dst type is invalid");
+
+    // Verify image consistency
+    ASSERT(src->cols != ((dst->cols / 2) + 1), "src must have dst->cols / 2 + 1 columns");
+    ASSERT(src->rows != dst->rows, "src and dst have different number of rows");
+
+    const float scale = 1.0f / ((float)dst->cols * (float)dst->rows);
+
+    image_arena_mark_t mark = markImageArena();
+
+    image_t tmp = *src;
+    tmp.stride = 0;
+    tmp.step = 0;
+    tmp.data = (uint8_t *)allocImageArena((size_t)src->cols * src->rows * sizeof(complex_pixel_t));
+
+    if ((tmp.data == NULL) || (fftPass(src, &tmp, 1, 1, 1.0f) == 0) || (fftRealRows(&tmp, dst, 1, scale) == 0))
+    {
+        ASSERT(1 == 1, "Unable to transform, see FFT_MAX_RADIX, FFT_PLAN_MEMORY and the size of the image arena");
+    }
+
+    releaseImageArena(mark);
+
+    TRACE_EXIT();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+/*!
+ * \brief Returns the cached plan of a transform length
+ *
+ * A new plan is stored in fft_memory. If there is no room for it, all cached
+ * plans are discarded first. So a returned plan is only valid until the next
+ * call of this function.
+ *
+ * \param[in] n    Length of the complex transform
+ * \param[in] real 1 for the plan of a real transform of length 2n
+ *
+ * \return A pointer to the plan. NULL if the length has a prime factor larger
+ *         than FFT_MAX_RADIX or the plan does not fit in FFT_PLAN_MEMORY.
+ */
+static const fft_plan_t *fftPlan(const int32_t n, const int32_t real)
+{
+    for (int32_t i = 0; i < fft_plan_count; i++)
+    {
+        if ((fft_plans[i].n == n) && (fft_plans[i].real == real))
+        {
+            return &fft_plans[i];
+        }
+    }
+
+    // The permutation is stored in 16 bits
+    if (n > 65536)
+    {
+        return NULL;
+    }
+
+    // Factor into radix 4 first, the cheapest butterfly per element
+    int32_t factors[FFT_MAX_FACTORS];
+    int32_t nfactors = 0;
+    int32_t rem = n;
+
+    while ((rem % 4) == 0)
+    {
+        factors[nfactors++] = 4;
+        rem /= 4;
+    }
+
+    for (int32_t p = 2; rem > 1; p++)
+    {
+        while ((rem % p) == 0)
+        {
+            if (p > FFT_MAX_RADIX)
+            {
+                return NULL;
+            }
+
+            factors[nfactors++] = p;
+            rem /= p;
+        }
+    }
+
+    // Permutation, twiddles and real twiddles, in complex_pixel_t elements
+    const size_t perm_size = ((n * sizeof(uint16_t)) + sizeof(complex_pixel_t) - 1) / sizeof(complex_pixel_t);
+    const size_t size = perm_size + n + (real ? (n + 1) : 0);
+
+    if (size > (FFT_PLAN_MEMORY / sizeof(complex_pixel_t)))
+    {
+        return NULL;
+    }
+
+    if ((fft_plan_count == FFT_MAX_PLANS) ||
+        ((fft_memory_used + size) > (FFT_PLAN_MEMORY / sizeof(complex_pixel_t))))
+    {
+        fft_plan_count = 0;
+        fft_memory_used = 0;
+    }
+
+    fft_plan_t *plan = &fft_plans[fft_plan_count];
+
+    plan->n = n;
+    plan->real = real;
+    plan->nfactors = nfactors;
+    plan->perm = (uint16_t *)&fft_memory[fft_memory_used];
+    plan->tw = &fft_memory[fft_memory_used + perm_size];
+    plan->rtw = real ? &fft_memory[fft_memory_used + perm_size + n] : NULL;
+
+    for (int32_t s = 0; s < nfactors; s++)
+    {
+        plan->factors[s] = factors[s];
+    }
+
+    // Position p of the permuted input holds input element perm[p]. The last
+    // stage combines radix sub-transforms of consecutive blocks, where block q
+    // holds the elements q, q + radix, q + 2 * radix, ... of its input.
+    for (int32_t p = 0; p < n; p++)
+    {
+        int32_t idx = 0;
+        int32_t stride = 1;
+        int32_t size_s = n;
+        int32_t pos = p;
+
+        for (int32_t s = nfactors - 1; s >= 0; s--)
+        {
+            size_s /= factors[s];
+            idx += (pos / size_s) * stride;
+            pos %= size_s;
+            stride *= factors[s];
+        }
+
+        plan->perm[p] = (uint16_t)idx;
+    }
+
+    for (int32_t k = 0; k < n; k++)
+    {
+        plan->tw[k].real = (float)cos(2.0 * M_PI * k / n);
+        plan->tw[k].imaginary = (float)-sin(2.0 * M_PI * k / n);
+    }
+
+    if (real)
+    {
+        for (int32_t k = 0; k <= n; k++)
+        {
+            plan->rtw[k].real = (float)cos(M_PI * k / n);
+            plan->rtw[k].imaginary = (float)-sin(M_PI * k / n);
+        }
+    }
+
+    fft_memory_used += size;
+    fft_plan_count++;
+
+    return plan;
+}
+
+/*!
+ * \brief Executes the butterfly stages of a plan
+ *
+ * The input must be in digit-reversed order, the output is in natural order.
+ * Element e of lane l is stored at index e * FFT_LANES + l, so every
+ * butterfly is applied to FFT_LANES consecutive floats. The inputs of a
+ * butterfly are multiplied by their twiddles while they are loaded.
+ *
+ * \param[in]     plan    A pointer to the plan
+ * \param[in,out] re      Real parts
+ * \param[in,out] im      Imaginary parts
+ * \param[in]     inverse 1 for the inverse transform, without scaling
+ */
+static void fftStages(const fft_plan_t *plan, float *re, float *im, const int32_t inverse)
+{
+    const int32_t n = plan->n;
+
+    // Sign of the exponent, the imaginary parts of the twiddles are flipped
+    // for the inverse transform
+    const float sign = inverse ? 1.0f : -1.0f;
+    int32_t m = 1;
+
+    for (int32_t s = 0; s < plan->nfactors; s++)
+    {
+        const int32_t r = plan->factors[s];
+        const int32_t len = m * r;
+        const int32_t ts = n / len;
+        const int32_t d = m * FFT_LANES;
+
+        for (int32_t j = 0; j < m; j++)
+        {
+            // Twiddles W^(j * q) of the r inputs
+            float wr[FFT_MAX_RADIX];
+            float wi[FFT_MAX_RADIX];
+
+            for (int32_t q = 0; q < r; q++)
+            {
+                wr[q] = plan->tw[j * q * ts].real;
+                wi[q] = -sign * plan->tw[j * q * ts].imaginary;
+            }
+
+            for (int32_t b = j; b < n; b += len)
+            {
+                float *xr = re + (b * FFT_LANES);
+                float *xi = im + (b * FFT_LANES);
+
+                if (r == 4)
+                {
+                    for (int32_t l = 0; l < FFT_LANES; l++)
+                    {
+                        const float a1r = (xr[l + d] * wr[1]) - (xi[l + d] * wi[1]);
+                        const float a1i = (xr[l + d] * wi[1]) + (xi[l + d] * wr[1]);
+                        const float a2r = (xr[l + 2 * d] * wr[2]) - (xi[l + 2 * d] * wi[2]);
+                        const float a2i = (xr[l + 2 * d] * wi[2]) + (xi[l + 2 * d] * wr[2]);
+                        const float a3r = (xr[l + 3 * d] * wr[3]) - (xi[l + 3 * d] * wi[3]);
+                        const float a3i = (xr[l + 3 * d] * wi[3]) + (xi[l + 3 * d] * wr[3]);
+
+                        const float t0r = xr[l] + a2r;
+                        const float t0i = xi[l] + a2i;
+                        const float t1r = xr[l] - a2r;
+                        const float t1i = xi[l] - a2i;
+                        const float t2r = a1r + a3r;
+                        const float t2i = a1i + a3i;
+
+                        // sign * i * (a1 - a3)
+                        const float t3r = -sign * (a1i - a3i);
+                        const float t3i = sign * (a1r - a3r);
+
+                        xr[l] = t0r + t2r;
+                        xi[l] = t0i + t2i;
+                        xr[l + d] = t1r + t3r;
+                        xi[l + d] = t1i + t3i;
+                        xr[l + 2 * d] = t0r - t2r;
+                        xi[l + 2 * d] = t0i - t2i;
+                        xr[l + 3 * d] = t1r - t3r;
+                        xi[l + 3 * d] = t1i - t3i;
+                    }
+                }
+                else if (r == 2)
+                {
+                    for (int32_t l = 0; l < FFT_LANES; l++)
+                    {
+                        const float a1r = (xr[l + d] * wr[1]) - (xi[l + d] * wi[1]);
+                        const float a1i = (xr[l + d] * wi[1]) + (xi[l + d] * wr[1]);
+
+                        xr[l + d] = xr[l] - a1r;
+                        xi[l + d] = xi[l] - a1i;
+                        xr[l] += a1r;
+                        xi[l] += a1i;
+                    }
+                }
+                else if (r == 3)
+                {
+                    const float s3 = sign * 0.866025403784439f;
+
+                    for (int32_t l = 0; l < FFT_LANES; l++)
+                    {
+                        const float a1r = (xr[l + d] * wr[1]) - (xi[l + d] * wi[1]);
+                        const float a1i = (xr[l + d] * wi[1]) + (xi[l + d] * wr[1]);
+                        const float a2r = (xr[l + 2 * d] * wr[2]) - (xi[l + 2 * d] * wi[2]);
+                        const float a2i = (xr[l + 2 * d] * wi[2]) + (xi[l + 2 * d] * wr[2]);
+
+                        const float tr = a1r + a2r;
+                        const float ti = a1i + a2i;
+                        const float ur = xr[l] - (0.5f * tr);
+                        const float ui = xi[l] - (0.5f * ti);
+
+                        // sign * i * sin(60) * (a1 - a2)
+                        const float vr = -s3 * (a1i - a2i);
+                        const float vi = s3 * (a1r - a2r);
+
+                        xr[l] += tr;
+                        xi[l] += ti;
+                        xr[l + d] = ur + vr;
+                        xi[l + d] = ui + vi;
+                        xr[l + 2 * d] = ur - vr;
+                        xi[l + 2 * d] = ui - vi;
+                    }
+                }
+                else if (r == 5)
+                {
+                    const float c1 = 0.309016994374947f;
+                    const float c2 = -0.809016994374947f;
+                    const float s1 = sign * 0.951056516295154f;
+                    const float s2 = sign * 0.587785252292473f;
+
+                    for (int32_t l = 0; l < FFT_LANES; l++)
+                    {
+                        const float a1r = (xr[l + d] * wr[1]) - (xi[l + d] * wi[1]);
+                        const float a1i = (xr[l + d] * wi[1]) + (xi[l + d] * wr[1]);
+                        const float a2r = (xr[l + 2 * d] * wr[2]) - (xi[l + 2 * d] * wi[2]);
+                        const float a2i = (xr[l + 2 * d] * wi[2]) + (xi[l + 2 * d] * wr[2]);
+                        const float a3r = (xr[l + 3 * d] * wr[3]) - (xi[l + 3 * d] * wi[3]);
+                        const float a3i = (xr[l + 3 * d] * wi[3]) + (xi[l + 3 * d] * wr[3]);
+                        const float a4r = (xr[l + 4 * d] * wr[4]) - (xi[l + 4 * d] * wi[4]);
+                        const float a4i = (xr[l + 4 * d] * wi[4]) + (xi[l + 4 * d] * wr[4]);
+
+                        const float t1r = a1r + a4r;
+                        const float t1i = a1i + a4i;
+                        const float t2r = a2r + a3r;
+                        const float t2i = a2i + a3i;
+                        const float d1r = a1r - a4r;
+                        const float d1i = a1i - a4i;
+                        const float d2r = a2r - a3r;
+                        const float d2i = a2i - a3i;
+
+                        const float b1r = xr[l] + (c1 * t1r) + (c2 * t2r);
+                        const float b1i = xi[l] + (c1 * t1i) + (c2 * t2i);
+                        const float b2r = xr[l] + (c2 * t1r) + (c1 * t2r);
+                        const float b2i = xi[l] + (c2 * t1i) + (c1 * t2i);
+
+                        // sign * i * e, with e1 = s1 d1 + s2 d2 and
+                        // e2 = s2 d1 - s1 d2
+                        const float e1r = -((s1 * d1i) + (s2 * d2i));
+                        const float e1i = (s1 * d1r) + (s2 * d2r);
+                        const float e2r = -((s2 * d1i) - (s1 * d2i));
+                        const float e2i = (s2 * d1r) - (s1 * d2r);
+
+                        xr[l] += t1r + t2r;
+                        xi[l] += t1i + t2i;
+                        xr[l + d] = b1r + e1r;
+                        xi[l + d] = b1i + e1i;
+                        xr[l + 4 * d] = b1r - e1r;
+                        xi[l + 4 * d] = b1i - e1i;
+                        xr[l + 2 * d] = b2r + e2r;
+                        xi[l + 2 * d] = b2i + e2i;
+                        xr[l + 3 * d] = b2r - e2r;
+                        xi[l + 3 * d] = b2i - e2i;
+                    }
+                }
+                else
+                {
+                    // Generic odd prime radix, a direct DFT of r points
+                    const int32_t tr = n / r;
+
+                    for (int32_t l = 0; l < FFT_LANES; l++)
+                    {
+                        float ar[FFT_MAX_RADIX];
+                        float ai[FFT_MAX_RADIX];
+
+                        for (int32_t q = 0; q < r; q++)
+                        {
+                            ar[q] = (xr[l + q * d] * wr[q]) - (xi[l + q * d] * wi[q]);
+                            ai[q] = (xr[l + q * d] * wi[q]) + (xi[l + q * d] * wr[q]);
+                        }
+
+                        for (int32_t p = 0; p < r; p++)
+                        {
+                            float yr = 0.0f;
+                            float yi = 0.0f;
+
+                            for (int32_t q = 0; q < r; q++)
+                            {
+                                const complex_pixel_t t = plan->tw[((p * q) % r) * tr];
+                                const float ti = -sign * t.imaginary;
+
+                                yr += (ar[q] * t.real) - (ai[q] * ti);
+                                yi += (ar[q] * ti) + (ai[q] * t.real);
+                            }
+
+                            xr[l + p * d] = yr;
+                            xi[l + p * d] = yi;
+                        }
+                    }
+                }
+            }
+        }
+
+        m = len;
+    }
+}
+
+/*!
+ * \brief Gathers lanes of elements in digit-reversed order
+ *
+ * \param[in]  s    A pointer to the first element of the first lane
+ * \param[in]  type ::IMGTYPE_COMPLEX or ::IMGTYPE_FLOAT
+ * \param[in]  perm The digit-reversal permutation
+ * \param[in]  n    Number of elements
+ * \param[in]  elem Distance in pixels between consecutive elements
+ * \param[in]  lane Distance in pixels between consecutive lanes
+ * \param[in]  w    Number of lanes
+ * \param[out] re   Real parts
+ * \param[out] im   Imaginary parts
+ */
+static inline void fftGather(const uint8_t *s, const eImageType type, const uint16_t *perm, const int32_t n,
+                             const int32_t elem, const int32_t lane, const int32_t w, float *re, float *im)
+{
+    if (type == IMGTYPE_COMPLEX)
+    {
+        for (int32_t p = 0; p < n; p++)
+        {
+            const complex_pixel_t *e = (const complex_pixel_t *)s + (perm[p] * elem);
+
+            for (int32_t l = 0; l < w; l++)
+            {
+                re[p * FFT_LANES + l] = e[l * lane].real;
+                im[p * FFT_LANES + l] = e[l * lane].imaginary;
+            }
+        }
+    }
+    else
+    {
+        for (int32_t p = 0; p < n; p++)
+        {
+            const float_pixel_t *e = (const float_pixel_t *)s + (perm[p] * elem);
+
+            for (int32_t l = 0; l < w; l++)
+            {
+                re[p * FFT_LANES + l] = e[l * lane];
+                im[p * FFT_LANES + l] = 0.0f;
+            }
+        }
+    }
+}
+
+/*!
+ * \brief Scatters lanes of elements in natural order
+ *
+ * \param[out] d     A pointer to the first element of the first lane
+ * \param[in]  type  ::IMGTYPE_COMPLEX, or ::IMGTYPE_FLOAT to store only the
+ *                    real parts
+ * \param[in]  n     Number of elements
+ * \param[in]  elem  Distance in pixels between consecutive elements
+ * \param[in]  lane  Distance in pixels between consecutive lanes
+ * \param[in]  w     Number of lanes
+ * \param[in]  scale Factor applied to the elements
+ * \param[in]  re    Real parts
+ * \param[in]  im    Imaginary parts
+ */
+static inline void fftScatter(uint8_t *d, const eImageType type, const int32_t n, const int32_t elem,
+                              const int32_t lane, const int32_t w, const float scale, const float *re, const float *im)
+{
+    if (type == IMGTYPE_COMPLEX)
+    {
+        for (int32_t p = 0; p < n; p++)
+        {
+            complex_pixel_t *e = (complex_pixel_t *)d + (p * elem);
+
+            for (int32_t l = 0; l < w; l++)
+            {
+                e[l * lane].real = re[p * FFT_LANES + l] * scale;
+                e[l * lane].imaginary = im[p * FFT_LANES + l] * scale;
+            }
+        }
+    }
+    else
+    {
+        for (int32_t p = 0; p < n; p++)
+        {
+            float_pixel_t *e = (float_pixel_t *)d + (p * elem);
+
+            for (int32_t l = 0; l < w; l++)
+            {
+                e[l * lane] = re[p * FFT_LANES + l] * scale;
+            }
+        }
+    }
+}
+
+/*!
+ * \brief Transforms all rows or all columns of an image
+ *
+ * FFT_LANES rows or columns are gathered in digit-reversed order into a
+ * buffer in the arena, transformed and scattered to the destination image.
+ * The source and destination image can be the same image.
+ *
+ * \param[in]  src     A pointer to the ::IMGTYPE_FLOAT or ::IMGTYPE_COMPLEX
+ *                     source image
+ * \param[out] dst     A pointer to the ::IMGTYPE_COMPLEX or ::IMGTYPE_FLOAT
+ *                     destination image, of which only the real part is
+ *                     stored
+ * \param[in]  columns 1 to transform the columns, 0 for the rows
+ * \param[in]  inverse 1 for the inverse transform
+ * \param[in]  scale   Factor applied to the results
+ *
+ * \return 1 on success, 0 if there is no plan or no memory in the arena
+ */
+static int32_t fftPass(const image_t *src, image_t *dst, const int32_t columns, const int32_t inverse, const float scale)
 {
-    return (*((complex_pixel_t *)(img->data) + (r * img->cols + c)));
+    const int32_t n = columns ? src->rows : src->cols;
+    const int32_t count = columns ? src->cols : src->rows;
+
+    // Distance between consecutive elements and between consecutive lanes
+    const int32_t src_elem = columns ? IMAGE_STRIDE(src) : 1;
+    const int32_t src_lane = columns ? 1 : IMAGE_STRIDE(src);
+    const int32_t dst_elem = columns ? IMAGE_STRIDE(dst) : 1;
+    const int32_t dst_lane = columns ? 1 : IMAGE_STRIDE(dst);
+
+    const fft_plan_t *plan = fftPlan(n, 0);
+
+    if (plan == NULL)
+    {
+        return 0;
+    }
+
+    image_arena_mark_t mark = markImageArena();
+
+    float *re = (float *)allocImageArena(2 * (size_t)n * FFT_LANES * sizeof(float));
+
+    if (re == NULL)
+    {
+        return 0;
+    }
+
+    float *im = re + (n * FFT_LANES);
+
+    // The unused lanes of the last block are transformed as well
+    memset(re, 0, 2 * (size_t)n * FFT_LANES * sizeof(float));
+
+    for (int32_t v = 0; v < count; v += FFT_LANES)
+    {
+        const uint8_t *s = src->data + ((size_t)v * src_lane * ((src->type == IMGTYPE_COMPLEX) ? sizeof(complex_pixel_t) : sizeof(float_pixel_t)));
+        uint8_t *d = dst->data + ((size_t)v * dst_lane * ((dst->type == IMGTYPE_COMPLEX) ? sizeof(complex_pixel_t) : sizeof(float_pixel_t)));
+
+        // A constant number of lanes for full blocks lets the compiler
+        // vectorize the gather and scatter
+        if ((count - v) >= FFT_LANES)
+        {
+            fftGather(s, src->type, plan->perm, n, src_elem, src_lane, FFT_LANES, re, im);
+            fftStages(plan, re, im, inverse);
+            fftScatter(d, dst->type, n, dst_elem, dst_lane, FFT_LANES, scale, re, im);
+        }
+        else
+        {
+            fftGather(s, src->type, plan->perm, n, src_elem, src_lane, count - v, re, im);
+            fftStages(plan, re, im, inverse);
+            fftScatter(d, dst->type, n, dst_elem, dst_lane, count - v, scale, re, im);
+        }
+    }
+
+    releaseImageArena(mark);
+
+    return 1;
 }
 
-void setComplexPixel(const image_t *img, const int32_t c, const int32_t r, const complex_pixel_t value)
+/*!
+ * \brief Transforms all rows of a real image to half spectra, or back
+ *
+ * For an even number of columns, a real row x of length 2n is transformed as
+ * the complex row z(k) = x(2k) + i x(2k+1) of length n. With Z the transform
+ * of z and W = exp(-2 pi i / 2n), the spectrum of x is
+ *
+ *     X(k) = (Z(k) + conj(Z(n-k))) / 2 - i W^k (Z(k) - conj(Z(n-k))) / 2
+ *
+ * for k = 0..n. The inverse runs these steps backwards. Rows with an odd
+ * number of columns are transformed as complex rows.
+ *
+ * \param[in]  src     A pointer to the ::IMGTYPE_FLOAT image, or for the
+ *                     inverse the ::IMGTYPE_COMPLEX half spectra
+ * \param[out] dst     A pointer to the ::IMGTYPE_COMPLEX half spectra, or for
+ *                     the inverse the ::IMGTYPE_FLOAT image
+ * \param[in]  inverse 1 for the inverse transform
+ * \param[in]  scale   Factor applied to the results of the inverse transform
+ *
+ * \return 1 on success, 0 if there is no plan or no memory in the arena
+ */
+static int32_t fftRealRows(const image_t *src, image_t *dst, const int32_t inverse, const float scale)
 {
-    *((complex_pixel_t *)(img->data) + (r * img->cols + c)) = value;
+    const image_t *img = inverse ? dst : src;
+    const image_t *spc = inverse ? src : dst;
+    const int32_t cols = img->cols;
+    const int32_t odd = cols & 1;
+    const int32_t n = odd ? cols : (cols / 2);
+    const int32_t img_stride = IMAGE_STRIDE(img);
+    const int32_t spc_stride = IMAGE_STRIDE(spc);
+
+    const fft_plan_t *plan = fftPlan(n, !odd);
+
+    if (plan == NULL)
+    {
+        return 0;
+    }
+
+    image_arena_mark_t mark = markImageArena();
+
+    float *re = (float *)allocImageArena(2 * (size_t)n * FFT_LANES * sizeof(float));
+
+    if (re == NULL)
+    {
+        return 0;
+    }
+
+    float *im = re + (n * FFT_LANES);
+
+    // The unused lanes of the last block are transformed as well
+    memset(re, 0, 2 * (size_t)n * FFT_LANES * sizeof(float));
+
+    for (int32_t v = 0; v < img->rows; v += FFT_LANES)
+    {
+        const int32_t w = ((img->rows - v) < FFT_LANES) ? (img->rows - v) : FFT_LANES;
+        float_pixel_t *x = (float_pixel_t *)img->data + (v * img_stride);
+        complex_pixel_t *y = (complex_pixel_t *)spc->data + (v * spc_stride);
+
+        if (!inverse)
+        {
+            // Gather pairs of real pixels, or single pixels for odd rows
+            for (int32_t p = 0; p < n; p++)
+            {
+                const int32_t k = plan->perm[p];
+
+                for (int32_t l = 0; l < w; l++)
+                {
+                    const float_pixel_t *e = x + (l * img_stride);
+                    re[p * FFT_LANES + l] = odd ? e[k] : e[2 * k];
+                    im[p * FFT_LANES + l] = odd ? 0.0f : e[2 * k + 1];
+                }
+            }
+
+            fftStages(plan, re, im, 0);
+
+            if (odd)
+            {
+                for (int32_t k = 0; k <= (cols / 2); k++)
+                {
+                    for (int32_t l = 0; l < w; l++)
+                    {
+                        y[l * spc_stride + k].real = re[k * FFT_LANES + l];
+                        y[l * spc_stride + k].imaginary = im[k * FFT_LANES + l];
+                    }
+                }
+            }
+            else
+            {
+                // Separate the spectra of the even and odd pixels
+                for (int32_t k = 0; k <= n; k++)
+                {
+                    const int32_t a = (k == n) ? 0 : k;
+                    const int32_t b = (k == 0) ? 0 : (n - k);
+                    const float wr = plan->rtw[k].real;
+                    const float wi = plan->rtw[k].imaginary;
+
+                    for (int32_t l = 0; l < w; l++)
+                    {
+                        const float zar = re[a * FFT_LANES + l];
+                        const float zai = im[a * FFT_LANES + l];
+                        const float zbr = re[b * FFT_LANES + l];
+                        const float zbi = im[b * FFT_LANES + l];
+
+                        // Even and odd spectra, fo = -i (za - conj(zb)) / 2
+                        const float fer = 0.5f * (zar + zbr);
+                        const float fei = 0.5f * (zai - zbi);
+                        const float For = 0.5f * (zai + zbi);
+                        const float Foi = -0.5f * (zar - zbr);
+
+                        y[l * spc_stride + k].real = fer + (wr * For) - (wi * Foi);
+                        y[l * spc_stride + k].imaginary = fei + (wr * Foi) + (wi * For);
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (int32_t p = 0; p < n; p++)
+            {
+                const int32_t k = plan->perm[p];
+
+                if (odd)
+                {
+                    // Complete the spectrum of the row from its Hermitian half
+                    const int32_t h = (k <= (cols / 2)) ? k : (cols - k);
+                    const float s = (k <= (cols / 2)) ? 1.0f : -1.0f;
+
+                    for (int32_t l = 0; l < w; l++)
+                    {
+                        re[p * FFT_LANES + l] = y[l * spc_stride + h].real;
+                        im[p * FFT_LANES + l] = s * y[l * spc_stride + h].imaginary;
+                    }
+                }
+                else
+                {
+                    const float wr = plan->rtw[k].real;
+                    const float wi = plan->rtw[k].imaginary;
+
+                    for (int32_t l = 0; l < w; l++)
+                    {
+                        const complex_pixel_t xa = y[l * spc_stride + k];
+                        const complex_pixel_t xb = y[l * spc_stride + n - k];
+
+                        // fe = xa + conj(xb), fo = (xa - conj(xb)) conj(W^k)
+                        const float fer = xa.real + xb.real;
+                        const float fei = xa.imaginary - xb.imaginary;
+                        const float dr = xa.real - xb.real;
+                        const float di = xa.imaginary + xb.imaginary;
+                        const float For = (dr * wr) + (di * wi);
+                        const float Foi = (di * wr) - (dr * wi);
+
+                        // z = fe + i fo
+                        re[p * FFT_LANES + l] = fer - Foi;
+                        im[p * FFT_LANES + l] = fei + For;
+                    }
+                }
+            }
+
+            fftStages(plan, re, im, 1);
+
+            for (int32_t p = 0; p < n; p++)
+            {
+                for (int32_t l = 0; l < w; l++)
+                {
+                    float_pixel_t *e = x + (l * img_stride);
+
+                    if (odd)
+                    {
+                        e[p] = re[p * FFT_LANES + l] * scale;
+                    }
+                    else
+                    {
+                        e[2 * p] = re[p * FFT_LANES + l] * scale;
+                        e[2 * p + 1] = im[p * FFT_LANES + l] * scale;
+                    }
+                }
+            }
+        }
+    }
+
+    releaseImageArena(mark);
+
+    return 1;
 }
@@ -41,18 +41,48 @@ extern "C" {
 
 #include "image.h"
 
-/// \brief Type definition of a complex pixel
-/// Two floats per pixel
-typedef struct complex_pixel_t
-{
-    float real;      ///< real part of the complex number
-    float imaginary; ///< imaginary part of the complex number
+/*!
+ * \brief Size in bytes of the memory for cached FFT plans
+ *
+ * A plan holds the factorization, the digit-reversal permutation and the
+ * twiddle factors of one transform length. Plans are calculated once and
+ * reused for every next frame of the same size. When a new plan does not fit,
+ * all cached plans are discarded. The plans of a 1920x1080 transform take
+ * about 30 kB, the plans of a ::EVDK5_WIDTH x ::EVDK5_HEIGHT transform and of
+ * the frequency domain convolution blocks take less than 4 kB.
+ *
+ * The memory is statically allocated, so the MCU default is small. The value
+ * can be overridden with a compiler definition.
+ */
+#ifndef FFT_PLAN_MEMORY
+#ifdef MCUXPRESSO_SDK
+#define FFT_PLAN_MEMORY (8 * 1024)
+#else
+#define FFT_PLAN_MEMORY (64 * 1024)
+#endif
+#endif
 
-}complex_pixel_t;
+/// Maximum number of cached FFT plans
+#ifndef FFT_MAX_PLANS
+#ifdef MCUXPRESSO_SDK
+#define FFT_MAX_PLANS (4)
+#else
+#define FFT_MAX_PLANS (8)
+#endif
+#endif
 
-// Functions are documented in the source file
+/// Largest prime factor of a transform length. Factors 2, 3, 4 and 5 have
+/// dedicated butterflies, larger prime factors use a direct DFT.
+#ifndef FFT_MAX_RADIX
+#define FFT_MAX_RADIX (31)
+#endif
 
+// Functions are documented in the source file
 
+void fft2d(const image_t *src, image_t *dst);
+void ifft2d(const image_t *src, image_t *dst);
+void fft2dReal(const image_t *src, image_t *dst);
+void ifft2dReal(const image_t *src, image_t *dst);
 
 #endif // _TRANSFORMS_H_
 
@@ -0,0 +1,1132 @@
+/*! ***************************************************************************
+ *
+ * \brief     Operator benchmarks
+ * \file      benchmarks.c
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include "benchmarks.h"
+
+#include <math.h>
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+// Defines
+// ----------------------------------------------------------------------------
+/// Limit for operators that iterate over the image until nothing changes
+#define ITERATIVE_MAX_PIXELS (640 * 480)
+
+/// Size of the lookup table for the two-pass labelling operators
+#define LUT_SIZE (1 << 20)
+
+/// Number of BLOB columns and rows in the binary image
+#define BLOB_COLS (8)
+#define BLOB_ROWS (6)
+
+// ----------------------------------------------------------------------------
+// Local variables
+// ----------------------------------------------------------------------------
+/// 3x3 mask with all cells set
+static const uint8_t mask_3x3[3 * 3] =
+{
+    1, 1, 1,
+    1, 1, 1,
+    1, 1, 1,
+};
+
+/// Hit-and-miss masks that find top left corners
+static const uint8_t hit_3x3[3 * 3] =
+{
+    0, 0, 0,
+    0, 1, 1,
+    0, 1, 0,
+};
+
+static const uint8_t miss_3x3[3 * 3] =
+{
+    0, 1, 0,
+    1, 0, 0,
+    0, 0, 0,
+};
+
+/// Horizontal line detector mask
+static int16_t line_3x3[3][3] =
+{
+    {-1, -1, -1},
+    { 2,  2,  2},
+    {-1, -1, -1},
+};
+
+// ----------------------------------------------------------------------------
+// Fixture
+// ----------------------------------------------------------------------------
+/*!
+ * \brief Deterministic pseudo random-number generator (xorshift32)
+ *
+ * The benchmarks do not use rand(), so every run processes the same images.
+ *
+ * \param[in,out] state Generator state, must not be 0
+ *
+ * \return A pseudo random number
+ */
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+
+    *state = x;
+
+    return x;
+}
+
+void createFixture(bench_fixture_t *f, const int32_t cols, const int32_t rows)
+{
+    memset(f, 0, sizeof(*f));
+
+    f->cols = cols;
+    f->rows = rows;
+
+    f->gray = newUint8Image(cols, rows);
+    f->binary = newUint8Image(cols, rows);
+    f->gray16 = newInt16Image(cols, rows);
+    f->uyvy = newUyvyImage(cols, rows);
+    f->bgr = newBgr888Image(cols, rows);
+    f->flt = newFloatImage(cols, rows);
+    f->cpx = newComplexImage(cols, rows);
+    f->dst8 = newUint8Image(cols, rows);
+    f->tmp8 = newUint8Image(cols, rows);
+    f->dst16 = newInt16Image(cols, rows);
+    f->ii = newUint32Image(cols + 1, rows + 1);
+    f->bits = newBinaryImage(cols, rows);
+    f->dstbits = newBinaryImage(cols, rows);
+    f->msk8 = newUint8Image(3, 3);
+    f->msk16 = newInt16Image(3, 3);
+    f->msk15 = newInt16Image(15, 15);
+    f->row15 = newInt16Image(15, 1);
+    f->col15 = newInt16Image(1, 15);
+    f->disk15 = newInt16Image(15, 15);
+    f->tpl = newUint8Image(32, 32);
+    f->scores = newFloatImage(cols - 31, rows - 31);
+
+    // Graylevel image: a diagonal gradient with uniform noise
+    uint32_t state = 0x12345678;
+
+    for (int32_t y = 0; y < rows; y++)
+    {
+        for (int32_t x = 0; x < cols; x++)
+        {
+            int32_t p = (((x * 255) / cols) + ((y * 255) / rows)) / 2;
+
+            p += (int32_t)(xorshift32(&state) % 33) - 16;
+            p = (p < 0) ? 0 : ((p > 255) ? 255 : p);
+
+            setUint8Pixel(f->gray, x, y, (uint8_pixel_t)p);
+        }
+    }
+
+    // Binary image: a grid of rings, so there are holes to fill, and a bar
+    // that touches the left border
+    clearUint8Image(f->binary);
+
+    float pitch_x = (float)cols / BLOB_COLS;
+    float pitch_y = (float)rows / BLOB_ROWS;
+    float outer = 0.35f * ((pitch_x < pitch_y) ? pitch_x : pitch_y);
+    float inner = 0.5f * outer;
+
+    for (int32_t y = 0; y < rows; y++)
+    {
+        for (int32_t x = 0; x < cols; x++)
+        {
+            float dx = fmodf((float)x, pitch_x) - (pitch_x / 2.0f);
+            float dy = fmodf((float)y, pitch_y) - (pitch_y / 2.0f);
+            float d = sqrtf((dx * dx) + (dy * dy));
+
+            if ((d <= outer) && (d >= inner))
+            {
+                setUint8Pixel(f->binary, x, y, 1);
+            }
+        }
+    }
+
+    for (int32_t y = (rows / 2) - (rows / 64); y <= (rows / 2) + (rows / 64); y++)
+    {
+        for (int32_t x = 0; x < (int32_t)(pitch_x / 2.0f - outer); x++)
+        {
+            setUint8Pixel(f->binary, x, y, 1);
+        }
+    }
+
+    // Other pixel types
+    convertUint8ToBinary(f->binary, f->bits);
+    convertUint8ToUyvy(f->gray, f->uyvy);
+    convertUint8ToBgr888(f->gray, f->bgr);
+
+    for (int32_t y = 0; y < rows; y++)
+    {
+        for (int32_t x = 0; x < cols; x++)
+        {
+            uint8_pixel_t p = getUint8Pixel(f->gray, x, y);
+
+            setInt16Pixel(f->gray16, x, y, (int16_pixel_t)p);
+            setFloatPixel(f->flt, x, y, (float)p - 128.0f);
+        }
+    }
+
+    fft2d(f->flt, f->cpx);
+
+    // Masks
+    for (int32_t y = 0; y < 3; y++)
+    {
+        for (int32_t x = 0; x < 3; x++)
+        {
+            setUint8Pixel(f->msk8, x, y, 1);
+            setInt16Pixel(f->msk16, x, y, (int16_pixel_t)(((x == 1) && (y == 1)) ? 8 : -1));
+        }
+    }
+
+    // Row and column mask approximate a binomial mask without zero taps
+    int16_pixel_t binomial[15] = {1, 14, 91, 364, 1001, 2002, 3003, 3432, 3003, 2002, 1001, 364, 91, 14, 1};
+
+    for (int32_t i = 0; i < 15; i++)
+    {
+        int16_pixel_t k = (int16_pixel_t)((binomial[i] + 127) / 128);
+
+        setInt16Pixel(f->row15, i, 0, k);
+        setInt16Pixel(f->col15, 0, i, k);
+    }
+
+    for (int32_t y = 0; y < 15; y++)
+    {
+        for (int32_t x = 0; x < 15; x++)
+        {
+            setInt16Pixel(f->msk15, x, y, (int16_pixel_t)(getInt16Pixel(f->row15, x, 0) * getInt16Pixel(f->col15, 0, y)));
+            setInt16Pixel(f->disk15, x, y, (int16_pixel_t)((((x - 7) * (x - 7)) + ((y - 7) * (y - 7))) <= 49));
+        }
+    }
+
+    // Huffman tree and encoded data of the binary image
+    uint32_t hist[256];
+
+    histogram(f->binary, hist);
+    f->tree = make_huffman_tree(make_huffman_pq(hist));
+    f->encoded = encode_image(f->binary, f->tree, &f->encoded_size);
+
+    // Worst case stack of the Canny edge tracker
+    f->stack = (uint32_t *)malloc((size_t)cols * rows * sizeof(uint32_t));
+
+    // Notch filter that removes a horizontal and a vertical interference
+    f->notch_params.shape = FREQUENCY_BUTTERWORTH;
+    f->notch_params.band = FREQUENCY_NOTCH;
+    f->notch_params.cutoff = 3.0f;
+    f->notch_params.order = 2;
+    f->notch_params.notches = 2;
+    f->notch_params.notch[0].x = cols / 8;
+    f->notch_params.notch[1].y = rows / 8;
+    f->transfer = (float *)malloc(frequencyFilterBufferSize(cols, rows));
+    initFrequencyFilter(&f->notch, f->transfer, cols, rows, &f->notch_params);
+
+    // Reproducible noise
+    rngSeed(&f->rng, 2026);
+    f->noise = (float *)malloc((size_t)cols * rows * sizeof(float));
+
+    // Template from the center of the graylevel image
+    for (int32_t y = 0; y < f->tpl->rows; y++)
+    {
+        for (int32_t x = 0; x < f->tpl->cols; x++)
+        {
+            setUint8Pixel(f->tpl, x, y, getUint8Pixel(f->gray, (cols / 2) + x, (rows / 2) + y));
+        }
+    }
+}
+
+void destroyFixture(bench_fixture_t *f)
+{
+    free(f->encoded);
+    free(f->stack);
+    free(f->transfer);
+    free(f->noise);
+    destroy_huffman_tree(&f->tree);
+
+    f->encoded = NULL;
+    f->stack = NULL;
+    f->transfer = NULL;
+    f->noise = NULL;
+}
+
+// ----------------------------------------------------------------------------
+// Benchmarks
+// ----------------------------------------------------------------------------
+
+// Coding and compression
+static void bmHuffmanTree(bench_fixture_t *f)
+{
+    uint32_t hist[256];
+
+    histogram(f->binary, hist);
+    TreeNode *root = make_huffman_tree(make_huffman_pq(hist));
+    destroy_huffman_tree(&root);
+}
+
+static void bmEncodeImage(bench_fixture_t *f)
+{
+    size_t size;
+    free(encode_image(f->binary, f->tree, &size));
+}
+
+static void bmDecodeImage(bench_fixture_t *f)
+{
+    decode_image(f->encoded, f->encoded_size, f->tree, f->dst8);
+}
+
+// Graphics algorithms
+static void bmTextPutstring(bench_fixture_t *f)
+{
+    textSetxy(0, 0);
+    textPutstring(f->dst8, "EVDK benchmark 0123456789");
+}
+
+static void bmDrawLineUint8(bench_fixture_t *f)
+{
+    point_t p1 = {0, 0};
+    point_t p2 = {f->cols - 1, f->rows - 1};
+    drawLineUint8(f->dst8, p1, p2, 255);
+}
+
+static void bmDrawLineBgr888(bench_fixture_t *f)
+{
+    point_t p1 = {0, 0};
+    point_t p2 = {f->cols - 1, f->rows - 1};
+    bgr888_pixel_t val = {255, 255, 255};
+    drawLineBgr888(f->bgr, p1, p2, val);
+}
+
+static void bmDrawLineUyvy(bench_fixture_t *f)
+{
+    point_t p1 = {0, 0};
+    point_t p2 = {f->cols - 1, f->rows - 1};
+    uyvy_pixel_t val = 0x80FF;
+    drawLineUyvy(f->uyvy, p1, p2, val);
+}
+
+static void bmAffineTransformation(bench_fixture_t *f)
+{
+    float m[2][3] =
+    {
+        {0.9f, -0.1f, 10.0f},
+        {0.1f,  0.9f, 5.0f},
+    };
+
+    affineTransformation(f->gray, f->dst8, TRANSFORM_FORWARD, m);
+}
+
+static void bmRotate(bench_fixture_t *f)
+{
+    point_t center = {f->cols / 2, f->rows / 2};
+    rotate(f->gray, f->dst8, 0.3f, center);
+}
+
+static void bmRotate180(bench_fixture_t *f)
+{
+    rotate180_c(f->dst8);
+}
+
+static void bmWarpPerspective(bench_fixture_t *f)
+{
+    const point_t from[4] =
+    {
+        {f->cols / 8, f->rows / 8},
+        {f->cols - 1 - (f->cols / 16), f->rows / 10},
+        {f->cols - 1 - (f->cols / 8), f->rows - 1 - (f->rows / 8)},
+        {f->cols / 10, f->rows - 1 - (f->rows / 16)},
+    };
+
+    const point_t to[4] =
+    {
+        {0, 0},
+        {f->cols - 1, 0},
+        {f->cols - 1, f->rows - 1},
+        {0, f->rows - 1},
+    };
+
+    warpPerspective(f->gray, f->dst8, from, to, TRANSFORM_BACKWARD);
+}
+
+static void bmWarpPerspectiveFast(bench_fixture_t *f)
+{
+    const point_t from[4] =
+    {
+        {f->cols / 8, f->rows / 8},
+        {f->cols - 1 - (f->cols / 16), f->rows / 10},
+        {f->cols - 1 - (f->cols / 8), f->rows - 1 - (f->rows / 8)},
+        {f->cols / 10, f->rows - 1 - (f->rows / 16)},
+    };
+
+    warpPerspectiveFast(f->gray, f->dst8, from, TRANSFORM_BACKWARD);
+}
+
+static void bmZoomIn(bench_fixture_t *f)
+{
+    zoom(f->gray, f->dst8, 0, 0, f->cols / 2, f->rows / 2, ZOOM_IN);
+}
+
+static void bmZoomOut(bench_fixture_t *f)
+{
+    zoom(f->gray, f->dst8, 0, 0, f->cols, f->rows, ZOOM_OUT);
+}
+
+static void bmZoomFactor(bench_fixture_t *f)
+{
+    zoomFactor(f->gray, f->dst8, 0, 0, f->cols / 4, f->rows / 4, ZOOM_IN, 4);
+}
+
+// Histogram operations
+static void bmHistogram(bench_fixture_t *f)
+{
+    uint32_t hist[256];
+    histogram(f->gray, hist);
+}
+
+static void bmHistogramBinary(bench_fixture_t *f)
+{
+    uint32_t hist[256];
+    histogram(f->binary, hist);
+}
+
+static void bmHistogramStatsMask(bench_fixture_t *f)
+{
+    uint32_t hist[256];
+    histogram_stats_t stats;
+    histogramStats(f->gray, f->binary, hist, &stats);
+}
+
+static void bmHistogramBgr888(bench_fixture_t *f)
+{
+    uint32_t hist[3 * 256];
+    histogram_stats_t stats[3];
+    histogramBgr888(f->bgr, NULL, hist, stats);
+}
+
+static void bmHistogramInt16(bench_fixture_t *f)
+{
+    uint32_t hist[64];
+    histogram_stats_t stats;
+    histogramInt16(f->gray16, NULL, 0, 255, 64, hist, &stats);
+}
+
+static void bmBrightness(bench_fixture_t *f)
+{
+    brightness(f->gray, f->dst8, 20);
+}
+
+static void bmContrast(bench_fixture_t *f)
+{
+    contrast(f->gray, f->dst8, 1.5f);
+}
+
+// Image fundamentals
+static void bmNewDeleteImage(bench_fixture_t *f)
+{
+    image_t *img = newUint8Image(f->cols, f->rows);
+    deleteUint8Image(img);
+}
+
+static void bmCopyUint8Image(bench_fixture_t *f)
+{
+    copyUint8Image(f->gray, f->dst8);
+}
+
+static void bmCopyInt16Image(bench_fixture_t *f)
+{
+    copyInt16Image(f->gray16, f->dst16);
+}
+
+static void bmClearUint8Image(bench_fixture_t *f)
+{
+    clearUint8Image(f->dst8);
+}
+
+static void bmClearInt16Image(bench_fixture_t *f)
+{
+    clearInt16Image(f->dst16);
+}
+
+static void bmConvertUyvyToUint8(bench_fixture_t *f)
+{
+    convertUyvyToUint8(f->uyvy, f->dst8);
+}
+
+static void bmConvertUyvyToInt16(bench_fixture_t *f)
+{
+    convertUyvyToInt16(f->uyvy, f->dst16);
+}
+
+static void bmConvertUint8ToUyvy(bench_fixture_t *f)
+{
+    convertUint8ToUyvy(f->gray, f->uyvy);
+}
+
+static void bmConvertUyvyToBgr888(bench_fixture_t *f)
+{
+    convertUyvyToBgr888(f->uyvy, f->bgr);
+}
+
+static void bmConvertUyvyToBgr888Fast(bench_fixture_t *f)
+{
+    convertUyvyToBgr888Fast(f->uyvy, f->bgr, YUV_BT601, YUV_RANGE_FULL);
+}
+
+static void bmConvertUint8ToBgr888(bench_fixture_t *f)
+{
+    convertUint8ToBgr888(f->gray, f->bgr);
+}
+
+static void bmConvertBgr888ToUint8(bench_fixture_t *f)
+{
+    convertBgr888ToUint8(f->bgr, f->dst8);
+}
+
+static void bmConvertBgr888ToInt16(bench_fixture_t *f)
+{
+    convertBgr888ToInt16(f->bgr, f->dst16);
+}
+
+static void bmSetSelectedToValue(bench_fixture_t *f)
+{
+    setSelectedToValue(f->binary, f->dst8, 1, 255);
+}
+
+static void bmNeighbourCount(bench_fixture_t *f)
+{
+    volatile uint32_t cnt = 0;
+
+    for (int32_t y = 1; y < (f->rows - 1); y++)
+    {
+        for (int32_t x = 1; x < (f->cols - 1); x++)
+        {
+            cnt += neighbourCount(f->binary, x, y, 1, CONNECTED_EIGHT);
+        }
+    }
+}
+
+static void bmScale(bench_fixture_t *f)
+{
+    scale(f->gray, f->dst8);
+}
+
+static void bmScaleInt16ToUint8(bench_fixture_t *f)
+{
+    scaleInt16ToUint8(f->gray16, f->dst8);
+}
+
+static void bmScaleFloatToUint8(bench_fixture_t *f)
+{
+    scaleFloatToUint8(f->flt, f->dst8);
+}
+
+static void bmScaleFast(bench_fixture_t *f)
+{
+    scaleFast(f->gray, f->dst8);
+}
+
+static void bmConvolveUint8(bench_fixture_t *f)
+{
+    convolve(f->gray, f->dst8, f->msk8);
+}
+
+static void bmConvolveInt16(bench_fixture_t *f)
+{
+    convolve(f->gray16, f->dst16, f->msk16);
+}
+
+static void bmConvolveFast(bench_fixture_t *f)
+{
+    convolveFast(f->gray16, f->dst16, f->msk16);
+}
+
+static void bmConvolveFastBorder(bench_fixture_t *f)
+{
+    convolveFastBorder(f->gray16, f->dst16, f->msk15, BORDER_REFLECT, 0.0f);
+}
+
+static void bmConvolve15x15(bench_fixture_t *f)
+{
+    convolve(f->gray16, f->dst16, f->msk15);
+}
+
+static void bmConvolveDisk15x15(bench_fixture_t *f)
+{
+    convolve(f->gray16, f->dst16, f->disk15);
+}
+
+static void bmConvolveSeparable(bench_fixture_t *f)
+{
+    convolveSeparable(f->gray16, f->dst16, f->row15, f->col15);
+}
+
+static void bmCorrelate(bench_fixture_t *f)
+{
+    correlate(f->gray16, f->dst16, f->msk16);
+}
+
+static void bmCorrelateDisk15x15(bench_fixture_t *f)
+{
+    correlate(f->gray16, f->dst16, f->disk15);
+}
+
+static void bmConvertUint8ToBinary(bench_fixture_t *f)
+{
+    convertUint8ToBinary(f->binary, f->dstbits);
+}
+
+static void bmIntegralImage(bench_fixture_t *f)
+{
+    integralImage(f->gray, f->ii);
+}
+
+// Mensuration
+static void bmArea(bench_fixture_t *f)
+{
+    blobinfo_t info;
+    area(f->binary, &info, 1);
+}
+
+static void bmCentroid(bench_fixture_t *f)
+{
+    blobinfo_t info;
+    centroid(f->binary, &info, 1);
+}
+
+static void bmPerimeter(bench_fixture_t *f)
+{
+    blobinfo_t info;
+    perimeter(f->binary, &info, 1);
+}
+
+static void bmCircularity(bench_fixture_t *f)
+{
+    blobinfo_t info;
+    circularity(f->binary, &info, 1);
+}
+
+static void bmHuInvariantMoments(bench_fixture_t *f)
+{
+    blobinfo_t info;
+    huInvariantMoments(f->binary, &info, 1);
+}
+
+static void bmLabelIterative(bench_fixture_t *f)
+{
+    labelIterative(f->binary, f->dst8, CONNECTED_EIGHT);
+}
+
+static void bmLabelTwoPass(bench_fixture_t *f)
+{
+    labelTwoPass(f->binary, f->dst8, CONNECTED_EIGHT, LUT_SIZE);
+}
+
+// Morphological filters
+static void bmDilation(bench_fixture_t *f)
+{
+    dilation(f->binary, f->dst8, mask_3x3, 3);
+}
+
+static void bmDilationBinary(bench_fixture_t *f)
+{
+    dilation(f->bits, f->dstbits, mask_3x3, 3);
+}
+
+static void bmDilationGray(bench_fixture_t *f)
+{
+    dilationGray(f->gray, f->dst8, mask_3x3, 3);
+}
+
+static void bmErosion(bench_fixture_t *f)
+{
+    erosion(f->binary, f->dst8, mask_3x3, 3);
+}
+
+static void bmErosionBinary(bench_fixture_t *f)
+{
+    erosion(f->bits, f->dstbits, mask_3x3, 3);
+}
+
+static void bmErosionGray(bench_fixture_t *f)
+{
+    erosionGray(f->gray, f->dst8, mask_3x3, 3);
+}
+
+static void bmFillHolesIterative(bench_fixture_t *f)
+{
+    fillHolesIterative(f->binary, f->dst8, CONNECTED_FOUR);
+}
+
+static void bmFillHolesTwoPass(bench_fixture_t *f)
+{
+    fillHolesTwoPass(f->binary, f->dst8, CONNECTED_FOUR, LUT_SIZE);
+}
+
+static void bmHitmiss(bench_fixture_t *f)
+{
+    hitmiss(f->binary, f->dst8, hit_3x3, miss_3x3);
+}
+
+static void bmOutline(bench_fixture_t *f)
+{
+    outline(f->binary, f->dst8, mask_3x3, 3);
+}
+
+static void bmRemoveBorderBlobsIterative(bench_fixture_t *f)
+{
+    removeBorderBlobsIterative(f->binary, f->dst8, CONNECTED_EIGHT);
+}
+
+static void bmRemoveBorderBlobsTwoPass(bench_fixture_t *f)
+{
+    removeBorderBlobsTwoPass(f->binary, f->dst8, CONNECTED_EIGHT, LUT_SIZE);
+}
+
+static void bmSkeleton(bench_fixture_t *f)
+{
+    skeleton(f->binary, f->dst8, mask_3x3, 3);
+}
+
+static void bmSkeletonBinary(bench_fixture_t *f)
+{
+    skeleton(f->bits, f->dstbits, mask_3x3, 3);
+}
+
+static void bmThinning(bench_fixture_t *f)
+{
+    thinning(f->binary, f->dst8);
+}
+
+// Noise
+static void bmGaussian(bench_fixture_t *f)
+{
+    gaussian(f->tmp8, 100.0f, 128.0f);
+}
+
+static void bmSaltPepper(bench_fixture_t *f)
+{
+    saltPepper(f->tmp8, 0.1f);
+}
+
+static void bmUniform(bench_fixture_t *f)
+{
+    uniform(f->tmp8, 0, 255);
+}
+
+static void bmGaussianRng(bench_fixture_t *f)
+{
+    gaussianRng(f->tmp8, 100.0f, 128.0f, &f->rng);
+}
+
+static void bmRngFillUint32(bench_fixture_t *f)
+{
+    rngFillUint32(&f->rng, (uint32_t *)f->noise, (size_t)f->cols * f->rows);
+}
+
+static void bmRngFillGaussian(bench_fixture_t *f)
+{
+    rngFillGaussian(&f->rng, f->noise, (size_t)f->cols * f->rows);
+}
+
+// Nonlinear filters
+static void bmHarmonic(bench_fixture_t *f)
+{
+    harmonic(f->gray, f->dst8, 3);
+}
+
+static void bmMaximum(bench_fixture_t *f)
+{
+    maximum(f->gray, f->dst8, 3);
+}
+
+static void bmMaximum15x15(bench_fixture_t *f)
+{
+    maximum(f->gray, f->dst8, 15);
+}
+
+static void bmMean(bench_fixture_t *f)
+{
+    mean(f->gray, f->dst8, 3);
+}
+
+static void bmMean15x15(bench_fixture_t *f)
+{
+    mean(f->gray, f->dst8, 15);
+}
+
+static void bmMeanFast(bench_fixture_t *f)
+{
+    meanFast(f->gray, f->dst8);
+}
+
+static void bmMedian(bench_fixture_t *f)
+{
+    median(f->gray, f->dst8, 3);
+}
+
+static void bmMedian15x15(bench_fixture_t *f)
+{
+    median(f->gray, f->dst8, 15);
+}
+
+static void bmMidpoint(bench_fixture_t *f)
+{
+    midpoint(f->gray, f->dst8, 3);
+}
+
+static void bmMinimum(bench_fixture_t *f)
+{
+    minimum(f->gray, f->dst8, 3);
+}
+
+static void bmRange(bench_fixture_t *f)
+{
+    range(f->gray, f->dst8, 3);
+}
+
+// Pyramids
+static void bmPyrDown(bench_fixture_t *f)
+{
+    image_t half = *f->dst8;
+    half.cols = (f->cols + 1) / 2;
+    half.rows = (f->rows + 1) / 2;
+    pyrDown(f->gray, &half);
+}
+
+static void bmPyrUp(bench_fixture_t *f)
+{
+    image_t half = *f->tmp8;
+    half.cols = (f->cols + 1) / 2;
+    half.rows = (f->rows + 1) / 2;
+    pyrUp(&half, f->dst8);
+}
+
+static void bmGaussianPyramid(bench_fixture_t *f)
+{
+    image_arena_mark_t mark = markImageArena();
+    pyramid_t gauss;
+    initPyramid(&gauss, allocImageArena(pyramidBufferSize(f->cols, f->rows, 4, IMGTYPE_UINT8)),
+                f->cols, f->rows, 4, IMGTYPE_UINT8);
+    gaussianPyramid(f->gray, &gauss);
+    releaseImageArena(mark);
+}
+
+static void bmLaplacianPyramid(bench_fixture_t *f)
+{
+    image_arena_mark_t mark = markImageArena();
+    pyramid_t gauss;
+    pyramid_t lap;
+    initPyramid(&gauss, allocImageArena(pyramidBufferSize(f->cols, f->rows, 4, IMGTYPE_UINT8)),
+                f->cols, f->rows, 4, IMGTYPE_UINT8);
+    initPyramid(&lap, allocImageArena(pyramidBufferSize(f->cols, f->rows, 4, IMGTYPE_INT16)),
+                f->cols, f->rows, 4, IMGTYPE_INT16);
+    gaussianPyramid(f->gray, &gauss);
+    laplacianPyramid(&gauss, &lap);
+    releaseImageArena(mark);
+}
+
+// Segmentation
+static void bmThreshold(bench_fixture_t *f)
+{
+    threshold(f->gray, f->dst8, 100, 200);
+}
+
+static void bmThresholdLumaView(bench_fixture_t *f)
+{
+    image_t luma;
+    lumaView(f->uyvy, &luma);
+    threshold(&luma, f->dst8, 100, 200);
+}
+
+static void bmThresholdOptimum(bench_fixture_t *f)
+{
+    thresholdOptimum(f->gray, f->dst8, BRIGHTNESS_BRIGHT);
+}
+
+static void bmThreshold2Means(bench_fixture_t *f)
+{
+    threshold2Means(f->gray, f->dst8, BRIGHTNESS_BRIGHT);
+}
+
+static void bmThresholdOtsu(bench_fixture_t *f)
+{
+    thresholdOtsu(f->gray, f->dst8, BRIGHTNESS_BRIGHT);
+}
+
+static void bmLineDetector(bench_fixture_t *f)
+{
+    lineDetector(f->gray, f->dst8, line_3x3);
+}
+
+static void bmCanny(bench_fixture_t *f)
+{
+    canny(f->gray, f->dst8, f->dst16, f->tmp8, f->stack, (uint32_t)(f->cols * f->rows), 80, 160);
+}
+
+// Spatial filters
+static void bmGaussianFilter3x3(bench_fixture_t *f)
+{
+    gaussianFilter_3x3(f->gray16, f->dst16);
+}
+
+static void bmGaussianFilter5x5(bench_fixture_t *f)
+{
+    gaussianFilter_5x5(f->gray16, f->dst16);
+}
+
+static void bmLaplacianFilter3x3(bench_fixture_t *f)
+{
+    laplacianFilter_3x3(f->gray16, f->dst16);
+}
+
+static void bmLaplacianFilter5x5(bench_fixture_t *f)
+{
+    laplacianFilter_5x5(f->gray16, f->dst16);
+}
+
+static void bmSobel(bench_fixture_t *f)
+{
+    sobel(f->gray16, f->dst16, f->flt);
+}
+
+static void bmSobelFast(bench_fixture_t *f)
+{
+    sobelFast(f->gray16, f->dst16);
+}
+
+static void bmSobelFused(bench_fixture_t *f)
+{
+    sobelFused(f->gray, f->dst16, NULL, MAGNITUDE_L1);
+}
+
+static void bmSobelFusedDirection(bench_fixture_t *f)
+{
+    sobelFused(f->gray, f->dst16, f->dst8, MAGNITUDE_APPROX);
+}
+
+// Spatial frequency filters
+static void bmInitFrequencyFilter(bench_fixture_t *f)
+{
+    initFrequencyFilter(&f->notch, f->transfer, f->cols, f->rows, &f->notch_params);
+}
+
+static void bmFrequencyFilter(bench_fixture_t *f)
+{
+    frequencyFilter(f->gray, f->dst8, &f->notch);
+}
+
+// Template matching
+static void bmMatchTemplateSsd(bench_fixture_t *f)
+{
+    matchTemplate(f->gray, f->tpl, f->scores, MATCH_SSD);
+}
+
+static void bmMatchTemplateZncc(bench_fixture_t *f)
+{
+    matchTemplate(f->gray, f->tpl, f->scores, MATCH_ZNCC);
+}
+
+static void bmMatchTemplateCoarseToFine(bench_fixture_t *f)
+{
+    match_t matches[4];
+    matchTemplateCoarseToFine(f->gray, f->tpl, MATCH_ZNCC, 3, matches, 4);
+}
+
+// Transforms
+static void bmFft2d(bench_fixture_t *f)
+{
+    fft2d(f->flt, f->cpx);
+}
+
+static void bmIfft2d(bench_fixture_t *f)
+{
+    ifft2d(f->cpx, f->flt);
+}
+
+static void bmFft2dReal(bench_fixture_t *f)
+{
+    // The half spectrum equals the left columns of the full spectrum
+    image_t half = *f->cpx;
+    half.cols = (f->cols / 2) + 1;
+    fft2dReal(f->flt, &half);
+}
+
+static void bmIfft2dReal(bench_fixture_t *f)
+{
+    image_t half = *f->cpx;
+    half.cols = (f->cols / 2) + 1;
+    ifft2dReal(&half, f->flt);
+}
+
+// ----------------------------------------------------------------------------
+// Benchmark table
+// ----------------------------------------------------------------------------
+const benchmark_t benchmarks[] =
+{
+    {"make_huffman_tree", "coding_and_compression", 0, bmHuffmanTree},
+    {"encode_image", "coding_and_compression", 0, bmEncodeImage},
+    {"decode_image", "coding_and_compression", 0, bmDecodeImage},
+
+    {"textPutstring", "graphics_algorithms", 0, bmTextPutstring},
+    {"drawLineUint8", "graphics_algorithms", 0, bmDrawLineUint8},
+    {"drawLineBgr888", "graphics_algorithms", 0, bmDrawLineBgr888},
+    {"drawLineUyvy", "graphics_algorithms", 0, bmDrawLineUyvy},
+    {"affineTransformation", "graphics_algorithms", 0, bmAffineTransformation},
+    {"rotate", "graphics_algorithms", 0, bmRotate},
+    {"rotate180_c", "graphics_algorithms", 0, bmRotate180},
+    {"warpPerspective", "graphics_algorithms", 0, bmWarpPerspective},
+    {"warpPerspectiveFast", "graphics_algorithms", 0, bmWarpPerspectiveFast},
+    {"zoom_in", "graphics_algorithms", 0, bmZoomIn},
+    {"zoom_out", "graphics_algorithms", 0, bmZoomOut},
+    {"zoomFactor", "graphics_algorithms", 0, bmZoomFactor},
+
+    {"histogram", "histogram_operations", 0, bmHistogram},
+    {"histogram_binary", "histogram_operations", 0, bmHistogramBinary},
+    {"histogramStats_mask", "histogram_operations", 0, bmHistogramStatsMask},
+    {"histogramBgr888", "histogram_operations", 0, bmHistogramBgr888},
+    {"histogramInt16", "histogram_operations", 0, bmHistogramInt16},
+    {"brightness", "histogram_operations", 0, bmBrightness},
+    {"contrast", "histogram_operations", 0, bmContrast},
+
+    {"newUint8Image", "image_fundamentals", 0, bmNewDeleteImage},
+    {"copyUint8Image", "image_fundamentals", 0, bmCopyUint8Image},
+    {"copyInt16Image", "image_fundamentals", 0, bmCopyInt16Image},
+    {"clearUint8Image", "image_fundamentals", 0, bmClearUint8Image},
+    {"clearInt16Image", "image_fundamentals", 0, bmClearInt16Image},
+    {"convertUyvyToUint8", "image_fundamentals", 0, bmConvertUyvyToUint8},
+    {"convertUyvyToInt16", "image_fundamentals", 0, bmConvertUyvyToInt16},
+    {"convertUint8ToUyvy", "image_fundamentals", 0, bmConvertUint8ToUyvy},
+    {"convertUyvyToBgr888", "image_fundamentals", 0, bmConvertUyvyToBgr888},
+    {"convertUyvyToBgr888Fast", "image_fundamentals", 0, bmConvertUyvyToBgr888Fast},
+    {"convertUint8ToBgr888", "image_fundamentals", 0, bmConvertUint8ToBgr888},
+    {"convertBgr888ToUint8", "image_fundamentals", 0, bmConvertBgr888ToUint8},
+    {"convertBgr888ToInt16", "image_fundamentals", 0, bmConvertBgr888ToInt16},
+    {"setSelectedToValue", "image_fundamentals", 0, bmSetSelectedToValue},
+    {"neighbourCount", "image_fundamentals", 0, bmNeighbourCount},
+    {"scale", "image_fundamentals", 0, bmScale},
+    {"scaleInt16ToUint8", "image_fundamentals", 0, bmScaleInt16ToUint8},
+    {"scaleFloatToUint8", "image_fundamentals", 0, bmScaleFloatToUint8},
+    {"scaleFast", "image_fundamentals", 0, bmScaleFast},
+    {"convolve_uint8", "image_fundamentals", 0, bmConvolveUint8},
+    {"convolve_int16", "image_fundamentals", 0, bmConvolveInt16},
+    {"convolveFast", "image_fundamentals", 0, bmConvolveFast},
+    {"convolve_15x15", "image_fundamentals", 0, bmConvolve15x15},
+    {"convolve_disk15x15", "image_fundamentals", 0, bmConvolveDisk15x15},
+    {"convolveSeparable", "image_fundamentals", 0, bmConvolveSeparable},
+    {"convolveFastBorder_15x15", "image_fundamentals", 0, bmConvolveFastBorder},
+    {"correlate", "image_fundamentals", 0, bmCorrelate},
+    {"correlate_disk15x15", "image_fundamentals", 0, bmCorrelateDisk15x15},
+    {"integralImage", "image_fundamentals", 0, bmIntegralImage},
+    {"convertUint8ToBinary", "image_fundamentals", 0, bmConvertUint8ToBinary},
+
+    {"area", "mensuration", 0, bmArea},
+    {"centroid", "mensuration", 0, bmCentroid},
+    {"perimeter", "mensuration", 0, bmPerimeter},
+    {"circularity", "mensuration", 0, bmCircularity},
+    {"huInvariantMoments", "mensuration", 0, bmHuInvariantMoments},
+    {"labelIterative", "mensuration", ITERATIVE_MAX_PIXELS, bmLabelIterative},
+    {"labelTwoPass", "mensuration", 0, bmLabelTwoPass},
+
+    {"dilation", "morphological_filters", 0, bmDilation},
+    {"dilation_binary", "morphological_filters", 0, bmDilationBinary},
+    {"dilationGray", "morphological_filters", 0, bmDilationGray},
+    {"erosion", "morphological_filters", 0, bmErosion},
+    {"erosion_binary", "morphological_filters", 0, bmErosionBinary},
+    {"erosionGray", "morphological_filters", 0, bmErosionGray},
+    {"fillHolesIterative", "morphological_filters", ITERATIVE_MAX_PIXELS, bmFillHolesIterative},
+    {"fillHolesTwoPass", "morphological_filters", 0, bmFillHolesTwoPass},
+    {"hitmiss", "morphological_filters", 0, bmHitmiss},
+    {"outline", "morphological_filters", 0, bmOutline},
+    {"removeBorderBlobsIterative", "morphological_filters", ITERATIVE_MAX_PIXELS, bmRemoveBorderBlobsIterative},
+    {"removeBorderBlobsTwoPass", "morphological_filters", 0, bmRemoveBorderBlobsTwoPass},
+    {"skeleton", "morphological_filters", ITERATIVE_MAX_PIXELS, bmSkeleton},
+    {"skeleton_binary", "morphological_filters", 0, bmSkeletonBinary},
+    {"thinning", "morphological_filters", 0, bmThinning},
+
+    {"gaussian", "noise", 0, bmGaussian},
+    {"saltPepper", "noise", 0, bmSaltPepper},
+    {"uniform", "noise", 0, bmUniform},
+    {"gaussianRng", "noise", 0, bmGaussianRng},
+    {"rngFillUint32", "noise", 0, bmRngFillUint32},
+    {"rngFillGaussian", "noise", 0, bmRngFillGaussian},
+
+    {"harmonic", "nonlinear_filters", 0, bmHarmonic},
+    {"maximum", "nonlinear_filters", 0, bmMaximum},
+    {"maximum_15x15", "nonlinear_filters", 0, bmMaximum15x15},
+    {"mean", "nonlinear_filters", 0, bmMean},
+    {"mean_15x15", "nonlinear_filters", 0, bmMean15x15},
+    {"meanFast", "nonlinear_filters", 0, bmMeanFast},
+    {"median", "nonlinear_filters", 0, bmMedian},
+    {"median_15x15", "nonlinear_filters", 0, bmMedian15x15},
+    {"midpoint", "nonlinear_filters", 0, bmMidpoint},
+    {"minimum", "nonlinear_filters", 0, bmMinimum},
+    {"range", "nonlinear_filters", 0, bmRange},
+
+    {"pyrDown", "pyramids", 0, bmPyrDown},
+    {"pyrUp", "pyramids", 0, bmPyrUp},
+    {"gaussianPyramid", "pyramids", 0, bmGaussianPyramid},
+    {"laplacianPyramid", "pyramids", 0, bmLaplacianPyramid},
+
+    {"threshold", "segmentation", 0, bmThreshold},
+    {"thresholdLumaView", "segmentation", 0, bmThresholdLumaView},
+    {"thresholdOptimum", "segmentation", 0, bmThresholdOptimum},
+    {"threshold2Means", "segmentation", 0, bmThreshold2Means},
+    {"thresholdOtsu", "segmentation", 0, bmThresholdOtsu},
+    {"lineDetector", "segmentation", 0, bmLineDetector},
+    {"canny", "segmentation", 0, bmCanny},
+
+    {"gaussianFilter_3x3", "spatial_filters", 0, bmGaussianFilter3x3},
+    {"gaussianFilter_5x5", "spatial_filters", 0, bmGaussianFilter5x5},
+    {"laplacianFilter_3x3", "spatial_filters", 0, bmLaplacianFilter3x3},
+    {"laplacianFilter_5x5", "spatial_filters", 0, bmLaplacianFilter5x5},
+    {"sobel", "spatial_filters", 0, bmSobel},
+    {"sobelFast", "spatial_filters", 0, bmSobelFast},
+    {"sobelFused", "spatial_filters", 0, bmSobelFused},
+    {"sobelFused_direction", "spatial_filters", 0, bmSobelFusedDirection},
+
+    {"initFrequencyFilter", "spatial_frequency_filters", 0, bmInitFrequencyFilter},
+    {"frequencyFilter", "spatial_frequency_filters", 0, bmFrequencyFilter},
+
+    {"matchTemplate_ssd", "template_matching", 640 * 480, bmMatchTemplateSsd},
+    {"matchTemplate_zncc", "template_matching", 640 * 480, bmMatchTemplateZncc},
+    {"matchTemplateCoarseToFine", "template_matching", 0, bmMatchTemplateCoarseToFine},
+
+    {"fft2d", "transforms", 0, bmFft2d},
+    {"ifft2d", "transforms", 0, bmIfft2d},
+    {"fft2dReal", "transforms", 0, bmFft2dReal},
+    {"ifft2dReal", "transforms", 0, bmIfft2dReal},
+};
+
+const uint32_t benchmarkCount = sizeof(benchmarks) / sizeof(benchmark_t);
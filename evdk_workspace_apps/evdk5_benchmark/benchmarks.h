@@ -0,0 +1,123 @@
+/*! ***************************************************************************
+ *
+ * \brief     Operator benchmarks
+ * \file      benchmarks.h
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifndef _BENCHMARKS_H_
+#define _BENCHMARKS_H_
+
+#include "image.h"
+#include "operators.h"
+
+// ----------------------------------------------------------------------------
+// Type definitions
+// ----------------------------------------------------------------------------
+/// Input and output images shared by all benchmarks of one resolution
+typedef struct
+{
+    int32_t cols;      ///< Number of columns of all images
+    int32_t rows;      ///< Number of rows of all images
+
+    image_t *gray;     ///< Textured graylevel source image
+    image_t *binary;   ///< Binary source image with ring shaped BLOBs
+    image_t *gray16;   ///< ::IMGTYPE_INT16 copy of gray
+    image_t *uyvy;     ///< ::IMGTYPE_UYVY copy of gray
+    image_t *bgr;      ///< ::IMGTYPE_BGR888 copy of gray
+    image_t *flt;      ///< ::IMGTYPE_FLOAT copy of gray
+    image_t *cpx;      ///< ::IMGTYPE_COMPLEX spectrum of flt
+
+    image_t *dst8;     ///< ::IMGTYPE_UINT8 destination image
+    image_t *tmp8;     ///< ::IMGTYPE_UINT8 scratch image
+    image_t *dst16;    ///< ::IMGTYPE_INT16 destination image
+    image_t *ii;       ///< ::IMGTYPE_UINT32 integral image of gray
+    image_t *bits;     ///< ::IMGTYPE_BINARY copy of binary
+    image_t *dstbits;  ///< ::IMGTYPE_BINARY destination image
+
+    image_t *msk8;     ///< 3x3 ::IMGTYPE_UINT8 mask
+    image_t *msk16;    ///< 3x3 ::IMGTYPE_INT16 mask
+    image_t *msk15;    ///< 15x15 ::IMGTYPE_INT16 rank-1 mask
+    image_t *row15;    ///< 15x1 ::IMGTYPE_INT16 row mask of msk15
+    image_t *col15;    ///< 1x15 ::IMGTYPE_INT16 column mask of msk15
+    image_t *disk15;   ///< 15x15 ::IMGTYPE_INT16 disk mask, not rank-1
+    image_t *tpl;      ///< 32x32 ::IMGTYPE_UINT8 crop of the center of gray
+    image_t *scores;   ///< ::IMGTYPE_FLOAT scores of tpl in gray
+
+    TreeNode *tree;    ///< Huffman tree of the binary image
+    uint8_t *encoded;  ///< Huffman encoded binary image
+    size_t encoded_size; ///< Number of bytes in encoded
+    uint32_t *stack;   ///< Edge tracker stack of canny(), one element per pixel
+    float *transfer;   ///< Transfer function of notch
+    frequency_params_t notch_params; ///< Parameters of notch
+    frequency_filter_t notch; ///< Notch filter for periodic noise in gray
+    rng_t rng;         ///< Generator of the noise benchmarks, fixed seed
+    float *noise;      ///< Scratch buffer of one float per pixel
+
+}bench_fixture_t;
+
+/// Describes a single operator benchmark
+typedef struct
+{
+    const char *name;  ///< Name of the benchmark, usually the operator name
+    const char *group; ///< Operator module the benchmark belongs to
+    uint32_t max_pixels; ///< The benchmark is skipped for images with more
+                         ///< pixels, 0 means no limit
+    void (*run)(bench_fixture_t *f); ///< Executes the operator once
+
+}benchmark_t;
+
+// ----------------------------------------------------------------------------
+// Function prototypes
+// ----------------------------------------------------------------------------
+/*!
+ * \brief Creates all images for benchmarks at the given resolution
+ *
+ * The images are allocated in the image arena.
+ *
+ * \param[out] f    A pointer to the fixture
+ * \param[in]  cols The number of columns
+ * \param[in]  rows The number of rows
+ */
+void createFixture(bench_fixture_t *f, const int32_t cols, const int32_t rows);
+
+/*!
+ * \brief Releases the resources of a fixture that are not in the image arena
+ *
+ * \param[in] f A pointer to the fixture
+ */
+void destroyFixture(bench_fixture_t *f);
+
+/// The table of all benchmarks
+extern const benchmark_t benchmarks[];
+
+/// The number of entries in ::benchmarks
+extern const uint32_t benchmarkCount;
+
+#endif // _BENCHMARKS_H_
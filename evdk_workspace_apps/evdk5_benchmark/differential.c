@@ -0,0 +1,624 @@
+/*! ***************************************************************************
+ *
+ * \brief     Differential tests of the fast operator variants
+ * \file      differential.c
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#include "differential.h"
+#include "main.h"
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI (3.14159265358979323846)
+#endif
+
+// ----------------------------------------------------------------------------
+// Local type definitions
+// ----------------------------------------------------------------------------
+/// Defines how the outputs of the reference and fast operator are compared
+typedef enum
+{
+    COMPARE_EXACT,    ///< Pixels must be within the tolerance
+    COMPARE_DISPLACED ///< Pixels must be within the tolerance of one of the
+                      ///< pixels in the 3x3 neighbourhood. For geometric
+                      ///< operators that round coordinates differently.
+
+}eCompare;
+
+/// The images and parameters of a single test case
+typedef struct
+{
+    image_t *src;     ///< Source image
+    image_t *ref;     ///< Destination of the reference operator
+    image_t *fast;    ///< Destination of the fast operator
+    image_t *msk;     ///< Random 3x3 ::IMGTYPE_INT16 mask
+    point_t from[4];  ///< Random quadrilateral in the source image
+
+    image_t views[3]; ///< Storage for src, ref and fast if they are views
+
+}diff_case_t;
+
+/// Describes a reference operator and its fast variant
+typedef struct
+{
+    const char *name;  ///< Name of the pair
+    eImageType type;   ///< Type of the source and destination images
+    int32_t min;       ///< Smallest generated source pixel value
+    int32_t max;       ///< Largest generated source pixel value
+    int32_t odd;       ///< Only generate images with odd dimensions
+    int32_t border;    ///< Number of border pixels that are not compared,
+                       ///< because the fast operator skips them
+    eCompare compare;  ///< How the outputs are compared
+    int32_t tolerance; ///< Maximum allowed absolute difference of a pixel
+    void (*reference)(diff_case_t *c); ///< Executes the reference operator
+    void (*fast)(diff_case_t *c);      ///< Executes the fast operator
+
+}diff_pair_t;
+
+/// The result of comparing the outputs of a single test case
+typedef struct
+{
+    uint32_t mismatches; ///< Number of pixels outside the tolerance
+    int32_t max_diff;    ///< Largest absolute difference of the compared pixels
+    int32_t x;           ///< Column of the first mismatch
+    int32_t y;           ///< Row of the first mismatch
+
+}diff_result_t;
+
+// ----------------------------------------------------------------------------
+// Operator pairs
+// ----------------------------------------------------------------------------
+static void refConvolve(diff_case_t *c)
+{
+    convolve(c->src, c->ref, c->msk);
+}
+
+static void fastConvolve(diff_case_t *c)
+{
+    convolveFast(c->src, c->fast, c->msk);
+}
+
+static void fastConvolveBorder(diff_case_t *c)
+{
+    convolveFastBorder(c->src, c->fast, c->msk, BORDER_CONSTANT, 0.0f);
+}
+
+static void refScale(diff_case_t *c)
+{
+    scale(c->src, c->ref);
+}
+
+static void fastScale(diff_case_t *c)
+{
+    scaleFast(c->src, c->fast);
+}
+
+static void refMean(diff_case_t *c)
+{
+    mean(c->src, c->ref, 3);
+}
+
+static void fastMean(diff_case_t *c)
+{
+    meanFast(c->src, c->fast);
+}
+
+/*!
+ * \brief Independent reference for the Sobel magnitude
+ *
+ * The L1 magnitude of the 3x3 Sobel gradients, calculated directly from the
+ * definition with pixels outside the image being 0. sobel(), sobelFast() and
+ * sobelFused() share a single kernel, so they are compared with this loop
+ * instead of with each other.
+ */
+static void refSobel(diff_case_t *c)
+{
+    const image_t *src = c->src;
+
+    for (int32_t y = 0; y < src->rows; y++)
+    {
+        for (int32_t x = 0; x < src->cols; x++)
+        {
+            int32_t p[3][3];
+
+            for (int32_t j = -1; j <= 1; j++)
+            {
+                for (int32_t i = -1; i <= 1; i++)
+                {
+                    int32_t inside = ((x + i) >= 0) && ((y + j) >= 0) &&
+                                     ((x + i) < src->cols) && ((y + j) < src->rows);
+
+                    p[j + 1][i + 1] = inside ? getInt16Pixel(src, x + i, y + j) : 0;
+                }
+            }
+
+            int32_t gx = (p[0][2] + (2 * p[1][2]) + p[2][2]) -
+                         (p[0][0] + (2 * p[1][0]) + p[2][0]);
+            int32_t gy = (p[2][0] + (2 * p[2][1]) + p[2][2]) -
+                         (p[0][0] + (2 * p[0][1]) + p[0][2]);
+            int32_t m = abs(gx) + abs(gy);
+
+            setInt16Pixel(c->ref, x, y, (int16_pixel_t)((m > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : m));
+        }
+    }
+}
+
+static void fastSobelBorder(diff_case_t *c)
+{
+    sobel(c->src, c->fast, NULL);
+}
+
+static void fastSobel(diff_case_t *c)
+{
+    sobelFast(c->src, c->fast);
+}
+
+static void fastSobelFused(diff_case_t *c)
+{
+    sobelFused(c->src, c->fast, NULL, MAGNITUDE_L1);
+}
+
+// warpPerspectiveFast() always maps onto the entire destination image
+static void refWarp(diff_case_t *c, const eTransformDirection d)
+{
+    const point_t to[4] =
+    {
+        {0, 0},
+        {c->ref->cols - 1, 0},
+        {c->ref->cols - 1, c->ref->rows - 1},
+        {0, c->ref->rows - 1},
+    };
+
+    warpPerspective(c->src, c->ref, c->from, to, d);
+}
+
+static void refWarpBackward(diff_case_t *c)
+{
+    refWarp(c, TRANSFORM_BACKWARD);
+}
+
+static void fastWarpBackward(diff_case_t *c)
+{
+    warpPerspectiveFast(c->src, c->fast, c->from, TRANSFORM_BACKWARD);
+}
+
+static void refWarpForward(diff_case_t *c)
+{
+    refWarp(c, TRANSFORM_FORWARD);
+}
+
+static void fastWarpForward(diff_case_t *c)
+{
+    warpPerspectiveFast(c->src, c->fast, c->from, TRANSFORM_FORWARD);
+}
+
+// rotate() is accurate to one pixel only, because sinf(M_PI) is not 0
+static void refRotate180(diff_case_t *c)
+{
+    const point_t center = {(c->src->cols - 1) / 2, (c->src->rows - 1) / 2};
+
+    rotate(c->src, c->ref, (float)M_PI, center);
+}
+
+static void fastRotate180(diff_case_t *c)
+{
+    copyUint8Image(c->src, c->fast);
+    rotate180_c(c->fast);
+}
+
+static const uint8_t mask_5x5[5 * 5] =
+{
+    0, 1, 1, 1, 0,
+    1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1,
+    0, 1, 1, 1, 0,
+};
+
+static void refErosion(diff_case_t *c)
+{
+    erosion(c->src, c->ref, mask_5x5, 5);
+}
+
+static void fastErosionBinary(diff_case_t *c)
+{
+    image_arena_mark_t mark = markImageArena();
+
+    image_t *src = newBinaryImage(c->src->cols, c->src->rows);
+    image_t *dst = newBinaryImage(c->src->cols, c->src->rows);
+
+    convertUint8ToBinary(c->src, src);
+    erosion(src, dst, mask_5x5, 5);
+    convertBinaryToUint8(dst, c->fast);
+
+    releaseImageArena(mark);
+}
+
+/// All pairs that are tested
+static const diff_pair_t pairs[] =
+{
+    {"convolve/convolveFast", IMGTYPE_INT16, -1024, 1023, 0, 1, COMPARE_EXACT, 0, refConvolve, fastConvolve},
+    {"convolve/convolveFastBorder", IMGTYPE_INT16, -1024, 1023, 0, 0, COMPARE_EXACT, 0, refConvolve, fastConvolveBorder},
+    {"scale/scaleFast", IMGTYPE_UINT8, 0, 255, 0, 0, COMPARE_EXACT, 0, refScale, fastScale},
+    {"mean/meanFast", IMGTYPE_UINT8, 0, 255, 0, 1, COMPARE_EXACT, 0, refMean, fastMean},
+    {"Sobel reference/sobel", IMGTYPE_INT16, -4096, 4095, 0, 0, COMPARE_EXACT, 0, refSobel, fastSobelBorder},
+    {"Sobel reference/sobelFast", IMGTYPE_INT16, 0, 255, 0, 1, COMPARE_EXACT, 0, refSobel, fastSobel},
+    {"Sobel reference/sobelFused", IMGTYPE_INT16, -4096, 4095, 0, 0, COMPARE_EXACT, 0, refSobel, fastSobelFused},
+    {"warpPerspective/warpPerspectiveFast backward", IMGTYPE_UINT8, 0, 255, 0, 0, COMPARE_EXACT, 0, refWarpBackward, fastWarpBackward},
+    {"warpPerspective/warpPerspectiveFast forward", IMGTYPE_UINT8, 0, 255, 0, 0, COMPARE_EXACT, 0, refWarpForward, fastWarpForward},
+    {"erosion/erosion binary", IMGTYPE_UINT8, 0, 1, 0, 0, COMPARE_EXACT, 0, refErosion, fastErosionBinary},
+    {"rotate/rotate180_c", IMGTYPE_UINT8, 0, 255, 1, 1, COMPARE_DISPLACED, 0, refRotate180, fastRotate180},
+};
+
+// ----------------------------------------------------------------------------
+// Test case generation
+// ----------------------------------------------------------------------------
+/*!
+ * \brief Deterministic pseudo random-number generator (xorshift32)
+ *
+ * \param[in,out] state Generator state, must not be 0
+ *
+ * \return A pseudo random number
+ */
+static uint32_t xorshift32(uint32_t *state)
+{
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+
+    *state = x;
+
+    return x;
+}
+
+/*!
+ * \brief Returns a pseudo random number in the range [min, max]
+ */
+static int32_t randomRange(uint32_t *state, const int32_t min, const int32_t max)
+{
+    return min + (int32_t)(xorshift32(state) % (uint32_t)(max - min + 1));
+}
+
+static int32_t getPixel(const image_t *img, const int32_t x, const int32_t y)
+{
+    return (img->type == IMGTYPE_INT16) ? getInt16Pixel(img, x, y) :
+                                          getUint8Pixel(img, x, y);
+}
+
+static void setPixel(const image_t *img, const int32_t x, const int32_t y,
+                     const int32_t value)
+{
+    if (img->type == IMGTYPE_INT16)
+    {
+        setInt16Pixel(img, x, y, (int16_pixel_t)value);
+    }
+    else
+    {
+        setUint8Pixel(img, x, y, (uint8_pixel_t)value);
+    }
+}
+
+/*!
+ * \brief Allocates an image, which is either a new image or a view on a larger
+ *        image so the stride differs from the number of columns
+ */
+static image_t *newCaseImage(uint32_t *state, const eImageType type,
+                             const int32_t cols, const int32_t rows,
+                             image_t *view)
+{
+    if ((xorshift32(state) % 4) != 0)
+    {
+        return (type == IMGTYPE_INT16) ? newInt16Image(cols, rows) :
+                                         newUint8Image(cols, rows);
+    }
+
+    int32_t pad_x = randomRange(state, 1, 16);
+    int32_t pad_y = randomRange(state, 0, 4);
+
+    image_t *parent = (type == IMGTYPE_INT16) ?
+                      newInt16Image(cols + pad_x, rows + pad_y) :
+                      newUint8Image(cols + pad_x, rows + pad_y);
+
+    if (parent == NULL)
+    {
+        return NULL;
+    }
+
+    roiImage(parent, view, randomRange(state, 0, pad_x),
+             randomRange(state, 0, pad_y), cols, rows);
+
+    return view;
+}
+
+/*!
+ * \brief Fills the source image with one of several patterns
+ *
+ * Uniform noise, a constant value, a noisy gradient and salt-and-pepper noise
+ * on a constant background are generated, so both typical images and corner
+ * cases such as a single gray value are covered.
+ */
+static void fillSource(uint32_t *state, const image_t *img, const int32_t min,
+                       const int32_t max)
+{
+    int32_t pattern = randomRange(state, 0, 3);
+    int32_t constant = randomRange(state, min, max);
+
+    for (int32_t y = 0; y < img->rows; y++)
+    {
+        for (int32_t x = 0; x < img->cols; x++)
+        {
+            int32_t p = constant;
+
+            if (pattern == 0)
+            {
+                p = randomRange(state, min, max);
+            }
+            else if (pattern == 2)
+            {
+                p = min + (((max - min) * (x + y)) / (img->cols + img->rows));
+                p += randomRange(state, -8, 8);
+                p = (p < min) ? min : ((p > max) ? max : p);
+            }
+            else if ((pattern == 3) && ((xorshift32(state) % 16) == 0))
+            {
+                p = (xorshift32(state) & 1) ? max : min;
+            }
+
+            setPixel(img, x, y, p);
+        }
+    }
+}
+
+/*!
+ * \brief Generates the images and parameters of a test case
+ *
+ * \return 0 if the case could not be allocated in the image arena
+ */
+static int32_t createCase(uint32_t *state, const diff_pair_t *p,
+                          diff_case_t *c)
+{
+    int32_t cols = randomRange(state, 3, DIFF_MAX_COLS);
+    int32_t rows = randomRange(state, 3, DIFF_MAX_ROWS);
+
+    if (p->odd)
+    {
+        cols |= 1;
+        rows |= 1;
+    }
+
+    c->src = newCaseImage(state, p->type, cols, rows, &c->views[0]);
+    c->ref = newCaseImage(state, p->type, cols, rows, &c->views[1]);
+    c->fast = newCaseImage(state, p->type, cols, rows, &c->views[2]);
+    c->msk = newInt16Image(3, 3);
+
+    if ((c->src == NULL) || (c->ref == NULL) || (c->fast == NULL) ||
+        (c->msk == NULL))
+    {
+        return 0;
+    }
+
+    fillSource(state, c->src, p->min, p->max);
+
+    for (int32_t i = 0; i < (3 * 3); i++)
+    {
+        ((int16_pixel_t *)c->msk->data)[i] = (int16_pixel_t)randomRange(state, -8, 8);
+    }
+
+    // A convex quadrilateral near the corners of the source image
+    int32_t dx = (cols - 1) / 4;
+    int32_t dy = (rows - 1) / 4;
+
+    c->from[0].x = randomRange(state, 0, dx);
+    c->from[0].y = randomRange(state, 0, dy);
+    c->from[1].x = cols - 1 - randomRange(state, 0, dx);
+    c->from[1].y = randomRange(state, 0, dy);
+    c->from[2].x = cols - 1 - randomRange(state, 0, dx);
+    c->from[2].y = rows - 1 - randomRange(state, 0, dy);
+    c->from[3].x = randomRange(state, 0, dx);
+    c->from[3].y = rows - 1 - randomRange(state, 0, dy);
+
+    // Pixels that an operator does not write must be equal in both outputs
+    int32_t background = randomRange(state, p->min, p->max);
+
+    for (int32_t y = 0; y < rows; y++)
+    {
+        for (int32_t x = 0; x < cols; x++)
+        {
+            setPixel(c->ref, x, y, background);
+            setPixel(c->fast, x, y, background);
+        }
+    }
+
+    return 1;
+}
+
+// ----------------------------------------------------------------------------
+// Comparison
+// ----------------------------------------------------------------------------
+/*!
+ * \brief Returns the smallest absolute difference between \p value and the
+ *        pixels in the 3x3 neighbourhood of (x,y)
+ */
+static int32_t neighbourhoodDiff(const image_t *img, const int32_t x,
+                                 const int32_t y, const int32_t value)
+{
+    int32_t diff = INT32_MAX;
+
+    for (int32_t j = -1; j <= 1; j++)
+    {
+        for (int32_t i = -1; i <= 1; i++)
+        {
+            if (((x + i) >= 0) && ((y + j) >= 0) &&
+                ((x + i) < img->cols) && ((y + j) < img->rows))
+            {
+                int32_t d = abs(getPixel(img, x + i, y + j) - value);
+                diff = (d < diff) ? d : diff;
+            }
+        }
+    }
+
+    return diff;
+}
+
+static void compareCase(const diff_pair_t *p, const diff_case_t *c,
+                        diff_result_t *r)
+{
+    const int32_t b = p->border;
+
+    r->mismatches = 0;
+    r->max_diff = 0;
+    r->x = -1;
+    r->y = -1;
+
+    for (int32_t y = b; y < (c->ref->rows - b); y++)
+    {
+        for (int32_t x = b; x < (c->ref->cols - b); x++)
+        {
+            int32_t v_ref = getPixel(c->ref, x, y);
+            int32_t v_fast = getPixel(c->fast, x, y);
+            int32_t diff = abs(v_ref - v_fast);
+
+            // Either output may be displaced by one pixel
+            if ((p->compare == COMPARE_DISPLACED) && (diff > p->tolerance))
+            {
+                int32_t d1 = neighbourhoodDiff(c->fast, x, y, v_ref);
+                int32_t d2 = neighbourhoodDiff(c->ref, x, y, v_fast);
+
+                diff = (d1 < d2) ? d1 : d2;
+            }
+
+            r->max_diff = (diff > r->max_diff) ? diff : r->max_diff;
+
+            if (diff > p->tolerance)
+            {
+                if (r->mismatches == 0)
+                {
+                    r->x = x;
+                    r->y = y;
+                }
+
+                r->mismatches++;
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Function implementation
+// ----------------------------------------------------------------------------
+uint32_t runDifferential(const char *filter, const uint32_t cases,
+                         const uint32_t seed)
+{
+    uint32_t failed = 0;
+
+    printf("EVDK DIFFERENTIAL TESTS\n\n");
+    printf("%u cases per pair, seed %u, images up to %dx%d\n\n",
+           cases, seed, DIFF_MAX_COLS, DIFF_MAX_ROWS);
+    printf("%-46s %8s %8s %8s %12s %12s %8s\n", "pair", "cases", "failed",
+           "max diff", "ref [us]", "fast [us]", "speedup");
+
+    for (uint32_t i = 0; i < (sizeof(pairs) / sizeof(diff_pair_t)); i++)
+    {
+        const diff_pair_t *p = &pairs[i];
+
+        if ((filter != NULL) && (strstr(p->name, filter) == NULL))
+        {
+            continue;
+        }
+
+        // Every pair has its own generator, so a failing case can be
+        // reproduced with a filter
+        uint32_t state = (seed + ((i + 1) * 0x9E3779B9u)) | 1;
+
+        uint32_t failures = 0;
+        int32_t max_diff = 0;
+        uint64_t t_ref = 0;
+        uint64_t t_fast = 0;
+
+        for (uint32_t n = 0; n < cases; n++)
+        {
+            image_arena_mark_t mark = markImageArena();
+
+            diff_case_t c;
+
+            if (createCase(&state, p, &c) == 0)
+            {
+                printf("Could not allocate test case %u\n", n);
+                releaseImageArena(mark);
+                break;
+            }
+
+            uint64_t t0 = benchNow();
+            p->reference(&c);
+            uint64_t t1 = benchNow();
+            p->fast(&c);
+            uint64_t t2 = benchNow();
+
+            t_ref += t1 - t0;
+            t_fast += t2 - t1;
+
+            diff_result_t r;
+            compareCase(p, &c, &r);
+
+            max_diff = (r.max_diff > max_diff) ? r.max_diff : max_diff;
+
+            if (r.mismatches != 0)
+            {
+                // Only report the first failing case of a pair
+                if (failures == 0)
+                {
+                    printf("%s: case %u (%dx%d) has %u mismatching pixels, "
+                           "first at (%d,%d): reference %d, fast %d\n",
+                           p->name, n, c.src->cols, c.src->rows,
+                           r.mismatches, r.x, r.y,
+                           getPixel(c.ref, r.x, r.y), getPixel(c.fast, r.x, r.y));
+                }
+
+                failures++;
+            }
+
+            releaseImageArena(mark);
+        }
+
+        printf("%-46s %8u %8u %8d %12.1f %12.1f %7.2fx\n",
+               p->name, cases, failures, max_diff, t_ref / 1e3, t_fast / 1e3,
+               (t_fast > 0) ? ((double)t_ref / (double)t_fast) : 0.0);
+
+        failed += (failures != 0) ? 1 : 0;
+    }
+
+    printf("\n%u pairs failed\n", failed);
+
+    return failed;
+}
@@ -0,0 +1,71 @@
+/*! ***************************************************************************
+ *
+ * \brief     Differential tests of the fast operator variants
+ * \file      differential.h
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifndef _DIFFERENTIAL_H_
+#define _DIFFERENTIAL_H_
+
+#include "image.h"
+#include "operators.h"
+
+// ----------------------------------------------------------------------------
+// Defines
+// ----------------------------------------------------------------------------
+/// Default number of generated test cases per operator pair
+#define DIFF_DEFAULT_CASES (1000)
+
+/// Largest generated image
+#define DIFF_MAX_COLS (EVDK5_WIDTH)
+#define DIFF_MAX_ROWS (EVDK5_HEIGHT)
+
+// ----------------------------------------------------------------------------
+// Function prototypes
+// ----------------------------------------------------------------------------
+/*!
+ * \brief Runs the differential tests
+ *
+ * Every fast operator is compared with its reference operator on randomly
+ * generated images of random sizes. The output of both must be identical,
+ * or within the error bound of the pair. The time spent in both operators is
+ * accumulated to report the speedup of the fast operator.
+ *
+ * \param[in] filter A pointer to a string that must be part of the name of
+ *                   a pair to be tested. NULL tests all pairs.
+ * \param[in] cases  The number of test cases per pair
+ * \param[in] seed   The seed of the image generator
+ *
+ * \return The number of pairs that failed
+ */
+uint32_t runDifferential(const char *filter, const uint32_t cases,
+                         const uint32_t seed);
+
+#endif // _DIFFERENTIAL_H_
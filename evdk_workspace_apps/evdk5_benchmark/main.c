@@ -0,0 +1,361 @@
+/*! ***************************************************************************
+ *
+ * \brief     Operator benchmark suite
+ * \file      main.c
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \note      Times every operator at several resolutions and writes the
+ *            results to the console and to a JSON file, so results of
+ *            different releases can be compared.
+ *
+ *            Usage: evdk5_benchmark [options]
+ *            - --filter <text>      Only run benchmarks whose name contains
+ *                                   text
+ *            - --resolution <name>  Only run at one resolution (qqvga, vga,
+ *                                   1080p or 4k)
+ *            - --min-time <s>       Minimum time per benchmark, default 0.2
+ *            - --min-samples <n>    Minimum number of samples, default 3
+ *            - --json <file>        Output file, default evdk5_benchmark.json
+ *            - --list               List all benchmarks and exit
+ *            - --differential       Compare the fast operators with their
+ *                                   reference operators instead
+ *            - --cases <n>          Test cases per pair, default 1000
+ *            - --seed <n>           Seed of the differential tests, default 1
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "main.h"
+
+#include <math.h>
+#include <time.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+// ----------------------------------------------------------------------------
+// Local variables
+// ----------------------------------------------------------------------------
+/// All resolutions that are benchmarked
+static const bench_resolution_t resolutions[] =
+{
+    {"qqvga", 160, 120},
+    {"vga", 640, 480},
+    {"1080p", 1920, 1080},
+    {"4k", 3840, 2160},
+};
+
+/// Samples of the benchmark that is running
+static double samples[BENCH_MAX_SAMPLES];
+
+// ----------------------------------------------------------------------------
+// Function implementation
+// ----------------------------------------------------------------------------
+uint64_t benchNow(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER freq, cnt;
+
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&cnt);
+
+    return (uint64_t)((cnt.QuadPart * 1000000000.0) / freq.QuadPart);
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static int compareDouble(const void *p1, const void *p2)
+{
+    double d1 = *(const double *)p1;
+    double d2 = *(const double *)p2;
+
+    return (d1 > d2) - (d1 < d2);
+}
+
+/*!
+ * \brief Times a benchmark
+ *
+ * The benchmark is executed once to warm up caches, after which it is
+ * executed until both \p min_samples and \p min_time are reached.
+ *
+ * \param[in]  b           A pointer to the benchmark
+ * \param[in]  f           A pointer to the fixture
+ * \param[in]  min_samples Minimum number of timed executions
+ * \param[in]  min_time    Minimum total time in seconds
+ * \param[out] stats       A pointer to the resulting statistics
+ */
+static void runBenchmark(const benchmark_t *b, bench_fixture_t *f,
+                         const uint32_t min_samples, const double min_time,
+                         bench_stats_t *stats)
+{
+    // Every run releases the memory it allocated in the image arena
+    image_arena_mark_t mark = markImageArena();
+
+    // Warm up
+    b->run(f);
+    releaseImageArena(mark);
+
+    uint32_t n = 0;
+    double total = 0.0;
+
+    while ((n < BENCH_MAX_SAMPLES) &&
+           ((n < min_samples) || (total < (min_time * 1e9))))
+    {
+        uint64_t t0 = benchNow();
+        b->run(f);
+        uint64_t t1 = benchNow();
+
+        releaseImageArena(mark);
+
+        samples[n] = (double)(t1 - t0);
+        total += samples[n];
+        n++;
+    }
+
+    // Calculate the statistics
+    stats->samples = n;
+    stats->mean_ns = total / n;
+    stats->variance_ns2 = 0.0;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        double d = samples[i] - stats->mean_ns;
+        stats->variance_ns2 += d * d;
+    }
+
+    stats->variance_ns2 = (n > 1) ? (stats->variance_ns2 / (n - 1)) : 0.0;
+    stats->stddev_ns = sqrt(stats->variance_ns2);
+
+    qsort(samples, n, sizeof(double), compareDouble);
+
+    stats->min_ns = samples[0];
+    stats->max_ns = samples[n - 1];
+    stats->median_ns = ((n % 2) == 1) ? samples[n / 2] :
+                       ((samples[(n / 2) - 1] + samples[n / 2]) / 2.0);
+}
+
+static void printUsage(void)
+{
+    printf("Usage: evdk5_benchmark [options]\n");
+    printf("  --filter <text>      Only run benchmarks whose name contains text\n");
+    printf("  --resolution <name>  Only run at one resolution (qqvga, vga, 1080p or 4k)\n");
+    printf("  --min-time <s>       Minimum time per benchmark, default 0.2\n");
+    printf("  --min-samples <n>    Minimum number of samples, default 3\n");
+    printf("  --json <file>        Output file, default evdk5_benchmark.json\n");
+    printf("  --list               List all benchmarks and exit\n");
+    printf("  --differential       Compare the fast operators with their reference operators instead\n");
+    printf("  --cases <n>          Test cases per pair, default %d\n", DIFF_DEFAULT_CASES);
+    printf("  --seed <n>           Seed of the differential tests, default 1\n");
+}
+
+// ----------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    const char *filter = NULL;
+    const char *resolution = NULL;
+    const char *json_path = "evdk5_benchmark.json";
+    double min_time = 0.2;
+    uint32_t min_samples = 3;
+    uint32_t differential = 0;
+    uint32_t cases = DIFF_DEFAULT_CASES;
+    uint32_t seed = 1;
+
+    // Parse the command line
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--filter") == 0) && (i + 1 < argc))
+        {
+            filter = argv[++i];
+        }
+        else if ((strcmp(argv[i], "--resolution") == 0) && (i + 1 < argc))
+        {
+            resolution = argv[++i];
+        }
+        else if ((strcmp(argv[i], "--min-time") == 0) && (i + 1 < argc))
+        {
+            min_time = atof(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "--min-samples") == 0) && (i + 1 < argc))
+        {
+            min_samples = (uint32_t)atoi(argv[++i]);
+            min_samples = (min_samples < 1) ? 1 : min_samples;
+        }
+        else if ((strcmp(argv[i], "--json") == 0) && (i + 1 < argc))
+        {
+            json_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--differential") == 0)
+        {
+            differential = 1;
+        }
+        else if ((strcmp(argv[i], "--cases") == 0) && (i + 1 < argc))
+        {
+            cases = (uint32_t)atoi(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "--seed") == 0) && (i + 1 < argc))
+        {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--list") == 0)
+        {
+            for (uint32_t b = 0; b < benchmarkCount; b++)
+            {
+                printf("%-24s %s\n", benchmarks[b].group, benchmarks[b].name);
+            }
+
+            return 0;
+        }
+        else
+        {
+            printUsage();
+            return (strcmp(argv[i], "--help") == 0) ? 0 : 1;
+        }
+    }
+
+    if (differential)
+    {
+        return (runDifferential(filter, cases, seed) == 0) ? 0 : 1;
+    }
+
+    FILE *json = fopen(json_path, "w");
+
+    if (json == NULL)
+    {
+        printf("Unable to open %s\n", json_path);
+        return 1;
+    }
+
+    printf("EVDK OPERATOR BENCHMARKS\n\n");
+
+    // Write the header
+    time_t now = time(NULL);
+    char date[32];
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    fprintf(json, "{\n");
+    fprintf(json, "  \"suite\": \"evdk5_benchmark\",\n");
+    fprintf(json, "  \"schema\": 1,\n");
+    fprintf(json, "  \"date\": \"%s\",\n", date);
+#if defined(__VERSION__)
+    fprintf(json, "  \"compiler\": \"%s\",\n", __VERSION__);
+#else
+    fprintf(json, "  \"compiler\": \"unknown\",\n");
+#endif
+    fprintf(json, "  \"min_time_s\": %g,\n", min_time);
+    fprintf(json, "  \"min_samples\": %u,\n", min_samples);
+    fprintf(json, "  \"results\": [");
+
+    // The fixtures at 4K do not fit in the default arena
+    initImageArena(NULL, BENCH_ARENA_SIZE);
+
+    uint32_t first = 1;
+
+    for (uint32_t r = 0; r < (sizeof(resolutions) / sizeof(bench_resolution_t)); r++)
+    {
+        const bench_resolution_t *res = &resolutions[r];
+
+        if ((resolution != NULL) && (strcmp(resolution, res->name) != 0))
+        {
+            continue;
+        }
+
+        const uint32_t pixels = (uint32_t)(res->cols * res->rows);
+
+        printf("%s (%dx%d)\n", res->name, res->cols, res->rows);
+        printf("%-28s %8s %12s %10s %10s %8s\n",
+               "operator", "samples", "mean [us]", "ns/pixel", "Mpixel/s", "cv [%]");
+
+        image_arena_mark_t mark = markImageArena();
+
+        bench_fixture_t f;
+        createFixture(&f, res->cols, res->rows);
+
+        for (uint32_t b = 0; b < benchmarkCount; b++)
+        {
+            const benchmark_t *bm = &benchmarks[b];
+
+            if ((filter != NULL) && (strstr(bm->name, filter) == NULL))
+            {
+                continue;
+            }
+
+            fprintf(json, "%s\n    {\"name\": \"%s\", \"group\": \"%s\", "
+                          "\"resolution\": \"%s\", \"cols\": %d, \"rows\": %d, ",
+                    first ? "" : ",", bm->name, bm->group,
+                    res->name, res->cols, res->rows);
+            first = 0;
+
+            if ((bm->max_pixels != 0) && (pixels > bm->max_pixels))
+            {
+                printf("%-28s %8s\n", bm->name, "skipped");
+                fprintf(json, "\"skipped\": true}");
+                continue;
+            }
+
+            bench_stats_t s;
+            runBenchmark(bm, &f, min_samples, min_time, &s);
+
+            double ns_per_pixel = s.mean_ns / pixels;
+            double mpixels_per_s = (pixels * 1e3) / s.mean_ns;
+
+            printf("%-28s %8u %12.1f %10.3f %10.2f %8.2f\n",
+                   bm->name, s.samples, s.mean_ns / 1e3, ns_per_pixel,
+                   mpixels_per_s, (100.0 * s.stddev_ns) / s.mean_ns);
+
+            fprintf(json, "\"skipped\": false, \"samples\": %u, "
+                          "\"mean_ns\": %.1f, \"median_ns\": %.1f, "
+                          "\"min_ns\": %.1f, \"max_ns\": %.1f, "
+                          "\"stddev_ns\": %.1f, \"variance_ns2\": %.1f, "
+                          "\"ns_per_pixel\": %.4f, \"mpixels_per_s\": %.3f}",
+                    s.samples, s.mean_ns, s.median_ns, s.min_ns, s.max_ns,
+                    s.stddev_ns, s.variance_ns2, ns_per_pixel, mpixels_per_s);
+            fflush(json);
+        }
+
+        destroyFixture(&f);
+        releaseImageArena(mark);
+
+        printf("\n");
+    }
+
+    fprintf(json, "\n  ]\n}\n");
+    fclose(json);
+
+    printf("Results written to %s\n", json_path);
+
+    return 0;
+}
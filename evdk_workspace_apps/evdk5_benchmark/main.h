@@ -0,0 +1,90 @@
+/*! ***************************************************************************
+ *
+ * \brief     Operator benchmark suite
+ * \file      main.h
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+
+#ifndef _MAIN_H_
+#define _MAIN_H_
+
+#include "stdio.h"
+#include "string.h"
+
+#include "image.h"
+#include "operators.h"
+
+#include "benchmarks.h"
+#include "differential.h"
+
+// ----------------------------------------------------------------------------
+// Defines
+// ----------------------------------------------------------------------------
+/// Size of the image arena, large enough for all 4K fixture images
+#define BENCH_ARENA_SIZE (512 * 1024 * 1024)
+
+/// Maximum number of samples per benchmark
+#define BENCH_MAX_SAMPLES (1000)
+
+// ----------------------------------------------------------------------------
+// Type definitions
+// ----------------------------------------------------------------------------
+/// Defines an image resolution
+typedef struct
+{
+    const char *name; ///< Name of the resolution
+    int32_t cols;     ///< Number of columns
+    int32_t rows;     ///< Number of rows
+
+}bench_resolution_t;
+
+/// Timing statistics of a benchmark at one resolution
+typedef struct
+{
+    uint32_t samples;    ///< Number of timed executions
+    double mean_ns;      ///< Mean execution time
+    double median_ns;    ///< Median execution time
+    double min_ns;       ///< Fastest execution time
+    double max_ns;       ///< Slowest execution time
+    double variance_ns2; ///< Sample variance of the execution time
+    double stddev_ns;    ///< Sample standard deviation of the execution time
+
+}bench_stats_t;
+
+// ----------------------------------------------------------------------------
+// Function prototypes
+// ----------------------------------------------------------------------------
+/*!
+ * \brief Returns a monotonic timestamp in nanoseconds
+ *
+ * \return The timestamp
+ */
+uint64_t benchNow(void);
+
+#endif // _MAIN_H_
@@ -182,9 +182,10 @@ int main(void)
 void drawHistogram(image_t *src, image_t *dst)
 {
     uint32_t hist[256] = {0};
+    histogram_stats_t stats;
 
-    // Calculate the histogram
-    histogram(src, hist);
+    // Calculate the histogram and the min and max gray values
+    histogramStats(src, NULL, hist, &stats);
 
     // Normalize
 
@@ -246,22 +247,9 @@ void drawHistogram(image_t *src, image_t *dst)
     textSetUint8Colors(255, 0);
     textPutstring(dst, str);
 
-    // Find min and max gray values in the original histogram
-    histogram(src, hist);
-    uint8_pixel_t min_gray = 0;
-    uint8_pixel_t max_gray = 255;
-
-    int i = 0;
-    while (hist[i++] == 0)
-    {
-    }
-    min_gray = i - 1;
-
-    i = 255;
-    while (hist[i--] == 0)
-    {
-    }
-    max_gray = i + 1;
+    // Show the min and max gray values of the original image
+    uint8_pixel_t min_gray = (uint8_pixel_t)stats.min;
+    uint8_pixel_t max_gray = (uint8_pixel_t)stats.max;
 
     sprintf(str, "%d  %d", min_gray, max_gray);
 
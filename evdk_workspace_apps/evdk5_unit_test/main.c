@@ -82,6 +82,9 @@ int main(void)
 #ifndef TEST_ASSIGNMENTS_ONLY
     RUN_TEST(test_brightness);
     RUN_TEST(test_histogram);
+    RUN_TEST(test_histogramStats);
+    RUN_TEST(test_histogramBgr888);
+    RUN_TEST(test_histogramInt16);
 #endif
     // printf("\n");
 
@@ -91,6 +94,16 @@ int main(void)
     RUN_TEST(test_convolveFast);
 #ifndef TEST_ASSIGNMENTS_ONLY
     RUN_TEST(test_convolve);
+    RUN_TEST(test_convolveSeparable);
+    RUN_TEST(test_convolveLargeMask);
+    RUN_TEST(test_convolveFastBorder);
+    RUN_TEST(test_roiImage);
+    RUN_TEST(test_imageArena);
+    RUN_TEST(test_newAlignedImage);
+    RUN_TEST(test_convertUyvyToBgr888Fast);
+    RUN_TEST(test_lumaView);
+    RUN_TEST(test_integralImage);
+    RUN_TEST(test_squaredIntegralImage);
 #endif
     // printf("\n");
 
@@ -115,12 +128,16 @@ int main(void)
     RUN_TEST(test_hitmiss);
     RUN_TEST(test_removeBorderBlobsIterative);
     RUN_TEST(test_skeleton);
+    RUN_TEST(test_binaryMorphology);
+    RUN_TEST(test_thinning);
 #endif
     // printf("\n");
 
     printf("NOISE\n");
 #ifndef TEST_ASSIGNMENTS_ONLY
-// RUN_TEST();
+    RUN_TEST(test_rng);
+    RUN_TEST(test_rngGaussian);
+    RUN_TEST(test_noiseRng);
 #endif
     // printf("\n");
 
@@ -130,10 +147,21 @@ int main(void)
     RUN_TEST(test_harmonic);
     RUN_TEST(test_maximum);
     RUN_TEST(test_mean);
+    RUN_TEST(test_meanLargeWindow);
     RUN_TEST(test_median);
+    RUN_TEST(test_medianLargeWindow);
     RUN_TEST(test_midpoint);
     RUN_TEST(test_minimum);
     RUN_TEST(test_range);
+    RUN_TEST(test_runningMinMax);
+#endif
+    // printf("\n");
+
+    printf("PYRAMIDS\n");
+#ifndef TEST_ASSIGNMENTS_ONLY
+    RUN_TEST(test_pyrDown);
+    RUN_TEST(test_pyrUp);
+    RUN_TEST(test_laplacianPyramid);
 #endif
     // printf("\n");
 
@@ -144,6 +172,7 @@ int main(void)
     RUN_TEST(test_threshold);
     RUN_TEST(test_thresholdOptimum);
     RUN_TEST(test_lineDetector);
+    RUN_TEST(test_canny);
 #endif
     // printf("\n");
 
@@ -153,18 +182,36 @@ int main(void)
     RUN_TEST(test_gaussianFilter);
     RUN_TEST(test_laplacian);
     RUN_TEST(test_sobel);
+    RUN_TEST(test_sobelFused);
 #endif
     // printf("\n");
 
     printf("SPATIAL FREQUENCY FILTERS\n");
 #ifndef TEST_ASSIGNMENTS_ONLY
-// RUN_TEST();
+    RUN_TEST(test_initFrequencyFilter);
+    RUN_TEST(test_frequencyFilter);
+#endif
+    // printf("\n");
+
+    printf("TEMPLATE MATCHING\n");
+#ifndef TEST_ASSIGNMENTS_ONLY
+    RUN_TEST(test_matchTemplate);
+    RUN_TEST(test_findBestMatches);
+    RUN_TEST(test_matchTemplateCoarseToFine);
 #endif
     // printf("\n");
 
     printf("TRANSFORMS\n");
 #ifndef TEST_ASSIGNMENTS_ONLY
-// RUN_TEST();
+    RUN_TEST(test_fft2d);
+    RUN_TEST(test_fft2dReal);
+#endif
+    // printf("\n");
+
+    printf("TRACE\n");
+#if !defined(TEST_ASSIGNMENTS_ONLY) && (EVDK_TRACE == 1)
+    RUN_TEST(test_traceEvents);
+    RUN_TEST(test_traceWriteChrome);
 #endif
     // printf("\n");
 
@@ -201,6 +248,19 @@ void prettyprint(const image_t *img, const char *title)
             {
                 printf("0x%04X, ", getUyvyPixel(img, c, r));
             }
+            else if (img->type == IMGTYPE_UINT32)
+            {
+                printf("%8u, ", (unsigned int)getUint32Pixel(img, c, r));
+            }
+            else if (img->type == IMGTYPE_BINARY)
+            {
+                printf("%d, ", getBinaryPixel(img, c, r));
+            }
+            else if (img->type == IMGTYPE_COMPLEX)
+            {
+                complex_pixel_t p = getComplexPixel(img, c, r);
+                printf("%8.3f%+8.3fi, ", p.real, p.imaginary);
+            }
             else
             {
                 printf("Image type not supported\n");
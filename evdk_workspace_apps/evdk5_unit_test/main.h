@@ -47,10 +47,14 @@
 #include "test_image_fundamentals.h"
 #include "test_mensuration.h"
 #include "test_morphological_filters.h"
+#include "test_noise.h"
 #include "test_nonlinear_filters.h"
+#include "test_pyramids.h"
 #include "test_segmentation.h"
 #include "test_spatial_filters.h"
 #include "test_spatial_frequency_filters.h"
+#include "test_template_matching.h"
+#include "test_trace.h"
 #include "test_transforms.h"
 
 // ----------------------------------------------------------------------------
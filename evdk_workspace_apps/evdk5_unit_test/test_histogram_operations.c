@@ -294,3 +294,217 @@ void test_contrast(void)
         TEST_ASSERT_EQUAL_MESSAGE(exp.rows, dst.rows, name);
     }
 }
+
+void test_histogramStats(void)
+{
+    // Runs of equal pixels and a number of columns that is not a multiple of 4
+    image_t *img = newUint8Image(37, 11);
+    image_t *mask = newUint8Image(37, 11);
+
+    for (int32_t y = 0; y < img->rows; ++y)
+    {
+        for (int32_t x = 0; x < img->cols; ++x)
+        {
+            setUint8Pixel(img, x, y, (uint8_pixel_t)(((x / 5) * 31) + (y * 3) + 20));
+            setUint8Pixel(mask, x, y, (uint8_pixel_t)(((x + y) % 3) == 0));
+        }
+    }
+
+    for (int32_t masked = 0; masked < 2; ++masked)
+    {
+        uint32_t exp[256] = {0};
+        histogram_stats_t exp_stats = {0, 255, 0, 0};
+
+        for (int32_t y = 0; y < img->rows; ++y)
+        {
+            for (int32_t x = 0; x < img->cols; ++x)
+            {
+                const uint8_pixel_t v = getUint8Pixel(img, x, y);
+
+                if ((masked == 1) && (getUint8Pixel(mask, x, y) == 0))
+                {
+                    continue;
+                }
+
+                exp[v]++;
+                exp_stats.count++;
+                exp_stats.sum += v;
+                exp_stats.min = (v < exp_stats.min) ? v : exp_stats.min;
+                exp_stats.max = (v > exp_stats.max) ? v : exp_stats.max;
+            }
+        }
+
+        uint32_t hist[256];
+        histogram_stats_t stats;
+
+        histogramStats(img, (masked == 1) ? mask : NULL, hist, &stats);
+
+        const char *name = (masked == 1) ? "masked" : "not masked";
+        TEST_ASSERT_EQUAL_UINT32_ARRAY_MESSAGE(exp, hist, 256, name);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(exp_stats.count, stats.count, name);
+        TEST_ASSERT_EQUAL_INT32_MESSAGE(exp_stats.min, stats.min, name);
+        TEST_ASSERT_EQUAL_INT32_MESSAGE(exp_stats.max, stats.max, name);
+        TEST_ASSERT_EQUAL_INT64_MESSAGE(exp_stats.sum, stats.sum, name);
+    }
+
+    // A luma view of a region of interest
+    image_t *uyvy = newUyvyImage(10, 6);
+    image_t luma;
+    image_t roi;
+
+    for (int32_t y = 0; y < uyvy->rows; ++y)
+    {
+        for (int32_t x = 0; x < uyvy->cols; ++x)
+        {
+            setUyvyPixel(uyvy, x, y, (uyvy_pixel_t)(((x + (10 * y)) << 8) | 0x80));
+        }
+    }
+
+    lumaView(uyvy, &luma);
+    roiImage(&luma, &roi, 2, 1, 7, 3);
+
+    uint32_t hist[256];
+    histogram_stats_t stats;
+
+    histogramStats(&roi, NULL, hist, &stats);
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(21, stats.count, "luma view count");
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(12, stats.min, "luma view min");
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(38, stats.max, "luma view max");
+    TEST_ASSERT_EQUAL_INT64_MESSAGE((12 + 22 + 32) * 7 + (3 * 21), stats.sum, "luma view sum");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, hist[25], "luma view bin");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, hist[0x80], "luma view counts chroma");
+
+    // Nothing is counted with an empty mask
+    memset(mask->data, 0, (size_t)mask->cols * mask->rows);
+    histogramStats(img, mask, hist, &stats);
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, stats.count, "empty mask count");
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(0, stats.min, "empty mask min");
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(0, stats.max, "empty mask max");
+
+    deleteUyvyImage(uyvy);
+    deleteUint8Image(mask);
+    deleteUint8Image(img);
+}
+
+void test_histogramBgr888(void)
+{
+    image_t *img = newBgr888Image(13, 7);
+    image_t *mask = newUint8Image(13, 7);
+
+    uint32_t exp[3 * 256] = {0};
+
+    for (int32_t y = 0; y < img->rows; ++y)
+    {
+        for (int32_t x = 0; x < img->cols; ++x)
+        {
+            const bgr888_pixel_t p = {(uint8_t)(x * 3), (uint8_t)(100 + y), (uint8_t)(255 - (x * y))};
+
+            setBgr888Pixel(img, x, y, p);
+            setUint8Pixel(mask, x, y, (uint8_pixel_t)(x < 9));
+
+            if (x < 9)
+            {
+                exp[p.b]++;
+                exp[256 + p.g]++;
+                exp[512 + p.r]++;
+            }
+        }
+    }
+
+    uint32_t hist[3 * 256];
+    histogram_stats_t stats[3];
+
+    histogramBgr888(img, mask, hist, stats);
+
+    TEST_ASSERT_EQUAL_UINT32_ARRAY_MESSAGE(exp, hist, 3 * 256, "histogram incorrect");
+
+    TEST_ASSERT_EQUAL_UINT32(63, stats[0].count);
+    TEST_ASSERT_EQUAL_INT32(0, stats[0].min);
+    TEST_ASSERT_EQUAL_INT32(24, stats[0].max);
+    TEST_ASSERT_EQUAL_INT64(7 * 3 * 36, stats[0].sum);
+    TEST_ASSERT_EQUAL_INT32(100, stats[1].min);
+    TEST_ASSERT_EQUAL_INT32(106, stats[1].max);
+    TEST_ASSERT_EQUAL_INT32(255 - 48, stats[2].min);
+    TEST_ASSERT_EQUAL_INT32(255, stats[2].max);
+
+    // Without a mask and without statistics
+    histogramBgr888(img, NULL, hist, NULL);
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(7, hist[36], "blue bin incorrect");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(13, hist[256 + 103], "green bin incorrect");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(19, hist[512 + 255], "red bin incorrect");
+
+    deleteUint8Image(mask);
+    deleteBgr888Image(img);
+}
+
+void test_histogramInt16(void)
+{
+    image_t *img = newInt16Image(29, 9);
+
+    for (int32_t y = 0; y < img->rows; ++y)
+    {
+        for (int32_t x = 0; x < img->cols; ++x)
+        {
+            setInt16Pixel(img, x, y, (int16_pixel_t)((x * 1103) - (y * 977) - 7000));
+        }
+    }
+
+    // Bins of unequal width, and values outside the range
+    const int16_pixel_t min = -5000;
+    const int16_pixel_t max = 20000;
+    const int32_t bins = 7;
+
+    uint32_t exp[7] = {0};
+    histogram_stats_t exp_stats = {0, INT16_MAX, INT16_MIN, 0};
+
+    for (int32_t y = 0; y < img->rows; ++y)
+    {
+        for (int32_t x = 0; x < img->cols; ++x)
+        {
+            const int32_t v = getInt16Pixel(img, x, y);
+            const int32_t c = (v < min) ? min : ((v > max) ? max : v);
+
+            exp[((c - min) * bins) / (max - min + 1)]++;
+            exp_stats.count++;
+            exp_stats.sum += v;
+            exp_stats.min = (v < exp_stats.min) ? v : exp_stats.min;
+            exp_stats.max = (v > exp_stats.max) ? v : exp_stats.max;
+        }
+    }
+
+    uint32_t hist[7];
+    histogram_stats_t stats;
+
+    histogramInt16(img, NULL, min, max, bins, hist, &stats);
+
+    TEST_ASSERT_EQUAL_UINT32_ARRAY_MESSAGE(exp, hist, 7, "histogram incorrect");
+    TEST_ASSERT_EQUAL_UINT32(exp_stats.count, stats.count);
+    TEST_ASSERT_EQUAL_INT32(exp_stats.min, stats.min);
+    TEST_ASSERT_EQUAL_INT32(exp_stats.max, stats.max);
+    TEST_ASSERT_EQUAL_INT64(exp_stats.sum, stats.sum);
+
+    // One bin per value over the full range
+    image_t *full = newInt16Image(4, 1);
+    setInt16Pixel(full, 0, 0, INT16_MIN);
+    setInt16Pixel(full, 1, 0, -1);
+    setInt16Pixel(full, 2, 0, 0);
+    setInt16Pixel(full, 3, 0, INT16_MAX);
+
+    uint32_t *all = (uint32_t *)malloc(65536 * sizeof(uint32_t));
+
+    histogramInt16(full, NULL, INT16_MIN, INT16_MAX, 65536, all, &stats);
+
+    TEST_ASSERT_EQUAL_UINT32(1, all[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, all[32767]);
+    TEST_ASSERT_EQUAL_UINT32(1, all[32768]);
+    TEST_ASSERT_EQUAL_UINT32(1, all[65535]);
+    TEST_ASSERT_EQUAL_UINT32(0, all[32769]);
+    TEST_ASSERT_EQUAL_INT64(-2, stats.sum);
+
+    free(all);
+    deleteInt16Image(full);
+    deleteInt16Image(img);
+}
@@ -37,6 +37,15 @@
 /// \brief Unit test function for histogram()
 void test_histogram(void);
 
+/// \brief Unit test function for histogramStats()
+void test_histogramStats(void);
+
+/// \brief Unit test function for histogramBgr888()
+void test_histogramBgr888(void);
+
+/// \brief Unit test function for histogramInt16()
+void test_histogramInt16(void);
+
 /// \brief Unit test function for brightness()
 void test_brightness(void);
 
@@ -3425,3 +3425,1117 @@ void test_convolveFast(void)
         TEST_ASSERT_EQUAL_MESSAGE(exp.rows, dst.rows, name);
     }
 }
+
+void test_roiImage(void)
+{
+    uint8_pixel_t src_data[12 * 8] =
+    {
+        10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,
+        10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,
+        10,  10, 200, 200,  10,  10,  10,  10,  10,  10,  10,  10,
+        10,  10, 200, 200,  10,  10,  10,  10,  10,  10,  10,  10,
+        10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,
+        10,  10,  10,  10,  10,  10,  10,  10,  10, 200, 200,  10,
+        10,  10,  10,  10,  10,  10,  10,  10,  10, 200, 200,  10,
+        10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,  10,
+    };
+
+    uint8_pixel_t exp_data[12 * 8] =
+    {
+        99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,
+        99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,
+        99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,
+        99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,
+        99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,  99,
+        99,  99,  99,  99,  99,  99,   0,   0,   0,   1,   1,  99,
+        99,  99,  99,  99,  99,  99,   0,   0,   0,   1,   1,  99,
+        99,  99,  99,  99,  99,  99,   0,   0,   0,   0,   0,  99,
+    };
+
+    uint8_pixel_t dst_data[12 * 8];
+
+    // Prepare images
+    image_t src = {12, 8, IMGTYPE_UINT8, src_data};
+    image_t dst = {12, 8, IMGTYPE_UINT8, dst_data};
+
+    for (uint32_t i = 0; i < (12 * 8); ++i)
+    {
+        dst_data[i] = 99;
+    }
+
+    // Create views on the bottom-right corner of both images
+    image_t src_roi;
+    image_t dst_roi;
+
+    roiImage(&src, &src_roi, 6, 5, 5, 3);
+    roiImage(&dst, &dst_roi, 6, 5, 5, 3);
+
+    // Verify the view
+    TEST_ASSERT_EQUAL_MESSAGE(5, src_roi.cols, "roi cols incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(3, src_roi.rows, "roi rows incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(12, src_roi.stride, "roi stride incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(200, getUint8Pixel(&src_roi, 3, 0), "roi pixel incorrect");
+
+    // A view of a view keeps the stride of the parent image
+    image_t roi_roi;
+    roiImage(&src_roi, &roi_roi, 3, 0, 2, 2);
+    TEST_ASSERT_EQUAL_MESSAGE(12, roi_roi.stride, "roi of roi stride incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(200, getUint8Pixel(&roi_roi, 0, 0), "roi of roi pixel incorrect");
+
+    // Execute the operator on the views only
+    threshold(&src_roi, &dst_roi, 100, 255);
+
+    // Verify the result, pixels outside the view must be untouched
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp_data, dst_data, (12 * 8), "threshold on view incorrect");
+
+    // Copying a view into a contiguous image
+    uint8_pixel_t cpy_data[2 * 2];
+    image_t cpy = {2, 2, IMGTYPE_UINT8, cpy_data};
+    uint8_pixel_t cpy_exp[2 * 2] = {200, 200, 200, 200};
+
+    roiImage(&src, &src_roi, 2, 2, 2, 2);
+    copyUint8Image(&src_roi, &cpy);
+
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(cpy_exp, cpy_data, (2 * 2), "copy of view incorrect");
+}
+
+void test_imageArena(void)
+{
+    // Use a small static buffer for the arena during this test
+    static uint8_t buffer[4096];
+
+    initImageArena(buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_MESSAGE(0, getImageArenaUsage(), "arena not empty after init");
+
+    // Images are allocated from the buffer
+    image_t *a = newUint8Image(12, 8);
+    image_t *b = newInt16Image(12, 8);
+    image_t *c = newEmptyUint8Image(12, 8);
+
+    TEST_ASSERT_NOT_NULL_MESSAGE(a, "image a not allocated");
+    TEST_ASSERT_NOT_NULL_MESSAGE(b, "image b not allocated");
+    TEST_ASSERT_NOT_NULL_MESSAGE(c, "image c not allocated");
+    TEST_ASSERT_TRUE_MESSAGE((a->data >= buffer) && (a->data < (buffer + sizeof(buffer))), "image a data not in arena");
+    TEST_ASSERT_TRUE_MESSAGE((b->data >= buffer) && (b->data < (buffer + sizeof(buffer))), "image b data not in arena");
+    TEST_ASSERT_NULL_MESSAGE(c->data, "empty image has data");
+    TEST_ASSERT_EQUAL_MESSAGE(12, a->stride, "image a stride incorrect");
+
+    size_t used_a = (size_t)(b->data - buffer);
+    TEST_ASSERT_TRUE_MESSAGE(used_a >= (12 * 8), "image data overlaps");
+
+    // Deleting an image that is not on top only marks it as deleted
+    size_t used = getImageArenaUsage();
+    deleteInt16Image(b);
+    TEST_ASSERT_EQUAL_MESSAGE(used, getImageArenaUsage(), "memory returned too early");
+
+    // Deleting the top image also returns the images below it that were
+    // already deleted
+    deleteUint8Image(c);
+    TEST_ASSERT_TRUE_MESSAGE(getImageArenaUsage() <= used_a, "deleted images not returned");
+
+    // Per-frame allocation with a mark
+    image_arena_mark_t mark = markImageArena();
+    used = getImageArenaUsage();
+
+    for (uint32_t i = 0; i < 32; ++i)
+    {
+        image_t *tmp = newUint8Image(4, 4);
+        TEST_ASSERT_NOT_NULL_MESSAGE(tmp, "temporary image not allocated");
+
+        void *lut = allocImageArena(16);
+        TEST_ASSERT_NOT_NULL_MESSAGE(lut, "temporary buffer not allocated");
+    }
+
+    releaseImageArena(mark);
+    TEST_ASSERT_EQUAL_MESSAGE(used, getImageArenaUsage(), "mark not released");
+
+    // Image a is still valid
+    clearUint8Image(a);
+    TEST_ASSERT_EQUAL_MESSAGE(0, getUint8Pixel(a, 11, 7), "image a invalid");
+
+    deleteAllImages();
+    TEST_ASSERT_EQUAL_MESSAGE(0, getImageArenaUsage(), "arena not empty after deleteAllImages");
+
+    // Restore the default arena
+    initImageArena(NULL, IMAGE_ARENA_SIZE);
+}
+
+void test_newAlignedImage(void)
+{
+    // Strides are rounded up so that every row starts aligned
+    image_t *u8 = newAlignedImage(12, 8, IMGTYPE_UINT8, 32);
+    image_t *bgr = newAlignedImage(12, 8, IMGTYPE_BGR888, 32);
+    image_t *i16 = newAlignedImage(12, 8, IMGTYPE_INT16, 64);
+    image_t *dst = newAlignedImage(12, 8, IMGTYPE_UINT8, 64);
+
+    TEST_ASSERT_EQUAL_MESSAGE(32, u8->stride, "uint8 stride incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(32, bgr->stride, "bgr888 stride incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(32, i16->stride, "int16 stride incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(64, dst->stride, "uint8 stride incorrect");
+
+    for (int32_t r = 0; r < 8; ++r)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(0, ((uintptr_t)(u8->data + (r * u8->stride * sizeof(uint8_pixel_t)))) % 32, "uint8 row not aligned");
+        TEST_ASSERT_EQUAL_MESSAGE(0, ((uintptr_t)(bgr->data + (r * bgr->stride * sizeof(bgr888_pixel_t)))) % 32, "bgr888 row not aligned");
+        TEST_ASSERT_EQUAL_MESSAGE(0, ((uintptr_t)(i16->data + (r * i16->stride * sizeof(int16_pixel_t)))) % 64, "int16 row not aligned");
+        TEST_ASSERT_EQUAL_MESSAGE(0, ((uintptr_t)(dst->data + (r * dst->stride * sizeof(uint8_pixel_t)))) % 64, "uint8 row not aligned");
+    }
+
+    // Operators respect the padding
+    memset(u8->data, 200, (size_t)u8->stride * u8->rows);
+    memset(dst->data, 7, (size_t)dst->stride * dst->rows);
+
+    for (int32_t r = 0; r < 8; ++r)
+    {
+        for (int32_t c = 0; c < 12; ++c)
+        {
+            setUint8Pixel(u8, c, r, (uint8_pixel_t)((r * 12) + c));
+        }
+    }
+
+    threshold(u8, dst, 50, 255);
+
+    for (int32_t r = 0; r < 8; ++r)
+    {
+        for (int32_t c = 0; c < 12; ++c)
+        {
+            uint8_pixel_t exp = (((r * 12) + c) >= 50) ? 1 : 0;
+            TEST_ASSERT_EQUAL_MESSAGE(exp, getUint8Pixel(dst, c, r), "threshold on aligned image incorrect");
+        }
+
+        for (int32_t c = 12; c < 64; ++c)
+        {
+            TEST_ASSERT_EQUAL_MESSAGE(7, dst->data[(r * dst->stride) + c], "padding modified");
+        }
+    }
+
+    copyUint8Image(u8, dst);
+    TEST_ASSERT_EQUAL_MESSAGE(95, getUint8Pixel(dst, 11, 7), "copy to aligned image incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(7, dst->data[(7 * dst->stride) + 12], "padding modified by copy");
+
+    deleteUint8Image(dst);
+    deleteInt16Image(i16);
+    deleteBgr888Image(bgr);
+    deleteUint8Image(u8);
+}
+
+/*!
+ * \brief Reference implementation of the equations documented at
+ *        convertUyvyToBgr888Fast(), with coefficients derived from Kr and Kb
+ */
+static void refUyvyToBgr(const int32_t y, const int32_t u, const int32_t v,
+                         const double kr, const double kb, const int32_t limited,
+                         int32_t rgb_fixed[3], double rgb_real[3])
+{
+    const double kg = 1.0 - kr - kb;
+    const double sy = limited ? (255.0 / 219.0) : 1.0;
+    const double sc = limited ? (255.0 / 224.0) : 1.0;
+    const double k[5] =
+    {
+        sy,
+        sc * 2.0 * (1.0 - kr),
+        sc * 2.0 * kb * (1.0 - kb) / kg,
+        sc * 2.0 * kr * (1.0 - kr) / kg,
+        sc * 2.0 * (1.0 - kb),
+    };
+    int32_t q[5];
+
+    for (int32_t i = 0; i < 5; ++i)
+    {
+        q[i] = (int32_t)((k[i] * 8192.0) + 0.5);
+    }
+
+    const int32_t yy = y - (limited ? 16 : 0);
+    const int32_t uu = u - 128;
+    const int32_t vv = v - 128;
+    const int32_t sum[3] =
+    {
+        (q[0] * yy) + (q[1] * vv),
+        (q[0] * yy) - (q[2] * uu) - (q[3] * vv),
+        (q[0] * yy) + (q[4] * uu),
+    };
+    const double real[3] =
+    {
+        (k[0] * yy) + (k[1] * vv),
+        (k[0] * yy) - (k[2] * uu) - (k[3] * vv),
+        (k[0] * yy) + (k[4] * uu),
+    };
+
+    for (int32_t i = 0; i < 3; ++i)
+    {
+        // Floor division, sum can be negative
+        int32_t val = (sum[i] + 4096 + (1 << 24)) / 8192 - (1 << 11);
+        rgb_fixed[i] = (val < 0) ? 0 : ((val > 255) ? 255 : val);
+        rgb_real[i] = (real[i] < 0.0) ? 0.0 : ((real[i] > 255.0) ? 255.0 : real[i]);
+    }
+}
+
+void test_convertUyvyToBgr888Fast(void)
+{
+    const double kr[2] = {0.299, 0.2126};
+    const double kb[2] = {0.114, 0.0722};
+
+    image_t *src = newUyvyImage(256, 256);
+    image_t *dst = newBgr888Image(256, 256);
+    image_t *src_narrow = newUyvyImage(38, 3);
+    image_t *dst_narrow = newBgr888Image(38, 3);
+
+    for (int32_t m = 0; m < 2; ++m)
+    {
+        for (int32_t l = 0; l < 2; ++l)
+        {
+            int32_t rgb_fixed[3];
+            double rgb_real[3];
+
+            // All combinations of Y, U and V: Y varies per column, V per row
+            for (int32_t u = 0; u < 256; ++u)
+            {
+                for (int32_t r = 0; r < 256; ++r)
+                {
+                    for (int32_t c = 0; c < 256; ++c)
+                    {
+                        uint8_t uv = (uint8_t)(((c % 2) == 0) ? u : r);
+                        setUyvyPixel(src, c, r, (uyvy_pixel_t)((c << 8) | uv));
+                    }
+                }
+
+                convertUyvyToBgr888Fast(src, dst, (eYuvMatrix)m, (eYuvRange)l);
+
+                for (int32_t r = 0; r < 256; ++r)
+                {
+                    for (int32_t c = 0; c < 256; ++c)
+                    {
+                        refUyvyToBgr(c, u, r, kr[m], kb[m], l, rgb_fixed, rgb_real);
+
+                        bgr888_pixel_t p = getBgr888Pixel(dst, c, r);
+
+                        if ((p.r != rgb_fixed[0]) || (p.g != rgb_fixed[1]) || (p.b != rgb_fixed[2]))
+                        {
+                            TEST_FAIL_MESSAGE("Not bit-exact with the fixed-point reference");
+                        }
+
+                        if ((((double)p.r - rgb_real[0]) > 1.0) || ((rgb_real[0] - (double)p.r) > 1.0) ||
+                            (((double)p.g - rgb_real[1]) > 1.0) || ((rgb_real[1] - (double)p.g) > 1.0) ||
+                            (((double)p.b - rgb_real[2]) > 1.0) || ((rgb_real[2] - (double)p.b) > 1.0))
+                        {
+                            TEST_FAIL_MESSAGE("Differs more than 1 from the real-valued equations");
+                        }
+                    }
+                }
+            }
+
+            // A width that is not a multiple of the vector width
+            for (int32_t r = 0; r < 3; ++r)
+            {
+                for (int32_t c = 0; c < 38; ++c)
+                {
+                    uint8_t uv = (uint8_t)(((c % 2) == 0) ? (c * 7) : (r * 90));
+                    setUyvyPixel(src_narrow, c, r, (uyvy_pixel_t)(((c * 6) << 8) | uv));
+                }
+            }
+
+            memset(dst_narrow->data, 0, 38 * 3 * sizeof(bgr888_pixel_t));
+            convertUyvyToBgr888Fast(src_narrow, dst_narrow, (eYuvMatrix)m, (eYuvRange)l);
+
+            for (int32_t r = 0; r < 3; ++r)
+            {
+                for (int32_t c = 0; c < 38; ++c)
+                {
+                    int32_t c0 = c - (c % 2);
+                    refUyvyToBgr(c * 6, c0 * 7, r * 90, kr[m], kb[m], l, rgb_fixed, rgb_real);
+
+                    bgr888_pixel_t p = getBgr888Pixel(dst_narrow, c, r);
+                    TEST_ASSERT_EQUAL_MESSAGE(rgb_fixed[0], p.r, "Narrow image red incorrect");
+                    TEST_ASSERT_EQUAL_MESSAGE(rgb_fixed[1], p.g, "Narrow image green incorrect");
+                    TEST_ASSERT_EQUAL_MESSAGE(rgb_fixed[2], p.b, "Narrow image blue incorrect");
+                }
+            }
+        }
+    }
+
+    deleteBgr888Image(dst_narrow);
+    deleteUyvyImage(src_narrow);
+    deleteBgr888Image(dst);
+    deleteUyvyImage(src);
+}
+
+void test_lumaView(void)
+{
+    image_t *uyvy = newUyvyImage(8, 4);
+    image_t *dst = newUint8Image(8, 4);
+    image_t *exp = newUint8Image(8, 4);
+    image_t luma;
+
+    // Y is a gradient, U and V are set to values that are neither 0 nor 1
+    for (int32_t r = 0; r < 4; ++r)
+    {
+        for (int32_t c = 0; c < 8; ++c)
+        {
+            setUyvyPixel(uyvy, c, r, (uyvy_pixel_t)((((r * 8) + c) << 8) | 0x80));
+        }
+    }
+
+    lumaView(uyvy, &luma);
+    convertUyvyToUint8(uyvy, exp);
+
+    TEST_ASSERT_EQUAL_MESSAGE(IMGTYPE_UINT8, luma.type, "type incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(8, luma.cols, "cols incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(4, luma.rows, "rows incorrect");
+
+    // Getter
+    for (int32_t r = 0; r < 4; ++r)
+    {
+        for (int32_t c = 0; c < 8; ++c)
+        {
+            TEST_ASSERT_EQUAL_MESSAGE(getUint8Pixel(exp, c, r), getUint8PixelStrided(&luma, c, r), "getter incorrect");
+        }
+    }
+
+    // Copy
+    copyUint8Image(&luma, dst);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp->data, dst->data, 8 * 4, "copyUint8Image incorrect");
+
+    // Histogram
+    uint32_t hist[256];
+    uint32_t hist_exp[256];
+    histogram(&luma, hist);
+    histogram(exp, hist_exp);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY_MESSAGE(hist_exp, hist, 256, "histogram incorrect");
+
+    // Convolution and correlation filter the copied Y plane
+    image_t *msk = newUint8Image(3, 3);
+    image_t *cnv = newUint8Image(8, 4);
+    const uint8_pixel_t msk_data[3 * 3] = {0, 1, 0, 2, 1, 0, 0, 1, 1};
+
+    for (int32_t i = 0; i < (3 * 3); ++i)
+    {
+        msk->data[i] = msk_data[i];
+    }
+
+    convolve(&luma, dst, msk);
+    convolve(exp, cnv, msk);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(cnv->data, dst->data, 8 * 4, "convolve incorrect");
+
+    correlate(&luma, dst, msk);
+    correlate(exp, cnv, msk);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(cnv->data, dst->data, 8 * 4, "correlate incorrect");
+
+    deleteUint8Image(cnv);
+    deleteUint8Image(msk);
+
+    // Threshold and labeling
+    threshold(&luma, dst, 10, 20);
+    threshold(exp, exp, 10, 20);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(exp->data, dst->data, 8 * 4, "threshold incorrect");
+
+    // A ROI of a luma view is a luma view, the setter writes only Y
+    image_t roi;
+    roiImage(&luma, &roi, 2, 1, 4, 2);
+    TEST_ASSERT_EQUAL_MESSAGE(10, getUint8PixelStrided(&roi, 0, 0), "roi of luma view incorrect");
+
+    setUint8PixelStrided(&roi, 1, 1, 1);
+    TEST_ASSERT_EQUAL_HEX16_MESSAGE(0x0180, getUyvyPixel(uyvy, 3, 2), "setter incorrect");
+
+    // Binary Y channel
+    for (int32_t r = 0; r < 4; ++r)
+    {
+        for (int32_t c = 0; c < 8; ++c)
+        {
+            uint8_pixel_t val = ((c == 0) || (c == 7) || (c == 3)) ? 0 : 1;
+            setUyvyPixel(uyvy, c, r, (uyvy_pixel_t)((val << 8) | 0x01));
+        }
+    }
+
+    TEST_ASSERT_EQUAL_MESSAGE(2, labelIterative(&luma, dst, CONNECTED_FOUR), "labelIterative incorrect");
+
+    labelTwoPass(&luma, dst, CONNECTED_FOUR, 16);
+    TEST_ASSERT_EQUAL_MESSAGE(1, getUint8Pixel(dst, 2, 2), "labelTwoPass incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(0, getUint8Pixel(dst, 3, 2), "labelTwoPass incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(2, getUint8Pixel(dst, 4, 1), "labelTwoPass incorrect");
+
+    deleteUint8Image(exp);
+    deleteUint8Image(dst);
+    deleteUyvyImage(uyvy);
+}
+
+/*!
+ * \brief Reference implementation of convolve() for uint8_pixel_t and
+ *        int16_pixel_t images, returns the unclipped value of pixel (x,y)
+ */
+static int32_t refConvolvePixel(const image_t *src, const int32_t *m,
+                                const int32_t mcols, const int32_t mrows,
+                                const int32_t x, const int32_t y)
+{
+    int32_t val = 0;
+
+    for (int32_t j = -(mrows / 2); j <= (mrows / 2); j++)
+    {
+        for (int32_t i = -(mcols / 2); i <= (mcols / 2); i++)
+        {
+            if (((x - i) >= 0) && ((y - j) >= 0) && ((x - i) < src->cols) && ((y - j) < src->rows))
+            {
+                int32_t p = (src->type == IMGTYPE_UINT8) ? getUint8Pixel(src, x - i, y - j) : getInt16Pixel(src, x - i, y - j);
+                val += p * m[((j + (mrows / 2)) * mcols) + i + (mcols / 2)];
+            }
+        }
+    }
+
+    return val;
+}
+
+void test_convolveSeparable(void)
+{
+    // uint8_pixel_t, 5x3 mask
+    {
+        const int32_t r[5] = {1, 2, 3, 2, 1};
+        const int32_t c[3] = {1, 0, 2};
+        int32_t m[3 * 5];
+
+        image_t *src = newUint8Image(13, 9);
+        image_t *dst = newUint8Image(13, 9);
+        image_t *dst2 = newUint8Image(13, 9);
+        image_t *row = newUint8Image(5, 1);
+        image_t *col = newUint8Image(1, 3);
+        image_t *msk = newUint8Image(5, 3);
+
+        for (int32_t y = 0; y < 9; ++y)
+        {
+            for (int32_t x = 0; x < 13; ++x)
+            {
+                setUint8Pixel(src, x, y, (uint8_pixel_t)(((x * 7) + (y * 13)) % 23));
+            }
+        }
+
+        for (int32_t j = 0; j < 3; ++j)
+        {
+            setUint8Pixel(col, 0, j, (uint8_pixel_t)c[j]);
+
+            for (int32_t i = 0; i < 5; ++i)
+            {
+                setUint8Pixel(row, i, 0, (uint8_pixel_t)r[i]);
+                setUint8Pixel(msk, i, j, (uint8_pixel_t)(r[i] * c[j]));
+                m[(j * 5) + i] = r[i] * c[j];
+            }
+        }
+
+        convolveSeparable(src, dst, row, col);
+        convolve(src, dst2, msk);
+
+        for (int32_t y = 0; y < 9; ++y)
+        {
+            for (int32_t x = 0; x < 13; ++x)
+            {
+                int32_t val = refConvolvePixel(src, m, 5, 3, x, y);
+                val = (val > 255) ? 255 : val;
+
+                TEST_ASSERT_EQUAL_MESSAGE(val, getUint8Pixel(dst, x, y), "convolveSeparable uint8 incorrect");
+                TEST_ASSERT_EQUAL_MESSAGE(val, getUint8Pixel(dst2, x, y), "convolve uint8 with rank-1 mask incorrect");
+            }
+        }
+
+        deleteUint8Image(msk);
+        deleteUint8Image(col);
+        deleteUint8Image(row);
+        deleteUint8Image(dst2);
+        deleteUint8Image(dst);
+        deleteUint8Image(src);
+    }
+
+    // int16_pixel_t, 3x7 mask with negative values and clipping
+    {
+        const int32_t r[3] = {-2, 0, 4};
+        const int32_t c[7] = {1, 3, 6, 9, 6, 3, 1};
+        int32_t m[7 * 3];
+
+        image_t *src = newInt16Image(10, 11);
+        image_t *dst = newInt16Image(10, 11);
+        image_t *dst2 = newInt16Image(10, 11);
+        image_t *row = newInt16Image(3, 1);
+        image_t *col = newInt16Image(1, 7);
+        image_t *msk = newInt16Image(3, 7);
+
+        for (int32_t y = 0; y < 11; ++y)
+        {
+            for (int32_t x = 0; x < 10; ++x)
+            {
+                setInt16Pixel(src, x, y, (int16_pixel_t)((((x * 31) + (y * 17)) % 61) * ((x == 5) ? 100 : -3)));
+            }
+        }
+
+        for (int32_t j = 0; j < 7; ++j)
+        {
+            setInt16Pixel(col, 0, j, (int16_pixel_t)c[j]);
+
+            for (int32_t i = 0; i < 3; ++i)
+            {
+                setInt16Pixel(row, i, 0, (int16_pixel_t)r[i]);
+                setInt16Pixel(msk, i, j, (int16_pixel_t)(r[i] * c[j]));
+                m[(j * 3) + i] = r[i] * c[j];
+            }
+        }
+
+        convolveSeparable(src, dst, row, col);
+        convolve(src, dst2, msk);
+
+        for (int32_t y = 0; y < 11; ++y)
+        {
+            for (int32_t x = 0; x < 10; ++x)
+            {
+                int32_t val = refConvolvePixel(src, m, 3, 7, x, y);
+                val = (val > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : ((val < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : val);
+
+                TEST_ASSERT_EQUAL_MESSAGE(val, getInt16Pixel(dst, x, y), "convolveSeparable int16 incorrect");
+                TEST_ASSERT_EQUAL_MESSAGE(val, getInt16Pixel(dst2, x, y), "convolve int16 with rank-1 mask incorrect");
+            }
+        }
+
+        // A mask that is not rank-1
+        setInt16Pixel(msk, 1, 3, 5);
+        m[(3 * 3) + 1] = 5;
+        convolve(src, dst2, msk);
+
+        for (int32_t y = 0; y < 11; ++y)
+        {
+            for (int32_t x = 0; x < 10; ++x)
+            {
+                int32_t val = refConvolvePixel(src, m, 3, 7, x, y);
+                val = (val > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : ((val < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : val);
+
+                TEST_ASSERT_EQUAL_MESSAGE(val, getInt16Pixel(dst2, x, y), "convolve int16 with full mask incorrect");
+            }
+        }
+
+        deleteInt16Image(msk);
+        deleteInt16Image(col);
+        deleteInt16Image(row);
+        deleteInt16Image(dst2);
+        deleteInt16Image(dst);
+        deleteInt16Image(src);
+    }
+}
+
+void test_convolveLargeMask(void)
+{
+    // int16_pixel_t, 9x13 mask that is not rank-1, convolve and correlate
+    {
+        image_t *src = newInt16Image(70, 45);
+        image_t *dst = newInt16Image(70, 45);
+        image_t *msk = newInt16Image(9, 13);
+        int32_t m[9 * 13];
+        int32_t f[9 * 13];
+
+        for (int32_t y = 0; y < 45; ++y)
+        {
+            for (int32_t x = 0; x < 70; ++x)
+            {
+                setInt16Pixel(src, x, y, (int16_pixel_t)((((x * 37) + (y * 23) + (x * y)) % 601) - 300));
+            }
+        }
+
+        for (int32_t j = 0; j < 13; ++j)
+        {
+            for (int32_t i = 0; i < 9; ++i)
+            {
+                m[(j * 9) + i] = (((i * 7) + (j * 11) + (i * j * 3)) % 41) - 20;
+                f[((12 - j) * 9) + (8 - i)] = m[(j * 9) + i];
+                setInt16Pixel(msk, i, j, (int16_pixel_t)m[(j * 9) + i]);
+            }
+        }
+
+        convolve(src, dst, msk);
+
+        for (int32_t y = 0; y < 45; ++y)
+        {
+            for (int32_t x = 0; x < 70; ++x)
+            {
+                int32_t val = refConvolvePixel(src, m, 9, 13, x, y);
+                val = (val > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : ((val < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : val);
+
+                TEST_ASSERT_INT_WITHIN_MESSAGE(1, val, getInt16Pixel(dst, x, y), "convolve int16 with large mask incorrect");
+            }
+        }
+
+        // Correlation is convolution with the mirrored mask
+        correlate(src, dst, msk);
+
+        for (int32_t y = 0; y < 45; ++y)
+        {
+            for (int32_t x = 0; x < 70; ++x)
+            {
+                int32_t val = refConvolvePixel(src, f, 9, 13, x, y);
+                val = (val > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : ((val < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : val);
+
+                TEST_ASSERT_INT_WITHIN_MESSAGE(1, val, getInt16Pixel(dst, x, y), "correlate int16 with large mask incorrect");
+            }
+        }
+
+        // Products that are too large for single precision use the direct
+        // method, which is exact
+        setInt16Pixel(src, 35, 20, 30000);
+        setInt16Pixel(msk, 4, 6, 10000);
+        m[(6 * 9) + 4] = 10000;
+        convolve(src, dst, msk);
+
+        for (int32_t y = 0; y < 45; ++y)
+        {
+            for (int32_t x = 0; x < 70; ++x)
+            {
+                int32_t val = refConvolvePixel(src, m, 9, 13, x, y);
+                val = (val > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : ((val < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : val);
+
+                TEST_ASSERT_EQUAL_MESSAGE(val, getInt16Pixel(dst, x, y), "convolve int16 with large products incorrect");
+            }
+        }
+
+        deleteInt16Image(msk);
+        deleteInt16Image(dst);
+        deleteInt16Image(src);
+    }
+
+    // int16_pixel_t, full-scale source and a 21x9 mask near the bound of the
+    // frequency domain
+    {
+        image_t *src = newInt16Image(163, 111);
+        image_t *dst = newInt16Image(163, 111);
+        image_t *msk = newInt16Image(21, 9);
+        int32_t m[21 * 9] = {0};
+
+        for (int32_t y = 0; y < 111; ++y)
+        {
+            for (int32_t x = 0; x < 163; ++x)
+            {
+                setInt16Pixel(src, x, y, (int16_pixel_t)(((((x * 37) + (y * 23) + (x * y)) % 3) - 1) * 32767));
+            }
+        }
+
+        // 32767 * sum|msk| is just below 2^21, so the frequency domain is
+        // used
+        m[(0 * 21) + 0] = 20;
+        m[(2 * 21) + 17] = -20;
+        m[(4 * 21) + 10] = 13;
+        m[(8 * 21) + 5] = -11;
+
+        for (int32_t j = 0; j < 9; ++j)
+        {
+            for (int32_t i = 0; i < 21; ++i)
+            {
+                setInt16Pixel(msk, i, j, (int16_pixel_t)m[(j * 21) + i]);
+            }
+        }
+
+        convolve(src, dst, msk);
+
+        for (int32_t y = 0; y < 111; ++y)
+        {
+            for (int32_t x = 0; x < 163; ++x)
+            {
+                int32_t val = refConvolvePixel(src, m, 21, 9, x, y);
+                val = (val > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : ((val < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : val);
+
+                TEST_ASSERT_INT_WITHIN_MESSAGE(1, val, getInt16Pixel(dst, x, y), "convolve int16 near the bound incorrect");
+            }
+        }
+
+        // A dense mask of +-20 exceeds the bound and uses the direct method,
+        // which is exact
+        for (int32_t j = 0; j < 9; ++j)
+        {
+            for (int32_t i = 0; i < 21; ++i)
+            {
+                m[(j * 21) + i] = ((((i * 7) + (j * 11) + (i * j * 3)) % 5) < 2) ? 20 : -20;
+                setInt16Pixel(msk, i, j, (int16_pixel_t)m[(j * 21) + i]);
+            }
+        }
+
+        convolve(src, dst, msk);
+
+        for (int32_t y = 0; y < 111; ++y)
+        {
+            for (int32_t x = 0; x < 163; ++x)
+            {
+                int32_t val = refConvolvePixel(src, m, 21, 9, x, y);
+                val = (val > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : ((val < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : val);
+
+                TEST_ASSERT_EQUAL_MESSAGE(val, getInt16Pixel(dst, x, y), "convolve int16 above the bound incorrect");
+            }
+        }
+
+        deleteInt16Image(msk);
+        deleteInt16Image(dst);
+        deleteInt16Image(src);
+    }
+
+    // uint8_pixel_t, 9x9 mask that is not rank-1, larger than one block
+    {
+        image_t *src = newUint8Image(300, 37);
+        image_t *dst = newUint8Image(300, 37);
+        image_t *msk = newUint8Image(9, 9);
+        int32_t m[9 * 9];
+
+        for (int32_t y = 0; y < 37; ++y)
+        {
+            for (int32_t x = 0; x < 300; ++x)
+            {
+                setUint8Pixel(src, x, y, (uint8_pixel_t)(((x * 13) + (y * 29)) % 5));
+            }
+        }
+
+        for (int32_t j = 0; j < 9; ++j)
+        {
+            for (int32_t i = 0; i < 9; ++i)
+            {
+                m[(j * 9) + i] = ((i + j) % 3 == 0) ? 2 : ((i * j) % 2);
+                setUint8Pixel(msk, i, j, (uint8_pixel_t)m[(j * 9) + i]);
+            }
+        }
+
+        convolve(src, dst, msk);
+
+        for (int32_t y = 0; y < 37; ++y)
+        {
+            for (int32_t x = 0; x < 300; ++x)
+            {
+                int32_t val = refConvolvePixel(src, m, 9, 9, x, y);
+                val = (val > UINT8_PIXEL_MAX) ? UINT8_PIXEL_MAX : ((val < UINT8_PIXEL_MIN) ? UINT8_PIXEL_MIN : val);
+
+                TEST_ASSERT_INT_WITHIN_MESSAGE(1, val, getUint8Pixel(dst, x, y), "convolve uint8 with large mask incorrect");
+            }
+        }
+
+        // Masks of fewer than 9x9 cells use the direct method, which is exact
+        deleteUint8Image(msk);
+        msk = newUint8Image(7, 7);
+
+        for (int32_t j = 0; j < 7; ++j)
+        {
+            for (int32_t i = 0; i < 7; ++i)
+            {
+                m[(j * 7) + i] = ((i + j) % 3 == 0) ? 2 : ((i * j) % 2);
+                setUint8Pixel(msk, i, j, (uint8_pixel_t)m[(j * 7) + i]);
+            }
+        }
+
+        convolve(src, dst, msk);
+
+        for (int32_t y = 0; y < 37; ++y)
+        {
+            for (int32_t x = 0; x < 300; ++x)
+            {
+                int32_t val = refConvolvePixel(src, m, 7, 7, x, y);
+                val = (val > UINT8_PIXEL_MAX) ? UINT8_PIXEL_MAX : ((val < UINT8_PIXEL_MIN) ? UINT8_PIXEL_MIN : val);
+
+                TEST_ASSERT_EQUAL_MESSAGE(val, getUint8Pixel(dst, x, y), "convolve uint8 with 7x7 mask incorrect");
+            }
+        }
+
+        deleteUint8Image(msk);
+        deleteUint8Image(dst);
+        deleteUint8Image(src);
+    }
+}
+
+/*!
+ * \brief Reference border handling for test_convolveFastBorder()
+ */
+static int32_t refBorderCoordinate(int32_t p, const int32_t n, const eBorder border)
+{
+    if (border == BORDER_REPLICATE)
+    {
+        return (p < 0) ? 0 : ((p >= n) ? (n - 1) : p);
+    }
+
+    if (border == BORDER_REFLECT)
+    {
+        while ((n > 1) && ((p < 0) || (p >= n)))
+        {
+            p = (p < 0) ? -p : ((2 * (n - 1)) - p);
+        }
+
+        return (n > 1) ? p : 0;
+    }
+
+    return ((p < 0) || (p >= n)) ? -1 : p;
+}
+
+/*!
+ * \brief Reference implementation of convolveFastBorder(), returns the
+ *        unclipped value of pixel (x,y)
+ */
+static double refConvolveBorderPixel(const image_t *src, const image_t *msk, const eBorder border,
+                                     const float value, const int32_t x, const int32_t y)
+{
+    double val = 0;
+
+    for (int32_t j = 0; j < msk->rows; j++)
+    {
+        for (int32_t i = 0; i < msk->cols; i++)
+        {
+            int32_t sx = refBorderCoordinate(x + (msk->cols / 2) - i, src->cols, border);
+            int32_t sy = refBorderCoordinate(y + (msk->rows / 2) - j, src->rows, border);
+            double k;
+            double p;
+
+            if (src->type == IMGTYPE_UINT8)
+            {
+                k = getUint8Pixel(msk, i, j);
+                p = ((sx < 0) || (sy < 0)) ? value : getUint8Pixel(src, sx, sy);
+            }
+            else if (src->type == IMGTYPE_INT16)
+            {
+                k = getInt16Pixel(msk, i, j);
+                p = ((sx < 0) || (sy < 0)) ? value : getInt16Pixel(src, sx, sy);
+            }
+            else
+            {
+                k = getFloatPixel(msk, i, j);
+                p = ((sx < 0) || (sy < 0)) ? value : getFloatPixel(src, sx, sy);
+            }
+
+            val += p * k;
+        }
+    }
+
+    return val;
+}
+
+void test_convolveFastBorder(void)
+{
+    const eBorder borders[4] = {BORDER_SKIP, BORDER_CONSTANT, BORDER_REPLICATE, BORDER_REFLECT};
+    const int32_t sizes[4][2] = {{3, 3}, {5, 3}, {1, 7}, {9, 9}};
+
+    image_t *src8 = newUint8Image(11, 7);
+    image_t *dst8 = newUint8Image(11, 7);
+    image_t *src16 = newInt16Image(11, 7);
+    image_t *dst16 = newInt16Image(11, 7);
+    image_t *srcf = newFloatImage(11, 7);
+    image_t *dstf = newFloatImage(11, 7);
+
+    for (int32_t y = 0; y < 7; ++y)
+    {
+        for (int32_t x = 0; x < 11; ++x)
+        {
+            int32_t v = ((x * 37) + (y * 11)) % 29;
+
+            setUint8Pixel(src8, x, y, (uint8_pixel_t)v);
+            setInt16Pixel(src16, x, y, (int16_pixel_t)((v - 14) * 100));
+            setFloatPixel(srcf, x, y, (float_pixel_t)v * 0.25f);
+        }
+    }
+
+    for (int32_t s = 0; s < 4; ++s)
+    {
+        const int32_t mcols = sizes[s][0];
+        const int32_t mrows = sizes[s][1];
+
+        image_t *msk8 = newUint8Image(mcols, mrows);
+        image_t *msk16 = newInt16Image(mcols, mrows);
+        image_t *mskf = newFloatImage(mcols, mrows);
+
+        // Not rank-1 and not symmetric
+        for (int32_t j = 0; j < mrows; ++j)
+        {
+            for (int32_t i = 0; i < mcols; ++i)
+            {
+                int32_t k = ((i * 3) + (j * 5) + ((i * j) % 4)) % 7;
+
+                setUint8Pixel(msk8, i, j, (uint8_pixel_t)(k / 2));
+                setInt16Pixel(msk16, i, j, (int16_pixel_t)(k - 3));
+                setFloatPixel(mskf, i, j, (float_pixel_t)(k - 3) * 0.5f);
+            }
+        }
+
+        for (int32_t b = 0; b < 4; ++b)
+        {
+            clearUint8Image(dst8);
+            clearInt16Image(dst16);
+            clearFloatImage(dstf);
+
+            convolveFastBorder(src8, dst8, msk8, borders[b], 3.0f);
+            convolveFastBorder(src16, dst16, msk16, borders[b], -250.0f);
+            convolveFastBorder(srcf, dstf, mskf, borders[b], 1.5f);
+
+            for (int32_t y = 0; y < 7; ++y)
+            {
+                for (int32_t x = 0; x < 11; ++x)
+                {
+                    int32_t border = (x < (mcols / 2)) || (x >= (11 - (mcols / 2))) ||
+                                     (y < (mrows / 2)) || (y >= (7 - (mrows / 2)));
+
+                    if ((borders[b] == BORDER_SKIP) && border)
+                    {
+                        TEST_ASSERT_EQUAL_MESSAGE(0, getUint8Pixel(dst8, x, y), "uint8 border pixel written");
+                        TEST_ASSERT_EQUAL_MESSAGE(0, getInt16Pixel(dst16, x, y), "int16 border pixel written");
+                        TEST_ASSERT_EQUAL_FLOAT_MESSAGE(0.0f, getFloatPixel(dstf, x, y), "float border pixel written");
+                        continue;
+                    }
+
+                    double v8 = refConvolveBorderPixel(src8, msk8, borders[b], 3.0f, x, y);
+                    double v16 = refConvolveBorderPixel(src16, msk16, borders[b], -250.0f, x, y);
+                    double vf = refConvolveBorderPixel(srcf, mskf, borders[b], 1.5f, x, y);
+
+                    v8 = (v8 > 255) ? 255 : ((v8 < 0) ? 0 : v8);
+                    v16 = (v16 > INT16_PIXEL_MAX) ? INT16_PIXEL_MAX : ((v16 < INT16_PIXEL_MIN) ? INT16_PIXEL_MIN : v16);
+
+                    TEST_ASSERT_EQUAL_MESSAGE((int32_t)v8, getUint8Pixel(dst8, x, y), "uint8 incorrect");
+                    TEST_ASSERT_EQUAL_MESSAGE((int32_t)v16, getInt16Pixel(dst16, x, y), "int16 incorrect");
+                    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-3f, (float)vf, getFloatPixel(dstf, x, y), "float incorrect");
+                }
+            }
+        }
+
+        // With a constant border of 0 the result equals convolve()
+        convolveFastBorder(src16, dst16, msk16, BORDER_CONSTANT, 0.0f);
+        image_t *exp16 = newInt16Image(11, 7);
+        convolve(src16, exp16, msk16);
+        TEST_ASSERT_EQUAL_INT16_ARRAY_MESSAGE((int16_t *)exp16->data, (int16_t *)dst16->data, 11 * 7, "differs from convolve()");
+
+        deleteInt16Image(exp16);
+        deleteFloatImage(mskf);
+        deleteInt16Image(msk16);
+        deleteUint8Image(msk8);
+    }
+
+    deleteFloatImage(dstf);
+    deleteFloatImage(srcf);
+    deleteInt16Image(dst16);
+    deleteInt16Image(src16);
+    deleteUint8Image(dst8);
+    deleteUint8Image(src8);
+}
+
+void test_integralImage(void)
+{
+    image_t *src = newUint8Image(13, 9);
+    image_t *ii = newUint32Image(14, 10);
+
+    for (int32_t y = 0; y < src->rows; ++y)
+    {
+        for (int32_t x = 0; x < src->cols; ++x)
+        {
+            setUint8Pixel(src, x, y, (uint8_pixel_t)(((x * 31) + (y * 57) + (x * y)) % 256));
+        }
+    }
+
+    integralImage(src, ii);
+
+    // The sum of every rectangle equals the sum of its pixels
+    for (int32_t y0 = 0; y0 <= src->rows; ++y0)
+    {
+        for (int32_t y1 = y0; y1 <= src->rows; ++y1)
+        {
+            for (int32_t x0 = 0; x0 <= src->cols; ++x0)
+            {
+                for (int32_t x1 = x0; x1 <= src->cols; ++x1)
+                {
+                    uint32_t exp = 0;
+
+                    for (int32_t y = y0; y < y1; ++y)
+                    {
+                        for (int32_t x = x0; x < x1; ++x)
+                        {
+                            exp += getUint8Pixel(src, x, y);
+                        }
+                    }
+
+                    TEST_ASSERT_EQUAL_UINT32_MESSAGE(exp, getIntegralSum(ii, x0, y0, x1, y1), "Rectangle sum incorrect");
+                }
+            }
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, getUint32Pixel(ii, 0, 5), "First column is not 0");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, getUint32Pixel(ii, 5, 0), "First row is not 0");
+
+    // The source image can be a view with a stride and a step
+    image_t *uyvy = newUyvyImage(6, 4);
+    image_t luma;
+    image_t roi;
+    image_t *ii_roi = newUint32Image(5, 3);
+
+    for (int32_t y = 0; y < 4; ++y)
+    {
+        for (int32_t x = 0; x < 6; ++x)
+        {
+            setUyvyPixel(uyvy, x, y, (uyvy_pixel_t)((((x + (y * 6)) * 3) << 8) | 0x80));
+        }
+    }
+
+    lumaView(uyvy, &luma);
+    roiImage(&luma, &roi, 1, 1, 4, 2);
+    integralImage(&roi, ii_roi);
+
+    uint32_t exp = 0;
+
+    for (int32_t y = 1; y < 3; ++y)
+    {
+        for (int32_t x = 1; x < 5; ++x)
+        {
+            exp += (uint32_t)((x + (y * 6)) * 3);
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(exp, getIntegralSum(ii_roi, 0, 0, 4, 2), "View sum incorrect");
+
+    deleteUint32Image(ii_roi);
+    deleteUyvyImage(uyvy);
+    deleteUint32Image(ii);
+    deleteUint8Image(src);
+}
+
+void test_squaredIntegralImage(void)
+{
+    image_t *src = newUint8Image(11, 7);
+    image_t *sq = newUint32Image(12, 8);
+
+    for (int32_t y = 0; y < src->rows; ++y)
+    {
+        for (int32_t x = 0; x < src->cols; ++x)
+        {
+            setUint8Pixel(src, x, y, (uint8_pixel_t)(((x * 83) + (y * 29) + (x * y * 7)) % 256));
+        }
+    }
+
+    squaredIntegralImage(src, sq);
+
+    // The sum of every rectangle equals the sum of its squared pixels
+    for (int32_t y0 = 0; y0 <= src->rows; ++y0)
+    {
+        for (int32_t y1 = y0; y1 <= src->rows; ++y1)
+        {
+            for (int32_t x0 = 0; x0 <= src->cols; ++x0)
+            {
+                for (int32_t x1 = x0; x1 <= src->cols; ++x1)
+                {
+                    uint32_t exp = 0;
+
+                    for (int32_t y = y0; y < y1; ++y)
+                    {
+                        for (int32_t x = x0; x < x1; ++x)
+                        {
+                            exp += (uint32_t)getUint8Pixel(src, x, y) * getUint8Pixel(src, x, y);
+                        }
+                    }
+
+                    TEST_ASSERT_EQUAL_UINT32_MESSAGE(exp, getIntegralSum(sq, x0, y0, x1, y1), "Rectangle sum incorrect");
+                }
+            }
+        }
+    }
+
+    deleteUint32Image(sq);
+    deleteUint8Image(src);
+
+    // The corners wrap around 2^32, a rectangle of 257x257 white pixels
+    // is still correct
+    src = newUint8Image(300, 280);
+    sq = newUint32Image(301, 281);
+
+    memset(src->data, 255, (size_t)src->cols * src->rows);
+
+    squaredIntegralImage(src, sq);
+
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(257u * 257u * 255u * 255u, getIntegralSum(sq, 40, 20, 297, 277), "Large rectangle sum incorrect");
+
+    deleteUint32Image(sq);
+    deleteUint8Image(src);
+}
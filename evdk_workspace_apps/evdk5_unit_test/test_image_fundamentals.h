@@ -46,4 +46,35 @@ void test_convolve(void);
 /// \brief Unit test function for convolveFast()
 void test_convolveFast(void);
 
+/// \brief Unit test function for convolveSeparable()
+void test_convolveSeparable(void);
+
+/// \brief Unit test function for convolve() and correlate() with masks that
+///        are applied in the frequency domain
+void test_convolveLargeMask(void);
+
+/// \brief Unit test function for convolveFastBorder()
+void test_convolveFastBorder(void);
+
+/// \brief Unit test function for roiImage()
+void test_roiImage(void);
+
+/// \brief Unit test function for the image arena
+void test_imageArena(void);
+
+/// \brief Unit test function for newAlignedImage()
+void test_newAlignedImage(void);
+
+/// \brief Unit test function for convertUyvyToBgr888Fast()
+void test_convertUyvyToBgr888Fast(void);
+
+/// \brief Unit test function for lumaView()
+void test_lumaView(void);
+
+/// \brief Unit test function for integralImage() and getIntegralSum()
+void test_integralImage(void);
+
+/// \brief Unit test function for squaredIntegralImage()
+void test_squaredIntegralImage(void);
+
 #endif // _TEST_IMAGE_FUNDAMENTALS_H_
@@ -9006,3 +9006,253 @@ void test_skeleton(void)
         TEST_ASSERT_EQUAL_MESSAGE(exp.rows, dst.rows, name);
     }
 }
+
+void test_binaryMorphology(void)
+{
+    // Widths below, at and above the 64 pixel word size
+    const int32_t widths[] = {13, 64, 150};
+
+    // 3x3, 5x5 and asymmetric masks
+    const uint8_t m3[3 * 3] = {0, 1, 0,
+                               1, 1, 1,
+                               0, 1, 0};
+    const uint8_t m5[5 * 5] = {1, 1, 1, 1, 1,
+                               1, 1, 1, 1, 1,
+                               1, 1, 1, 1, 1,
+                               1, 1, 1, 1, 1,
+                               1, 1, 1, 1, 1};
+    const uint8_t ma[3 * 3] = {1, 1, 0,
+                               0, 1, 0,
+                               0, 1, 1};
+    const uint8_t m1[3 * 3] = {0, 0, 0,
+                               1, 1, 0,
+                               0, 1, 0};
+    const uint8_t m2[3 * 3] = {0, 1, 1,
+                               0, 0, 1,
+                               0, 0, 0};
+
+    for (uint32_t i = 0; i < (sizeof(widths) / sizeof(widths[0])); ++i)
+    {
+        const int32_t cols = widths[i];
+        const int32_t rows = 23;
+
+        image_t *src = newUint8Image(cols, rows);
+        image_t *dst = newUint8Image(cols, rows);
+        image_t *bin = newBinaryImage(cols, rows);
+        image_t *tmp = newBinaryImage(cols, rows);
+        image_t *out = newUint8Image(cols, rows);
+
+        // Noisy blobs, so the objects survive a few erosions
+        uint32_t seed = 2025;
+
+        for (int32_t y = 0; y < rows; ++y)
+        {
+            for (int32_t x = 0; x < cols; ++x)
+            {
+                seed = (seed * 1103515245u) + 12345u;
+                uint8_pixel_t p = ((((x / 9) + (y / 7)) % 2) == 0) ? 1 : 0;
+                setUint8Pixel(src, x, y, ((seed >> 24) < 20) ? (1 - p) : p);
+            }
+        }
+
+        char name[80] = "";
+
+        // Pack and unpack
+        convertUint8ToBinary(src, bin);
+
+        for (int32_t y = 0; y < rows; ++y)
+        {
+            for (int32_t x = 0; x < cols; ++x)
+            {
+                sprintf(name, "%d columns, pixel (%d,%d)", cols, x, y);
+                TEST_ASSERT_EQUAL_MESSAGE(getUint8Pixel(src, x, y), getBinaryPixel(bin, x, y), name);
+            }
+        }
+
+        convertBinaryToUint8(bin, out);
+        TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(src->data, out->data, (cols * rows), "convertBinaryToUint8 incorrect");
+
+        setBinaryPixel(bin, cols - 1, rows - 1, 1);
+        TEST_ASSERT_EQUAL_MESSAGE(1, getBinaryPixel(bin, cols - 1, rows - 1), "setBinaryPixel incorrect");
+        setBinaryPixel(bin, cols - 1, rows - 1, 0);
+        TEST_ASSERT_EQUAL_MESSAGE(0, getBinaryPixel(bin, cols - 1, rows - 1), "setBinaryPixel incorrect");
+        convertUint8ToBinary(src, bin);
+
+        // The binary operators must give the same result as the uint8_pixel_t
+        // operators
+        const uint8_t *masks[] = {m3, m5, ma};
+        const uint8_t sizes[] = {3, 5, 3};
+
+        for (uint32_t m = 0; m < 3; ++m)
+        {
+            dilation(src, dst, masks[m], sizes[m]);
+            dilation(bin, tmp, masks[m], sizes[m]);
+            convertBinaryToUint8(tmp, out);
+            sprintf(name, "dilation, %d columns, mask %d", cols, m);
+            TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(dst->data, out->data, (cols * rows), name);
+
+            erosion(src, dst, masks[m], sizes[m]);
+            erosion(bin, tmp, masks[m], sizes[m]);
+            convertBinaryToUint8(tmp, out);
+            sprintf(name, "erosion, %d columns, mask %d", cols, m);
+            TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(dst->data, out->data, (cols * rows), name);
+
+            outline(src, dst, masks[m], sizes[m]);
+            outline(bin, tmp, masks[m], sizes[m]);
+            convertBinaryToUint8(tmp, out);
+            sprintf(name, "outline, %d columns, mask %d", cols, m);
+            TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(dst->data, out->data, (cols * rows), name);
+        }
+
+        // Skeleton with symmetric masks only
+        for (uint32_t m = 0; m < 2; ++m)
+        {
+            skeleton(src, dst, masks[m], sizes[m]);
+            skeleton(bin, tmp, masks[m], sizes[m]);
+            convertBinaryToUint8(tmp, out);
+            sprintf(name, "skeleton, %d columns, mask %d", cols, m);
+            TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(dst->data, out->data, (cols * rows), name);
+        }
+
+        hitmiss(src, dst, m1, m2);
+        hitmiss(bin, tmp, m1, m2);
+        convertBinaryToUint8(tmp, out);
+        sprintf(name, "hitmiss, %d columns", cols);
+        TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(dst->data, out->data, (cols * rows), name);
+
+        deleteUint8Image(out);
+        deleteBinaryImage(tmp);
+        deleteBinaryImage(bin);
+        deleteUint8Image(dst);
+        deleteUint8Image(src);
+    }
+}
+
+// Straightforward Zhang-Suen thinning, every pixel is checked in every pass
+static void thinningReference(image_t *img)
+{
+    const int32_t dx[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    const int32_t dy[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+    image_t *del = newUint8Image(img->cols, img->rows);
+
+    int32_t changed = 1;
+    while (changed)
+    {
+        changed = 0;
+
+        for (int32_t it = 0; it < 2; ++it)
+        {
+            clearUint8Image(del);
+
+            for (int32_t y = 0; y < img->rows; ++y)
+            {
+                for (int32_t x = 0; x < img->cols; ++x)
+                {
+                    if (getUint8Pixel(img, x, y) == 0)
+                    {
+                        continue;
+                    }
+
+                    int32_t p[8];
+                    for (int32_t k = 0; k < 8; ++k)
+                    {
+                        int32_t nx = x + dx[k];
+                        int32_t ny = y + dy[k];
+                        p[k] = ((nx >= 0) && (ny >= 0) && (nx < img->cols) && (ny < img->rows)) ? getUint8Pixel(img, nx, ny) : 0;
+                    }
+
+                    int32_t b = 0;
+                    int32_t a = 0;
+                    for (int32_t k = 0; k < 8; ++k)
+                    {
+                        b += p[k];
+                        a += ((p[k] == 0) && (p[(k + 1) % 8] == 1)) ? 1 : 0;
+                    }
+
+                    int32_t c = (it == 0) ? ((p[0] * p[2] * p[4]) == 0) && ((p[2] * p[4] * p[6]) == 0)
+                                          : ((p[0] * p[2] * p[6]) == 0) && ((p[0] * p[4] * p[6]) == 0);
+
+                    if ((b >= 2) && (b <= 6) && (a == 1) && c)
+                    {
+                        setUint8Pixel(del, x, y, 1);
+                    }
+                }
+            }
+
+            for (int32_t y = 0; y < img->rows; ++y)
+            {
+                for (int32_t x = 0; x < img->cols; ++x)
+                {
+                    if (getUint8Pixel(del, x, y) == 1)
+                    {
+                        setUint8Pixel(img, x, y, 0);
+                        changed = 1;
+                    }
+                }
+            }
+        }
+    }
+
+    deleteUint8Image(del);
+}
+
+void test_thinning(void)
+{
+    // A bar of three pixels wide is thinned to its center line, Zhang-Suen
+    // removes one more pixel at the east end than at the west end
+    uint8_pixel_t bar_data[5 * 9] =
+    {
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 1, 1, 1, 1, 1, 1, 1, 0,
+        0, 1, 1, 1, 1, 1, 1, 1, 0,
+        0, 1, 1, 1, 1, 1, 1, 1, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+    };
+
+    uint8_pixel_t exp_data[5 * 9] =
+    {
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 1, 1, 1, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+    };
+
+    image_t bar = {9, 5, IMGTYPE_UINT8, bar_data};
+    image_t *dst = newUint8Image(9, 5);
+
+    thinning(&bar, dst);
+
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp_data, dst->data, (9 * 5), "Bar");
+
+    deleteUint8Image(dst);
+
+    // Noisy blobs, including objects that touch the image border
+    image_t *src = newUint8Image(61, 37);
+    image_t *exp = newUint8Image(61, 37);
+    dst = newUint8Image(61, 37);
+
+    uint32_t seed = 2026;
+
+    for (int32_t y = 0; y < src->rows; ++y)
+    {
+        for (int32_t x = 0; x < src->cols; ++x)
+        {
+            seed = (seed * 1103515245u) + 12345u;
+            uint8_pixel_t p = ((((x / 11) + (y / 8)) % 3) != 0) ? 1 : 0;
+            setUint8Pixel(src, x, y, ((seed >> 24) < 16) ? (1 - p) : p);
+        }
+    }
+
+    copyUint8Image(src, exp);
+    thinningReference(exp);
+
+    thinning(src, dst);
+
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp->data, dst->data, (61 * 37), "Noisy blobs");
+
+    deleteUint8Image(dst);
+    deleteUint8Image(exp);
+    deleteUint8Image(src);
+}
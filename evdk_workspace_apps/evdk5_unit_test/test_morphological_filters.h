@@ -64,4 +64,10 @@ void test_removeBorderBlobsTwoPass(void);
 /// \brief Unit test function for skeleton()
 void test_skeleton(void);
 
+/// \brief Unit test function for the morphological filters on binary images
+void test_binaryMorphology(void);
+
+/// \brief Unit test function for thinning()
+void test_thinning(void);
+
 #endif // _TEST_MORPHOLOGICAL_FILTERS_H_
@@ -0,0 +1,242 @@
+/*! ***************************************************************************
+ *
+ * \brief     Unit test functions for noise
+ * \file      test_noise.c
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "main.h"
+
+// Returns the mean and the variance of the pixels of an image
+static void imageMoments(const image_t *img, double *mean, double *var)
+{
+    const double n = (double)(img->cols * img->rows);
+    double sum = 0.0;
+    double sq = 0.0;
+
+    for (int32_t y = 0; y < img->rows; ++y)
+    {
+        for (int32_t x = 0; x < img->cols; ++x)
+        {
+            const double v = getUint8Pixel(img, x, y);
+
+            sum += v;
+            sq += v * v;
+        }
+    }
+
+    *mean = sum / n;
+    *var = (sq / n) - ((*mean) * (*mean));
+}
+
+void test_rng(void)
+{
+    // xoshiro128** seeded with splitmix64(2026)
+    const uint32_t exp[5] = {0x3D85DD4Du, 0xEA60B832u, 0x07A9C363u, 0x071B1BFFu, 0xD1F3D0C9u};
+
+    rng_t rng;
+    rngSeed(&rng, 2026);
+
+    for (int32_t i = 0; i < 5; ++i)
+    {
+        const uint32_t val = rngUint32(&rng);
+        TEST_ASSERT_EQUAL_HEX32_MESSAGE(exp[i], val, "Sequence incorrect");
+    }
+
+    // The same seed gives the same sequence, also in batches
+    uint32_t buf[100];
+    rngSeed(&rng, 2026);
+    rngFillUint32(&rng, buf, 100);
+    TEST_ASSERT_EQUAL_HEX32_ARRAY_MESSAGE(exp, buf, 5, "Batch incorrect");
+
+    rng_t other;
+    rngSeed(&other, 2026);
+
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        const uint32_t val = rngUint32(&other);
+        TEST_ASSERT_EQUAL_HEX32_MESSAGE(buf[i], val, "Batch differs from single numbers");
+    }
+
+    const uint32_t next = rngUint32(&other);
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE(next, rngUint32(&rng), "Batch did not advance the state");
+
+    // A similar seed gives an unrelated sequence
+    rngSeed(&other, 2027);
+    const uint32_t first = rngUint32(&other);
+    TEST_ASSERT_NOT_EQUAL_MESSAGE(exp[0], first, "Seeds 2026 and 2027 are equal");
+
+    // Uniform numbers are in [0, 1) and equal the batch version
+    float uni[1000];
+    rngSeed(&rng, 1);
+    rngFillUniform(&rng, uni, 1000);
+    rngSeed(&other, 1);
+
+    double sum = 0.0;
+
+    for (int32_t i = 0; i < 1000; ++i)
+    {
+        TEST_ASSERT_TRUE_MESSAGE((uni[i] >= 0.0f) && (uni[i] < 1.0f), "Uniform out of range");
+        const float val = rngUniform(&other);
+        TEST_ASSERT_EQUAL_FLOAT_MESSAGE(val, uni[i], "Uniform batch differs");
+        sum += uni[i];
+    }
+
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.03f, 0.5f, (float)(sum / 1000.0), "Uniform mean incorrect");
+}
+
+void test_rngGaussian(void)
+{
+    const int32_t n = 200000;
+    float *buf = (float *)malloc(n * sizeof(float));
+
+    rng_t rng;
+    rngSeed(&rng, 7);
+    rngFillGaussian(&rng, buf, (size_t)n);
+
+    double sum = 0.0;
+    double sq = 0.0;
+    int32_t above1 = 0;
+    int32_t above3 = 0;
+    float peak = 0.0f;
+
+    for (int32_t i = 0; i < n; ++i)
+    {
+        const float a = fabsf(buf[i]);
+
+        sum += buf[i];
+        sq += (double)buf[i] * buf[i];
+        above1 += (a > 1.0f);
+        above3 += (a > 3.0f);
+        peak = (a > peak) ? a : peak;
+    }
+
+    const double mean = sum / n;
+
+    // Moments and tail probabilities of the standard normal distribution
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, 0.0f, (float)mean, "Mean incorrect");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.02f, 1.0f, (float)((sq / n) - (mean * mean)), "Variance incorrect");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.005f, 0.3173f, (float)above1 / n, "P(|x| > 1) incorrect");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.0006f, 0.0027f, (float)above3 / n, "P(|x| > 3) incorrect");
+
+    // The tail beyond the base layer is sampled
+    TEST_ASSERT_TRUE_MESSAGE(peak > 3.6f, "Tail not sampled");
+
+    // Single numbers equal the batch
+    rngSeed(&rng, 7);
+
+    for (int32_t i = 0; i < 1000; ++i)
+    {
+        const float val = rngGaussian(&rng);
+        TEST_ASSERT_EQUAL_FLOAT_MESSAGE(buf[i], val, "Batch differs from single numbers");
+    }
+
+    free(buf);
+}
+
+void test_noiseRng(void)
+{
+    image_t *img = newUint8Image(200, 150);
+    image_t *ref = newUint8Image(200, 150);
+    const int32_t n = img->cols * img->rows;
+
+    rng_t rng;
+    double mean;
+    double var;
+
+    // Salt and pepper noise
+    memset(img->data, 128, (size_t)n);
+    rngSeed(&rng, 1);
+    saltPepperRng(img, 0.2f, &rng);
+
+    int32_t cnt[256] = {0};
+
+    for (int32_t i = 0; i < n; ++i)
+    {
+        cnt[img->data[i]]++;
+    }
+
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(n, cnt[0] + cnt[128] + cnt[255], "Salt and pepper changed other values");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, 0.1f, (float)cnt[0] / n, "Pepper probability incorrect");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, 0.1f, (float)cnt[255] / n, "Salt probability incorrect");
+
+    // Reproducible with the same seed
+    memset(ref->data, 128, (size_t)n);
+    rngSeed(&rng, 1);
+    saltPepperRng(ref, 0.2f, &rng);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(ref->data, img->data, n, "Salt and pepper not reproducible");
+
+    // Uniform noise, every value in the range has the same probability
+    rngSeed(&rng, 2);
+    uniformRng(img, 10, 19, &rng);
+
+    memset(cnt, 0, sizeof(cnt));
+
+    for (int32_t i = 0; i < n; ++i)
+    {
+        cnt[img->data[i]]++;
+    }
+
+    for (int32_t v = 0; v < 256; ++v)
+    {
+        if ((v < 10) || (v > 19))
+        {
+            TEST_ASSERT_EQUAL_INT32_MESSAGE(0, cnt[v], "Uniform out of range");
+        }
+        else
+        {
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, 0.1f, (float)cnt[v] / n, "Uniform probability incorrect");
+        }
+    }
+
+    // Gaussian noise
+    rngSeed(&rng, 3);
+    gaussianRng(img, 100.0f, 128.0f, &rng);
+    imageMoments(img, &mean, &var);
+
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.2f, 128.0f, (float)mean, "Gaussian mean incorrect");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(3.0f, 100.0f + (1.0f / 12.0f), (float)var, "Gaussian variance incorrect");
+
+    // Reproducible with the same seed, different with another seed
+    rngSeed(&rng, 3);
+    gaussianRng(ref, 100.0f, 128.0f, &rng);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(ref->data, img->data, n, "Gaussian not reproducible");
+
+    rngSeed(&rng, 4);
+    gaussianRng(ref, 100.0f, 128.0f, &rng);
+    TEST_ASSERT_TRUE_MESSAGE(memcmp(ref->data, img->data, (size_t)n) != 0, "Gaussian equal for different seeds");
+
+    // The noise is clipped
+    rngSeed(&rng, 5);
+    gaussianRng(img, 10000.0f, 250.0f, &rng);
+    imageMoments(img, &mean, &var);
+    TEST_ASSERT_TRUE_MESSAGE((mean > 150.0) && (mean < 250.0), "Gaussian not clipped");
+
+    deleteUint8Image(ref);
+    deleteUint8Image(img);
+}
@@ -6087,3 +6087,236 @@ void test_midpoint()
         TEST_ASSERT_EQUAL_MESSAGE(exp.rows, dst.rows, name);
     }
 }
+
+void test_medianLargeWindow(void)
+{
+    const uint8_t sizes[] = {7, 15, 31, 61};
+
+    image_t *src = newUint8Image(37, 23);
+    image_t *dst = newUint8Image(37, 23);
+
+    // Pseudo random values with a few salt and pepper outliers
+    uint32_t seed = 12345;
+
+    for (int32_t y = 0; y < src->rows; ++y)
+    {
+        for (int32_t x = 0; x < src->cols; ++x)
+        {
+            seed = (seed * 1103515245u) + 12345u;
+            uint8_pixel_t v = (uint8_pixel_t)(((seed >> 16) % 64) + x + y);
+
+            if (((seed >> 8) % 17) == 0)
+            {
+                v = ((seed >> 12) & 1) ? 255 : 0;
+            }
+
+            setUint8Pixel(src, x, y, v);
+        }
+    }
+
+    for (uint32_t i = 0; i < (sizeof(sizes) / sizeof(sizes[0])); ++i)
+    {
+        const int32_t h = sizes[i] / 2;
+
+        median(src, dst, sizes[i]);
+
+        for (int32_t y = 0; y < src->rows; ++y)
+        {
+            for (int32_t x = 0; x < src->cols; ++x)
+            {
+                // Reference: counting sort of the clipped window
+                uint32_t hist[256] = {0};
+                uint32_t cnt = 0;
+
+                for (int32_t j = y - h; j <= (y + h); ++j)
+                {
+                    for (int32_t k = x - h; k <= (x + h); ++k)
+                    {
+                        if ((j >= 0) && (j < src->rows) && (k >= 0) && (k < src->cols))
+                        {
+                            hist[getUint8Pixel(src, k, j)]++;
+                            cnt++;
+                        }
+                    }
+                }
+
+                uint32_t a = 0;
+                uint32_t b = 0;
+                uint32_t sum = 0;
+
+                for (uint32_t v = 0; v < 256; ++v)
+                {
+                    if ((sum <= ((cnt - 1) / 2)) && ((sum + hist[v]) > ((cnt - 1) / 2)))
+                    {
+                        a = v;
+                    }
+
+                    if ((sum <= (cnt / 2)) && ((sum + hist[v]) > (cnt / 2)))
+                    {
+                        b = v;
+                    }
+
+                    sum += hist[v];
+                }
+
+                char name[80] = "";
+                sprintf(name, "n = %d, pixel (%d,%d)", sizes[i], x, y);
+
+                TEST_ASSERT_EQUAL_MESSAGE((a + b + 1) / 2, getUint8Pixel(dst, x, y), name);
+            }
+        }
+    }
+
+    deleteUint8Image(dst);
+    deleteUint8Image(src);
+}
+
+void test_meanLargeWindow(void)
+{
+    const uint8_t sizes[] = {7, 15, 31, 61};
+
+    image_t *src = newUint8Image(37, 23);
+    image_t *dst = newUint8Image(37, 23);
+
+    uint32_t seed = 54321;
+
+    for (int32_t y = 0; y < src->rows; ++y)
+    {
+        for (int32_t x = 0; x < src->cols; ++x)
+        {
+            seed = (seed * 1103515245u) + 12345u;
+            setUint8Pixel(src, x, y, (uint8_pixel_t)(seed >> 24));
+        }
+    }
+
+    for (uint32_t i = 0; i < (sizeof(sizes) / sizeof(sizes[0])); ++i)
+    {
+        const int32_t h = sizes[i] / 2;
+
+        mean(src, dst, sizes[i]);
+
+        for (int32_t y = 0; y < src->rows; ++y)
+        {
+            for (int32_t x = 0; x < src->cols; ++x)
+            {
+                // Reference: sum of the clipped window, rounded half up
+                uint32_t sum = 0;
+                uint32_t cnt = 0;
+
+                for (int32_t j = y - h; j <= (y + h); ++j)
+                {
+                    for (int32_t k = x - h; k <= (x + h); ++k)
+                    {
+                        if ((j >= 0) && (j < src->rows) && (k >= 0) && (k < src->cols))
+                        {
+                            sum += getUint8Pixel(src, k, j);
+                            cnt++;
+                        }
+                    }
+                }
+
+                char name[80] = "";
+                sprintf(name, "n = %d, pixel (%d,%d)", sizes[i], x, y);
+
+                TEST_ASSERT_EQUAL_MESSAGE(((2 * sum) + cnt) / (2 * cnt), getUint8Pixel(dst, x, y), name);
+            }
+        }
+    }
+
+    deleteUint8Image(dst);
+    deleteUint8Image(src);
+}
+
+void test_runningMinMax(void)
+{
+    // Squares, rectangles, lines and windows larger than the image
+    const int32_t sizes[][2] = {{1, 1}, {3, 3}, {7, 5}, {1, 9}, {11, 1}, {15, 15}, {41, 3}, {3, 61}};
+
+    image_t *src = newUint8Image(37, 23);
+    image_t *min = newUint8Image(37, 23);
+    image_t *max = newUint8Image(37, 23);
+
+    uint32_t seed = 2024;
+
+    for (int32_t y = 0; y < src->rows; ++y)
+    {
+        for (int32_t x = 0; x < src->cols; ++x)
+        {
+            seed = (seed * 1103515245u) + 12345u;
+            setUint8Pixel(src, x, y, (uint8_pixel_t)(seed >> 24));
+        }
+    }
+
+    for (uint32_t i = 0; i < (sizeof(sizes) / sizeof(sizes[0])); ++i)
+    {
+        const int32_t hc = sizes[i][0] / 2;
+        const int32_t hr = sizes[i][1] / 2;
+
+        runningMinMax(src, min, max, sizes[i][0], sizes[i][1]);
+
+        for (int32_t y = 0; y < src->rows; ++y)
+        {
+            for (int32_t x = 0; x < src->cols; ++x)
+            {
+                // Reference: scan the clipped window
+                uint8_pixel_t lo = 255;
+                uint8_pixel_t hi = 0;
+
+                for (int32_t j = y - hr; j <= (y + hr); ++j)
+                {
+                    for (int32_t k = x - hc; k <= (x + hc); ++k)
+                    {
+                        if ((j >= 0) && (j < src->rows) && (k >= 0) && (k < src->cols))
+                        {
+                            uint8_pixel_t p = getUint8Pixel(src, k, j);
+                            lo = (p < lo) ? p : lo;
+                            hi = (p > hi) ? p : hi;
+                        }
+                    }
+                }
+
+                char name[80] = "";
+                sprintf(name, "%dx%d, pixel (%d,%d)", sizes[i][0], sizes[i][1], x, y);
+
+                TEST_ASSERT_EQUAL_MESSAGE(lo, getUint8Pixel(min, x, y), name);
+                TEST_ASSERT_EQUAL_MESSAGE(hi, getUint8Pixel(max, x, y), name);
+            }
+        }
+    }
+
+    // Graylevel morphology with a flat mask equals the running maximum plus
+    // and the running minimum minus the mask value
+    uint8_t flat[7 * 7];
+    memset(flat, 40, sizeof(flat));
+
+    image_t *dst = newUint8Image(37, 23);
+
+    runningMinMax(src, min, max, 7, 7);
+
+    dilationGray(src, dst, flat, 7);
+
+    for (int32_t y = 0; y < src->rows; ++y)
+    {
+        for (int32_t x = 0; x < src->cols; ++x)
+        {
+            int32_t exp = getUint8Pixel(max, x, y) + 40;
+            TEST_ASSERT_EQUAL_MESSAGE((exp > 255) ? 255 : exp, getUint8Pixel(dst, x, y), "dilationGray incorrect");
+        }
+    }
+
+    erosionGray(src, dst, flat, 7);
+
+    for (int32_t y = 0; y < src->rows; ++y)
+    {
+        for (int32_t x = 0; x < src->cols; ++x)
+        {
+            int32_t exp = getUint8Pixel(min, x, y) - 40;
+            TEST_ASSERT_EQUAL_MESSAGE((exp < 0) ? 0 : exp, getUint8Pixel(dst, x, y), "erosionGray incorrect");
+        }
+    }
+
+    deleteUint8Image(dst);
+    deleteUint8Image(max);
+    deleteUint8Image(min);
+    deleteUint8Image(src);
+}
@@ -43,6 +43,9 @@ void test_maximum(void);
 /// \brief Unit test function for mean()
 void test_mean(void);
 
+/// \brief Unit test function for mean() with large windows
+void test_meanLargeWindow(void);
+
 /// \brief Unit test function for meanFast()
 void test_meanFast(void);
 
@@ -52,9 +55,15 @@ void test_minimum(void);
 /// \brief Unit test function for range()
 void test_range(void);
 
+/// \brief Unit test function for runningMinMax()
+void test_runningMinMax(void);
+
 /// \brief Unit test function for median()
 void test_median(void);
 
+/// \brief Unit test function for median() with windows larger than 11x11
+void test_medianLargeWindow(void);
+
 /// \brief Unit test function for midpoint()
 void test_midpoint(void);
 
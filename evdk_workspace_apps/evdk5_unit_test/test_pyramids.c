@@ -0,0 +1,325 @@
+/*! ***************************************************************************
+ *
+ * \brief     Unit test functions for pyramids
+ * \file      test_pyramids.c
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "main.h"
+
+// Mirrors an index without repeating the border pixel
+static int32_t reflectReference(int32_t i, const int32_t n)
+{
+    if (n == 1)
+    {
+        return 0;
+    }
+
+    while ((i < 0) || (i >= n))
+    {
+        i = (i < 0) ? -i : ((2 * n) - 2 - i);
+    }
+
+    return i;
+}
+
+// Fills an image with pseudo random values on top of a gradient
+static void fillPyramidSource(image_t *img, uint32_t seed)
+{
+    for (int32_t y = 0; y < img->rows; ++y)
+    {
+        for (int32_t x = 0; x < img->cols; ++x)
+        {
+            seed = (seed * 1103515245u) + 12345u;
+            setUint8Pixel(img, x, y, (uint8_pixel_t)(((seed >> 16) % 128) + (4 * x) + (2 * y)));
+        }
+    }
+}
+
+// Straightforward 5x5 convolution of the source, evaluated at the even pixels
+static void pyrDownReference(const image_t *src, image_t *dst)
+{
+    const int32_t w[5] = {1, 4, 6, 4, 1};
+
+    for (int32_t y = 0; y < dst->rows; ++y)
+    {
+        for (int32_t x = 0; x < dst->cols; ++x)
+        {
+            int32_t sum = 0;
+
+            for (int32_t j = -2; j <= 2; ++j)
+            {
+                for (int32_t i = -2; i <= 2; ++i)
+                {
+                    sum += w[i + 2] * w[j + 2] *
+                           getUint8Pixel(src, reflectReference((2 * x) + i, src->cols),
+                                         reflectReference((2 * y) + j, src->rows));
+                }
+            }
+
+            setUint8Pixel(dst, x, y, (uint8_pixel_t)((sum + 128) >> 8));
+        }
+    }
+}
+
+// Straightforward 5x5 convolution of the source with zeros inserted
+static void pyrUpReference(const image_t *src, image_t *dst)
+{
+    const int32_t w[5] = {1, 4, 6, 4, 1};
+
+    for (int32_t y = 0; y < dst->rows; ++y)
+    {
+        for (int32_t x = 0; x < dst->cols; ++x)
+        {
+            int32_t sum = 0;
+
+            for (int32_t j = -2; j <= 2; ++j)
+            {
+                for (int32_t i = -2; i <= 2; ++i)
+                {
+                    int32_t c = reflectReference(x + i, dst->cols);
+                    int32_t r = reflectReference(y + j, dst->rows);
+
+                    if (((c % 2) == 0) && ((r % 2) == 0))
+                    {
+                        sum += w[i + 2] * w[j + 2] * getUint8Pixel(src, c / 2, r / 2);
+                    }
+                }
+            }
+
+            setUint8Pixel(dst, x, y, (uint8_pixel_t)((sum + 32) >> 6));
+        }
+    }
+}
+
+void test_pyrDown(void)
+{
+    const int32_t sizes[][2] = {{16, 12}, {13, 9}, {7, 2}, {2, 7}, {3, 1}, {1, 1}};
+
+    for (uint32_t s = 0; s < (sizeof(sizes) / sizeof(sizes[0])); ++s)
+    {
+        const int32_t cols = sizes[s][0];
+        const int32_t rows = sizes[s][1];
+
+        image_t *src = newUint8Image(cols, rows);
+        image_t *exp = newUint8Image((cols + 1) / 2, (rows + 1) / 2);
+        image_t *dst = newUint8Image((cols + 1) / 2, (rows + 1) / 2);
+
+        fillPyramidSource(src, 2026 + s);
+
+        pyrDownReference(src, exp);
+        pyrDown(src, dst);
+
+        char name[80] = "";
+        sprintf(name, "pyrDown, %dx%d", cols, rows);
+        TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp->data, dst->data, (exp->cols * exp->rows), name);
+
+        deleteUint8Image(dst);
+        deleteUint8Image(exp);
+        deleteUint8Image(src);
+    }
+
+    // A luma view as source
+    image_t *uyvy = newUyvyImage(13, 9);
+    image_t *src = newUint8Image(13, 9);
+    image_t *exp = newUint8Image(7, 5);
+    image_t *dst = newUint8Image(7, 5);
+    image_t luma;
+
+    fillPyramidSource(src, 1);
+
+    for (int32_t y = 0; y < src->rows; ++y)
+    {
+        for (int32_t x = 0; x < src->cols; ++x)
+        {
+            setUyvyPixel(uyvy, x, y, (uyvy_pixel_t)(0x0080 | (getUint8Pixel(src, x, y) << 8)));
+        }
+    }
+
+    lumaView(uyvy, &luma);
+
+    pyrDown(src, exp);
+    pyrDown(&luma, dst);
+
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp->data, dst->data, (7 * 5), "pyrDown, luma view");
+
+    deleteUint8Image(dst);
+    deleteUint8Image(exp);
+    deleteUint8Image(src);
+    deleteUyvyImage(uyvy);
+}
+
+void test_pyrUp(void)
+{
+    const int32_t sizes[][2] = {{16, 12}, {13, 9}, {14, 3}, {2, 7}, {3, 2}, {2, 2}};
+
+    for (uint32_t s = 0; s < (sizeof(sizes) / sizeof(sizes[0])); ++s)
+    {
+        const int32_t cols = sizes[s][0];
+        const int32_t rows = sizes[s][1];
+
+        image_t *src = newUint8Image((cols + 1) / 2, (rows + 1) / 2);
+        image_t *exp = newUint8Image(cols, rows);
+        image_t *dst = newUint8Image(cols, rows);
+
+        fillPyramidSource(src, 2026 + s);
+
+        pyrUpReference(src, exp);
+        pyrUp(src, dst);
+
+        char name[80] = "";
+        sprintf(name, "pyrUp, %dx%d", cols, rows);
+        TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp->data, dst->data, (cols * rows), name);
+
+        deleteUint8Image(dst);
+        deleteUint8Image(exp);
+        deleteUint8Image(src);
+    }
+
+    // A constant image remains constant
+    image_t *src = newUint8Image(5, 4);
+    image_t *dst = newUint8Image(9, 8);
+    uint8_pixel_t exp_data[9 * 8];
+
+    memset(src->data, 77, 5 * 4);
+    memset(exp_data, 77, 9 * 8);
+
+    pyrUp(src, dst);
+
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp_data, dst->data, (9 * 8), "pyrUp, constant");
+
+    deleteUint8Image(dst);
+    deleteUint8Image(src);
+}
+
+void test_laplacianPyramid(void)
+{
+    const int32_t cols = 37;
+    const int32_t rows = 23;
+    const int32_t levels = 4;
+
+    image_arena_mark_t mark = markImageArena();
+
+    image_t *src = newUint8Image(cols, rows);
+    void *gauss_buf = allocImageArena(pyramidBufferSize(cols, rows, levels, IMGTYPE_UINT8));
+    void *lap_buf = allocImageArena(pyramidBufferSize(cols, rows, levels, IMGTYPE_INT16));
+    void *rec_buf = allocImageArena(pyramidBufferSize(cols, rows, levels, IMGTYPE_UINT8));
+    pyramid_t gauss;
+    pyramid_t lap;
+    pyramid_t rec;
+
+    TEST_ASSERT_NOT_NULL(gauss_buf);
+    TEST_ASSERT_NOT_NULL(lap_buf);
+    TEST_ASSERT_NOT_NULL(rec_buf);
+
+    initPyramid(&gauss, gauss_buf, cols, rows, levels, IMGTYPE_UINT8);
+    initPyramid(&lap, lap_buf, cols, rows, levels, IMGTYPE_INT16);
+    initPyramid(&rec, rec_buf, cols, rows, levels, IMGTYPE_UINT8);
+
+    // Level sizes are halved and rounded up
+    const int32_t exp_cols[4] = {37, 19, 10, 5};
+    const int32_t exp_rows[4] = {23, 12, 6, 3};
+
+    for (int32_t l = 0; l < levels; ++l)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(exp_cols[l], gauss.level[l].cols, "Level columns");
+        TEST_ASSERT_EQUAL_MESSAGE(exp_rows[l], gauss.level[l].rows, "Level rows");
+    }
+
+    fillPyramidSource(src, 42);
+
+    gaussianPyramid(src, &gauss);
+
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(src->data, gauss.level[0].data, (cols * rows), "Gaussian level 0");
+
+    for (int32_t l = 1; l < levels; ++l)
+    {
+        image_t *exp = newUint8Image(exp_cols[l], exp_rows[l]);
+
+        pyrDown(&gauss.level[l - 1], exp);
+
+        char name[80] = "";
+        sprintf(name, "Gaussian level %d", l);
+        TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp->data, gauss.level[l].data, (exp_cols[l] * exp_rows[l]), name);
+    }
+
+    laplacianPyramid(&gauss, &lap);
+
+    for (int32_t l = 0; l < levels; ++l)
+    {
+        image_t *up = newUint8Image(exp_cols[l], exp_rows[l]);
+
+        if (l < (levels - 1))
+        {
+            pyrUp(&gauss.level[l + 1], up);
+        }
+        else
+        {
+            memset(up->data, 0, exp_cols[l] * exp_rows[l]);
+        }
+
+        for (int32_t y = 0; y < exp_rows[l]; ++y)
+        {
+            for (int32_t x = 0; x < exp_cols[l]; ++x)
+            {
+                char name[80] = "";
+                sprintf(name, "Laplacian level %d, pixel (%d,%d)", l, x, y);
+                TEST_ASSERT_EQUAL_MESSAGE(getUint8Pixel(&gauss.level[l], x, y) - getUint8Pixel(up, x, y),
+                                          getInt16Pixel(&lap.level[l], x, y), name);
+            }
+        }
+    }
+
+    // Collapsing restores the Gaussian pyramid exactly
+    collapseLaplacianPyramid(&lap, &rec);
+
+    for (int32_t l = 0; l < levels; ++l)
+    {
+        char name[80] = "";
+        sprintf(name, "Reconstructed level %d", l);
+        TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(gauss.level[l].data, rec.level[l].data, (exp_cols[l] * exp_rows[l]), name);
+    }
+
+    // Coordinates between levels
+    point_t p = {21, 13};
+    point_t q = pyramidMapPoint(&gauss, p, 0, 2);
+    TEST_ASSERT_EQUAL_MESSAGE(5, q.x, "Map to coarse, x");
+    TEST_ASSERT_EQUAL_MESSAGE(3, q.y, "Map to coarse, y");
+
+    q = pyramidMapPoint(&gauss, q, 2, 0);
+    TEST_ASSERT_EQUAL_MESSAGE(20, q.x, "Map to fine, x");
+    TEST_ASSERT_EQUAL_MESSAGE(12, q.y, "Map to fine, y");
+
+    p.x = 36;
+    p.y = -4;
+    q = pyramidMapPoint(&gauss, p, 0, 3);
+    TEST_ASSERT_EQUAL_MESSAGE(4, q.x, "Map to coarse, clipped x");
+    TEST_ASSERT_EQUAL_MESSAGE(0, q.y, "Map to coarse, clipped y");
+
+    releaseImageArena(mark);
+}
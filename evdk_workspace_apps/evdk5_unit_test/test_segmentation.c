@@ -792,3 +792,127 @@ void test_lineDetector(void)
          TEST_ASSERT_EQUAL_MESSAGE(exp.rows, dst.rows, name);
      }
 }
+
+void test_canny(void)
+{
+    image_t *src = newUint8Image(40, 30);
+    image_t *dst = newUint8Image(40, 30);
+    image_t *mag = newInt16Image(40, 30);
+    image_t *dir = newUint8Image(40, 30);
+    uint32_t stack[40 * 30];
+
+    // A bright rectangle gives a closed contour of one pixel wide
+    for (int32_t y = 0; y < src->rows; ++y)
+    {
+        for (int32_t x = 0; x < src->cols; ++x)
+        {
+            int32_t inside = (x >= 10) && (x < 30) && (y >= 8) && (y < 22);
+            setUint8Pixel(src, x, y, inside ? 200 : 20);
+        }
+    }
+
+    canny(src, dst, mag, dir, stack, 40 * 30, 100, 300);
+
+    for (int32_t y = 0; y < src->rows; ++y)
+    {
+        for (int32_t x = 0; x < src->cols; ++x)
+        {
+            int32_t near = (x >= 8) && (x <= 31) && (y >= 6) && (y <= 23) &&
+                           !((x >= 12) && (x <= 27) && (y >= 10) && (y <= 19));
+
+            if (!near)
+            {
+                char name[80] = "";
+                sprintf(name, "Rectangle, pixel (%d,%d)", x, y);
+                TEST_ASSERT_EQUAL_MESSAGE(0, getUint8Pixel(dst, x, y), name);
+            }
+        }
+    }
+
+    // Exactly one edge pixel across every side, away from the corners
+    for (int32_t y = 11; y <= 18; ++y)
+    {
+        int32_t left = 0;
+        int32_t right = 0;
+
+        for (int32_t x = 8; x <= 11; ++x)
+        {
+            left += getUint8Pixel(dst, x, y);
+            right += getUint8Pixel(dst, x + 20, y);
+        }
+
+        TEST_ASSERT_EQUAL_MESSAGE(1, left, "Left side is not one pixel wide");
+        TEST_ASSERT_EQUAL_MESSAGE(1, right, "Right side is not one pixel wide");
+    }
+
+    for (int32_t x = 13; x <= 26; ++x)
+    {
+        int32_t top = 0;
+        int32_t bottom = 0;
+
+        for (int32_t y = 6; y <= 9; ++y)
+        {
+            top += getUint8Pixel(dst, x, y);
+            bottom += getUint8Pixel(dst, x, y + 14);
+        }
+
+        TEST_ASSERT_EQUAL_MESSAGE(1, top, "Top side is not one pixel wide");
+        TEST_ASSERT_EQUAL_MESSAGE(1, bottom, "Bottom side is not one pixel wide");
+    }
+
+    // Hysteresis: a weak edge that continues a strong edge is kept, a weak edge
+    // on its own is removed. The horizontal edge is strong left of column 20
+    // and weak right of it.
+    for (int32_t y = 0; y < src->rows; ++y)
+    {
+        for (int32_t x = 0; x < src->cols; ++x)
+        {
+            int32_t p = 100;
+
+            if (y < 10)
+            {
+                p = (x < 20) ? 0 : 75;
+            }
+
+            if ((y >= 20) && (x >= 10) && (x < 30))
+            {
+                p += 25;
+            }
+
+            setUint8Pixel(src, x, y, (uint8_pixel_t)p);
+        }
+    }
+
+    canny(src, dst, mag, dir, stack, 40 * 30, 60, 200);
+
+    for (int32_t x = 2; x < 38; x = (x == 17) ? 23 : (x + 1))
+    {
+        char name[80] = "";
+        sprintf(name, "Hysteresis, column %d", x);
+        TEST_ASSERT_EQUAL_MESSAGE(1, getUint8Pixel(dst, x, 9) + getUint8Pixel(dst, x, 10), name);
+    }
+
+    for (int32_t y = 15; y < src->rows; ++y)
+    {
+        for (int32_t x = 0; x < src->cols; ++x)
+        {
+            char name[80] = "";
+            sprintf(name, "Hysteresis, pixel (%d,%d)", x, y);
+            TEST_ASSERT_EQUAL_MESSAGE(0, getUint8Pixel(dst, x, y), name);
+        }
+    }
+
+    // A stack of one element gives the same result
+    image_t *exp = newUint8Image(40, 30);
+    copyUint8Image(dst, exp);
+
+    canny(src, dst, mag, dir, stack, 1, 60, 200);
+
+    TEST_ASSERT_EQUAL_uint8_pixel_t_ARRAY_MESSAGE(exp->data, dst->data, (40 * 30), "Small stack");
+
+    deleteUint8Image(exp);
+    deleteUint8Image(dir);
+    deleteInt16Image(mag);
+    deleteUint8Image(dst);
+    deleteUint8Image(src);
+}
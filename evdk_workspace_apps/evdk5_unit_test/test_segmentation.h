@@ -49,4 +49,7 @@ void test_thresholdOtsu(void);
 /// \brief Unit test function for lineDetector()
 void test_lineDetector(void);
 
+/// \brief Unit test function for canny()
+void test_canny(void);
+
 #endif // _TEST_SEGMENTATION_H_
@@ -419,3 +419,96 @@ void test_sobelFast(void)
     TEST_ASSERT_EQUAL_MESSAGE(exp_mag.cols, dst_mag.cols, name);
     TEST_ASSERT_EQUAL_MESSAGE(exp_mag.rows, dst_mag.rows, name);
 }
+
+void test_sobelFused(void)
+{
+    // The width is not a multiple of the SIMD width
+    image_t *src = newUint8Image(37, 13);
+    image_t *src16 = newInt16Image(37, 13);
+    image_t *mag = newInt16Image(37, 13);
+    image_t *ref = newInt16Image(37, 13);
+    image_t *dir = newUint8Image(37, 13);
+
+    uint32_t seed = 2027;
+
+    for (int32_t y = 0; y < src->rows; ++y)
+    {
+        for (int32_t x = 0; x < src->cols; ++x)
+        {
+            seed = (seed * 1103515245u) + 12345u;
+            setUint8Pixel(src, x, y, (uint8_pixel_t)(seed >> 24));
+            setInt16Pixel(src16, x, y, (int16_pixel_t)(seed >> 24));
+        }
+    }
+
+    const eMagnitude norms[] = {MAGNITUDE_L1, MAGNITUDE_L2, MAGNITUDE_APPROX};
+
+    for (uint32_t n = 0; n < 3; ++n)
+    {
+        sobelFused(src, mag, dir, norms[n]);
+
+        for (int32_t y = 0; y < src->rows; ++y)
+        {
+            for (int32_t x = 0; x < src->cols; ++x)
+            {
+                // Reference gradient, pixels outside the image are 0
+                int32_t p[3][3];
+                for (int32_t j = -1; j <= 1; ++j)
+                {
+                    for (int32_t i = -1; i <= 1; ++i)
+                    {
+                        int32_t inside = ((x + i) >= 0) && ((y + j) >= 0) && ((x + i) < src->cols) && ((y + j) < src->rows);
+                        p[j + 1][i + 1] = inside ? getUint8Pixel(src, x + i, y + j) : 0;
+                    }
+                }
+
+                int32_t gx = (p[0][2] + (2 * p[1][2]) + p[2][2]) - (p[0][0] + (2 * p[1][0]) + p[2][0]);
+                int32_t gy = (p[2][0] + (2 * p[2][1]) + p[2][2]) - (p[0][0] + (2 * p[0][1]) + p[0][2]);
+                float l2 = sqrtf((float)((gx * gx) + (gy * gy)));
+
+                char name[80] = "";
+                sprintf(name, "Norm %d, pixel (%d,%d)", n, x, y);
+
+                int32_t m = getInt16Pixel(mag, x, y);
+
+                if (norms[n] == MAGNITUDE_L1)
+                {
+                    TEST_ASSERT_EQUAL_MESSAGE(abs(gx) + abs(gy), m, name);
+                }
+                else if (norms[n] == MAGNITUDE_L2)
+                {
+                    TEST_ASSERT_EQUAL_MESSAGE((int32_t)(l2 + 0.5f), m, name);
+                }
+                else
+                {
+                    // The approximation is within 4% of the L2 norm
+                    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1.0f + (0.04f * l2), l2, (float)m, name);
+                }
+
+                // The direction is within one binary angle
+                if ((gx != 0) || (gy != 0))
+                {
+                    int32_t a = (int32_t)lroundf(atan2f((float)gy, (float)gx) * 128.0f / (float)M_PI) & 255;
+                    int32_t d = abs(a - getUint8Pixel(dir, x, y));
+                    TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(1, (d > 128) ? (256 - d) : d, name);
+                }
+                else
+                {
+                    TEST_ASSERT_EQUAL_MESSAGE(0, getUint8Pixel(dir, x, y), name);
+                }
+            }
+        }
+    }
+
+    // The L1 magnitude of an int16_pixel_t image equals sobel()
+    sobelFused(src16, mag, NULL, MAGNITUDE_L1);
+    sobel(src16, ref, NULL);
+
+    TEST_ASSERT_EQUAL_INT16_ARRAY_MESSAGE(ref->data, mag->data, (37 * 13), "sobel() and sobelFused() differ");
+
+    deleteUint8Image(dir);
+    deleteInt16Image(ref);
+    deleteInt16Image(mag);
+    deleteInt16Image(src16);
+    deleteUint8Image(src);
+}
@@ -46,4 +46,7 @@ void test_sobel(void);
 /// \brief Unit test function for sobelFast()
 void test_sobelFast(void);
 
+/// \brief Unit test function for sobelFused()
+void test_sobelFused(void);
+
 #endif // _TEST_SPATIAL_FILTERS_H_
@@ -32,4 +32,217 @@
  *****************************************************************************/
 
 #include "main.h"
+#include <math.h>
 
+// Straightforward evaluation of a low-pass transfer function
+static double lowpassReference(const frequency_params_t *p, const double d, const double d0)
+{
+    if (p->shape == FREQUENCY_IDEAL)
+    {
+        return (d <= d0) ? 1.0 : 0.0;
+    }
+    else if (p->shape == FREQUENCY_BUTTERWORTH)
+    {
+        return 1.0 / (1.0 + pow(d / d0, 2.0 * p->order));
+    }
+
+    return exp(-(d * d) / (2.0 * d0 * d0));
+}
+
+// Straightforward evaluation of a band-reject transfer function
+static double bandrejectReference(const frequency_params_t *p, const double d)
+{
+    const double c0 = p->cutoff;
+    const double w = p->width;
+
+    if (p->shape == FREQUENCY_IDEAL)
+    {
+        return ((d >= (c0 - (w / 2.0))) && (d <= (c0 + (w / 2.0)))) ? 0.0 : 1.0;
+    }
+    else if (p->shape == FREQUENCY_BUTTERWORTH)
+    {
+        return (d == c0) ? 0.0 : (1.0 / (1.0 + pow((d * w) / ((d * d) - (c0 * c0)), 2.0 * p->order)));
+    }
+
+    return (d == 0.0) ? 1.0 : (1.0 - exp(-pow(((d * d) - (c0 * c0)) / (d * w), 2.0)));
+}
+
+void test_initFrequencyFilter(void)
+{
+    const int32_t cols = 16;
+    const int32_t rows = 12;
+    const eFrequencyShape shapes[] = {FREQUENCY_IDEAL, FREQUENCY_BUTTERWORTH, FREQUENCY_GAUSSIAN};
+    const eFrequencyBand bands[] = {FREQUENCY_LOWPASS, FREQUENCY_HIGHPASS, FREQUENCY_BANDPASS, FREQUENCY_BANDREJECT};
+
+    float buffer[((16 / 2) + 1) * 12];
+
+    TEST_ASSERT_EQUAL_size_t_MESSAGE(sizeof(buffer), frequencyFilterBufferSize(cols, rows), "buffer size");
+
+    for (uint32_t s = 0; s < (sizeof(shapes) / sizeof(shapes[0])); ++s)
+    {
+        for (uint32_t b = 0; b < (sizeof(bands) / sizeof(bands[0])); ++b)
+        {
+            frequency_params_t params = {0};
+            params.shape = shapes[s];
+            params.band = bands[b];
+            params.cutoff = 3.5f;
+            params.width = 2.0f;
+            params.order = 2;
+
+            frequency_filter_t filter;
+            initFrequencyFilter(&filter, buffer, cols, rows, &params);
+
+            TEST_ASSERT_EQUAL_INT32((cols / 2) + 1, filter.transfer.cols);
+            TEST_ASSERT_EQUAL_INT32(rows, filter.transfer.rows);
+
+            char name[80] = "";
+            sprintf(name, "shape %d, band %d", shapes[s], bands[b]);
+
+            for (int32_t y = 0; y < rows; ++y)
+            {
+                for (int32_t u = 0; u < filter.transfer.cols; ++u)
+                {
+                    const int32_t v = (y <= (rows / 2)) ? y : (y - rows);
+                    const double d = sqrt((double)((u * u) + (v * v)));
+                    double h = 0.0;
+
+                    switch (bands[b])
+                    {
+                    case FREQUENCY_LOWPASS:
+                        h = lowpassReference(&params, d, params.cutoff);
+                        break;
+                    case FREQUENCY_HIGHPASS:
+                        h = 1.0 - lowpassReference(&params, d, params.cutoff);
+                        break;
+                    case FREQUENCY_BANDPASS:
+                        h = 1.0 - bandrejectReference(&params, d);
+                        break;
+                    default:
+                        h = bandrejectReference(&params, d);
+                        break;
+                    }
+
+                    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-5f, (float)h, getFloatPixel(&filter.transfer, u, y), name);
+                }
+            }
+        }
+    }
+
+    // A notch and its mirror image, which wraps around in the rows
+    frequency_params_t params = {0};
+    params.shape = FREQUENCY_GAUSSIAN;
+    params.band = FREQUENCY_NOTCH;
+    params.cutoff = 1.0f;
+    params.notches = 1;
+    params.notch[0].x = 0;
+    params.notch[0].y = 4;
+
+    frequency_filter_t filter;
+    initFrequencyFilter(&filter, buffer, cols, rows, &params);
+
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-6f, 0.0f, getFloatPixel(&filter.transfer, 0, 4), "notch");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-6f, 0.0f, getFloatPixel(&filter.transfer, 0, rows - 4), "mirrored notch");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-3f, 1.0f, getFloatPixel(&filter.transfer, 0, 0), "DC");
+
+    // Distance 1 to the notch and distance sqrt(17) to the mirrored notch
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-6f, (float)((1.0 - exp(-0.5)) * (1.0 - exp(-8.5))), getFloatPixel(&filter.transfer, 1, 4), "next to notch");
+}
+
+void test_frequencyFilter(void)
+{
+    const int32_t cols = 32;
+    const int32_t rows = 24;
+    const double pi = 3.14159265358979323846;
+
+    image_t *src = newFloatImage(cols, rows);
+    image_t *dst = newFloatImage(cols, rows);
+    image_t *uyvy = newUyvyImage(cols, rows);
+    image_t *src8 = newUint8Image(cols, rows);
+    image_t *dst8 = newUint8Image(cols, rows);
+
+    float buffer[((32 / 2) + 1) * 24];
+    frequency_filter_t filter;
+
+    // A constant with periodic noise at frequency (4,3), D = 5
+    for (int32_t y = 0; y < rows; ++y)
+    {
+        for (int32_t x = 0; x < cols; ++x)
+        {
+            const double n = cos(2.0 * pi * (((4.0 * x) / cols) + ((3.0 * y) / rows)));
+
+            setFloatPixel(src, x, y, (float)(10.0 + (5.0 * n)));
+            setUyvyPixel(uyvy, x, y, (uyvy_pixel_t)(0x0080 | ((uint8_pixel_t)(100.0 + (50.0 * n) + 0.5) << 8)));
+        }
+    }
+
+    // A notch filter removes the noise
+    frequency_params_t params = {0};
+    params.shape = FREQUENCY_GAUSSIAN;
+    params.band = FREQUENCY_NOTCH;
+    params.cutoff = 1.0f;
+    params.notches = 1;
+    params.notch[0].x = 4;
+    params.notch[0].y = 3;
+
+    initFrequencyFilter(&filter, buffer, cols, rows, &params);
+    frequencyFilter(src, dst, &filter);
+
+    for (int32_t i = 0; i < (cols * rows); ++i)
+    {
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-3f, 10.0f, ((float *)dst->data)[i], "notch");
+    }
+
+    // A band-pass filter only keeps the noise
+    params.shape = FREQUENCY_IDEAL;
+    params.band = FREQUENCY_BANDPASS;
+    params.cutoff = 5.0f;
+    params.width = 1.0f;
+
+    initFrequencyFilter(&filter, buffer, cols, rows, &params);
+    frequencyFilter(src, dst, &filter);
+
+    for (int32_t i = 0; i < (cols * rows); ++i)
+    {
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-3f, ((float *)src->data)[i] - 10.0f, ((float *)dst->data)[i], "band-pass");
+    }
+
+    // In-place
+    frequencyFilter(src, src, &filter);
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY_MESSAGE((float *)dst->data, (float *)src->data, (cols * rows), "in-place");
+
+    // A low-pass filter on a uint8 luma view
+    image_t luma;
+    lumaView(uyvy, &luma);
+
+    params.shape = FREQUENCY_BUTTERWORTH;
+    params.band = FREQUENCY_LOWPASS;
+    params.cutoff = 2.0f;
+    params.order = 8;
+
+    initFrequencyFilter(&filter, buffer, cols, rows, &params);
+    frequencyFilter(&luma, dst8, &filter);
+
+    for (int32_t i = 0; i < (cols * rows); ++i)
+    {
+        TEST_ASSERT_EQUAL_UINT8_MESSAGE(100, dst8->data[i], "low-pass, luma view");
+    }
+
+    // Negative values are clipped
+    copyUint8Image(&luma, src8);
+    params.band = FREQUENCY_HIGHPASS;
+
+    initFrequencyFilter(&filter, buffer, cols, rows, &params);
+    frequencyFilter(src8, dst8, &filter);
+
+    for (int32_t i = 0; i < (cols * rows); ++i)
+    {
+        const int32_t e = (int32_t)src8->data[i] - 100;
+        TEST_ASSERT_INT_WITHIN_MESSAGE(1, (e < 0) ? 0 : e, dst8->data[i], "high-pass, uint8");
+    }
+
+    deleteUint8Image(dst8);
+    deleteUint8Image(src8);
+    deleteUyvyImage(uyvy);
+    deleteFloatImage(dst);
+    deleteFloatImage(src);
+}
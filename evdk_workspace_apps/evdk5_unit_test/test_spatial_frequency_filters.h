@@ -34,6 +34,10 @@
 #ifndef _TEST_SPATIAL_FREQUENCY_FILTERS_H_
 #define _TEST_SPATIAL_FREQUENCY_FILTERS_H_
 
+/// \brief Unit test function for initFrequencyFilter()
+void test_initFrequencyFilter(void);
 
+/// \brief Unit test function for frequencyFilter()
+void test_frequencyFilter(void);
 
 #endif // _TEST_SPATIAL_FREQUENCY_FILTERS_H_
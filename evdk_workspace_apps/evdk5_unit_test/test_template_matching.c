@@ -0,0 +1,281 @@
+/*! ***************************************************************************
+ *
+ * \brief     Unit test functions for template matching
+ * \file      test_template_matching.c
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \copyright 2026 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "main.h"
+
+// Fills an image with pseudo random values in the range [0, range)
+static void fillMatchSource(image_t *img, uint32_t seed, const uint32_t range)
+{
+    for (int32_t y = 0; y < img->rows; ++y)
+    {
+        for (int32_t x = 0; x < img->cols; ++x)
+        {
+            seed = (seed * 1103515245u) + 12345u;
+            setUint8Pixel(img, x, y, (uint8_pixel_t)((seed >> 16) % range));
+        }
+    }
+}
+
+// Straightforward evaluation of the score of one window
+static double matchReference(const image_t *src, const image_t *tpl,
+                             const eMatchMethod method, const int32_t x0,
+                             const int32_t y0)
+{
+    const double n = (double)(tpl->cols * tpl->rows);
+    double ms = 0.0;
+    double mt = 0.0;
+
+    for (int32_t y = 0; y < tpl->rows; ++y)
+    {
+        for (int32_t x = 0; x < tpl->cols; ++x)
+        {
+            ms += getUint8Pixel(src, x0 + x, y0 + y) / n;
+            mt += getUint8Pixel(tpl, x, y) / n;
+        }
+    }
+
+    // Only ZNCC subtracts the means
+    if (method != MATCH_ZNCC)
+    {
+        ms = 0.0;
+        mt = 0.0;
+    }
+
+    double st = 0.0;
+    double ss = 0.0;
+    double tt = 0.0;
+    double ssd = 0.0;
+
+    for (int32_t y = 0; y < tpl->rows; ++y)
+    {
+        for (int32_t x = 0; x < tpl->cols; ++x)
+        {
+            const double s = getUint8Pixel(src, x0 + x, y0 + y) - ms;
+            const double t = getUint8Pixel(tpl, x, y) - mt;
+
+            st += s * t;
+            ss += s * s;
+            tt += t * t;
+            ssd += (s - t) * (s - t);
+        }
+    }
+
+    if (method == MATCH_SSD)
+    {
+        return ssd;
+    }
+
+    return ((ss * tt) > 1e-9) ? (st / sqrt(ss * tt)) : 0.0;
+}
+
+void test_matchTemplate(void)
+{
+    const eMatchMethod methods[] = {MATCH_SSD, MATCH_NCC, MATCH_ZNCC};
+    const char *names[] = {"SSD", "NCC", "ZNCC"};
+
+    image_t *src = newUint8Image(23, 17);
+    image_t tpl;
+
+    fillMatchSource(src, 2026, 256);
+
+    // The template is a view with a stride
+    roiImage(src, &tpl, 9, 7, 6, 5);
+
+    image_t *dst = newFloatImage(src->cols - tpl.cols + 1, src->rows - tpl.rows + 1);
+
+    for (uint32_t m = 0; m < (sizeof(methods) / sizeof(methods[0])); ++m)
+    {
+        matchTemplate(src, &tpl, dst, methods[m]);
+
+        for (int32_t y = 0; y < dst->rows; ++y)
+        {
+            for (int32_t x = 0; x < dst->cols; ++x)
+            {
+                const double exp = matchReference(src, &tpl, methods[m], x, y);
+                const double tol = (methods[m] == MATCH_SSD) ? 0.5 : 1e-5;
+
+                char name[80] = "";
+                sprintf(name, "%s, (%d,%d)", names[m], x, y);
+                TEST_ASSERT_FLOAT_WITHIN_MESSAGE((float)tol, (float)exp, getFloatPixel(dst, x, y), name);
+            }
+        }
+    }
+
+    // The template itself is a perfect match
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-6f, 1.0f, getFloatPixel(dst, 9, 7), "ZNCC peak is not 1");
+
+    // ZNCC does not change with the gain and offset of the template
+    image_t *bright = newUint8Image(tpl.cols, tpl.rows);
+    image_t *low = newUint8Image(23, 17);
+
+    fillMatchSource(low, 2027, 100);
+
+    for (int32_t y = 0; y < bright->rows; ++y)
+    {
+        for (int32_t x = 0; x < bright->cols; ++x)
+        {
+            setUint8Pixel(bright, x, y, (uint8_pixel_t)((2 * getUint8Pixel(low, 3 + x, 11 + y)) + 30));
+        }
+    }
+
+    matchTemplate(low, bright, dst, MATCH_ZNCC);
+
+    match_t best;
+    TEST_ASSERT_EQUAL_INT32(1, findBestMatches(dst, MATCH_ZNCC, 1, &best, 1));
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(3, best.position.x, "ZNCC peak x");
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(11, best.position.y, "ZNCC peak y");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-6f, 1.0f, best.score, "ZNCC peak is not 1");
+
+    // A template without variation has no ZNCC score
+    memset(bright->data, 77, (size_t)bright->cols * bright->rows);
+
+    matchTemplate(low, bright, dst, MATCH_ZNCC);
+
+    for (int32_t i = 0; i < (dst->cols * dst->rows); ++i)
+    {
+        TEST_ASSERT_EQUAL_FLOAT_MESSAGE(0.0f, ((float *)dst->data)[i], "Flat template");
+    }
+
+    deleteUint8Image(low);
+    deleteUint8Image(bright);
+    deleteFloatImage(dst);
+    deleteUint8Image(src);
+}
+
+void test_findBestMatches(void)
+{
+    image_t *scores = newFloatImage(10, 8);
+    match_t matches[4];
+
+    memset(scores->data, 0, (size_t)scores->cols * scores->rows * sizeof(float));
+
+    setFloatPixel(scores, 2, 2, 0.9f);
+    setFloatPixel(scores, 3, 2, 0.95f);
+    setFloatPixel(scores, 7, 5, 0.8f);
+    setFloatPixel(scores, 0, 7, -0.5f);
+
+    // Higher is better, (2,2) is suppressed by (3,2)
+    TEST_ASSERT_EQUAL_INT32(3, findBestMatches(scores, MATCH_ZNCC, 3, matches, 3));
+    TEST_ASSERT_EQUAL_INT32(3, matches[0].position.x);
+    TEST_ASSERT_EQUAL_INT32(2, matches[0].position.y);
+    TEST_ASSERT_EQUAL_FLOAT(0.95f, matches[0].score);
+    TEST_ASSERT_EQUAL_INT32(7, matches[1].position.x);
+    TEST_ASSERT_EQUAL_INT32(5, matches[1].position.y);
+    TEST_ASSERT_EQUAL_FLOAT(0.8f, matches[1].score);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, matches[2].score);
+
+    // Without suppression both neighbours are found
+    TEST_ASSERT_EQUAL_INT32(2, findBestMatches(scores, MATCH_ZNCC, 1, matches, 2));
+    TEST_ASSERT_EQUAL_INT32(2, matches[1].position.x);
+    TEST_ASSERT_EQUAL_INT32(2, matches[1].position.y);
+
+    // Lower is better
+    TEST_ASSERT_EQUAL_INT32(1, findBestMatches(scores, MATCH_SSD, 3, matches, 1));
+    TEST_ASSERT_EQUAL_INT32(0, matches[0].position.x);
+    TEST_ASSERT_EQUAL_INT32(7, matches[0].position.y);
+
+    // The image is too small for more matches
+    TEST_ASSERT_EQUAL_INT32(1, findBestMatches(scores, MATCH_ZNCC, 10, matches, 4));
+
+    deleteFloatImage(scores);
+}
+
+void test_matchTemplateCoarseToFine(void)
+{
+    image_t *src = newUint8Image(160, 120);
+    image_t *tpl = newUint8Image(32, 24);
+
+    // Smooth background with some noise
+    fillMatchSource(src, 7, 16);
+
+    for (int32_t y = 0; y < src->rows; ++y)
+    {
+        for (int32_t x = 0; x < src->cols; ++x)
+        {
+            setUint8Pixel(src, x, y, (uint8_pixel_t)(getUint8Pixel(src, x, y) + x + (y / 2)));
+        }
+    }
+
+    // Blocks of different sizes, so the template has detail on every level
+    for (int32_t y = 0; y < tpl->rows; ++y)
+    {
+        for (int32_t x = 0; x < tpl->cols; ++x)
+        {
+            const int32_t v = (((x / 8) + (y / 8)) % 2) * 120 + (((x / 3) + (y / 4)) % 2) * 50;
+            setUint8Pixel(tpl, x, y, (uint8_pixel_t)(40 + v));
+        }
+    }
+
+    // Paste the template at an odd position and a noisy copy with less
+    // contrast
+    for (int32_t y = 0; y < tpl->rows; ++y)
+    {
+        for (int32_t x = 0; x < tpl->cols; ++x)
+        {
+            setUint8Pixel(src, 101 + x, 37 + y, getUint8Pixel(tpl, x, y));
+            setUint8Pixel(src, 13 + x, 77 + y, (uint8_pixel_t)((getUint8Pixel(tpl, x, y) / 2) +
+                          (getUint8Pixel(src, 13 + x, 77 + y) % 8)));
+        }
+    }
+
+    match_t matches[2];
+
+    TEST_ASSERT_EQUAL_INT32(2, matchTemplateCoarseToFine(src, tpl, MATCH_ZNCC, 3, matches, 2));
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(101, matches[0].position.x, "First match x");
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(37, matches[0].position.y, "First match y");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-6f, 1.0f, matches[0].score, "First match score");
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(13, matches[1].position.x, "Second match x");
+    TEST_ASSERT_EQUAL_INT32_MESSAGE(77, matches[1].position.y, "Second match y");
+    TEST_ASSERT_TRUE_MESSAGE((matches[1].score > 0.95f) && (matches[1].score < 1.0f), "Second match score");
+
+    // SSD only finds the exact copy
+    TEST_ASSERT_EQUAL_INT32(1, matchTemplateCoarseToFine(src, tpl, MATCH_SSD, 3, matches, 1));
+    TEST_ASSERT_EQUAL_INT32(101, matches[0].position.x);
+    TEST_ASSERT_EQUAL_INT32(37, matches[0].position.y);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, matches[0].score);
+
+    // One level is an exhaustive search
+    image_t *scores = newFloatImage(src->cols - tpl->cols + 1, src->rows - tpl->rows + 1);
+    match_t exp;
+
+    matchTemplate(src, tpl, scores, MATCH_NCC);
+    findBestMatches(scores, MATCH_NCC, 1, &exp, 1);
+
+    TEST_ASSERT_EQUAL_INT32(1, matchTemplateCoarseToFine(src, tpl, MATCH_NCC, 1, matches, 1));
+    TEST_ASSERT_EQUAL_INT32(exp.position.x, matches[0].position.x);
+    TEST_ASSERT_EQUAL_INT32(exp.position.y, matches[0].position.y);
+    TEST_ASSERT_EQUAL_FLOAT(exp.score, matches[0].score);
+
+    deleteFloatImage(scores);
+    deleteUint8Image(tpl);
+    deleteUint8Image(src);
+}
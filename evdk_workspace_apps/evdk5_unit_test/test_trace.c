@@ -0,0 +1,143 @@
+/*! ***************************************************************************
+ *
+ * \brief     Unit test functions for operator tracing
+ * \file      test_trace.c
+ * \author    HAN Embedded Vision and Machine Learning
+ * \author
+ * \date      October 2026
+ *
+ * \copyright 2024 HAN University of Applied Sciences. All Rights Reserved.
+ *            \n\n
+ *            Permission is hereby granted, free of charge, to any person
+ *            obtaining a copy of this software and associated documentation
+ *            files (the "Software"), to deal in the Software without
+ *            restriction, including without limitation the rights to use,
+ *            copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *            copies of the Software, and to permit persons to whom the
+ *            Software is furnished to do so, subject to the following
+ *            conditions:
+ *            \n\n
+ *            The above copyright notice and this permission notice shall be
+ *            included in all copies or substantial portions of the Software.
+ *            \n\n
+ *            THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *            EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *            OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *            NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *            HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *            WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *            FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *            OTHER DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "main.h"
+
+#if (EVDK_TRACE == 1)
+
+// ----------------------------------------------------------------------------
+// Local variables
+// ----------------------------------------------------------------------------
+/// Timestamp of the test clock
+static uint64_t ticks = 0;
+
+/// Buffer that receives the exported trace
+static char json[1024];
+
+// ----------------------------------------------------------------------------
+// Local functions
+// ----------------------------------------------------------------------------
+// A clock that advances 10 ticks every time it is read
+static uint64_t testClock(void)
+{
+    ticks += 10;
+    return ticks;
+}
+
+// Appends the exported trace to the json buffer
+static void testWriter(const char *str, void *ctx)
+{
+    size_t *len = (size_t *)ctx;
+    size_t n = strlen(str);
+
+    if ((*len + n) < sizeof(json))
+    {
+        memcpy(&json[*len], str, n + 1);
+        *len += n;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Test functions
+// ----------------------------------------------------------------------------
+void test_traceEvents(void)
+{
+    image_t *src = newInt16Image(4, 3);
+    image_t *dst = newInt16Image(4, 3);
+
+    clearInt16Image(src);
+
+    // Selecting a clock resets the trace
+    traceSetClock(testClock, 10);
+    TEST_ASSERT_EQUAL_MESSAGE(0, traceGetEventCount(), "trace not empty after reset");
+
+    // The filter calls convolve(), which must be recorded as a nested event
+    gaussianFilter_3x3(src, dst);
+
+    TEST_ASSERT_EQUAL_MESSAGE(2, traceGetEventCount(), "number of events incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(0, traceGetDroppedCount(), "events dropped");
+    TEST_ASSERT_NULL_MESSAGE(traceGetEvent(2), "event out of range returned");
+
+    const trace_event_t *outer = traceGetEvent(0);
+    const trace_event_t *inner = traceGetEvent(1);
+
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("gaussianFilter_3x3", outer->name, "name of outer event incorrect");
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("convolve", inner->name, "name of inner event incorrect");
+    TEST_ASSERT_TRUE_MESSAGE(outer->end > outer->begin, "outer event has no duration");
+    TEST_ASSERT_TRUE_MESSAGE((inner->begin > outer->begin) && (inner->end < outer->end), "inner event not nested");
+
+    TEST_ASSERT_EQUAL_MESSAGE(4, outer->src.cols, "src cols incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(3, outer->src.rows, "src rows incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(IMGTYPE_INT16, outer->dst.type, "dst type incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE(2 * 4 * 3 * sizeof(int16_pixel_t), outer->bytes, "bytes incorrect");
+
+    // Restore the default clock
+    traceSetClock(NULL, 0);
+
+    deleteInt16Image(dst);
+    deleteInt16Image(src);
+}
+
+void test_traceWriteChrome(void)
+{
+    image_t *src = newUint8Image(4, 3);
+    image_t *dst = newUint8Image(4, 3);
+    size_t len = 0;
+
+    clearUint8Image(src);
+
+    // The reset reads the clock at 10 ticks, the copy runs from 20 to 30
+    // ticks. With 10 ticks per microsecond, the event starts at 1 us and
+    // takes 1 us.
+    ticks = 0;
+    traceSetClock(testClock, 10);
+    copyUint8Image(src, dst);
+
+    json[0] = '\0';
+    traceWriteChrome(testWriter, &len);
+
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(json, "\"traceEvents\""), "trace events missing");
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(json, "\"name\": \"copyUint8Image\""), "name missing");
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(json, "\"ph\": \"X\""), "complete event missing");
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(json, "\"ts\": 1.000, \"dur\": 1.000"), "timestamps incorrect");
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(json, "\"bytes\": 24"), "bytes incorrect");
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(json, "\"src\": \"4x3 uint8\""), "src image incorrect");
+    TEST_ASSERT_EQUAL_MESSAGE('\n', json[len - 1], "trace not terminated");
+
+    // Restore the default clock
+    traceSetClock(NULL, 0);
+
+    deleteUint8Image(dst);
+    deleteUint8Image(src);
+}
+
+#endif // EVDK_TRACE
@@ -32,4 +32,157 @@
  *****************************************************************************/
 
 #include "main.h"
+#include <math.h>
 
+// Fills a float image with pseudo random values in the range [-1, 1]
+static void fillTransformSource(image_t *img, uint32_t seed)
+{
+    for (int32_t y = 0; y < img->rows; ++y)
+    {
+        for (int32_t x = 0; x < img->cols; ++x)
+        {
+            seed = (seed * 1103515245u) + 12345u;
+            setFloatPixel(img, x, y, (float)((int32_t)((seed >> 16) % 2001) - 1000) / 1000.0f);
+        }
+    }
+}
+
+// Straightforward evaluation of the discrete Fourier transform of a float
+// image, only the first dst->cols columns of the spectrum are calculated
+static void dftReference(const image_t *src, image_t *dst)
+{
+    const double pi = 3.14159265358979323846;
+
+    for (int32_t v = 0; v < dst->rows; ++v)
+    {
+        for (int32_t u = 0; u < dst->cols; ++u)
+        {
+            double re = 0.0;
+            double im = 0.0;
+
+            for (int32_t y = 0; y < src->rows; ++y)
+            {
+                for (int32_t x = 0; x < src->cols; ++x)
+                {
+                    const double a = -2.0 * pi * ((((double)u * x) / src->cols) +
+                                                  (((double)v * y) / src->rows));
+
+                    re += getFloatPixel(src, x, y) * cos(a);
+                    im += getFloatPixel(src, x, y) * sin(a);
+                }
+            }
+
+            complex_pixel_t p = {(float)re, (float)im};
+            setComplexPixel(dst, u, v, p);
+        }
+    }
+}
+
+// Compares two complex images with a tolerance relative to the magnitude of
+// the spectrum
+static void assertComplexWithin(const image_t *exp, const image_t *act,
+                                const float tolerance, const char *name)
+{
+    for (int32_t y = 0; y < exp->rows; ++y)
+    {
+        for (int32_t x = 0; x < exp->cols; ++x)
+        {
+            complex_pixel_t e = getComplexPixel(exp, x, y);
+            complex_pixel_t a = getComplexPixel(act, x, y);
+
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(tolerance, e.real, a.real, name);
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(tolerance, e.imaginary, a.imaginary, name);
+        }
+    }
+}
+
+void test_fft2d(void)
+{
+    // Radix 4, 2, 3, 5 and a generic prime factor, including single rows and
+    // columns
+    const int32_t sizes[][2] = {{16, 8}, {12, 10}, {30, 9}, {14, 13}, {7, 5}, {1, 6}, {8, 1}, {1, 1}};
+
+    for (uint32_t s = 0; s < (sizeof(sizes) / sizeof(sizes[0])); ++s)
+    {
+        const int32_t cols = sizes[s][0];
+        const int32_t rows = sizes[s][1];
+
+        image_t *src = newFloatImage(cols, rows);
+        image_t *exp = newComplexImage(cols, rows);
+        image_t *dst = newComplexImage(cols, rows);
+        image_t *inv = newFloatImage(cols, rows);
+
+        fillTransformSource(src, 2026 + s);
+
+        dftReference(src, exp);
+        fft2d(src, dst);
+
+        char name[80] = "";
+        sprintf(name, "fft2d, %dx%d", cols, rows);
+        assertComplexWithin(exp, dst, 1e-4f * cols * rows, name);
+
+        // The inverse transform returns the original image, both to a float
+        // image and in-place
+        ifft2d(dst, inv);
+
+        sprintf(name, "ifft2d, %dx%d", cols, rows);
+        for (int32_t i = 0; i < (cols * rows); ++i)
+        {
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-5f, ((float *)src->data)[i], ((float *)inv->data)[i], name);
+        }
+
+        ifft2d(dst, dst);
+
+        sprintf(name, "ifft2d in-place, %dx%d", cols, rows);
+        for (int32_t i = 0; i < (cols * rows); ++i)
+        {
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-5f, ((float *)src->data)[i], ((complex_pixel_t *)dst->data)[i].real, name);
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-5f, 0.0f, ((complex_pixel_t *)dst->data)[i].imaginary, name);
+        }
+
+        deleteFloatImage(inv);
+        deleteComplexImage(dst);
+        deleteComplexImage(exp);
+        deleteFloatImage(src);
+    }
+}
+
+void test_fft2dReal(void)
+{
+    // Even and odd number of columns
+    const int32_t sizes[][2] = {{16, 8}, {20, 9}, {6, 14}, {15, 4}, {7, 7}, {2, 1}, {1, 3}};
+
+    for (uint32_t s = 0; s < (sizeof(sizes) / sizeof(sizes[0])); ++s)
+    {
+        const int32_t cols = sizes[s][0];
+        const int32_t rows = sizes[s][1];
+        const int32_t half = (cols / 2) + 1;
+
+        image_t *src = newFloatImage(cols, rows);
+        image_t *exp = newComplexImage(half, rows);
+        image_t *dst = newComplexImage(half, rows);
+        image_t *inv = newFloatImage(cols, rows);
+
+        fillTransformSource(src, 1 + s);
+
+        dftReference(src, exp);
+        fft2dReal(src, dst);
+
+        char name[80] = "";
+        sprintf(name, "fft2dReal, %dx%d", cols, rows);
+        assertComplexWithin(exp, dst, 1e-4f * cols * rows, name);
+
+        ifft2dReal(dst, inv);
+
+        sprintf(name, "ifft2dReal, %dx%d", cols, rows);
+        for (int32_t i = 0; i < (cols * rows); ++i)
+        {
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-5f, ((float *)src->data)[i], ((float *)inv->data)[i], name);
+        }
+
+        deleteFloatImage(inv);
+        deleteComplexImage(dst);
+        deleteComplexImage(exp);
+        deleteFloatImage(src);
+    }
+}
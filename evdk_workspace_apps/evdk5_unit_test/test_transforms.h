@@ -34,6 +34,10 @@
 #ifndef _TEST_TRANSFORMS_H_
 #define _TEST_TRANSFORMS_H_
 
+/// \brief Unit test function for fft2d() and ifft2d()
+void test_fft2d(void);
 
+/// \brief Unit test function for fft2dReal() and ifft2dReal()
+void test_fft2dReal(void);
 
 #endif // _TEST_TRANSFORMS_H_
@@ -80,7 +80,10 @@ void exampleWebcamUyvy(void);
 // Local variables
 // -----------------------------------------------------------------------------
 
-// Note: The heap (malloc()) is used for allocating image data
+// Note: Images are allocated from the image arena. The arena is allocated
+//       from the heap (malloc()) once in systemInit() and takes all of the
+//       heap except HEAP_RESERVE bytes. The reserve is for the other users of
+//       the heap, such as the buffers of the Huffman coder.
 //
 // uint8_pixel_t : 160 * 120 * 1 = 19200 bytes per image
 // int16_pixel_t : 160 * 120 * 2 = 38400 bytes per image
@@ -89,10 +92,17 @@ void exampleWebcamUyvy(void);
 // bgr888_pixel_t: 160 * 120 * 3 = 57600 bytes per image
 // float_pixel_t : 160 * 120 * 4 = 76800 bytes per image
 //
-// The heap is configured to 345888 (0x54720) bytes
-// Image data for 345888 / (160 * 120) = 18.015 uint8_pixel_t images can be
-// allocated. However, the images called 'cam' and 'usb' are mandatory and are
-// already taking 5 (2+3) of these.
+// The heap is configured to 345888 (0x54720) bytes, so the arena is
+// 345888 - 32768 = 313120 bytes. Image data for 313120 / (160 * 120) = 16.308
+// uint8_pixel_t images can be allocated. Before the arena the Huffman buffers
+// were allocated from the same heap as the images, so the capacity for images
+// is practically unchanged. However, the images called 'cam' and 'usb' are
+// mandatory and are already taking 5 (2+3) of these.
+#define HEAP_RESERVE (32 * 1024)
+
+// Boundaries of the heap, defined in the linker script
+extern uint8_t _pvHeapStart[];
+extern uint8_t _pvHeapLimit[];
 
 // Globally shared images. Allocation of these images is taken care of in
 // systemInit(). Not static, so these can be referenced in other source files.
@@ -224,6 +234,9 @@ void systemInit(void)
     PRINTF("Application init\r\n");
 
     // -------------------------------------------------------------------------
+    // The image arena takes the heap, except for HEAP_RESERVE bytes
+    initImageArena(NULL, (size_t)(_pvHeapLimit - _pvHeapStart) - HEAP_RESERVE);
+
     // Image memory allocation for static images required by camera and USB.
     // Allocation must be done before DMA initialization!
     cam = newUyvyImage(EVDK5_WIDTH, EVDK5_HEIGHT);